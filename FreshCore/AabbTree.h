@@ -0,0 +1,758 @@
+//
+//  AabbTree.h
+//  Fresh
+//
+
+#ifndef Fresh_AabbTree_h
+#define Fresh_AabbTree_h
+
+#include "FreshDebug.h"
+#include <vector>
+#include <algorithm>
+#include <utility>
+
+namespace fr
+{
+	// A dynamic bounding-volume tree of axis-aligned boxes, for worlds that a uniform grid serves badly: large,
+	// sparse, or with objects of very different sizes. Each element sits in a leaf whose box is its own box
+	// fattened by a margin, so small movements leave the tree alone; larger ones reinsert the leaf. Insertion
+	// picks the sibling that least increases total perimeter, and rotations keep the tree balanced.
+	//
+	// Handles stay valid until the element is removed. Queries test elements' exact boxes, keep no state, and
+	// may be made from within other queries' callbacks.
+	//
+	template< typename PosT, typename ValueT >
+	class AabbTree
+	{
+	public:
+
+		typedef PosT position_type;
+		typedef typename PosT::element_type real_type;
+
+		typedef ValueT value_type;
+		typedef ValueT& reference;
+		typedef const ValueT& const_reference;
+
+		typedef size_t Handle;
+		static const Handle INVALID_HANDLE = ~Handle( 0 );
+
+		explicit AabbTree( real_type margin );
+		// REQUIRES( margin >= 0 );
+
+		size_t size() const											{ return m_size; }
+		bool empty() const											{ return m_size == 0; }
+		int height() const											{ return m_root == INVALID_HANDLE ? 0 : m_nodes[ m_root ].height; }
+
+		void clear();
+
+		Handle add( const position_type& minCorner, const position_type& maxCorner, const_reference element );
+		// PROMISES( contains( result ));
+
+		bool move( Handle handle, const position_type& minCorner, const position_type& maxCorner, const position_type& displacement = position_type( 0 ));
+		// REQUIRES( contains( handle ));
+		// Returns true if the element had to be reinserted. A displacement (the expected movement before the next
+		// call) stretches the new fattened box in that direction.
+
+		void remove( Handle handle );
+		// REQUIRES( contains( handle ));
+		// PROMISES( !contains( handle ));
+
+		bool contains( Handle handle ) const						{ return handle < m_nodes.size() && m_nodes[ handle ].height == 0; }
+
+		const_reference operator[]( Handle handle ) const			{ ASSERT( contains( handle )); return m_nodes[ handle ].value; }
+		reference operator[]( Handle handle )						{ ASSERT( contains( handle )); return m_nodes[ handle ].value; }
+
+		const position_type& minCorner( Handle handle ) const		{ ASSERT( contains( handle )); return m_nodes[ handle ].elementMin; }
+		const position_type& maxCorner( Handle handle ) const		{ ASSERT( contains( handle )); return m_nodes[ handle ].elementMax; }
+
+		template< typename Function >
+		void eachOverlapping( const position_type& minCorner, const position_type& maxCorner, Function&& fn ) const;
+		// Calls fn( element ) once for each element whose box overlaps the given one.
+
+		template< typename BoxTest, typename Function >
+		void eachIntersecting( BoxTest&& intersectsBox, Function&& fn ) const;
+		// Calls fn( element ) once for each element whose box passes intersectsBox( minCorner, maxCorner ), for any shape
+		// that can test itself against a box. The test is also applied to the tree's own (larger) boxes to prune it.
+
+		template< typename Function >
+		void eachWithinRadius( const position_type& center, real_type radius, Function&& fn ) const;
+		// Calls fn( element ) once for each element whose box touches the circle.
+
+		template< typename Function >
+		void eachOnRay( const position_type& start, const position_type& end, Function&& fn ) const;
+		// Calls fn( element, t ) once for each element whose box the segment from start to end crosses, in no
+		// particular order, where t in [0,1] is how far along the segment it enters the box.
+
+		Handle firstOnRay( const position_type& start, const position_type& end, real_type* outT = nullptr ) const;
+		// Returns the element whose box the segment enters first, or INVALID_HANDLE.
+
+		template< typename Function >
+		void eachNearest( const position_type& point, size_t k, Function&& fn ) const;
+		// Calls fn( element, distanceSquared ) for the k elements whose boxes are nearest the point, nearest first.
+		// Points inside a box are at distance 0.
+
+	protected:
+
+		struct Node
+		{
+			position_type minCorner;		// For leaves, the fattened box.
+			position_type maxCorner;
+			position_type elementMin;		// Leaves only: the element's own box.
+			position_type elementMax;
+			value_type value;
+			Handle parent = INVALID_HANDLE;
+			Handle child1 = INVALID_HANDLE;
+			Handle child2 = INVALID_HANDLE;
+			int height = -1;				// 0 for leaves, -1 for free nodes.
+
+			bool isLeaf() const										{ return child1 == INVALID_HANDLE; }
+		};
+
+		// The traversal stack of the queries. Balancing keeps trees shallow enough that the fixed part almost always
+		// suffices, but it does not bound their height, so a deeper tree spills onto the heap rather than overrunning.
+		//
+		class NodeStack
+		{
+		public:
+
+			bool empty() const										{ return m_size == 0; }
+
+			void push( Handle handle )
+			{
+				if( m_size < FIXED_CAPACITY )
+				{
+					m_fixed[ m_size ] = handle;
+				}
+				else
+				{
+					m_spilled.push_back( handle );
+				}
+				++m_size;
+			}
+
+			Handle pop()
+			{
+				ASSERT( !empty() );
+				--m_size;
+				if( m_size < FIXED_CAPACITY )
+				{
+					return m_fixed[ m_size ];
+				}
+				const Handle handle = m_spilled.back();
+				m_spilled.pop_back();
+				return handle;
+			}
+
+		private:
+
+			static const size_t FIXED_CAPACITY = 64;
+
+			Handle m_fixed[ FIXED_CAPACITY ];
+			std::vector< Handle > m_spilled;
+			size_t m_size = 0;
+		};
+
+		Handle allocateNode();
+		void freeNode( Handle handle );
+
+		void insertLeaf( Handle leaf );
+		void removeLeaf( Handle leaf );
+		Handle balance( Handle handle );
+		void refit( Handle handle );
+
+		static real_type perimeter( const position_type& minCorner, const position_type& maxCorner )
+		{
+			return 2 * (( maxCorner[ 0 ] - minCorner[ 0 ] ) + ( maxCorner[ 1 ] - minCorner[ 1 ] ));
+		}
+
+		static real_type combinedPerimeter( const Node& a, const Node& b )
+		{
+			return 2 * (( std::max( a.maxCorner[ 0 ], b.maxCorner[ 0 ] ) - std::min( a.minCorner[ 0 ], b.minCorner[ 0 ] )) +
+						( std::max( a.maxCorner[ 1 ], b.maxCorner[ 1 ] ) - std::min( a.minCorner[ 1 ], b.minCorner[ 1 ] )));
+		}
+
+		static void combine( Node& into, const Node& a, const Node& b )
+		{
+			for( size_t i = 0; i < 2; ++i )
+			{
+				into.minCorner[ i ] = std::min( a.minCorner[ i ], b.minCorner[ i ] );
+				into.maxCorner[ i ] = std::max( a.maxCorner[ i ], b.maxCorner[ i ] );
+			}
+		}
+
+		static bool overlaps( const position_type& aMin, const position_type& aMax, const position_type& bMin, const position_type& bMax )
+		{
+			return aMin[ 0 ] <= bMax[ 0 ] && bMin[ 0 ] <= aMax[ 0 ] && aMin[ 1 ] <= bMax[ 1 ] && bMin[ 1 ] <= aMax[ 1 ];
+		}
+
+		static bool encloses( const position_type& outerMin, const position_type& outerMax, const position_type& innerMin, const position_type& innerMax )
+		{
+			return outerMin[ 0 ] <= innerMin[ 0 ] && outerMin[ 1 ] <= innerMin[ 1 ] && innerMax[ 0 ] <= outerMax[ 0 ] && innerMax[ 1 ] <= outerMax[ 1 ];
+		}
+
+		static real_type distanceSquared( const position_type& point, const position_type& minCorner, const position_type& maxCorner )
+		{
+			real_type result = 0;
+			for( size_t i = 0; i < 2; ++i )
+			{
+				const real_type outside = std::max( std::max( minCorner[ i ] - point[ i ], point[ i ] - maxCorner[ i ] ), real_type( 0 ));
+				result += outside * outside;
+			}
+			return result;
+		}
+
+		static bool segmentEnters( const position_type& start, const position_type& delta, const position_type& minCorner, const position_type& maxCorner, real_type maxT, real_type& outT );
+
+	private:
+
+		std::vector< Node > m_nodes;
+		Handle m_root = INVALID_HANDLE;
+		Handle m_freeList = INVALID_HANDLE;
+		size_t m_size = 0;
+		real_type m_margin;
+	};
+
+
+	///////////////////////////////////////////////////////
+
+	template< typename PosT, typename ValueT >
+	AabbTree< PosT, ValueT >::AabbTree( real_type margin )
+	:	m_margin( margin )
+	{
+		static_assert( position_type::nComponents == 2, "AabbTree requires a 2d-vector" );
+		REQUIRES( margin >= 0 );
+	}
+
+	template< typename PosT, typename ValueT >
+	void AabbTree< PosT, ValueT >::clear()
+	{
+		m_nodes.clear();
+		m_root = INVALID_HANDLE;
+		m_freeList = INVALID_HANDLE;
+		m_size = 0;
+	}
+
+	template< typename PosT, typename ValueT >
+	typename AabbTree< PosT, ValueT >::Handle AabbTree< PosT, ValueT >::allocateNode()
+	{
+		Handle handle;
+		if( m_freeList == INVALID_HANDLE )
+		{
+			handle = m_nodes.size();
+			m_nodes.emplace_back();
+		}
+		else
+		{
+			// Free nodes are chained through their parent links.
+			//
+			handle = m_freeList;
+			m_freeList = m_nodes[ handle ].parent;
+		}
+
+		auto& node = m_nodes[ handle ];
+		node.parent = node.child1 = node.child2 = INVALID_HANDLE;
+		node.height = 0;
+		return handle;
+	}
+
+	template< typename PosT, typename ValueT >
+	void AabbTree< PosT, ValueT >::freeNode( Handle handle )
+	{
+		auto& node = m_nodes[ handle ];
+		node.value = value_type{};
+		node.height = -1;
+		node.child1 = node.child2 = INVALID_HANDLE;
+		node.parent = m_freeList;
+		m_freeList = handle;
+	}
+
+	template< typename PosT, typename ValueT >
+	typename AabbTree< PosT, ValueT >::Handle AabbTree< PosT, ValueT >::add( const position_type& minCorner, const position_type& maxCorner, const_reference element )
+	{
+		const Handle handle = allocateNode();
+
+		auto& node = m_nodes[ handle ];
+		node.elementMin = minCorner;
+		node.elementMax = maxCorner;
+		node.value = element;
+		for( size_t i = 0; i < 2; ++i )
+		{
+			node.minCorner[ i ] = minCorner[ i ] - m_margin;
+			node.maxCorner[ i ] = maxCorner[ i ] + m_margin;
+		}
+
+		insertLeaf( handle );
+		++m_size;
+
+		PROMISES( contains( handle ));
+		return handle;
+	}
+
+	template< typename PosT, typename ValueT >
+	bool AabbTree< PosT, ValueT >::move( Handle handle, const position_type& minCorner, const position_type& maxCorner, const position_type& displacement )
+	{
+		REQUIRES( contains( handle ));
+
+		auto& node = m_nodes[ handle ];
+		node.elementMin = minCorner;
+		node.elementMax = maxCorner;
+
+		if( encloses( node.minCorner, node.maxCorner, minCorner, maxCorner ))
+		{
+			return false;
+		}
+
+		removeLeaf( handle );
+
+		auto& moved = m_nodes[ handle ];
+		for( size_t i = 0; i < 2; ++i )
+		{
+			moved.minCorner[ i ] = minCorner[ i ] - m_margin + std::min( displacement[ i ], real_type( 0 ));
+			moved.maxCorner[ i ] = maxCorner[ i ] + m_margin + std::max( displacement[ i ], real_type( 0 ));
+		}
+
+		insertLeaf( handle );
+		return true;
+	}
+
+	template< typename PosT, typename ValueT >
+	void AabbTree< PosT, ValueT >::remove( Handle handle )
+	{
+		REQUIRES( contains( handle ));
+
+		removeLeaf( handle );
+		freeNode( handle );
+		--m_size;
+
+		PROMISES( !contains( handle ));
+	}
+
+	template< typename PosT, typename ValueT >
+	void AabbTree< PosT, ValueT >::insertLeaf( Handle leaf )
+	{
+		if( m_root == INVALID_HANDLE )
+		{
+			m_root = leaf;
+			m_nodes[ leaf ].parent = INVALID_HANDLE;
+			return;
+		}
+
+		// Descend to the sibling that makes the cheapest tree. Making a new parent for a node costs the perimeter
+		// of their combined box, and every ancestor grows by however much including the leaf enlarges it.
+		//
+		Handle index = m_root;
+		while( !m_nodes[ index ].isLeaf() )
+		{
+			const Node& node = m_nodes[ index ];
+			const Node& leafNode = m_nodes[ leaf ];
+
+			const real_type combined = combinedPerimeter( node, leafNode );
+			const real_type cost = 2 * combined;
+			const real_type inheritanceCost = 2 * ( combined - perimeter( node.minCorner, node.maxCorner ));
+
+			const auto descentCost = [&]( const Node& child )
+			{
+				const real_type childCombined = combinedPerimeter( child, leafNode );
+				return inheritanceCost + ( child.isLeaf() ? childCombined : childCombined - perimeter( child.minCorner, child.maxCorner ));
+			};
+
+			const real_type cost1 = descentCost( m_nodes[ node.child1 ] );
+			const real_type cost2 = descentCost( m_nodes[ node.child2 ] );
+
+			if( cost < cost1 && cost < cost2 )
+			{
+				break;
+			}
+
+			index = cost1 < cost2 ? node.child1 : node.child2;
+		}
+
+		const Handle sibling = index;
+		const Handle oldParent = m_nodes[ sibling ].parent;
+		const Handle newParent = allocateNode();		// May reallocate m_nodes.
+
+		{
+			Node& parentNode = m_nodes[ newParent ];
+			parentNode.parent = oldParent;
+			combine( parentNode, m_nodes[ leaf ], m_nodes[ sibling ] );
+			parentNode.height = m_nodes[ sibling ].height + 1;
+			parentNode.child1 = sibling;
+			parentNode.child2 = leaf;
+		}
+
+		if( oldParent != INVALID_HANDLE )
+		{
+			Node& oldParentNode = m_nodes[ oldParent ];
+			( oldParentNode.child1 == sibling ? oldParentNode.child1 : oldParentNode.child2 ) = newParent;
+		}
+		else
+		{
+			m_root = newParent;
+		}
+
+		m_nodes[ sibling ].parent = newParent;
+		m_nodes[ leaf ].parent = newParent;
+
+		refit( newParent );
+	}
+
+	template< typename PosT, typename ValueT >
+	void AabbTree< PosT, ValueT >::removeLeaf( Handle leaf )
+	{
+		if( leaf == m_root )
+		{
+			m_root = INVALID_HANDLE;
+			return;
+		}
+
+		const Handle parent = m_nodes[ leaf ].parent;
+		const Handle grandParent = m_nodes[ parent ].parent;
+		const Handle sibling = m_nodes[ parent ].child1 == leaf ? m_nodes[ parent ].child2 : m_nodes[ parent ].child1;
+
+		// The sibling takes the parent's place.
+		//
+		if( grandParent != INVALID_HANDLE )
+		{
+			Node& grandParentNode = m_nodes[ grandParent ];
+			( grandParentNode.child1 == parent ? grandParentNode.child1 : grandParentNode.child2 ) = sibling;
+			m_nodes[ sibling ].parent = grandParent;
+			freeNode( parent );
+
+			refit( grandParent );
+		}
+		else
+		{
+			m_root = sibling;
+			m_nodes[ sibling ].parent = INVALID_HANDLE;
+			freeNode( parent );
+		}
+
+		m_nodes[ leaf ].parent = INVALID_HANDLE;
+	}
+
+	template< typename PosT, typename ValueT >
+	void AabbTree< PosT, ValueT >::refit( Handle index )
+	{
+		// Rebalance and re-box from here to the root.
+		//
+		while( index != INVALID_HANDLE )
+		{
+			index = balance( index );
+
+			Node& node = m_nodes[ index ];
+			const Node& child1 = m_nodes[ node.child1 ];
+			const Node& child2 = m_nodes[ node.child2 ];
+
+			node.height = 1 + std::max( child1.height, child2.height );
+			combine( node, child1, child2 );
+
+			index = node.parent;
+		}
+	}
+
+	template< typename PosT, typename ValueT >
+	typename AabbTree< PosT, ValueT >::Handle AabbTree< PosT, ValueT >::balance( Handle iA )
+	{
+		Node& A = m_nodes[ iA ];
+		if( A.isLeaf() || A.height < 2 )
+		{
+			return iA;
+		}
+
+		const Handle iB = A.child1;
+		const Handle iC = A.child2;
+		Node& B = m_nodes[ iB ];
+		Node& C = m_nodes[ iC ];
+
+		const int imbalance = C.height - B.height;
+
+		// Rotate whichever child is too tall up into A's place. A keeps its shorter child and takes the taller
+		// child's shorter child; the taller child keeps its own taller child.
+		//
+		const auto rotateUp = [&]( Handle iUp, Node& up, Handle& aSlotForGrandchild )
+		{
+			const Handle iF = up.child1;
+			const Handle iG = up.child2;
+			Node& F = m_nodes[ iF ];
+			Node& G = m_nodes[ iG ];
+
+			up.child1 = iA;
+			up.parent = A.parent;
+			A.parent = iUp;
+
+			if( up.parent != INVALID_HANDLE )
+			{
+				Node& parent = m_nodes[ up.parent ];
+				( parent.child1 == iA ? parent.child1 : parent.child2 ) = iUp;
+			}
+			else
+			{
+				m_root = iUp;
+			}
+
+			const bool keepF = F.height > G.height;
+			const Handle iKept = keepF ? iF : iG;
+			const Handle iGiven = keepF ? iG : iF;
+
+			up.child2 = iKept;
+			aSlotForGrandchild = iGiven;
+			m_nodes[ iGiven ].parent = iA;
+
+			combine( A, m_nodes[ A.child1 ], m_nodes[ A.child2 ] );
+			A.height = 1 + std::max( m_nodes[ A.child1 ].height, m_nodes[ A.child2 ].height );
+
+			combine( up, A, m_nodes[ iKept ] );
+			up.height = 1 + std::max( A.height, m_nodes[ iKept ].height );
+
+			return iUp;
+		};
+
+		if( imbalance > 1 )
+		{
+			return rotateUp( iC, C, A.child2 );
+		}
+		if( imbalance < -1 )
+		{
+			return rotateUp( iB, B, A.child1 );
+		}
+
+		return iA;
+	}
+
+	template< typename PosT, typename ValueT >
+	template< typename BoxTest, typename Function >
+	void AabbTree< PosT, ValueT >::eachIntersecting( BoxTest&& intersectsBox, Function&& fn ) const
+	{
+		if( m_root == INVALID_HANDLE )
+		{
+			return;
+		}
+
+		NodeStack stack;
+		stack.push( m_root );
+
+		while( !stack.empty() )
+		{
+			const Node& node = m_nodes[ stack.pop() ];
+			if( !intersectsBox( node.minCorner, node.maxCorner ))
+			{
+				continue;
+			}
+
+			if( node.isLeaf() )
+			{
+				if( intersectsBox( node.elementMin, node.elementMax ))
+				{
+					fn( node.value );
+				}
+			}
+			else
+			{
+				stack.push( node.child1 );
+				stack.push( node.child2 );
+			}
+		}
+	}
+
+	template< typename PosT, typename ValueT >
+	template< typename Function >
+	void AabbTree< PosT, ValueT >::eachOverlapping( const position_type& minCorner, const position_type& maxCorner, Function&& fn ) const
+	{
+		eachIntersecting( [&]( const position_type& boxMin, const position_type& boxMax )
+						 {
+							 return overlaps( boxMin, boxMax, minCorner, maxCorner );
+						 },
+						 std::forward< Function >( fn ));
+	}
+
+	template< typename PosT, typename ValueT >
+	template< typename Function >
+	void AabbTree< PosT, ValueT >::eachWithinRadius( const position_type& center, real_type radius, Function&& fn ) const
+	{
+		const real_type radiusSquared = radius * radius;
+		eachIntersecting( [&]( const position_type& boxMin, const position_type& boxMax )
+						 {
+							 return distanceSquared( center, boxMin, boxMax ) <= radiusSquared;
+						 },
+						 std::forward< Function >( fn ));
+	}
+
+	template< typename PosT, typename ValueT >
+	bool AabbTree< PosT, ValueT >::segmentEnters( const position_type& start, const position_type& delta, const position_type& minCorner, const position_type& maxCorner, real_type maxT, real_type& outT )
+	{
+		real_type tEnter = 0;
+		real_type tExit = maxT;
+		for( size_t i = 0; i < 2; ++i )
+		{
+			if( delta[ i ] == 0 )
+			{
+				if( start[ i ] < minCorner[ i ] || maxCorner[ i ] < start[ i ] )
+				{
+					return false;
+				}
+			}
+			else
+			{
+				real_type t0 = ( minCorner[ i ] - start[ i ] ) / delta[ i ];
+				real_type t1 = ( maxCorner[ i ] - start[ i ] ) / delta[ i ];
+				if( t1 < t0 )
+				{
+					std::swap( t0, t1 );
+				}
+				tEnter = std::max( tEnter, t0 );
+				tExit = std::min( tExit, t1 );
+				if( tEnter > tExit )
+				{
+					return false;
+				}
+			}
+		}
+		outT = tEnter;
+		return true;
+	}
+
+	template< typename PosT, typename ValueT >
+	template< typename Function >
+	void AabbTree< PosT, ValueT >::eachOnRay( const position_type& start, const position_type& end, Function&& fn ) const
+	{
+		if( m_root == INVALID_HANDLE )
+		{
+			return;
+		}
+
+		const position_type delta = end - start;
+
+		NodeStack stack;
+		stack.push( m_root );
+
+		real_type t;
+		while( !stack.empty() )
+		{
+			const Node& node = m_nodes[ stack.pop() ];
+			if( !segmentEnters( start, delta, node.minCorner, node.maxCorner, 1, t ))
+			{
+				continue;
+			}
+
+			if( node.isLeaf() )
+			{
+				if( segmentEnters( start, delta, node.elementMin, node.elementMax, 1, t ))
+				{
+					fn( node.value, t );
+				}
+			}
+			else
+			{
+				stack.push( node.child1 );
+				stack.push( node.child2 );
+			}
+		}
+	}
+
+	template< typename PosT, typename ValueT >
+	typename AabbTree< PosT, ValueT >::Handle AabbTree< PosT, ValueT >::firstOnRay( const position_type& start, const position_type& end, real_type* outT ) const
+	{
+		Handle nearest = INVALID_HANDLE;
+		real_type nearestT = 1;
+
+		if( m_root != INVALID_HANDLE )
+		{
+			const position_type delta = end - start;
+
+			NodeStack stack;
+			stack.push( m_root );
+
+			real_type t;
+			while( !stack.empty() )
+			{
+				const Handle index = stack.pop();
+				const Node& node = m_nodes[ index ];
+
+				// Only boxes entered before the nearest hit so far can hold a nearer one.
+				//
+				if( !segmentEnters( start, delta, node.minCorner, node.maxCorner, nearestT, t ))
+				{
+					continue;
+				}
+
+				if( node.isLeaf() )
+				{
+					if( segmentEnters( start, delta, node.elementMin, node.elementMax, nearestT, t ) && ( nearest == INVALID_HANDLE || t < nearestT ))
+					{
+						nearest = index;
+						nearestT = t;
+					}
+				}
+				else
+				{
+					stack.push( node.child1 );
+					stack.push( node.child2 );
+				}
+			}
+		}
+
+		if( outT && nearest != INVALID_HANDLE )
+		{
+			*outT = nearestT;
+		}
+		return nearest;
+	}
+
+	template< typename PosT, typename ValueT >
+	template< typename Function >
+	void AabbTree< PosT, ValueT >::eachNearest( const position_type& point, size_t k, Function&& fn ) const
+	{
+		if( m_root == INVALID_HANDLE || k == 0 )
+		{
+			return;
+		}
+
+		// Best-first search. Each entry's distance is a lower bound on the distance of every element beneath it
+		// (and for leaves, is the element's own distance), so when a leaf comes off the heap nothing left can be nearer.
+		//
+		struct Entry
+		{
+			real_type distanceSquared;
+			Handle handle;
+
+			bool operator<( const Entry& other ) const		{ return other.distanceSquared < distanceSquared; }		// Nearest first.
+		};
+
+		const auto entryFor = [&]( Handle handle )
+		{
+			const Node& node = m_nodes[ handle ];
+			return node.isLeaf() ? Entry{ distanceSquared( point, node.elementMin, node.elementMax ), handle }
+								 : Entry{ distanceSquared( point, node.minCorner, node.maxCorner ), handle };
+		};
+
+		std::vector< Entry > heap;
+		heap.reserve( 64 );
+		heap.push_back( entryFor( m_root ));
+
+		size_t nReported = 0;
+		while( !heap.empty() && nReported < k )
+		{
+			std::pop_heap( heap.begin(), heap.end() );
+			const Entry entry = heap.back();
+			heap.pop_back();
+
+			const Node& node = m_nodes[ entry.handle ];
+
+			if( node.isLeaf() )
+			{
+				fn( node.value, entry.distanceSquared );
+				++nReported;
+			}
+			else
+			{
+				for( const Handle child : { node.child1, node.child2 } )
+				{
+					heap.push_back( entryFor( child ));
+					std::push_heap( heap.begin(), heap.end() );
+				}
+			}
+		}
+	}
+}
+
+#endif
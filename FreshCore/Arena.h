@@ -0,0 +1,104 @@
+//
+//  Arena.h
+//  Fresh
+//
+
+#ifndef Fresh_Arena_h
+#define Fresh_Arena_h
+
+#include "FreshEssentials.h"
+#include "FreshDebug.h"
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <cstring>
+#include <type_traits>
+
+namespace fr
+{
+	// A bump allocator for trivially destructible objects that all die together.
+	// Allocations come from large blocks. Nothing is freed until the arena is destroyed, at which point every block
+	// is released at once. Size the first block well and there is exactly one allocation and one free.
+	//
+	class Arena
+	{
+	public:
+
+		explicit Arena( size_t firstBlockSize = 64 * 1024 )
+		:	m_nextBlockSize( std::max( firstBlockSize, size_t( 256 )))
+		{}
+
+		template< typename T >
+		T* allocate( size_t count = 1 )
+		{
+			static_assert( std::is_trivially_destructible< T >::value, "Arena objects are never destroyed." );
+
+			if( count == 0 )
+			{
+				return nullptr;
+			}
+
+			T* objects = static_cast< T* >( allocateBytes( sizeof( T ) * count, alignof( T )));
+			for( size_t i = 0; i < count; ++i )
+			{
+				new( objects + i ) T{};
+			}
+			return objects;
+		}
+
+		std::string_view copyString( std::string_view string )
+		{
+			if( string.empty() )
+			{
+				return std::string_view{};
+			}
+
+			char* characters = static_cast< char* >( allocateBytes( string.size(), 1 ));
+			std::memcpy( characters, string.data(), string.size() );
+			return std::string_view{ characters, string.size() };
+		}
+
+		size_t bytesAllocated() const				{ return m_bytesAllocated; }
+		size_t numBlocks() const					{ return m_blocks.size(); }
+
+	private:
+
+		std::vector< std::unique_ptr< unsigned char[] >> m_blocks;
+		unsigned char* m_next = nullptr;
+		size_t m_remaining = 0;
+		size_t m_nextBlockSize;
+		size_t m_bytesAllocated = 0;
+
+		void* allocateBytes( size_t size, size_t alignment )
+		{
+			size_t padding = ( alignment - reinterpret_cast< uintptr_t >( m_next ) % alignment ) % alignment;
+
+			if( !m_next || padding + size > m_remaining )
+			{
+				// Start a new block, at least doubling each time.
+				//
+				const size_t blockSize = std::max( m_nextBlockSize, size + alignment );
+				m_blocks.emplace_back( new unsigned char[ blockSize ] );
+				m_next = m_blocks.back().get();
+				m_remaining = blockSize;
+				m_nextBlockSize = blockSize * 2;
+
+				padding = ( alignment - reinterpret_cast< uintptr_t >( m_next ) % alignment ) % alignment;
+			}
+
+			ASSERT( padding + size <= m_remaining );
+
+			void* result = m_next + padding;
+			m_next += padding + size;
+			m_remaining -= padding + size;
+			m_bytesAllocated += size;
+			return result;
+		}
+
+		FRESH_PREVENT_COPYING( Arena )
+	};
+}
+
+#endif
@@ -32,8 +32,17 @@ namespace fr
 		virtual size_t getMemorySize() const = 0;
 		virtual bool isLoaded() const { return true; }
 		
+		virtual bool isSharedResource() const override { return true; }
+		
+	protected:
+		
+		void accountPayloadBytes( size_t bytes )		{ m_payloadAccount.set( classInfo(), bytes ); }
+		// Call whenever the asset's loaded data changes size, so that the class's instance accounting includes it.
+		
 	private:
 		
+		PayloadAccount m_payloadAccount;
+		
 		FRESH_DECLARE_CLASS_ABSTRACT( Asset, Object )
 	};
 	
@@ -116,6 +125,11 @@ namespace fr
 			}
 		}
 		
+		virtual void load( const ManifestDocument::Map& properties ) override
+		{
+			load( *properties.toManifestMap() );
+		}
+		
 		virtual void loadAsset( Asset::ptr asset ) override
 		{
 			REQUIRES( asset );
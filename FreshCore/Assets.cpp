@@ -38,11 +38,11 @@ namespace fr
 	{
 		FRESH_DECLARE_CLASS( AssetLoaderPackage, Package )
 		
-	public:
+	protected:
 		
-		virtual std::vector< Object::ptr > loadFromManifest( const Manifest& manifest ) override
+		virtual void onManifestLoaded( const std::vector< Object::ptr >& objects ) override
 		{
-			auto objects = Super::loadFromManifest( manifest );
+			Super::onManifestLoaded( objects );
 			if( !objects.empty() )
 			{
 				if( auto classMap = objects.front()->as< AssetClassMap >() )
@@ -50,9 +50,10 @@ namespace fr
 					m_classNameMap = classMap->map();
 				}
 			}
-			return objects;
 		}
 		
+	public:
+		
 		ClassInfo::cptr getAssetLoaderClassForAssetClass( const ClassInfo& assetClass ) const
 		{
 			std::string assetLoaderClassName( std::string( assetClass.className() ) + "Loader" );
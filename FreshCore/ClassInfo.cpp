@@ -9,23 +9,37 @@
 #include "ClassInfo.h"
 #include "Object.h"
 #include "Classes.h"
+#include <algorithm>
+#include <limits>
+#include <set>
 
 namespace
 {
 	using namespace fr;
+	
+	inline char toLowerAscii( char c )
+	{
+		return ( c >= 'A' && c <= 'Z' ) ? c + ( 'a' - 'A' ) : c;
+	}
 
 	bool hasConfigurationKey( const Manifest::Map& paring, const std::string& key )
 	{
 		return paring.find( key ) != paring.end();
 	}
 	
+	bool hasConfigurationKey( const ManifestDocument::Map& paring, const std::string& key )
+	{
+		return paring.find( key ) != nullptr;
+	}
+	
 	// Produces a property map based on configuration such that
 	// properties that are present in the pendingInitializationElement
 	// are removed from the configuration element.
 	// This has the effect of causing NoDefault properties of pseudoclasses to only get applied at all
 	// if the currently-loading object of that pseudoclass completely ignores the property in question.
 	//
-	Manifest::Map pareConfiguration( const Manifest::Map& configuration, const Manifest::Map* pendingInitialization )
+	template< typename PendingMapT >
+	Manifest::Map pareConfiguration( const Manifest::Map& configuration, const PendingMapT* pendingInitialization )
 	{
 		Manifest::Map pared = configuration;
 		
@@ -45,6 +59,31 @@ namespace
 		}
 		return pared;
 	}
+	
+	template< typename PendingMapT >
+	bool needsParing( const Manifest::Map& configuration, const PendingMapT* pendingInitialization )
+	{
+		return pendingInitialization && std::any_of( configuration.begin(), configuration.end(), [&]( const Manifest::Map::value_type& mapping )
+													{
+														return hasConfigurationKey( *pendingInitialization, mapping.first );
+													} );
+	}
+	
+	// Loads configuration into toObject, skipping keys that pendingInitialization will supply.
+	// The configuration is loaded in place, without copying, unless something actually needs to be pared away.
+	//
+	template< typename PendingMapT >
+	void loadConfiguration( Object& toObject, const Manifest::Map& configuration, const PendingMapT* pendingInitialization )
+	{
+		if( needsParing( configuration, pendingInitialization ))
+		{
+			toObject.load( pareConfiguration( configuration, pendingInitialization ));
+		}
+		else
+		{
+			toObject.load( configuration );
+		}
+	}
 
 	template< typename init_t >
 	void genericApplyConfiguration( Object& toObject, const Manifest::Map& configuration, const init_t& pendingInitialization )
@@ -174,6 +213,30 @@ namespace fr
 	{
 		REQUIRES( !m_className.empty() );
 		REQUIRES( m_superClass || szClassName == "Object" );
+		
+		if( m_superClass )
+		{
+			if( !m_isNative && m_factory && m_superClass->objectPool() )
+			{
+				useObjectPool( true );
+			}
+		}
+	}
+
+	void ClassInfo::useObjectPool( bool use )
+	{
+		REQUIRES( !isAbstract() );
+		
+		if( use && !m_objectPool )
+		{
+			m_objectPool = &ObjectPool::create( m_className, m_factory->objectSize(), m_factory->objectAlignment() );
+		}
+		m_usesObjectPool = use;
+	}
+
+	ObjectPool* getObjectPool( const ClassInfo& classInfo )
+	{
+		return classInfo.objectPool();
 	}
 
 	void ClassInfo::concludeInitialization()
@@ -181,6 +244,8 @@ namespace fr
 #ifdef FRESH_VERBOSE_REFLECTION
 		dev_trace( "Class " << m_className << " concluding initialization" );
 #endif
+		buildPropertyTable();
+		
 		if( !isAbstract() )
 		{
 			overrideAbstractSuperClassProps();
@@ -197,6 +262,72 @@ namespace fr
 #endif
 	}
 	
+	ClassInfo::InstanceStats ClassInfo::instanceStats() const
+	{
+		InstanceStats stats;
+		stats.nLive = m_nLiveInstances.load( std::memory_order_relaxed );
+		stats.nPeak = m_nPeakInstances.load( std::memory_order_relaxed );
+		stats.nCreated = m_nCreatedInstances.load( std::memory_order_relaxed );
+		stats.objectSize = m_factory ? m_factory->objectSize() : 0;
+		stats.payloadBytes = static_cast< size_t >( std::max( ptrdiff_t( 0 ), m_payloadBytes.load( std::memory_order_relaxed )));
+		return stats;
+	}
+	
+	void ClassInfo::resetPeakInstances() const
+	{
+		m_nPeakInstances.store( m_nLiveInstances.load( std::memory_order_relaxed ), std::memory_order_relaxed );
+	}
+	
+	void ClassInfo::onInstanceCreated() const
+	{
+		const size_t nLive = m_nLiveInstances.fetch_add( 1, std::memory_order_relaxed ) + 1;
+		m_nCreatedInstances.fetch_add( 1, std::memory_order_relaxed );
+		
+		size_t peak = m_nPeakInstances.load( std::memory_order_relaxed );
+		while( nLive > peak && !m_nPeakInstances.compare_exchange_weak( peak, nLive, std::memory_order_relaxed ))
+		{}
+	}
+	
+	void ClassInfo::onInstanceDestroyed() const
+	{
+		m_nLiveInstances.fetch_sub( 1, std::memory_order_relaxed );
+	}
+	
+	void ClassInfo::adjustPayloadBytes( ptrdiff_t delta ) const
+	{
+		m_payloadBytes.fetch_add( delta, std::memory_order_relaxed );
+	}
+	
+	PayloadAccount::~PayloadAccount()
+	{
+		if( m_classInfo && m_bytes > 0 && !isReflectionShuttingDown() )
+		{
+			m_classInfo->adjustPayloadBytes( -static_cast< ptrdiff_t >( m_bytes ));
+		}
+	}
+	
+	void PayloadAccount::set( const ClassInfo& classInfo, size_t bytes )
+	{
+		if( isReflectionShuttingDown() )
+		{
+			m_classInfo = nullptr;
+			m_bytes = 0;
+			return;
+		}
+		
+		if( m_classInfo && m_bytes > 0 )
+		{
+			m_classInfo->adjustPayloadBytes( -static_cast< ptrdiff_t >( m_bytes ));
+		}
+		
+		m_classInfo = &classInfo;
+		m_bytes = bytes;
+		if( m_bytes > 0 )
+		{
+			m_classInfo->adjustPayloadBytes( static_cast< ptrdiff_t >( m_bytes ));
+		}
+	}
+	
 	ClassInfo::NameRef ClassInfo::className() const
 	{
 		return m_className;
@@ -240,22 +371,15 @@ namespace fr
 	
 	bool ClassInfo::isKindOf( const ClassInfo& otherClass ) const
 	{
-#if TABULAR_CLASS_IS_KIND_OF
-		return isClassKindOf( *this, otherClass );
-#else
-		const ClassInfo* const pOtherClass = &otherClass;
-		const auto iter = m_superClassCache.find( pOtherClass );
-		if( iter == m_superClassCache.end() )
+		if( isNumbered() && otherClass.isNumbered() )
 		{
-			const bool isOtherClass = isKindOf_thorough( otherClass );
-			m_superClassCache[ pOtherClass ] = isOtherClass;
-			return isOtherClass;
+			return otherClass.m_hierarchyBegin <= m_hierarchyBegin && m_hierarchyBegin < otherClass.m_hierarchyEnd;
 		}
 		else
 		{
-			return iter->second;
+			// At least one class is still being created, so has no place in the hierarchy yet.
+			return isKindOf_thorough( otherClass );
 		}
-#endif
 	}
 	
 	bool ClassInfo::isKindOf_thorough( const ClassInfo& otherClass ) const
@@ -265,7 +389,11 @@ namespace fr
 	
 	int ClassInfo::getSuperClassDepth( const ClassInfo& possibleSuperClass ) const
 	{
-		if( this == &possibleSuperClass )
+		if( isNumbered() && possibleSuperClass.isNumbered() )
+		{
+			return isKindOf( possibleSuperClass ) ? m_hierarchyDepth - possibleSuperClass.m_hierarchyDepth : -1;
+		}
+		else if( this == &possibleSuperClass )
 		{
 			return 0;
 		}
@@ -287,6 +415,104 @@ namespace fr
 		}
 	}
 	
+	void ClassInfo::addToHierarchy()
+	{
+		REQUIRES( !isNumbered() );
+		
+		if( !m_superClass )
+		{
+			// The root class (Object) owns the whole number line.
+			//
+			renumberHierarchy( 0, std::numeric_limits< uint64_t >::max(), 0 );
+			return;
+		}
+		
+		m_superClass->m_subclasses.push_back( this );
+		
+		if( !m_superClass->isNumbered() )
+		{
+			// A renumbering squeezed the superclass out of the number line, so there is nothing to split.
+			// This class stays unnumbered too until the next renumbering, and isKindOf() walks the chain for it.
+			//
+			return;
+		}
+		
+		if( !m_superClass->allocateSubclassInterval( *this ))
+		{
+			// Out of space. Renumber everything from the root.
+			//
+			ClassInfo::ptr root = this;
+			while( root->m_superClass )
+			{
+				root = root->m_superClass;
+			}
+			root->renumberHierarchy( 0, std::numeric_limits< uint64_t >::max(), 0 );
+		}
+		
+		// In an absurdly deep hierarchy the renumbering can leave classes without an interval (and so their
+		// subclasses as well). isKindOf() still answers correctly for those, just not in constant time.
+	}
+	
+	bool ClassInfo::allocateSubclassInterval( ClassInfo& subclass )
+	{
+		const uint64_t width = freeSubclassSpace() / 2;
+		if( width < 2 )
+		{
+			return false;
+		}
+		
+		subclass.setHierarchyInterval( m_hierarchyNextSubclassBegin, m_hierarchyNextSubclassBegin + width, m_hierarchyDepth + 1 );
+		m_hierarchyNextSubclassBegin += width;
+		return true;
+	}
+	
+	void ClassInfo::setHierarchyInterval( uint64_t begin, uint64_t end, int depth )
+	{
+		m_hierarchyBegin = begin;
+		m_hierarchyEnd = end;
+		m_hierarchyNextSubclassBegin = begin + 1;
+		m_hierarchyDepth = depth;
+	}
+	
+	void ClassInfo::renumberHierarchy( uint64_t begin, uint64_t end, int depth )
+	{
+		setHierarchyInterval( begin, end, depth );
+		
+		if( m_subclasses.empty() )
+		{
+			return;
+		}
+		
+		// Share half of the interval among the existing subclasses in proportion to their own hierarchy sizes.
+		// The other half stays free for subclasses registered later.
+		//
+		const uint64_t share = ( freeSubclassSpace() / 2 ) / ( hierarchySize() - 1 );
+		
+		for( auto subclass : m_subclasses )
+		{
+			// A width of zero leaves the subclass's whole tree unnumbered, which also clears any interval it had.
+			//
+			const uint64_t width = share * subclass->hierarchySize();
+			subclass->renumberHierarchy( m_hierarchyNextSubclassBegin, m_hierarchyNextSubclassBegin + width, depth + 1 );
+			m_hierarchyNextSubclassBegin += width;
+		}
+	}
+	
+	uint64_t ClassInfo::freeSubclassSpace() const
+	{
+		return m_hierarchyEnd > m_hierarchyNextSubclassBegin ? m_hierarchyEnd - m_hierarchyNextSubclassBegin : 0;
+	}
+	
+	size_t ClassInfo::hierarchySize() const
+	{
+		size_t size = 1;
+		for( auto subclass : m_subclasses )
+		{
+			size += subclass->hierarchySize();
+		}
+		return size;
+	}
+	
 	void ClassInfo::addProperty( std::unique_ptr< PropertyAbstract >&& prop )
 	{
 		REQUIRES( prop );
@@ -304,6 +530,11 @@ namespace fr
 		
 		m_properties.emplace_back( std::move( prop ));
 		
+		if( m_isPropertyTableBuilt )
+		{
+			rebuildPropertyTables();
+		}
+		
 		PROMISES( getPropertyByName( propName ));
 	}
 	
@@ -317,23 +548,99 @@ namespace fr
 		return getPropertyByName( propName );
 	}
 	
-	PropertyAbstract* ClassInfo::getPropertyByName( PropertyNameRef propName ) const
+	PropertyAbstract* ClassInfo::getPropertyByName( std::string_view propName ) const
 	{
-		for( PropertiesCI iter = m_properties.begin(); iter != m_properties.end(); ++iter )
+		if( !m_isPropertyTableBuilt )
 		{
-			if( stringCaseInsensitiveCompare( (*iter)->propName(), propName ))
+			// Still registering.
+			//
+			return findPropertyInChain( propName );
+		}
+		
+		const auto iter = m_propertyTable.find( propName );
+		return iter != m_propertyTable.end() ? iter->second : nullptr;
+	}
+	
+	PropertyAbstract* ClassInfo::findPropertyInChain( std::string_view propName ) const
+	{
+		const PropertyNameEqual equal;
+		for( ClassInfo::cptr classInfo = this; classInfo; classInfo = classInfo->m_superClass )
+		{
+			for( const auto& property : classInfo->m_properties )
 			{
-				return iter->get();
+				if( equal( property->propName(), propName ))
+				{
+					return property.get();
+				}
 			}
 		}
+		return nullptr;
+	}
+	
+	size_t ClassInfo::PropertyNameHash::operator()( const std::string_view& name ) const
+	{
+		// FNV-1a over the lowercased name.
+		//
+		size_t hash = 14695981039346656037ULL;
+		for( const char c : name )
+		{
+			hash ^= static_cast< unsigned char >( toLowerAscii( c ));
+			hash *= 1099511628211ULL;
+		}
+		return hash;
+	}
+	
+	bool ClassInfo::PropertyNameEqual::operator()( const std::string_view& a, const std::string_view& b ) const
+	{
+		return a.size() == b.size() && std::equal( a.begin(), a.end(), b.begin(), []( char x, char y ) { return toLowerAscii( x ) == toLowerAscii( y ); } );
+	}
+	
+	const std::vector< PropertyAbstract* >& ClassInfo::getFlattenedProperties() const
+	{
+		REQUIRES( m_isPropertyTableBuilt );
+		return m_flattenedProperties;
+	}
+	
+	void ClassInfo::buildPropertyTable()
+	{
+		TIMER_AUTO( ClassInfo::buildPropertyTable )
 		
-		if( m_superClass )
+		m_propertyTable.clear();
+		m_flattenedProperties.clear();
+		
+		// Walk from this class toward Object. The first property found with a given name is the most derived one,
+		// which is the one that the chain walk used to find, so later (less derived) entries never displace it.
+		//
+		for( ClassInfo::cptr classInfo = this; classInfo; classInfo = classInfo->m_superClass )
 		{
-			return m_superClass->getPropertyByName( propName );
+			for( const auto& property : classInfo->m_properties )
+			{
+				if( m_propertyTable.emplace( property->propName(), property.get() ).second )
+				{
+					m_flattenedProperties.push_back( property.get() );
+				}
+			}
 		}
-		else
+		
+		m_isPropertyTableBuilt = true;
+		
+		// The prototype's split of the configuration into copied and loaded properties may have changed.
+		//
+		forgetPrototype();
+	}
+	
+	void ClassInfo::rebuildPropertyTables()
+	{
+		buildPropertyTable();
+		
+		// Subclasses flattened this class's properties into their own tables.
+		//
+		for( auto subclass : m_subclasses )
 		{
-			return nullptr;
+			if( subclass->m_isPropertyTableBuilt )
+			{
+				subclass->rebuildPropertyTables();
+			}
 		}
 	}
 	
@@ -356,15 +663,171 @@ namespace fr
 	void ClassInfo::applyConfiguration( Object& toObject, const Manifest::Map* pendingInitialization ) const
 	{
 		TIMER_AUTO( ClassInfo::applyConfiguration( Manifest::Map ) )
+		applyConfigurationTo( toObject, pendingInitialization );
+	}
+
+	void ClassInfo::applyConfiguration( Object& toObject, const ManifestDocument::Map* pendingInitialization ) const
+	{
+		TIMER_AUTO( ClassInfo::applyConfiguration( ManifestDocument::Map ) )
+		applyConfigurationTo( toObject, pendingInitialization );
+	}
+	
+	template< typename PendingMapT >
+	void ClassInfo::applyConfigurationTo( Object& toObject, const PendingMapT* pendingInitialization ) const
+	{
+		// Live instances of this very class are stamped from the prototype.
+		// Default objects, and objects of subclasses being configured level by level, load as usual.
+		//
+		if( !toObject.isInert() && &toObject.classInfo() == this )
+		{
+			if( !m_isPrototypeCompiled.load( std::memory_order_acquire ))
+			{
+				std::lock_guard< std::recursive_mutex > lock( m_prototypeMutex );
+				
+				if( m_isCompilingPrototype )
+				{
+					// The prototype's configuration made an instance of this class. It can't copy from the
+					// prototype under construction, so it loads.
+					//
+					applyConfigurationByLoading( toObject, pendingInitialization );
+					return;
+				}
+				
+				if( !m_isPrototypeCompiled.load( std::memory_order_relaxed ))
+				{
+					compilePrototype();
+				}
+			}
+			
+			if( m_prototype )
+			{
+				for( const auto property : m_prototypeProperties )
+				{
+					property->copyValue( &toObject, m_prototype.get() );
+				}
+				
+				// Load whatever could not be copied, least derived configuration first, as usual.
+				// Every level loads, even if nothing remains, since load() overrides may rely on being called.
+				//
+				for( auto iter = m_prototypeRemainders.rbegin(); iter != m_prototypeRemainders.rend(); ++iter )
+				{
+					loadConfiguration( toObject, *iter, pendingInitialization );
+				}
+				return;
+			}
+		}
 		
+		applyConfigurationByLoading( toObject, pendingInitialization );
+	}
+	
+	template< typename PendingMapT >
+	void ClassInfo::applyConfigurationByLoading( Object& toObject, const PendingMapT* pendingInitialization ) const
+	{
 		// Propagate the call up the class chain recursively.
 		//
 		if( m_superClass )
 		{
-			m_superClass->applyConfiguration( toObject, pendingInitialization );
+			m_superClass->applyConfigurationByLoading( toObject, pendingInitialization );
 		}
-
-		toObject.load( pareConfiguration( m_configuration, pendingInitialization ) );
+		
+		loadConfiguration( toObject, m_configuration, pendingInitialization );
+	}
+	
+	void ClassInfo::forgetPrototype()
+	{
+		std::lock_guard< std::recursive_mutex > lock( m_prototypeMutex );
+		ASSERT( !m_isCompilingPrototype );
+		
+		m_prototype = nullptr;
+		m_prototypeProperties.clear();
+		m_prototypeRemainders.clear();
+		m_isPrototypeCompiled = false;
+	}
+	
+	void ClassInfo::compilePrototype() const
+	{
+		// Called with m_prototypeMutex held.
+		//
+		TIMER_AUTO( ClassInfo::compilePrototype )
+		
+		ASSERT( m_isPropertyTableBuilt );
+		ASSERT( !m_isCompilingPrototype && !m_isPrototypeCompiled );
+		ASSERT( !m_prototype && m_prototypeProperties.empty() && m_prototypeRemainders.empty() );
+		
+		if( isAbstract() )
+		{
+			m_isPrototypeCompiled.store( true, std::memory_order_release );
+			return;
+		}
+		
+		// Split each level's configuration into properties that can be copied from a prototype and the rest.
+		// Properties resolve against this class, as they do when an instance loads.
+		// A property value that a more derived level overrides would only be overwritten, so it belongs to neither
+		// part; left in a remainder, it would load after the copied values and overwrite the override instead.
+		// Passthrough data goes to load() overrides at every level, as usual.
+		//
+		std::set< std::string > derivedKeys;
+		
+		for( ClassInfo::cptr classInfo = this; classInfo; classInfo = classInfo->m_superClass )
+		{
+			m_prototypeRemainders.emplace_back();
+			auto& remainder = m_prototypeRemainders.back();
+			
+			for( const auto& mapping : classInfo->m_configuration )
+			{
+				if( mapping.first != "passthrough" && derivedKeys.count( mapping.first ))
+				{
+					continue;
+				}
+				
+				const auto property = mapping.first != "passthrough" ? getPropertyByName( mapping.first ) : nullptr;
+				
+				// Inert objects load only LoadDefault properties, so only those will be right in the prototype.
+				//
+				if( property && property->shouldLoadDefaults() && mapping.second.first && property->isValueCopyable( *mapping.second.first ))
+				{
+					if( std::find( m_prototypeProperties.begin(), m_prototypeProperties.end(), property ) == m_prototypeProperties.end() )
+					{
+						m_prototypeProperties.push_back( property );
+					}
+				}
+				else
+				{
+					remainder.insert( remainder.end(), mapping );
+				}
+			}
+			
+			for( const auto& mapping : classInfo->m_configuration )
+			{
+				derivedKeys.insert( mapping.first );
+			}
+		}
+		
+		if( m_prototypeProperties.empty() )
+		{
+			// Nothing to gain. Keep loading.
+			//
+			m_prototypeRemainders.clear();
+			m_isPrototypeCompiled.store( true, std::memory_order_release );
+			return;
+		}
+		
+		m_isCompilingPrototype = true;
+		try
+		{
+			m_prototype = m_factory->createInertObject( *this );
+			applyConfigurationByLoading( *m_prototype, static_cast< const Manifest::Map* >( nullptr ));
+		}
+		catch( ... )
+		{
+			m_isCompilingPrototype = false;
+			m_prototype = nullptr;
+			m_prototypeProperties.clear();
+			m_prototypeRemainders.clear();
+			throw;
+		}
+		m_isCompilingPrototype = false;
+		m_isPrototypeCompiled.store( true, std::memory_order_release );
 	}
 
 	void ClassInfo::addMethod( const std::string& name, std::unique_ptr< StreamedMethodAbstract >&& streamedMethod )
@@ -15,10 +15,14 @@
 #include "StringTabulated.h"
 #include "ObjectFactory.h"
 #include "FreshManifest.h"
+#include "ManifestDocument.h"
 #include <vector>
 #include <unordered_set>
 #include <unordered_map>
+#include <string_view>
 #include <map>
+#include <atomic>
+#include <mutex>
 
 namespace fr
 {
@@ -81,6 +85,41 @@ namespace fr
 		
 		ObjectFactoryBase& factory() const										{ ASSERT( m_factory ); return *m_factory; }
 		
+		void useObjectPool( bool use );
+		// REQUIRES( !isAbstract() );
+		// When true, objects created from this class afterward are allocated from this class's ObjectPool.
+		// Pseudoclasses of a pooling class pool too, each in its own pool. See ObjectPool.h and FRESH_POOL_CLASS_OBJECTS().
+		
+		ObjectPool* objectPool() const											{ return m_usesObjectPool ? m_objectPool : nullptr; }
+		
+		//
+		// INSTANCE ACCOUNTING
+		//
+		
+		// Counts of the objects of exactly this class (not of its subclasses), inert ones included, and an estimate of
+		// the memory they hold: their own size plus whatever payload--pixels, vertices, audio samples--they report
+		// through a PayloadAccount.
+		//
+		struct InstanceStats
+		{
+			size_t nLive = 0;
+			size_t nPeak = 0;
+			size_t nCreated = 0;
+			size_t objectSize = 0;		// 0 for abstract classes.
+			size_t payloadBytes = 0;
+			
+			size_t liveBytes() const											{ return nLive * objectSize + payloadBytes; }
+		};
+		
+		InstanceStats instanceStats() const;
+		void resetPeakInstances() const;
+		// Sets the peak count to the live count.
+		
+		void onInstanceCreated() const;
+		void onInstanceDestroyed() const;
+		void adjustPayloadBytes( ptrdiff_t delta ) const;
+		// Called by Object and PayloadAccount.
+		
 		//
 		// CLASS RELATIONSHIPS AND COMPARISONS
 		//
@@ -94,6 +133,9 @@ namespace fr
 		// Returns the number of steps from this class "down" (base-wise, aka super-wise) to the possibleSuperClass.
 		// Returns < 0 if possibleSuperClass isn't a base class of this class.
 		// Returns 0 if possibleSuperClass IS this class.
+		//
+		// Both isKindOf( ClassInfo ) and getSuperClassDepth() are constant time for registered classes, except in a hierarchy
+		// deep enough to exhaust the numbering, where they walk the chain. See "hierarchy numbering" below.
 		
 		const ClassInfo& getCommonBase( const ClassInfo& otherClass ) const;
 		
@@ -112,7 +154,17 @@ namespace fr
 		
 		PropertyAbstract* overrideProperty( PropertyNameRef propName, unsigned int additionalFlags = 0 );
 		
-		PropertyAbstract* getPropertyByName( PropertyNameRef propName ) const;
+		PropertyAbstract* getPropertyByName( std::string_view propName ) const;
+		// Case-insensitive. Once the class has concluded initialization, resolves against a flattened table of this
+		// class's properties and all inherited ones, with overrides already resolved, so the cost does not grow with
+		// the depth of the class hierarchy. Before then, walks the class chain. Never modifies the class, so lookups
+		// may run on any thread, provided that no class is being registered or given properties at the same time.
+		
+		const std::vector< PropertyAbstract* >& getFlattenedProperties() const;
+		// REQUIRES( the class has concluded initialization );
+		// Every property of this class, inherited ones included, once each: the most derived version of each.
+		// Cheaper than the PropertyIterator when order does not matter.
+		
 		PropertyIterator getPropertyIteratorBegin() const;
 		PropertyIterator getPropertyIteratorEnd() const;
 		
@@ -122,6 +174,7 @@ namespace fr
 		void markDefaultObjectDoctored()										{ ASSERT( !m_isDefaultObjectDoctored ); m_isDefaultObjectDoctored = true; }
 				
 		void applyConfiguration( Object& toObject, const Manifest::Map* pendingInitialization = nullptr ) const;
+		void applyConfiguration( Object& toObject, const ManifestDocument::Map* pendingInitialization ) const;
 		
 		//
 		// METHODS AND ACCESSORS
@@ -166,12 +219,64 @@ namespace fr
 		Manifest::Map m_configuration;
 		
 		Properties m_properties;
+		
+		// The flattened property table maps each (case-insensitive) property name to the most-derived property of that name.
+		// Keys view the names stored in the properties themselves.
+		// The table is built when the class concludes initialization. Adding a property afterward, which happens only
+		// while registering classes, rebuilds the tables of this class and of its subclasses, which flattened it too.
+		//
+		struct PropertyNameHash
+		{
+			size_t operator()( const std::string_view& name ) const;
+		};
+		struct PropertyNameEqual
+		{
+			bool operator()( const std::string_view& a, const std::string_view& b ) const;
+		};
+		typedef std::unordered_map< std::string_view, PropertyAbstract*, PropertyNameHash, PropertyNameEqual > PropertyTable;
+		
+		PropertyTable m_propertyTable;
+		std::vector< PropertyAbstract* > m_flattenedProperties;	// The table's values, for iteration.
+		bool m_isPropertyTableBuilt = false;
+		
 		std::unordered_map< std::string, std::unique_ptr< SimpleAccessorAbstract >> m_accessors;
 		std::unordered_map< std::string, std::unique_ptr< StreamedMethodAbstract >> m_methods;
 
-#if !TABULAR_CLASS_IS_KIND_OF
-		mutable std::map< const ClassInfo*, bool > m_superClassCache;	// Speeds up isKindOf().
-#endif
+		// Hierarchy numbering.
+		// Each registered class owns an interval [begin, end) of a 64-bit number line. A subclass's interval lies
+		// within its superclass's, so "A is kind of B" is simply "A's begin lies in B's interval".
+		// New subclasses take half of their superclass's remaining free space, so registering a pseudoclass
+		// usually touches only the new class. When a superclass runs out of space, the whole tree is renumbered.
+		//
+		uint64_t m_hierarchyBegin = 0;
+		uint64_t m_hierarchyEnd = 0;					// Equal to m_hierarchyBegin until the class is numbered.
+		uint64_t m_hierarchyNextSubclassBegin = 0;
+		int m_hierarchyDepth = -1;
+		std::vector< ClassInfo::ptr > m_subclasses;	// Raw: the class registry owns every class and never removes one before shutdown.
+		
+		// Prototype instantiation.
+		// Parsing a configuration for every instance of a pseudoclass is wasteful when most of it sets plain values.
+		// The prototype is an inert instance with the whole configuration chain loaded. New instances copy those
+		// properties from it and load only the remainder of each level's configuration: object references,
+		// passthrough data and anything else whose loading does more than set a value.
+		// Compiled by the first live instance, under the mutex, since instances may load on several threads at once,
+		// and forgotten whenever the property table is rebuilt.
+		//
+		mutable SmartPtr< Object > m_prototype;								// Null if there is nothing to copy.
+		mutable std::vector< const PropertyAbstract* > m_prototypeProperties;
+		mutable std::vector< Manifest::Map > m_prototypeRemainders;		// This class's first, then its superclasses'.
+		mutable std::atomic< bool > m_isPrototypeCompiled{ false };
+		mutable bool m_isCompilingPrototype = false;						// The prototype itself loads while this is set.
+		mutable std::recursive_mutex m_prototypeMutex;
+		
+		mutable std::atomic< size_t > m_nLiveInstances{ 0 };
+		mutable std::atomic< size_t > m_nPeakInstances{ 0 };
+		mutable std::atomic< size_t > m_nCreatedInstances{ 0 };
+		mutable std::atomic< ptrdiff_t > m_payloadBytes{ 0 };
+		
+		ObjectPool* m_objectPool = nullptr;		// Kept when pooling is turned off: the pool may still hold objects.
+		bool m_usesObjectPool = false;
+		
 		bool m_isDefaultObjectDoctored = false;
 		bool m_isNative = true;
 		
@@ -185,6 +290,26 @@ namespace fr
 		
 		bool isKindOf_thorough( const ClassInfo& otherClass ) const;
 		
+		bool isNumbered() const													{ return m_hierarchyEnd > m_hierarchyBegin; }
+		void addToHierarchy();
+		bool allocateSubclassInterval( ClassInfo& subclass );
+		void setHierarchyInterval( uint64_t begin, uint64_t end, int depth );
+		void renumberHierarchy( uint64_t begin, uint64_t end, int depth );
+		uint64_t freeSubclassSpace() const;
+		size_t hierarchySize() const;
+		
+		PropertyAbstract* findPropertyInChain( std::string_view propName ) const;
+		void buildPropertyTable();
+		void rebuildPropertyTables();
+		
+		template< typename PendingMapT >
+		void applyConfigurationTo( Object& toObject, const PendingMapT* pendingInitialization ) const;
+		template< typename PendingMapT >
+		void applyConfigurationByLoading( Object& toObject, const PendingMapT* pendingInitialization ) const;
+		
+		void compilePrototype() const;
+		void forgetPrototype();
+		
 		// defaultObject is null iff the class is abstract.
 		
 		template< typename class_t > friend ClassInfo::ptr createNativeClass( ClassInfo::ptr base, ClassInfo::NameRef className, Placeable isPlaceable );
@@ -198,6 +323,27 @@ namespace fr
 		FRESH_PREVENT_COPYING( ClassInfo )
 	};
 	
+	// Counts the bytes an object holds beyond its own size against its class's instance accounting
+	// (see ClassInfo::instanceStats()). Keep one as a member and set it whenever the payload changes.
+	// It withdraws its bytes when destroyed.
+	//
+	class PayloadAccount
+	{
+	public:
+		PayloadAccount() = default;
+		~PayloadAccount();
+		
+		void set( const ClassInfo& classInfo, size_t bytes );
+		size_t bytes() const													{ return m_bytes; }
+		
+	private:
+		const ClassInfo* m_classInfo = nullptr;
+		size_t m_bytes = 0;
+		
+		PayloadAccount( const PayloadAccount& ) = delete;
+		void operator=( const PayloadAccount& ) = delete;
+	};
+	
 	//////////////////////////////////////////////////////////////////
 	// INLINES
 	
@@ -256,6 +402,12 @@ namespace fr
 	}	\
 	const fr::ClassInitializer< class_ > class_::s_classInit_##class_;
 
+// Invoke after FRESH_DEFINE_CLASS() for classes whose instances are created and destroyed in great numbers,
+// to have them allocated from an ObjectPool rather than the general heap.
+//
+#define FRESH_POOL_CLASS_OBJECTS( class_ )	\
+	static const bool s_objectPool_##class_ = ( class_::StaticGetClassInfo().useObjectPool( true ), true );
+
 // For each non-abstract, *templated* Object-derived class (direct or indirect) with one template parameter, invoke this macro somewhere in the global scope of the class's .cpp file.
 //
 #define FRESH_GET_CLASS_NAME_TEMPLATE_1( className, templateType1 )	STRINGIFY( className##_##templateType1 )
@@ -17,82 +17,25 @@ namespace
 	using namespace fr;
 
 	bool g_isReflectionInitialized = false;
+	bool g_isReflectionShuttingDown = false;
 	
 	typedef std::map< ClassInfo::Name, std::unique_ptr< ClassInfo >> Classes;
 	
-	Classes& getClasses()
-	{
-		static Classes classes;
-		return classes;
-	}
-	
-#if TABULAR_CLASS_IS_KIND_OF
-	size_t numClasses()
+	struct ClassRegistry
 	{
-		return getClasses().size();
-	}
-	
-	class ClassInheritanceMatrix
-	{
-	public:
-		
-		void addClass( const ClassInfo& classInfo )
-		{
-			const size_t nClasses = numClasses();
-			const size_t ordinal = classInfo.ordinal();
-			
-			std::vector< int > depths( nClasses, -1 );
-			
-			ClassInfo::cptr super = &classInfo;
-			int depth = 0;
-			while( super )
-			{
-				const size_t superClassOrdinal = super->ordinal();
-				ASSERT( superClassOrdinal < depths.size() );
-				depths[ superClassOrdinal ] = depth;
-				
-				super = super->getSuperClass();
-				++depth;
-			}
-			
-			m_classInheritanceDepths.insert( m_classInheritanceDepths.begin() + ordinal, std::move( depths ));
-		}
+		Classes classes;
 		
-		int inheritanceDepth( const ClassInfo& maybeDerived, const ClassInfo& maybeBase ) const
+		~ClassRegistry()
 		{
-			// Returns:
-			//		0				<=	identical class
-			//		x where x < 0	<=	no inheritance relationship.
-			//		x where x > 0	<=	maybeDerived is x steps of inheritance derived from maybeBase.
-			
-			const size_t derivedOrdinal = maybeDerived.ordinal();
-			const size_t baseOrdinal = maybeBase.ordinal();
-			
-			ASSERT( derivedOrdinal < m_classInheritanceDepths.size() );
-			const auto& depths = m_classInheritanceDepths[ derivedOrdinal ];
-			
-			if( baseOrdinal < depths.size() )
-			{
-				return depths[ baseOrdinal ];
-			}
-			else
-			{
-				// Can't be a base because it doesn't exist in this class's array.
-				return -1;
-			}
+			g_isReflectionShuttingDown = true;
 		}
-		
-	private:
-		
-		std::vector< std::vector< int >> m_classInheritanceDepths;
 	};
 	
-	ClassInheritanceMatrix& inheritanceMatrix()
+	Classes& getClasses()
 	{
-		static ClassInheritanceMatrix matrix;
-		return matrix;
+		static ClassRegistry registry;
+		return registry.classes;
 	}
-#endif
 }
 
 namespace fr
@@ -178,6 +121,11 @@ namespace fr
 		}
 	}
 	
+	bool isReflectionShuttingDown()
+	{
+		return g_isReflectionShuttingDown;
+	}
+	
 	bool isClass( ClassInfo::NameRef className )
 	{
 		return getClasses().find( className ) != getClasses().end();
@@ -224,9 +172,7 @@ namespace fr
 		classInfo->m_ordinal = classes.size();
 		classes[ classInfo->className() ].reset( classInfo );
 		
-#if TABULAR_CLASS_IS_KIND_OF
-		inheritanceMatrix().addClass( *classInfo );
-#endif
+		classInfo->addToHierarchy();
 		
 		PROMISES( isClass( classInfo->className() ));
 		
@@ -289,11 +235,6 @@ namespace fr
 
 	bool isClassKindOf( const ClassInfo& maybeDerived, const ClassInfo& maybeBase )
 	{
-#if TABULAR_CLASS_IS_KIND_OF
-		return inheritanceMatrix().inheritanceDepth( maybeDerived, maybeBase ) >= 0;
-#else
-		ASSERT( false );	// You must #define TABULAR_CLASS_IS_KIND_OF to call this function.
-		return 0;
-#endif
+		return maybeDerived.isKindOf( maybeBase );
 	}
 }
@@ -32,6 +32,10 @@ namespace fr
 
 	bool isClassKindOf( const ClassInfo& maybeDerived, const ClassInfo& maybeBase );
 	
+	bool isReflectionShuttingDown();
+	// True once the registered classes have begun to be destroyed, at static destruction time.
+	// Objects destroyed after that must not touch their ClassInfo.
+	
 
 
 
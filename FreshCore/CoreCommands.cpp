@@ -11,10 +11,13 @@
 #include "CommandProcessor.h"
 #include "ObjectStreamFormatter.h"
 #include "Assets.h"
+#include "ObjectPool.h"
+#include "Dispatch.h"
+#include "TraceRecorder.h"
+#include "FreshFile.h"
 
 #ifdef FRESH_PROFILER_ENABLED
 #	include "Profiler.h"
-#	include "FreshFile.h"
 #endif
 
 
@@ -165,6 +168,68 @@ namespace fr
 			processor.registerCommand( this, "gpf", "simulates a general protection fault", std::move( caller ) );
 		}
 
+		// Create the pools command.
+		//
+		{
+			auto caller = make_caller< void, const std::string& >( std::bind( &CoreCommands::listObjectPools, this, std::placeholders::_1 ) );
+			auto command = processor.registerCommand( this, "pools", "lists object pools with live and peak object counts and memory use", std::move( caller ) );
+			command->addArgument( CommandProcessor::CommandAbstract::Argument( { "class-filter", true, "the name, or part of the name, of the pooled class(es)" } ));
+		}
+
+		// Create the memstats command.
+		//
+		{
+			auto caller = make_caller< void, const std::string& >( std::bind( &CoreCommands::listInstanceStats, this, std::placeholders::_1 ) );
+			auto command = processor.registerCommand( this, "memstats", "lists live and peak instance counts and estimated memory per class", std::move( caller ) );
+			command->addArgument( CommandProcessor::CommandAbstract::Argument( { "class-filter", true, "the name, or part of the name, of the desired class(es)" } ));
+		}
+
+		// Create the memsnapshot command.
+		//
+		{
+			auto caller = make_caller< void >( std::bind( &CoreCommands::takeInstanceSnapshot, this ) );
+			processor.registerCommand( this, "memsnapshot", "remembers every class's instance counts and memory for a later memdiff", std::move( caller ) );
+		}
+
+		// Create the memdiff command.
+		//
+		{
+			auto caller = make_caller< void, const std::string& >( std::bind( &CoreCommands::diffInstanceSnapshot, this, std::placeholders::_1 ) );
+			auto command = processor.registerCommand( this, "memdiff", "lists the classes whose instance counts or memory changed since the last memsnapshot", std::move( caller ) );
+			command->addArgument( CommandProcessor::CommandAbstract::Argument( { "class-filter", true, "the name, or part of the name, of the desired class(es)" } ));
+		}
+
+		// Create the pooldebug command.
+		//
+		{
+			auto caller = make_caller< void, const std::string&, bool >( std::bind( &CoreCommands::debugObjectPools, this, std::placeholders::_1, std::placeholders::_2 ) );
+			auto command = processor.registerCommand( this, "pooldebug", "turns use-after-free checking on or off for object pools", std::move( caller ) );
+			command->addArgument( CommandProcessor::CommandAbstract::Argument( { "class-filter", false, "the name, or part of the name, of the pooled class(es)" } ));
+			command->addArgument( CommandProcessor::CommandAbstract::Argument( { "debugging", false, "1 to check, 0 to stop" } ));
+		}
+
+		// Create the mainqueue command.
+		//
+		{
+			auto caller = stream_function< void() >( std::bind( &CoreCommands::mainQueueStats, this ) );
+			processor.registerCommand( this, "mainqueue", "reports the main dispatch queue's depth and latency since the last report", std::move( caller ) );
+		}
+
+		// Create the tracestart command.
+		//
+		{
+			auto caller = stream_function< void() >( std::bind( &CoreCommands::startTrace, this ) );
+			processor.registerCommand( this, "tracestart", "starts capturing a trace of timed scopes on all threads", std::move( caller ) );
+		}
+
+		// Create the tracestop command.
+		//
+		{
+			auto caller = make_caller< void, const std::string& >( std::bind( &CoreCommands::stopTrace, this, std::placeholders::_1 ) );
+			auto command = processor.registerCommand( this, "tracestop", "stops capturing and saves the trace for chrome://tracing or Perfetto", std::move( caller ) );
+			command->addArgument( CommandProcessor::CommandAbstract::Argument( { "file-name", true, "the document file to save to (default trace.json)" } ));
+		}
+
 #if DEV_MODE && FRESH_BREAKPOINTS_ENABLED
 		// Create the break command.
 		//
@@ -244,6 +309,175 @@ namespace fr
 		}
 	}
 	
+	void CoreCommands::listObjectPools( const std::string& classFilter ) const
+	{
+		trace( "Object pools: (live/peak objects, live/reserved KB, allocations; * - debugging)" );
+		
+		size_t totalLiveBytes = 0;
+		size_t totalReservedBytes = 0;
+		ObjectPool::forEachPool( [&]( const ObjectPool& pool )
+								{
+									if( pool.className().find( classFilter ) != std::string::npos )
+									{
+										totalLiveBytes += pool.bytesLive();
+										totalReservedBytes += pool.bytesReserved();
+										trace( "\t" << ( pool.isDebugging() ? "*" : "" ) << pool.className() << " (" << pool.objectSize() << " bytes): "
+											  << pool.nLive() << "/" << pool.nPeak() << ", "
+											  << pool.bytesLive() / 1024 << "/" << pool.bytesReserved() / 1024 << "KB, "
+											  << pool.nAllocations() );
+									}
+								} );
+		
+		trace( "Total: " << totalLiveBytes / 1024 << "/" << totalReservedBytes / 1024 << "KB" );
+	}
+	
+	void CoreCommands::listInstanceStats( const std::string& classFilter ) const
+	{
+		trace( "Instances: (live/peak/created, object size, payload KB, total KB)" );
+		
+		std::vector< std::pair< ClassName, ClassInfo::InstanceStats >> classes;
+		forEachClass( [&]( const ClassInfo& classInfo )
+					 {
+						 const auto stats = classInfo.instanceStats();
+						 if( stats.nPeak > 0 && std::string( classInfo.className() ).find( classFilter ) != std::string::npos )
+						 {
+							 classes.emplace_back( classInfo.className(), stats );
+						 }
+					 } );
+		
+		std::sort( classes.begin(), classes.end(), []( const auto& a, const auto& b ) { return a.second.liveBytes() > b.second.liveBytes(); } );
+		
+		size_t totalLive = 0;
+		size_t totalBytes = 0;
+		for( const auto& entry : classes )
+		{
+			const auto& stats = entry.second;
+			totalLive += stats.nLive;
+			totalBytes += stats.liveBytes();
+			trace( "\t" << entry.first << ": " << stats.nLive << "/" << stats.nPeak << "/" << stats.nCreated << ", "
+				  << stats.objectSize << " bytes, "
+				  << stats.payloadBytes / 1024 << "KB, "
+				  << stats.liveBytes() / 1024 << "KB" );
+		}
+		
+		trace( "Total: " << totalLive << " objects, " << totalBytes / 1024 << "KB" );
+	}
+	
+	void CoreCommands::takeInstanceSnapshot()
+	{
+		m_instanceSnapshot.clear();
+		forEachClass( [&]( const ClassInfo& classInfo )
+					 {
+						 m_instanceSnapshot[ classInfo.className() ] = classInfo.instanceStats();
+					 } );
+		
+		trace( "Took a snapshot of " << m_instanceSnapshot.size() << " classes." );
+	}
+	
+	void CoreCommands::diffInstanceSnapshot( const std::string& classFilter ) const
+	{
+		if( m_instanceSnapshot.empty() )
+		{
+			trace( "No snapshot. Use memsnapshot first." );
+			return;
+		}
+		
+		struct Difference
+		{
+			ClassName className;
+			ptrdiff_t nLive;
+			ptrdiff_t nCreated;
+			ptrdiff_t bytes;
+		};
+		std::vector< Difference > differences;
+		
+		forEachClass( [&]( const ClassInfo& classInfo )
+					 {
+						 if( std::string( classInfo.className() ).find( classFilter ) == std::string::npos )
+						 {
+							 return;
+						 }
+						 
+						 const auto now = classInfo.instanceStats();
+						 
+						 ClassInfo::InstanceStats then;
+						 const auto iter = m_instanceSnapshot.find( classInfo.className() );
+						 if( iter != m_instanceSnapshot.end() )
+						 {
+							 then = iter->second;
+						 }
+						 
+						 const Difference difference{ classInfo.className(),
+							 static_cast< ptrdiff_t >( now.nLive ) - static_cast< ptrdiff_t >( then.nLive ),
+							 static_cast< ptrdiff_t >( now.nCreated ) - static_cast< ptrdiff_t >( then.nCreated ),
+							 static_cast< ptrdiff_t >( now.liveBytes() ) - static_cast< ptrdiff_t >( then.liveBytes() ) };
+						 
+						 if( difference.nLive != 0 || difference.bytes != 0 )
+						 {
+							 differences.push_back( difference );
+						 }
+					 } );
+		
+		std::sort( differences.begin(), differences.end(), []( const Difference& a, const Difference& b ) { return std::abs( a.bytes ) > std::abs( b.bytes ); } );
+		
+		trace( "Changes since snapshot: (live objects, objects created, KB)" );
+		
+		ptrdiff_t totalLive = 0;
+		ptrdiff_t totalBytes = 0;
+		for( const auto& difference : differences )
+		{
+			totalLive += difference.nLive;
+			totalBytes += difference.bytes;
+			trace( "\t" << difference.className << ": " << std::showpos << difference.nLive << std::noshowpos << ", "
+				  << difference.nCreated << ", " << std::showpos << difference.bytes / 1024 << std::noshowpos << "KB" );
+		}
+		
+		trace( "Total: " << std::showpos << totalLive << " objects, " << totalBytes / 1024 << std::noshowpos << "KB" );
+	}
+	
+	void CoreCommands::debugObjectPools( const std::string& classFilter, bool debugging ) const
+	{
+		forEachClass( [&]( const ClassInfo& classInfo )
+					 {
+						 if( classInfo.objectPool() && std::string( classInfo.className() ).find( classFilter ) != std::string::npos )
+						 {
+							 classInfo.objectPool()->setDebugging( debugging );
+							 trace( classInfo.className() << " pool debugging " << ( debugging ? "on" : "off" ));
+						 }
+					 } );
+	}
+	
+	void CoreCommands::mainQueueStats() const
+	{
+		using namespace std::chrono;
+		
+		auto& queue = dispatch::mainQueue();
+		const auto stats = queue.stats();
+		queue.resetStats();
+		
+		trace( "Main queue: " << stats.depth << " pending (peak " << stats.peakDepth << "), "
+			  << stats.nExecuted << " run, "
+			  << stats.nPollsOverBudget << " polls over budget, "
+			  << "latency mean " << duration_cast< microseconds >( stats.meanLatency ).count() << "us "
+			  << "max " << duration_cast< microseconds >( stats.maxLatency ).count() << "us" );
+	}
+	
+	void CoreCommands::startTrace() const
+	{
+		trace::startCapture();
+		trace( "Capturing trace." );
+	}
+	
+	void CoreCommands::stopTrace( const std::string& fileName ) const
+	{
+		trace::stopCapture();
+		
+		const auto filePath = getDocumentPath( fileName.empty() ? "trace.json" : fileName );
+		std::ofstream file( filePath.string() );
+		trace::writeChromeTrace( file );
+		trace( "Saved trace to " << filePath << "." );
+	}
+	
 	void CoreCommands::listPackages( PackageNameRef packageNameSubstring ) const
 	{
 		const Package& rootPackage = getRootPackage();
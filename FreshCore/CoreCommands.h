@@ -44,6 +44,14 @@ namespace fr
 		void listBreakpointTags( const std::string& tagFilter );
 		void simulateThrow( const gobbling_string& message );
 		void simulateGeneralProtectionFault();
+		void listObjectPools( const std::string& classFilter ) const;
+		void debugObjectPools( const std::string& classFilter, bool debugging ) const;
+		void listInstanceStats( const std::string& classFilter ) const;
+		void takeInstanceSnapshot();
+		void diffInstanceSnapshot( const std::string& classFilter ) const;
+		void mainQueueStats() const;
+		void startTrace() const;
+		void stopTrace( const std::string& fileName ) const;
 		
 #ifdef FRESH_PROFILER_ENABLED
 		void dumpProfile() const;
@@ -58,6 +66,8 @@ namespace fr
 
 		std::string m_desiredSimulatedThrowMessage;
 		bool m_wantsSimulatedGPF = false;
+		
+		std::map< ClassName, ClassInfo::InstanceStats > m_instanceSnapshot;
 	};
 }
 
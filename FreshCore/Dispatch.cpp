@@ -14,7 +14,11 @@
 #include <atomic>
 #include <condition_variable>
 #include <queue>
+#include <deque>
+#include <vector>
+#include <algorithm>
 #include <cassert>
+#include <exception>
 
 namespace fr
 {
@@ -31,6 +35,7 @@ namespace fr
 			~QueueImpl()
 			{
 				stop();
+				deletePostedBlocks( m_intake.exchange( nullptr ));
 			}
 
 			void maxExpectedBlockDuration( Duration duration, Queue::OverDurationCallback&& onOverDuration )
@@ -48,9 +53,57 @@ namespace fr
 			void asyncAfter( TimePoint when, Block::ptr block )
 			{
 				TIMER_AUTO_FUNC
+
+				// Count the block before it's visible, so that the depth never goes negative.
+				//
+				const size_t depth = ++m_depth;
+				size_t peakDepth = m_peakDepth.load( std::memory_order_relaxed );
+				while( depth > peakDepth && !m_peakDepth.compare_exchange_weak( peakDepth, depth, std::memory_order_relaxed ))
+				{}
+
+				auto posted = new PostedBlock{ when, std::move( block ), m_intake.load( std::memory_order_relaxed ) };
+				while( !m_intake.compare_exchange_weak( posted->next, posted ))
+				{}
+
+				// Wake the queue's thread if it's asleep. It sets m_isWaiting before it last checks the intake,
+				// and we set the intake before we check m_isWaiting, so one of us sees the other.
+				//
+				if( m_isWaiting )
+				{
+					std::lock_guard< decltype( m_stateMutex ) > lock{ m_stateMutex };
+					m_hasWork.notify_one();
+				}
+			}
+
+			void pollBudget( Duration maxDuration, size_t maxBlocks )
+			{
+				std::lock_guard< decltype( m_stateMutex ) > lock{ m_stateMutex };
+				m_pollMaxDuration = maxDuration;
+				m_pollMaxBlocks = maxBlocks;
+			}
+
+			Queue::Stats stats() const
+			{
+				std::lock_guard< decltype( m_stateMutex ) > lock{ m_stateMutex };
+
+				Queue::Stats stats;
+				stats.depth = m_depth;
+				stats.peakDepth = m_peakDepth;
+				stats.nExecuted = m_nExecuted;
+				stats.nPollsOverBudget = m_nPollsOverBudget;
+				stats.meanLatency = m_nExecuted > 0 ? m_totalLatency / static_cast< Duration::rep >( m_nExecuted ) : Duration{};
+				stats.maxLatency = m_maxLatency;
+				return stats;
+			}
+
+			void resetStats()
+			{
 				std::lock_guard< decltype( m_stateMutex ) > lock{ m_stateMutex };
-				m_blockQueue.push( { when, block } );
-				m_hasWork.notify_one();
+				m_peakDepth = m_depth.load();
+				m_nExecuted = 0;
+				m_nPollsOverBudget = 0;
+				m_totalLatency = {};
+				m_maxLatency = {};
 			}
 
 			void run()
@@ -78,6 +131,7 @@ namespace fr
 			{
 				TIMER_AUTO_FUNC
 				std::lock_guard< decltype( m_stateMutex ) > lock{ m_stateMutex };
+				m_depth -= m_blockQueue.size() + deletePostedBlocks( m_intake.exchange( nullptr ));
 				m_blockQueue = decltype( m_blockQueue ){};	// Clear the block queue.
 			}
 
@@ -118,8 +172,22 @@ namespace fr
 				m_threadId = std::this_thread::get_id();
 				std::unique_lock< decltype( m_stateMutex ) > lock{ m_stateMutex };
 
-				while( !m_blockQueue.empty() )
+				const auto startTime = Clock::now();
+				size_t nExecuted = 0;
+
+				// Blocks posted by the blocks we run are taken in too, so they may run in this same poll.
+				//
+				while( takeIntake(), !m_blockQueue.empty() )
 				{
+					if( nExecuted > 0 && isOverPollBudget( startTime, nExecuted ))
+					{
+						if( Clock::now() >= m_blockQueue.top().when )
+						{
+							++m_nPollsOverBudget;
+						}
+						break;
+					}
+
 					bool queueStillPending = executeNextBlock( lock );
 
 					// Though the queue may not be empty, we're still waiting for the time of the earliest
@@ -129,6 +197,8 @@ namespace fr
 					{
 						break;
 					}
+
+					++nExecuted;
 				}
 			}
 
@@ -141,12 +211,15 @@ namespace fr
 				// Store the thread ID.
 				//
 				m_threadId = std::this_thread::get_id();
+				trace::nameThread( m_queueName.empty() ? "dispatch queue" : m_queueName.c_str() );
 
 				// Main block execution loop.
 				//
 				std::unique_lock< decltype( m_stateMutex ) > lock{ m_stateMutex };
 				while( m_continue )
 				{
+					takeIntake();
+
 					const TimePoint nextScheduledEvent = m_blockQueue.empty()
 					? ( Clock::now() + std::chrono::hours{ 24*7*52 /* about a year; basically infinite */ } )
 					: m_blockQueue.top().when;
@@ -154,7 +227,7 @@ namespace fr
 					// Wait until any one of the following is true:
 					//
 					//	1. m_continue has reset (i.e. we're being asked to stop altogether).
-					//	2. The block queue has become non-empty.
+					//	2. Blocks have been posted.
 					//	3. The time of the next event has arrived.
 					//
 					const auto workPredicate = [this, nextScheduledEvent]()
@@ -165,6 +238,9 @@ namespace fr
 						// Thread stopping? Stop waiting.
 						if( !m_continue ) return true;
 
+						// Blocks posted? Stop waiting to take them in.
+						if( m_intake.load() ) return true;
+
 						// Queue empty? Continue waiting.
 						if( m_blockQueue.empty() ) return false;
 
@@ -180,12 +256,18 @@ namespace fr
 						return false;
 					};
 
-					if( m_hasWork.wait_until( lock, nextScheduledEvent, workPredicate ))
+					m_isWaiting = true;
+					const bool stoppedWaiting = m_hasWork.wait_until( lock, nextScheduledEvent, workPredicate );
+					m_isWaiting = false;
+
+					if( stoppedWaiting )
 					{
+						takeIntake();
+
 						// We've stopped waiting, but is there actual work to be done?
 						// (Else, probably we just need to reschedule our wait event at the top of this loop.)
 						//
-						if( m_continue && Clock::now() >= m_blockQueue.top().when )
+						if( m_continue && !m_blockQueue.empty() && Clock::now() >= m_blockQueue.top().when )
 						{
 							executeNextBlock( lock );
 						}
@@ -212,9 +294,11 @@ namespace fr
 						// Pop and call the block.
 
 						m_blockQueue.pop();
+						--m_depth;
 						lock.unlock();
 
 						const auto startTime = Clock::now();		// Record how long the block takes.
+						const auto latency = startTime - scheduledBlock.when;
 
 						scheduledBlock.block->call();
 
@@ -233,12 +317,49 @@ namespace fr
 						}
 
 						lock.lock();
+
+						++m_nExecuted;
+						m_totalLatency += latency;
+						m_maxLatency = std::max( m_maxLatency, latency );
+
 						return false;		// `false` means the larger queue management loop may need to continue.
 					}
 				}
 				return true;	// `true` means the larger queue management loop should not continue: there's no work here.
 			}
 
+			bool isOverPollBudget( TimePoint startTime, size_t nExecuted ) const
+			{
+				return ( m_pollMaxBlocks > 0 && nExecuted >= m_pollMaxBlocks ) ||
+					   ( m_pollMaxDuration > Duration::zero() && Clock::now() - startTime >= m_pollMaxDuration );
+			}
+
+			// Moves newly posted blocks into the block queue, in the order they were posted.
+			// Call with m_stateMutex locked.
+			//
+			void takeIntake()
+			{
+				PostedBlock* posted = m_intake.exchange( nullptr, std::memory_order_acquire );
+
+				// The intake is a stack. Reverse it.
+				//
+				PostedBlock* oldestFirst = nullptr;
+				while( posted )
+				{
+					PostedBlock* next = posted->next;
+					posted->next = oldestFirst;
+					oldestFirst = posted;
+					posted = next;
+				}
+
+				while( oldestFirst )
+				{
+					std::unique_ptr< PostedBlock > taken{ oldestFirst };
+					oldestFirst = taken->next;
+					m_blockQueue.push( { taken->when, std::move( taken->block ), m_nextSequence++ } );
+				}
+			}
+
 		private:
 
 			mutable std::mutex m_stateMutex;	// Used to make all internal accesses and changes atomically.
@@ -247,15 +368,53 @@ namespace fr
 			{
 				TimePoint when;
 				Block::ptr block;
+				unsigned long long sequence;		// Blocks due at the same time run in the order they were posted.
 
 				bool operator<( const ScheduledBlock& other ) const
 				{
 					// This is kinda confusing: The earlier time (<) is higher priority (>).
-					return when > other.when;
+					return when > other.when || ( when == other.when && sequence > other.sequence );
 				}
 			};
 
 			std::priority_queue< ScheduledBlock > m_blockQueue;
+			unsigned long long m_nextSequence = 0;
+
+			// Posted blocks wait here, newest first, until the queue's thread takes them in.
+			//
+			struct PostedBlock
+			{
+				TimePoint when;
+				Block::ptr block;
+				PostedBlock* next;
+			};
+
+			// Returns the number deleted.
+			//
+			static size_t deletePostedBlocks( PostedBlock* posted )
+			{
+				size_t nDeleted = 0;
+				while( posted )
+				{
+					std::unique_ptr< PostedBlock > deleted{ posted };
+					posted = deleted->next;
+					++nDeleted;
+				}
+				return nDeleted;
+			}
+
+			std::atomic< PostedBlock* > m_intake{ nullptr };
+			std::atomic_bool m_isWaiting{ false };
+
+			Duration m_pollMaxDuration{};
+			size_t m_pollMaxBlocks = 0;
+
+			std::atomic< size_t > m_depth{ 0 };
+			std::atomic< size_t > m_peakDepth{ 0 };
+			size_t m_nExecuted = 0;
+			size_t m_nPollsOverBudget = 0;
+			Duration m_totalLatency{};
+			Duration m_maxLatency{};
 
 			std::atomic_bool m_continue{ false };
 			std::condition_variable m_hasWork;
@@ -319,6 +478,24 @@ namespace fr
 			m_impl->poll();
 		}
 
+		void Queue::pollBudget( Duration maxDuration, size_t maxBlocks )
+		{
+			assert( m_impl );
+			m_impl->pollBudget( maxDuration, maxBlocks );
+		}
+
+		Queue::Stats Queue::stats() const
+		{
+			assert( m_impl );
+			return m_impl->stats();
+		}
+
+		void Queue::resetStats()
+		{
+			assert( m_impl );
+			m_impl->resetStats();
+		}
+
 		void Queue::runSync()
 		{
 			assert( m_impl );
@@ -339,15 +516,292 @@ namespace fr
 
 		///////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-		Queue& mainQueue()
+		namespace
 		{
-			static Queue queue{ "fr_main_queue" };
-			return queue;
+			const size_t NUM_QOS = 3;
+			const size_t MIN_WORKERS = 2;		// So that one long block can't stall all background work.
+
+			struct Task
+			{
+				std::shared_ptr< ConcurrentQueueImpl > queue;
+				size_t generation;
+				Block::ptr block;
+			};
 		}
 
-		Queue& globalQueue()
+		// The worker threads shared by all ConcurrentQueues, unless a queue has a pool of its own.
+		// Each worker has a deque of tasks per QoS class. A worker pushes the tasks it submits onto the back of
+		// its own deque and takes from there too, which keeps related work hot in its cache. Tasks submitted
+		// by other threads go to a shared injection deque. A worker with nothing of its own takes from the front
+		// of the injection deque, then steals from the front of other workers' deques.
+		//
+		class WorkerPool
 		{
-			static Queue queue{ "fr_global_queue" };
+		public:
+
+			static WorkerPool& instance()
+			{
+				static WorkerPool pool{ std::max< size_t >( MIN_WORKERS, std::thread::hardware_concurrency() ) };
+				return pool;
+			}
+
+			explicit WorkerPool( size_t nWorkers )
+			{
+				for( size_t i = 0; i < nWorkers; ++i )
+				{
+					m_workers.emplace_back( new Worker );
+				}
+				for( size_t i = 0; i < nWorkers; ++i )
+				{
+					m_workers[ i ]->thread = std::thread{ std::bind( &WorkerPool::work, this, i )};
+				}
+			}
+
+			~WorkerPool()
+			{
+				m_stopping = true;
+				{
+					std::lock_guard< std::mutex > lock{ m_idleMutex };
+					m_hasWork.notify_all();
+				}
+				for( const auto& worker : m_workers )
+				{
+					worker->thread.join();
+				}
+			}
+
+			size_t size() const
+			{
+				return m_workers.size();
+			}
+
+			void submit( Task&& task, QoS qos )
+			{
+				const auto qosIndex = static_cast< size_t >( qos );
+
+				// Count the task before it's visible, so that a worker that takes it never sees the count go negative.
+				//
+				++m_nPending;
+
+				if( t_worker && t_pool == this )
+				{
+					std::lock_guard< std::mutex > lock{ t_worker->mutex };
+					t_worker->tasks[ qosIndex ].push_back( std::move( task ));
+				}
+				else
+				{
+					std::lock_guard< std::mutex > lock{ m_injectionMutex };
+					m_injected[ qosIndex ].push_back( std::move( task ));
+				}
+
+				if( m_nSleeping > 0 )
+				{
+					std::lock_guard< std::mutex > lock{ m_idleMutex };
+					m_hasWork.notify_one();
+				}
+			}
+
+		private:
+
+			struct Worker
+			{
+				std::mutex mutex;
+				std::deque< Task > tasks[ NUM_QOS ];
+				std::thread thread;
+			};
+
+			std::vector< std::unique_ptr< Worker >> m_workers;
+
+			std::mutex m_injectionMutex;
+			std::deque< Task > m_injected[ NUM_QOS ];
+
+			std::atomic< size_t > m_nPending{ 0 };		// Tasks in any deque.
+			std::atomic< size_t > m_nSleeping{ 0 };
+			std::atomic_bool m_stopping{ false };
+			std::mutex m_idleMutex;
+			std::condition_variable m_hasWork;
+
+			static thread_local Worker* t_worker;
+			static thread_local WorkerPool* t_pool;
+
+			static bool popBack( std::mutex& mutex, std::deque< Task >& tasks, Task& outTask )
+			{
+				std::lock_guard< std::mutex > lock{ mutex };
+				if( tasks.empty() ) return false;
+				outTask = std::move( tasks.back() );
+				tasks.pop_back();
+				return true;
+			}
+
+			static bool popFront( std::mutex& mutex, std::deque< Task >& tasks, Task& outTask )
+			{
+				std::lock_guard< std::mutex > lock{ mutex };
+				if( tasks.empty() ) return false;
+				outTask = std::move( tasks.front() );
+				tasks.pop_front();
+				return true;
+			}
+
+			bool takeTask( size_t selfIndex, Task& outTask )
+			{
+				Worker& self = *m_workers[ selfIndex ];
+
+				for( size_t qos = 0; qos < NUM_QOS; ++qos )
+				{
+					if( popBack( self.mutex, self.tasks[ qos ], outTask ) || popFront( m_injectionMutex, m_injected[ qos ], outTask ))
+					{
+						return true;
+					}
+
+					// Steal, starting with the next worker along so that thieves spread out.
+					//
+					for( size_t i = 1; i < m_workers.size(); ++i )
+					{
+						Worker& victim = *m_workers[ ( selfIndex + i ) % m_workers.size() ];
+						if( popFront( victim.mutex, victim.tasks[ qos ], outTask ))
+						{
+							return true;
+						}
+					}
+				}
+				return false;
+			}
+
+			void work( size_t index );
+		};
+
+		thread_local WorkerPool::Worker* WorkerPool::t_worker = nullptr;
+		thread_local WorkerPool* WorkerPool::t_pool = nullptr;
+
+		class ConcurrentQueueImpl : public std::enable_shared_from_this< ConcurrentQueueImpl >
+		{
+		public:
+
+			ConcurrentQueueImpl( const std::string& queueName, QoS qos, WorkerPool& pool )
+			:	m_queueName( queueName )
+			,	m_qos( qos )
+			,	m_pool( pool )
+			{}
+
+			QoS qos() const
+			{
+				return m_qos;
+			}
+
+			void maxExpectedBlockDuration( Duration duration, Queue::OverDurationCallback&& onOverDuration )
+			{
+				std::lock_guard< std::mutex > lock{ m_callbackMutex };
+				m_maxExpectedBlockDuration = duration;
+				m_overDurationCallback = std::move( onOverDuration );
+			}
+
+			void async( Block::ptr block )
+			{
+				TIMER_AUTO_FUNC
+				++m_nOutstanding;
+				m_pool.submit( Task{ shared_from_this(), m_generation, std::move( block ) }, m_qos );
+			}
+
+			void asyncAfter( TimePoint when, Block::ptr block );
+
+			void clear()
+			{
+				++m_generation;
+			}
+
+			void wait()
+			{
+				std::unique_lock< std::mutex > lock{ m_idleMutex };
+				m_idle.wait( lock, [this]() { return m_nOutstanding == 0; } );
+			}
+
+			void execute( const Task& task )
+			{
+				if( task.generation == m_generation )
+				{
+					const auto startTime = Clock::now();
+
+					try
+					{
+						task.block->call();
+					}
+					catch( ... )
+					{
+						// An exception escaping a worker would terminate the program. Hand it to the main queue instead,
+						// where it surfaces as it would have had the block run there.
+						//
+						const auto exception = std::current_exception();
+						mainQueue().async( std::make_shared< Block >( [exception]() { std::rethrow_exception( exception ); },
+																	 "exception from " + task.block->name() ));
+					}
+
+					const auto duration = Clock::now() - startTime;
+
+					std::lock_guard< std::mutex > lock{ m_callbackMutex };
+					if( m_overDurationCallback && duration > m_maxExpectedBlockDuration )
+					{
+						m_overDurationCallback( task.block->name(), duration );
+					}
+				}
+
+				if( --m_nOutstanding == 0 )
+				{
+					std::lock_guard< std::mutex > lock{ m_idleMutex };
+					m_idle.notify_all();
+				}
+			}
+
+		private:
+
+			const std::string m_queueName;
+			const QoS m_qos;
+			WorkerPool& m_pool;
+
+			std::atomic< size_t > m_generation{ 0 };			// Tasks from earlier generations have been cleared.
+			std::atomic< size_t > m_nOutstanding{ 0 };		// Tasks submitted to the pool and not yet finished.
+			std::mutex m_idleMutex;
+			std::condition_variable m_idle;
+
+			std::mutex m_callbackMutex;
+			Duration m_maxExpectedBlockDuration{ std::chrono::minutes{ 10 }};
+			Queue::OverDurationCallback m_overDurationCallback;
+		};
+
+		void WorkerPool::work( size_t index )
+		{
+			t_worker = m_workers[ index ].get();
+			t_pool = this;
+			trace::nameThread( "dispatch worker" );
+
+			while( !m_stopping )
+			{
+				Task task;
+				if( takeTask( index, task ))
+				{
+					--m_nPending;
+					task.queue->execute( task );
+				}
+				else if( m_nPending > 0 )
+				{
+					// A task is in flight between deques. It will be visible in a moment.
+					//
+					std::this_thread::yield();
+				}
+				else
+				{
+					std::unique_lock< std::mutex > lock{ m_idleMutex };
+					++m_nSleeping;
+					m_hasWork.wait( lock, [this]() { return m_stopping || m_nPending > 0; } );
+					--m_nSleeping;
+				}
+			}
+		}
+
+		// Delayed blocks wait on a serial timer queue, then go to the pool when due.
+		//
+		Queue& timerQueue()
+		{
+			static Queue queue{ "fr_dispatch_timer_queue" };
 
 			if( !queue.running() )
 			{
@@ -357,6 +811,99 @@ namespace fr
 			return queue;
 		}
 
+		void ConcurrentQueueImpl::asyncAfter( TimePoint when, Block::ptr block )
+		{
+			TIMER_AUTO_FUNC
+			const auto self = shared_from_this();
+			const size_t generation = m_generation;
+
+			timerQueue().asyncAfter( when, std::make_shared< Block >( [self, generation, block]()
+																	 {
+																		 if( generation == self->m_generation )
+																		 {
+																			 ++self->m_nOutstanding;
+																			 self->m_pool.submit( Task{ self, generation, block }, self->m_qos );
+																		 }
+																	 }, "fr_dispatch_timer" ));
+		}
+
+		///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+		ConcurrentQueue::ConcurrentQueue( const std::string& queueName, QoS qos )
+		// Creating the shared pool here makes it outlive this queue, if this queue is static.
+		:	m_impl( std::make_shared< ConcurrentQueueImpl >( queueName, qos, WorkerPool::instance() ))
+		{}
+
+		ConcurrentQueue::ConcurrentQueue( const std::string& queueName, QoS qos, size_t nWorkers )
+		:	m_ownPool( new WorkerPool{ nWorkers } )
+		,	m_impl( std::make_shared< ConcurrentQueueImpl >( queueName, qos, *m_ownPool ))
+		{
+			assert( nWorkers > 0 );
+		}
+
+		ConcurrentQueue::~ConcurrentQueue()
+		{
+			m_impl->clear();
+			m_impl->wait();
+
+			// Every task has finished, so the pool's workers can go.
+			//
+			m_ownPool.reset();
+		}
+
+		QoS ConcurrentQueue::qos() const
+		{
+			return m_impl->qos();
+		}
+
+		void ConcurrentQueue::maxExpectedBlockDuration( Duration duration, Queue::OverDurationCallback&& onOverDuration )
+		{
+			m_impl->maxExpectedBlockDuration( duration, std::move( onOverDuration ));
+		}
+
+		void ConcurrentQueue::async( Block::ptr block )
+		{
+			m_impl->async( std::move( block ));
+		}
+
+		void ConcurrentQueue::asyncAfter( TimePoint when, Block::ptr block )
+		{
+			m_impl->asyncAfter( when, std::move( block ));
+		}
+
+		void ConcurrentQueue::clear()
+		{
+			m_impl->clear();
+		}
+
+		void ConcurrentQueue::wait()
+		{
+			m_impl->wait();
+		}
+
+		size_t ConcurrentQueue::numWorkers()
+		{
+			return WorkerPool::instance().size();
+		}
+
+		///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+		Queue& mainQueue()
+		{
+			static Queue queue{ "fr_main_queue" };
+			return queue;
+		}
+
+		ConcurrentQueue& globalQueue( QoS qos )
+		{
+			static ConcurrentQueue queues[ NUM_QOS ] = {
+				ConcurrentQueue{ "fr_global_queue_user_interactive", QoS::UserInteractive },
+				ConcurrentQueue{ "fr_global_queue_utility", QoS::Utility },
+				ConcurrentQueue{ "fr_global_queue_background", QoS::Background }};
+
+			return queues[ static_cast< size_t >( qos ) ];
+		}
+
 		bool onMainQueue()
 		{
 			return mainQueue().usesCurrentThread();
@@ -97,6 +97,11 @@ namespace fr
 		
 		///////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		
+		// Queue runs its blocks one at a time, in order of due time, either on a thread of its own (run())
+		// or on whatever thread calls poll() (as the main queue does, once per frame).
+		// Posting never takes a lock: blocks go onto a lock-free intake list, which the running thread
+		// moves into its schedule. So threads finishing background work can post to the main queue freely.
+		//
 		class Queue
 		{
 		public:
@@ -115,6 +120,26 @@ namespace fr
 			void stop();
 			void poll();
 			
+			// Limits the work one call to poll() does. poll() always runs at least one due block, then stops
+			// once it has spent maxDuration or run maxBlocks blocks, leaving the rest for the next call.
+			// Zero means no limit, which is the default.
+			//
+			void pollBudget( Duration maxDuration, size_t maxBlocks = 0 );
+			
+			struct Stats
+			{
+				size_t depth = 0;				// Blocks posted and not yet run, whether due or not.
+				size_t peakDepth = 0;
+				size_t nExecuted = 0;
+				size_t nPollsOverBudget = 0;	// Calls to poll() that stopped with due blocks left over.
+				Duration meanLatency{};			// From when a block fell due to when it started.
+				Duration maxLatency{};
+			};
+			
+			Stats stats() const;
+			void resetStats();
+			// Resets all but the depth.
+			
 			void runSync();
 			
 			// Removes all pending blocks (added via `async*()`) from the queue.
@@ -132,8 +157,62 @@ namespace fr
 		
 		///////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		
+		// Quality of service. Workers always take work of a higher class before work of a lower one.
+		//
+		enum class QoS
+		{
+			UserInteractive,	// Work the user is waiting on right now.
+			Utility,			// Ordinary background work, like loading assets.
+			Background,			// Work nobody is waiting on.
+		};
+		
+		// ConcurrentQueue runs its blocks on a shared pool of worker threads, one per hardware thread (but at least two).
+		// Blocks may run in any order and at the same time as one another. Each worker keeps its own deque of blocks,
+		// newest first, and idle workers steal the oldest blocks from busy ones, so blocks that queue more blocks
+		// keep every core busy without contending on one lock.
+		//
+		class ConcurrentQueue
+		{
+		public:
+			
+			explicit ConcurrentQueue( const std::string& queueName = {}, QoS qos = QoS::Utility );
+			
+			// Runs this queue's blocks on a pool of nWorkers threads of its own instead of the shared pool,
+			// as when measuring how work scales with the number of threads.
+			ConcurrentQueue( const std::string& queueName, QoS qos, size_t nWorkers );
+			
+			~ConcurrentQueue();
+			// Waits for blocks that are already running. Blocks not yet started are dropped.
+			
+			ConcurrentQueue( const ConcurrentQueue& ) = delete;
+			ConcurrentQueue& operator=( const ConcurrentQueue& ) = delete;
+			
+			QoS qos() const;
+			
+			void maxExpectedBlockDuration( Duration duration, Queue::OverDurationCallback&& onOverDuration );
+			
+			void async( Block::ptr block );
+			void asyncAfter( TimePoint when, Block::ptr block );
+			
+			// Removes all pending blocks (added via `async*()`) from the queue. Blocks already running finish.
+			void clear();
+			
+			// Blocks the calling thread until every block that is due has finished or been cleared.
+			// Don't call this from one of the queue's own blocks.
+			void wait();
+			
+			static size_t numWorkers();		// In the shared pool.
+			
+		private:
+			
+			std::unique_ptr< class WorkerPool > m_ownPool;
+			std::shared_ptr< class ConcurrentQueueImpl > m_impl;
+		};
+		
+		///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		
 		Queue& mainQueue();			// The queue associated with the main thread.
-		Queue& globalQueue();		// A utility queue for background work.
+		ConcurrentQueue& globalQueue( QoS qos = QoS::Utility );		// Concurrent queues for background work.
 		
 		// For debugging. Don't rely on this functionality.
 		
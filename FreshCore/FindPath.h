@@ -10,8 +10,12 @@
 #define Fresh_FindPath_h
 
 #include <set>
+#include <unordered_map>
 #include <vector>
 #include <utility>
+#include <algorithm>
+#include <functional>
+#include <limits>
 #include <cassert>
 
 using namespace std::placeholders;
@@ -216,6 +220,383 @@ namespace fr
         GetTimeFnT m_time;
 	};
 
+	// HeapPathFinder /////////////////////////////////////////////////////////////////////////////////////////
+	//
+	// The same search as PathFinder, for graphs whose nodes map onto a dense range of indices (tiles in a
+	// grid, say). The open set is a binary heap indexed by node, so improving an open node's score is a
+	// decrease-key rather than a scan. Per-node state lives in a PathFinderScratch that you keep between
+	// queries, so after the first few queries a search allocates nothing.
+	//
+	// The functors are template parameters so that they inline:
+	//
+	//		ScoreT heuristicEstimate( NodeT from, NodeT goal );
+	//		size_t getNeighbors( NodeT node, NodeT* outNeighbors );		// Writes at most MaxNeighbors.
+	//		size_t getNeighbors( NodeT node, NodeT priorPathNode, NodeT* outNeighbors );	// Or this, to prune by how node was reached.
+	//		ScoreT nodeDistance( NodeT from, NodeT to );
+	//		TimeT time();
+	//		size_t nodeIndex( NodeT node );
+	//
+	// Ties in estimated cost go to the lesser node, as they do in PathFinder, so both find the same paths.
+	// Use makeHeapPathFinder() to deduce the functor types.
+	//
+	// A query owns its scratch until it finishes: don't start another query on the same scratch while one
+	// may still be resumed with findPath().
+	//
+
+	template< typename NodeT, typename ScoreT = float >
+	class PathFinderScratch
+	{
+	public:
+
+		void reserve( size_t nNodes )					{ m_records.reserve( nNodes ); m_heap.reserve( nNodes ); }
+
+	private:
+
+		typedef unsigned int Stamp;
+		static const size_t NOT_IN_HEAP = size_t( -1 );
+
+		// A record is only meaningful for the current query if its stamp matches, so nothing needs clearing between queries.
+		//
+		struct Record
+		{
+			NodeT node;
+			NodeT priorPathNode;
+			ScoreT scoreG;
+			ScoreT scoreF;
+			size_t heapPosition = NOT_IN_HEAP;
+			Stamp stamp = 0;
+			bool isClosed = false;
+		};
+
+		std::vector< Record > m_records;
+		std::vector< size_t > m_heap;			// Record indices.
+		Stamp m_stamp = 0;
+
+		template< typename, typename, typename, typename, typename, typename, typename, typename, size_t >
+		friend class HeapPathFinder;
+	};
+
+	template< typename NodeT,
+		typename TimeT,
+		typename ScoreT,
+		typename HeuristicEstimateFnT,
+		typename GetNeighborsFnT,
+		typename NodeDistanceFnT,
+		typename GetTimeFnT,
+		typename NodeIndexFnT,
+		size_t MaxNeighbors = 8
+	>
+	class HeapPathFinder
+	{
+	public:
+
+		typedef PathFinderScratch< NodeT, ScoreT > Scratch;
+
+		HeapPathFinder( Scratch& scratch,
+						const NodeT& start,
+						const NodeT& goal,
+						const NodeT& nullNode,
+						HeuristicEstimateFnT heuristicEstimate,
+						GetNeighborsFnT getNeighbors,
+						NodeDistanceFnT nodeDistance,
+						GetTimeFnT time,
+						NodeIndexFnT nodeIndex
+			)
+		:	m_scratch( scratch )
+		,	m_start( start )
+		,	m_goal( goal )
+		,	m_null( nullNode )
+		,	m_heuristicEstimate( std::move( heuristicEstimate ))
+		,	m_getNeighbors( std::move( getNeighbors ))
+		,	m_nodeDistance( std::move( nodeDistance ))
+		,	m_time( std::move( time ))
+		,	m_nodeIndex( std::move( nodeIndex ))
+		{
+			if( ++m_scratch.m_stamp == 0 )
+			{
+				// Wrapped around. Forget all old stamps so that none matches by accident.
+				//
+				for( auto& record : m_scratch.m_records )
+				{
+					record.stamp = 0;
+				}
+				m_scratch.m_stamp = 1;
+			}
+			m_scratch.m_heap.clear();
+
+			assert( m_goal != m_null );
+			assert( m_start != m_null );
+
+			auto& startRecord = record( m_start );
+			startRecord.priorPathNode = m_null;
+			startRecord.scoreG = ScoreT( 0 );
+			startRecord.scoreF = m_heuristicEstimate( m_start, m_goal );
+			push( m_nodeIndex( m_start ));
+		}
+
+		bool findPath( bool& ranOutOfTime, TimeT timeLimit = TimeT( 0 ) )
+		{
+			TimeT startTime = m_time();
+			ranOutOfTime = false;
+
+			auto& records = m_scratch.m_records;
+			auto& heap = m_scratch.m_heap;
+
+			NodeT neighbors[ MaxNeighbors ];
+
+			// Consider the best of each open node.
+			//
+			while( !heap.empty() )
+			{
+				// Stop (pause) if out of time.
+				//
+				if( timeLimit > 0 && m_time() - startTime > timeLimit )
+				{
+					ranOutOfTime = true;
+					break;
+				}
+
+				const size_t iBest = heap.front();
+				const NodeT best = records[ iBest ].node;
+				assert( best != m_null );
+
+				if( best == m_goal )
+				{
+					// Found a complete path, now embedded in the records. Call path() to recover it.
+					//
+					return true;
+				}
+
+				// Move this node from the open to the closed set.
+				//
+				popFront();
+				records[ iBest ].isClosed = true;
+
+				// Evaluate all neighbors.
+				//
+				const ScoreT bestG = records[ iBest ].scoreG;
+				const size_t nNeighbors = callGetNeighbors( m_getNeighbors, best, records[ iBest ].priorPathNode, neighbors, 0 );
+				assert( nNeighbors <= MaxNeighbors );
+
+				for( size_t i = 0; i < nNeighbors; ++i )
+				{
+					const NodeT neighbor = neighbors[ i ];
+					assert( best != neighbor );
+
+					const size_t iNeighbor = m_nodeIndex( neighbor );
+					const bool isKnown = iNeighbor < records.size() && records[ iNeighbor ].stamp == m_scratch.m_stamp;
+
+					if( isKnown && records[ iNeighbor ].isClosed )
+					{
+						continue;
+					}
+
+					const ScoreT tentativeScoreG = bestG + m_nodeDistance( best, neighbor );
+					const ScoreT priorScoreG = isKnown ? records[ iNeighbor ].scoreG : std::numeric_limits< ScoreT >::infinity();
+
+					if( tentativeScoreG < priorScoreG )
+					{
+						auto& neighborRecord = record( neighbor );		// May grow the records.
+						neighborRecord.priorPathNode = best;
+						neighborRecord.scoreG = tentativeScoreG;
+						neighborRecord.scoreF = tentativeScoreG + m_heuristicEstimate( neighbor, m_goal );
+
+						if( neighborRecord.heapPosition == Scratch::NOT_IN_HEAP )
+						{
+							push( iNeighbor );
+						}
+						else
+						{
+							siftUp( neighborRecord.heapPosition );
+						}
+					}
+				}	// End initializing neighbors.
+
+			}	// End evaluating open nodes.
+
+			// No path found.
+			//
+			return false;
+		}
+
+		std::vector< NodeT > path() const
+		{
+			std::vector< NodeT > result;
+
+			auto currentNode = m_goal;
+			while( currentNode != m_null )
+			{
+				result.push_back( currentNode );
+
+				const size_t index = m_nodeIndex( currentNode );
+				assert( index < m_scratch.m_records.size() && m_scratch.m_records[ index ].stamp == m_scratch.m_stamp );
+				currentNode = m_scratch.m_records[ index ].priorPathNode;
+			}
+
+			// The path comes back in reverse order. Straighten it out.
+			//
+			std::reverse( result.begin(), result.end() );
+
+			return result;
+		}
+
+	protected:
+
+		typedef typename Scratch::Record Record;
+
+		// Passes the prior path node only to neighbor functors that take it.
+		//
+		template< typename FnT >
+		static auto callGetNeighbors( FnT& fn, const NodeT& node, const NodeT& priorPathNode, NodeT* outNeighbors, int ) -> decltype( fn( node, priorPathNode, outNeighbors ))
+		{
+			return fn( node, priorPathNode, outNeighbors );
+		}
+
+		template< typename FnT >
+		static size_t callGetNeighbors( FnT& fn, const NodeT& node, const NodeT&, NodeT* outNeighbors, long )
+		{
+			return fn( node, outNeighbors );
+		}
+
+		// The node's record for this query, made fresh if it belongs to an earlier one.
+		//
+		Record& record( const NodeT& node )
+		{
+			auto& records = m_scratch.m_records;
+
+			const size_t index = m_nodeIndex( node );
+			if( index >= records.size() )
+			{
+				records.resize( index + 1 );
+			}
+
+			auto& result = records[ index ];
+			if( result.stamp != m_scratch.m_stamp )
+			{
+				result.node = node;
+				result.scoreG = std::numeric_limits< ScoreT >::infinity();
+				result.heapPosition = Scratch::NOT_IN_HEAP;
+				result.stamp = m_scratch.m_stamp;
+				result.isClosed = false;
+			}
+			return result;
+		}
+
+		bool isBetter( size_t iRecordA, size_t iRecordB ) const
+		{
+			const auto& a = m_scratch.m_records[ iRecordA ];
+			const auto& b = m_scratch.m_records[ iRecordB ];
+			return a.scoreF < b.scoreF || ( !( b.scoreF < a.scoreF ) && std::less< NodeT >()( a.node, b.node ));
+		}
+
+		void place( size_t heapPosition, size_t iRecord )
+		{
+			m_scratch.m_heap[ heapPosition ] = iRecord;
+			m_scratch.m_records[ iRecord ].heapPosition = heapPosition;
+		}
+
+		void push( size_t iRecord )
+		{
+			m_scratch.m_heap.push_back( iRecord );
+			siftUp( m_scratch.m_heap.size() - 1 );
+		}
+
+		void popFront()
+		{
+			auto& heap = m_scratch.m_heap;
+			assert( !heap.empty() );
+
+			m_scratch.m_records[ heap.front() ].heapPosition = Scratch::NOT_IN_HEAP;
+
+			const size_t iLast = heap.back();
+			heap.pop_back();
+			if( !heap.empty() )
+			{
+				place( 0, iLast );
+				siftDown( 0 );
+			}
+		}
+
+		void siftUp( size_t position )
+		{
+			auto& heap = m_scratch.m_heap;
+			const size_t iRecord = heap[ position ];
+
+			while( position > 0 )
+			{
+				const size_t parent = ( position - 1 ) / 2;
+				if( !isBetter( iRecord, heap[ parent ] ))
+				{
+					break;
+				}
+				place( position, heap[ parent ] );
+				position = parent;
+			}
+			place( position, iRecord );
+		}
+
+		void siftDown( size_t position )
+		{
+			auto& heap = m_scratch.m_heap;
+			const size_t iRecord = heap[ position ];
+			const size_t size = heap.size();
+
+			for( ;; )
+			{
+				size_t child = position * 2 + 1;
+				if( child >= size )
+				{
+					break;
+				}
+				if( child + 1 < size && isBetter( heap[ child + 1 ], heap[ child ] ))
+				{
+					++child;
+				}
+				if( !isBetter( heap[ child ], iRecord ))
+				{
+					break;
+				}
+				place( position, heap[ child ] );
+				position = child;
+			}
+			place( position, iRecord );
+		}
+
+	private:
+
+		Scratch& m_scratch;
+		NodeT m_start, m_goal, m_null;
+
+		HeuristicEstimateFnT m_heuristicEstimate;
+		GetNeighborsFnT m_getNeighbors;
+		NodeDistanceFnT m_nodeDistance;
+		GetTimeFnT m_time;
+		NodeIndexFnT m_nodeIndex;
+	};
+
+	template< size_t MaxNeighbors = 8,
+		typename NodeT,
+		typename ScoreT,
+		typename HeuristicEstimateFnT,
+		typename GetNeighborsFnT,
+		typename NodeDistanceFnT,
+		typename GetTimeFnT,
+		typename NodeIndexFnT
+	>
+	inline HeapPathFinder< NodeT, decltype( std::declval< GetTimeFnT& >()() ), ScoreT, HeuristicEstimateFnT, GetNeighborsFnT, NodeDistanceFnT, GetTimeFnT, NodeIndexFnT, MaxNeighbors >
+	makeHeapPathFinder( PathFinderScratch< NodeT, ScoreT >& scratch,
+									const NodeT& start,
+									const NodeT& goal,
+									const NodeT& nullNode,
+									HeuristicEstimateFnT heuristicEstimate,
+									GetNeighborsFnT getNeighbors,
+									NodeDistanceFnT nodeDistance,
+									GetTimeFnT time,
+									NodeIndexFnT nodeIndex )
+	{
+		return { scratch, start, goal, nullNode, std::move( heuristicEstimate ), std::move( getNeighbors ), std::move( nodeDistance ), std::move( time ), std::move( nodeIndex ) };
+	}
+
 	///////////////////////////////////////////////////////////////////////////////////
 	// USE CASE
 
@@ -264,21 +645,21 @@ namespace fr
 		Node::Cost getHeuristicEstimate( Node* p, Node* q );
 		double time();
 
-		Node* getPriorPathNode( Node* p ) { return p->getPriorPathNode(); }
-		void setPriorPathNode( Node* p, Node* prior ) { return p->setPriorPathNode( prior ); }
-		Node::Cost getScore( Node* p, size_t type ) { return p->getScore( type ); }
-		void setScoreF( Node* p, Node::Cost cost ) { return p->setScore( 0, cost ); }
-		void setScoreG( Node* p, Node::Cost cost ) { return p->setScore( 1, cost ); }
-		void setScoreH( Node* p, Node::Cost cost ) { return p->setScore( 2, cost ); }
-		bool betterScoreF( Node* p, Node* q )
+		inline Node* getPriorPathNode( Node* p ) { return p->getPriorPathNode(); }
+		inline void setPriorPathNode( Node* p, Node* prior ) { return p->setPriorPathNode( prior ); }
+		inline Node::Cost getScore( Node* p, size_t type ) { return p->getScore( type ); }
+		inline void setScoreF( Node* p, Node::Cost cost ) { return p->setScore( 0, cost ); }
+		inline void setScoreG( Node* p, Node::Cost cost ) { return p->setScore( 1, cost ); }
+		inline void setScoreH( Node* p, Node::Cost cost ) { return p->setScore( 2, cost ); }
+		inline bool betterScoreF( Node* p, Node* q )
 		{
 			return p->getScore( 0 ) < q->getScore( 0 );
 		}
-		bool isInClosedSet( Node* p, size_t iVisit ) { return p->iLastVisit == iVisit; }
-		void addToClosedSet( Node* p, size_t iVisit ) { p->iLastVisit = iVisit; }
-		const Node::Neighbors& getNeighbors( Node* p ) { return p->getNeighbors(); }
-		Node::Cost nodeDistance( Node* p, Node* q ) { return 0.0f;			/* TODO */ }
-		Node::Cost getHeuristicEstimate( Node* p, Node* q ) { return 0.0f;	/* TODO */ }
+		inline bool isInClosedSet( Node* p, size_t iVisit ) { return p->iLastVisit == iVisit; }
+		inline void addToClosedSet( Node* p, size_t iVisit ) { p->iLastVisit = iVisit; }
+		inline const Node::Neighbors& getNeighbors( Node* p ) { return p->getNeighbors(); }
+		inline Node::Cost nodeDistance( Node* p, Node* q ) { return 0.0f;			/* TODO */ }
+		inline Node::Cost getHeuristicEstimate( Node* p, Node* q ) { return 0.0f;	/* TODO */ }
 
 		inline void pathfindTest( size_t nNodes, size_t maxNeighbors, Node::Cost maxCost, size_t iStart = 0, size_t iGoal = -1 )
 		{
@@ -0,0 +1,330 @@
+//
+//  FrameStats.cpp
+//  Fresh
+//
+
+#include "FrameStats.h"
+#include "FreshDebug.h"
+#include <cmath>
+#include <iomanip>
+
+namespace
+{
+	unsigned int highestBit( uint64_t x )
+	{
+		unsigned int bit = 0;
+		for( unsigned int shift = 32; shift > 0; shift >>= 1 )
+		{
+			if( x >> shift )
+			{
+				x >>= shift;
+				bit += shift;
+			}
+		}
+		return bit;
+	}
+
+	inline double toMilliseconds( uint64_t nanoseconds )
+	{
+		return nanoseconds / 1000000.0;
+	}
+}
+
+namespace fr
+{
+	size_t DurationHistogram::bucketForMicroseconds( uint64_t microseconds )
+	{
+		if( microseconds < SUB_BUCKETS )
+		{
+			return size_t( microseconds );
+		}
+
+		const unsigned int bit = highestBit( microseconds );
+		if( bit > MAX_VALUE_BITS )
+		{
+			return NUM_BUCKETS - 1;
+		}
+
+		// The sub-bucket is the SUB_BUCKET_BITS bits below the highest.
+		//
+		const unsigned int shift = bit - SUB_BUCKET_BITS;
+		return SUB_BUCKETS + shift * SUB_BUCKETS + size_t(( microseconds >> shift ) & ( SUB_BUCKETS - 1 ));
+	}
+
+	uint64_t DurationHistogram::bucketUpperMicroseconds( size_t bucket )
+	{
+		REQUIRES( bucket < NUM_BUCKETS );
+
+		if( bucket < SUB_BUCKETS )
+		{
+			return bucket + 1;
+		}
+
+		const size_t shift = ( bucket - SUB_BUCKETS ) / SUB_BUCKETS;
+		const uint64_t subBucket = ( bucket - SUB_BUCKETS ) % SUB_BUCKETS;
+		return ( SUB_BUCKETS + subBucket + 1 ) << shift;
+	}
+
+	void DurationHistogram::record( uint64_t nanoseconds )
+	{
+		++m_counts[ bucketForMicroseconds( nanoseconds / 1000 ) ];
+		++m_count;
+		m_totalNanoseconds += nanoseconds;
+		m_maxNanoseconds = std::max( m_maxNanoseconds, nanoseconds );
+	}
+
+	void DurationHistogram::merge( const DurationHistogram& other )
+	{
+		for( size_t i = 0; i < NUM_BUCKETS; ++i )
+		{
+			m_counts[ i ] += other.m_counts[ i ];
+		}
+		m_count += other.m_count;
+		m_totalNanoseconds += other.m_totalNanoseconds;
+		m_maxNanoseconds = std::max( m_maxNanoseconds, other.m_maxNanoseconds );
+	}
+
+	void DurationHistogram::clear()
+	{
+		m_counts.fill( 0 );
+		m_count = 0;
+		m_totalNanoseconds = 0;
+		m_maxNanoseconds = 0;
+	}
+
+	uint64_t DurationHistogram::percentileNanoseconds( double percentile ) const
+	{
+		REQUIRES( 0 <= percentile && percentile <= 100 );
+
+		if( m_count == 0 )
+		{
+			return 0;
+		}
+
+		const size_t target = std::max( size_t( 1 ), size_t( std::ceil( percentile / 100.0 * m_count )));
+
+		size_t cumulative = 0;
+		for( size_t i = 0; i < NUM_BUCKETS; ++i )
+		{
+			cumulative += m_counts[ i ];
+			if( cumulative >= target )
+			{
+				return std::min( bucketUpperMicroseconds( i ) * 1000, m_maxNanoseconds );
+			}
+		}
+
+		return m_maxNanoseconds;
+	}
+
+	//////////////////////////////////////////////////
+
+	const char* FrameStats::phaseName( Phase phase )
+	{
+		switch( phase )
+		{
+			case Phase::Frame: return "frame";
+			case Phase::Update: return "update";
+			case Phase::Render: return "render";
+			default: return "?";
+		}
+	}
+
+	void FrameStats::beginFrame()
+	{
+		const uint64_t now = trace::nowNanoseconds();
+
+		if( m_nFrames > 0 )
+		{
+			record( Phase::Frame, m_frameBeginNanoseconds, now );
+
+			if( ++m_nFramesInWindow >= m_windowFrames )
+			{
+				m_previousWindow = m_currentWindow;
+				for( auto& histogram : m_currentWindow )
+				{
+					histogram.clear();
+				}
+				m_nFramesInWindow = 0;
+			}
+		}
+
+		m_frameBeginNanoseconds = now;
+		++m_nFrames;
+	}
+
+	void FrameStats::beginUpdate()
+	{
+		m_phaseBeginNanoseconds = trace::nowNanoseconds();
+	}
+
+	void FrameStats::endUpdate( size_t nSubsteps )
+	{
+		record( Phase::Update, m_phaseBeginNanoseconds, trace::nowNanoseconds() );
+		++m_substepCounts[ nSubsteps < MAX_SUBSTEPS_COUNTED ? nSubsteps : MAX_SUBSTEPS_COUNTED ];
+	}
+
+	void FrameStats::beginRender()
+	{
+		m_phaseBeginNanoseconds = trace::nowNanoseconds();
+	}
+
+	void FrameStats::endRender()
+	{
+		record( Phase::Render, m_phaseBeginNanoseconds, trace::nowNanoseconds() );
+	}
+
+	void FrameStats::budgetSeconds( Phase phase, TimeType seconds )
+	{
+		REQUIRES( phase < Phase::NUM );
+		m_budgetNanoseconds[ size_t( phase ) ] = seconds > 0 ? uint64_t( seconds * 1e9 ) : 0;
+	}
+
+	TimeType FrameStats::budgetSeconds( Phase phase ) const
+	{
+		REQUIRES( phase < Phase::NUM );
+		return m_budgetNanoseconds[ size_t( phase ) ] / 1e9;
+	}
+
+	void FrameStats::windowFrames( size_t nFrames )
+	{
+		REQUIRES( nFrames > 0 );
+		m_windowFrames = nFrames;
+	}
+
+	void FrameStats::maxAlertsKept( size_t maxAlerts )
+	{
+		m_maxAlertsKept = maxAlerts;
+		while( m_recentAlerts.size() > m_maxAlertsKept )
+		{
+			m_recentAlerts.pop_front();
+		}
+	}
+
+	DurationHistogram FrameStats::recentHistogram( Phase phase ) const
+	{
+		REQUIRES( phase < Phase::NUM );
+
+		DurationHistogram histogram = m_previousWindow[ size_t( phase ) ];
+		histogram.merge( m_currentWindow[ size_t( phase ) ] );
+		return histogram;
+	}
+
+	void FrameStats::reset()
+	{
+		for( auto* histograms : { &m_session, &m_currentWindow, &m_previousWindow } )
+		{
+			for( auto& histogram : *histograms )
+			{
+				histogram.clear();
+			}
+		}
+		m_nFramesInWindow = 0;
+		m_substepCounts.fill( 0 );
+		m_nAlerts = 0;
+		m_recentAlerts.clear();
+		m_nFrames = 0;
+	}
+
+	void FrameStats::record( Phase phase, uint64_t beginNanoseconds, uint64_t endNanoseconds )
+	{
+		const uint64_t duration = endNanoseconds - beginNanoseconds;
+
+		m_session[ size_t( phase ) ].record( duration );
+		m_currentWindow[ size_t( phase ) ].record( duration );
+
+		const uint64_t budget = m_budgetNanoseconds[ size_t( phase ) ];
+		if( budget > 0 && duration > budget )
+		{
+			Alert alert;
+			alert.frame = m_nFrames;
+			alert.phase = phase;
+			alert.nanoseconds = duration;
+			alert.budgetNanoseconds = budget;
+
+			if( trace::isCapturing() )
+			{
+				alert.scopes = trace::scopeTotals( beginNanoseconds, endNanoseconds, m_maxScopesPerAlert );
+			}
+
+			++m_nAlerts;
+			if( m_alertListener )
+			{
+				m_alertListener( alert );
+			}
+
+			if( m_maxAlertsKept > 0 )
+			{
+				m_recentAlerts.push_back( std::move( alert ));
+				while( m_recentAlerts.size() > m_maxAlertsKept )
+				{
+					m_recentAlerts.pop_front();
+				}
+			}
+		}
+	}
+
+	void FrameStats::traceStats( std::ostream& out ) const
+	{
+		out << std::fixed << std::setprecision( 2 );
+		out << std::left << std::setw( 18 ) << "ms" << std::right
+			<< std::setw( 8 ) << "count"
+			<< std::setw( 9 ) << "mean"
+			<< std::setw( 9 ) << "p50"
+			<< std::setw( 9 ) << "p95"
+			<< std::setw( 9 ) << "p99"
+			<< std::setw( 9 ) << "max"
+			<< std::setw( 9 ) << "budget" << "\n";
+
+		const auto traceHistogram = [&]( const char* span, Phase phase, const DurationHistogram& histogram )
+		{
+			out << std::left << std::setw( 18 ) << ( std::string( span ) + " " + phaseName( phase )) << std::right
+				<< std::setw( 8 ) << histogram.count()
+				<< std::setw( 9 ) << toMilliseconds( histogram.meanNanoseconds() )
+				<< std::setw( 9 ) << toMilliseconds( histogram.percentileNanoseconds( 50 ))
+				<< std::setw( 9 ) << toMilliseconds( histogram.percentileNanoseconds( 95 ))
+				<< std::setw( 9 ) << toMilliseconds( histogram.percentileNanoseconds( 99 ))
+				<< std::setw( 9 ) << toMilliseconds( histogram.maxNanoseconds() )
+				<< std::setw( 9 ) << toMilliseconds( m_budgetNanoseconds[ size_t( phase ) ] ) << "\n";
+		};
+
+		for( size_t i = 0; i < size_t( Phase::NUM ); ++i )
+		{
+			traceHistogram( "recent", Phase( i ), recentHistogram( Phase( i )));
+		}
+		for( size_t i = 0; i < size_t( Phase::NUM ); ++i )
+		{
+			traceHistogram( "session", Phase( i ), m_session[ i ] );
+		}
+
+		out << "Substeps per update:";
+		for( size_t i = 0; i < m_substepCounts.size(); ++i )
+		{
+			out << "  " << i << ( i == MAX_SUBSTEPS_COUNTED ? "+" : "" ) << ": " << m_substepCounts[ i ];
+		}
+		out << "\n";
+
+		out << m_nAlerts << " budget overruns";
+		if( !m_recentAlerts.empty() )
+		{
+			out << "; the last " << m_recentAlerts.size() << ":";
+		}
+		out << "\n";
+
+		for( const auto& alert : m_recentAlerts )
+		{
+			out << "  frame " << alert.frame << ": " << phaseName( alert.phase ) << " took " << toMilliseconds( alert.nanoseconds )
+				<< " ms (budget " << toMilliseconds( alert.budgetNanoseconds ) << " ms)\n";
+
+			for( const auto& scope : alert.scopes )
+			{
+				out << "      " << std::setw( 9 ) << toMilliseconds( scope.nanoseconds ) << " ms  " << scope.name
+					<< " (" << scope.nCalls << ( scope.nCalls == 1 ? " call" : " calls" );
+				if( !scope.threadName.empty() )
+				{
+					out << " on " << scope.threadName;
+				}
+				out << ")\n";
+			}
+		}
+	}
+}
@@ -0,0 +1,161 @@
+//
+//  FrameStats.h
+//  Fresh
+//
+
+#ifndef Fresh_FrameStats_h
+#define Fresh_FrameStats_h
+
+#include "FreshEssentials.h"
+#include "FreshMath.h"
+#include "TraceRecorder.h"
+#include <array>
+#include <deque>
+#include <functional>
+#include <ostream>
+#include <vector>
+
+namespace fr
+{
+	// A histogram of durations with buckets whose width grows with their value, as in HdrHistogram: every value
+	// between 1 microsecond and several hours lands in a bucket no wider than 1/32 of its value, so percentiles
+	// are accurate to about 3% at any scale, in a fixed 4KB. Recording costs a few shifts and an increment.
+	//
+	class DurationHistogram
+	{
+	public:
+
+		void record( uint64_t nanoseconds );
+		void merge( const DurationHistogram& other );
+		void clear();
+
+		size_t count() const										{ return m_count; }
+		uint64_t maxNanoseconds() const								{ return m_maxNanoseconds; }
+		uint64_t meanNanoseconds() const							{ return m_count ? m_totalNanoseconds / m_count : 0; }
+
+		uint64_t percentileNanoseconds( double percentile ) const;
+		// REQUIRES( 0 <= percentile && percentile <= 100 );
+		// Returns the upper bound of the bucket holding the given percentile, but no more than the maximum recorded.
+		// Returns 0 if nothing has been recorded.
+
+	private:
+
+		static const unsigned int SUB_BUCKET_BITS = 5;
+		static const size_t SUB_BUCKETS = size_t( 1 ) << SUB_BUCKET_BITS;
+		static const unsigned int MAX_VALUE_BITS = 36;				// In microseconds: about 19 hours.
+		static const size_t NUM_BUCKETS = SUB_BUCKETS * ( MAX_VALUE_BITS - SUB_BUCKET_BITS + 2 );
+
+		static size_t bucketForMicroseconds( uint64_t microseconds );
+		static uint64_t bucketUpperMicroseconds( size_t bucket );
+
+		std::array< uint32_t, NUM_BUCKETS > m_counts = {};
+		size_t m_count = 0;
+		uint64_t m_totalNanoseconds = 0;
+		uint64_t m_maxNanoseconds = 0;
+	};
+
+	// FrameStats gathers the durations of each frame, and of its update and render, into histograms for the whole
+	// session and for a rolling window of recent frames, along with the number of update substeps each frame took.
+	// A frame, update or render that overruns its budget raises an alert, which carries the traced scopes
+	// (see TraceRecorder.h) that were running during the overrun, if a trace capture is running.
+	//
+	// The Stage keeps one of these; see its "framestats" console command.
+	//
+	class FrameStats
+	{
+	public:
+
+		enum class Phase
+		{
+			Frame,
+			Update,
+			Render,
+			NUM
+		};
+
+		static const char* phaseName( Phase phase );
+
+		struct Alert
+		{
+			size_t frame = 0;
+			Phase phase = Phase::Frame;
+			uint64_t nanoseconds = 0;
+			uint64_t budgetNanoseconds = 0;
+			std::vector< trace::ScopeTotal > scopes;				// Largest first.
+		};
+
+		typedef std::function< void( const Alert& ) > AlertListener;
+
+		static const size_t MAX_SUBSTEPS_COUNTED = 8;				// More substeps than this are counted as this many.
+
+		FrameStats() = default;
+
+		void beginFrame();
+		// Ends the previous frame, if any, and starts another.
+
+		void beginUpdate();
+		void endUpdate( size_t nSubsteps );
+		void beginRender();
+		void endRender();
+
+		// A budget of 0 disables alerts for its phase.
+		//
+		void budgetSeconds( Phase phase, TimeType seconds );
+		TimeType budgetSeconds( Phase phase ) const;
+
+		void windowFrames( size_t nFrames );
+		// REQUIRES( nFrames > 0 );
+		// The recent histograms cover between nFrames and twice as many of the most recent frames.
+		size_t windowFrames() const									{ return m_windowFrames; }
+
+		void maxScopesPerAlert( size_t maxScopes )					{ m_maxScopesPerAlert = maxScopes; }
+		void maxAlertsKept( size_t maxAlerts );
+
+		void alertListener( AlertListener&& listener )				{ m_alertListener = std::move( listener ); }
+		// Called on the frame's thread for each overrun, as the overrunning phase (or frame) ends.
+
+		size_t nFrames() const										{ return m_nFrames; }
+		size_t nAlerts() const										{ return m_nAlerts; }
+		const std::deque< Alert >& recentAlerts() const				{ return m_recentAlerts; }
+
+		const DurationHistogram& sessionHistogram( Phase phase ) const	{ return m_session[ size_t( phase ) ]; }
+		DurationHistogram recentHistogram( Phase phase ) const;
+
+		const std::array< size_t, MAX_SUBSTEPS_COUNTED + 1 >& substepCounts() const	{ return m_substepCounts; }
+		// Element i counts the frames that took i substeps.
+
+		void reset();
+		// Forgets every recorded frame and alert, but keeps the settings.
+
+		void traceStats( std::ostream& out ) const;
+
+	private:
+
+		typedef std::array< DurationHistogram, size_t( Phase::NUM ) > Histograms;
+
+		Histograms m_session;
+		Histograms m_currentWindow;
+		Histograms m_previousWindow;
+		size_t m_nFramesInWindow = 0;
+		size_t m_windowFrames = 600;
+
+		std::array< size_t, MAX_SUBSTEPS_COUNTED + 1 > m_substepCounts = {};
+
+		std::array< uint64_t, size_t( Phase::NUM ) > m_budgetNanoseconds = {};
+		size_t m_maxScopesPerAlert = 8;
+		size_t m_maxAlertsKept = 16;
+		size_t m_nAlerts = 0;
+		std::deque< Alert > m_recentAlerts;
+		AlertListener m_alertListener;
+
+		size_t m_nFrames = 0;
+		uint64_t m_frameBeginNanoseconds = 0;
+		uint64_t m_phaseBeginNanoseconds = 0;
+
+		void record( Phase phase, uint64_t beginNanoseconds, uint64_t endNanoseconds );
+
+		FRESH_PREVENT_COPYING( FrameStats )
+	};
+}
+
+#endif
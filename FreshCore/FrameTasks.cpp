@@ -0,0 +1,286 @@
+//
+//  FrameTasks.cpp
+//  Fresh
+//
+
+#include "FrameTasks.h"
+#include "FreshDebug.h"
+#include <deque>
+#include <iomanip>
+
+#if FRESH_ALLOW_THREADING
+#	include <condition_variable>
+#	include <exception>
+#endif
+
+namespace fr
+{
+#if FRESH_ALLOW_THREADING
+
+	// The shared state of one concurrent run(). Helpers hold it by shared pointer because a helper may not start
+	// until the run has finished; such a helper finds nothing left to start and leaves without touching the tasks.
+	//
+	class FrameTasks::Run
+	{
+	public:
+
+		Run( std::vector< Task >& tasks, const std::vector< Link >& links )
+		:	m_tasks( tasks )
+		,	m_links( links )
+		,	m_nUnstarted( tasks.size() )
+		{
+			for( size_t i = 0; i < tasks.size(); ++i )
+			{
+				if( tasks[ i ].nDependencies == 0 )
+				{
+					m_ready.push_back( i );
+				}
+			}
+		}
+
+		// Starts ready tasks until none are left to start.
+		//
+		void work()
+		{
+			std::unique_lock< std::mutex > lock{ m_mutex };
+
+			while( m_nUnstarted > 0 && !m_exception )
+			{
+				if( m_ready.empty() )
+				{
+					// Everything left is waiting on running tasks.
+					//
+					m_changed.wait( lock );
+					continue;
+				}
+
+				const TaskId id = m_ready.front();
+				m_ready.pop_front();
+				--m_nUnstarted;
+				++m_nRunning;
+
+				lock.unlock();
+
+				Task& task = m_tasks[ id ];
+				std::exception_ptr exception;
+				try
+				{
+					runTask( task );
+				}
+				catch( ... )
+				{
+					exception = std::current_exception();
+				}
+
+				lock.lock();
+
+				--m_nRunning;
+				if( exception && !m_exception )
+				{
+					m_exception = exception;
+				}
+
+				for( size_t link = task.firstDependentLink; link != NO_LINK; link = m_links[ link ].next )
+				{
+					const TaskId dependent = m_links[ link ].dependent;
+					if( --m_tasks[ dependent ].nDependencies == 0 )
+					{
+						m_ready.push_back( dependent );
+					}
+				}
+
+				m_changed.notify_all();
+			}
+		}
+
+		// Waits for tasks started by other threads to finish, then rethrows the first exception.
+		//
+		void finish()
+		{
+			{
+				std::unique_lock< std::mutex > lock{ m_mutex };
+				m_changed.wait( lock, [this]() { return m_nRunning == 0; } );
+
+				// Late helpers must now find nothing to start.
+				//
+				m_nUnstarted = 0;
+			}
+
+			if( m_exception )
+			{
+				std::rethrow_exception( m_exception );
+			}
+		}
+
+	private:
+
+		std::vector< Task >& m_tasks;
+		const std::vector< Link >& m_links;
+
+		std::mutex m_mutex;
+		std::condition_variable m_changed;
+		std::deque< TaskId > m_ready;
+		size_t m_nUnstarted;
+		size_t m_nRunning = 0;
+		std::exception_ptr m_exception;
+	};
+
+#endif
+
+	FrameTasks::TaskId FrameTasks::add( const char* name, std::function< void() >&& fn, std::initializer_list< TaskId > dependencies )
+	{
+		REQUIRES( name );
+		REQUIRES( fn );
+
+		const TaskId id = m_tasks.size();
+
+		for( const auto dependency : dependencies )
+		{
+			REQUIRES( dependency < id );
+			m_links.push_back( Link{ id, m_tasks[ dependency ].firstDependentLink } );
+			m_tasks[ dependency ].firstDependentLink = m_links.size() - 1;
+		}
+
+		m_tasks.push_back( Task{ name, std::move( fn ), dependencies.size() } );
+		return id;
+	}
+
+	void FrameTasks::run( size_t maxThreads )
+	{
+		if( m_tasks.empty() )
+		{
+			m_lastRunClocks = 0;
+			return;
+		}
+
+		const SystemClock startTime = getAbsoluteTimeClocks();
+
+		try
+		{
+			const size_t nThreads = std::min( numParallelThreads( maxThreads ), m_tasks.size() );
+			if( nThreads <= 1 )
+			{
+				runSerially();
+			}
+			else
+			{
+				runConcurrently( nThreads );
+			}
+		}
+		catch( ... )
+		{
+			clear();
+			throw;
+		}
+
+		m_lastRunClocks = getAbsoluteTimeClocks() - startTime;
+
+		recordTimings();
+		clear();
+	}
+
+	void FrameTasks::clear()
+	{
+		m_tasks.clear();
+		m_links.clear();
+	}
+
+	void FrameTasks::forEachTiming( const std::function< void( const std::string&, const Timing& ) >& fn ) const
+	{
+		for( const auto& timing : m_timings )
+		{
+			fn( timing.first, timing.second );
+		}
+	}
+
+	void FrameTasks::clearTimings()
+	{
+		m_timings.clear();
+	}
+
+	void FrameTasks::traceTimings( std::ostream& out ) const
+	{
+		out << "Last run took " << std::fixed << std::setprecision( 3 ) << clocksToSeconds( m_lastRunClocks ) * 1000.0 << " ms.\n";
+		out << std::left << std::setw( 32 ) << "task" << std::right
+			<< std::setw( 8 ) << "count"
+			<< std::setw( 12 ) << "last ms"
+			<< std::setw( 12 ) << "mean ms"
+			<< std::setw( 12 ) << "peak ms" << "\n";
+
+		for( const auto& timing : m_timings )
+		{
+			const auto& t = timing.second;
+			out << std::left << std::setw( 32 ) << timing.first << std::right
+				<< std::setw( 8 ) << t.nTasksLastRun
+				<< std::setw( 12 ) << clocksToSeconds( t.lastRunClocks ) * 1000.0
+				<< std::setw( 12 ) << ( t.nRuns ? clocksToSeconds( t.totalClocks ) * 1000.0 / t.nRuns : 0.0 )
+				<< std::setw( 12 ) << clocksToSeconds( t.peakRunClocks ) * 1000.0 << "\n";
+		}
+	}
+
+	void FrameTasks::runTask( Task& task )
+	{
+		const SystemClock startTime = getAbsoluteTimeClocks();
+		task.fn();
+		task.clocks = getAbsoluteTimeClocks() - startTime;
+	}
+
+	void FrameTasks::runSerially()
+	{
+		// Dependencies always precede their dependents, so the order of addition is a valid order to run in.
+		//
+		for( auto& task : m_tasks )
+		{
+			runTask( task );
+		}
+	}
+
+	void FrameTasks::runConcurrently( size_t nThreads )
+	{
+#if FRESH_ALLOW_THREADING
+		const auto run = std::make_shared< Run >( m_tasks, m_links );
+
+		auto& queue = dispatch::globalQueue( dispatch::QoS::UserInteractive );
+		for( size_t i = 1; i < nThreads; ++i )
+		{
+			queue.async( std::make_shared< dispatch::Block >( [run]() { run->work(); } ));
+		}
+
+		run->work();
+		run->finish();
+#else
+		runSerially();
+#endif
+	}
+
+	void FrameTasks::recordTimings()
+	{
+		for( auto& timing : m_timings )
+		{
+			timing.second.nTasksLastRun = 0;
+			timing.second.lastRunClocks = 0;
+		}
+
+		for( const auto& task : m_tasks )
+		{
+			auto iter = m_timings.find( task.name );
+			if( iter == m_timings.end() )
+			{
+				iter = m_timings.emplace( task.name, Timing{} ).first;
+			}
+
+			auto& timing = iter->second;
+			if( timing.nTasksLastRun++ == 0 )
+			{
+				++timing.nRuns;
+			}
+			timing.lastRunClocks += task.clocks;
+			timing.totalClocks += task.clocks;
+		}
+
+		for( auto& timing : m_timings )
+		{
+			timing.second.peakRunClocks = std::max( timing.second.peakRunClocks, timing.second.lastRunClocks );
+		}
+	}
+}
@@ -0,0 +1,112 @@
+//
+//  FrameTasks.h
+//  Fresh
+//
+
+#ifndef Fresh_FrameTasks_h
+#define Fresh_FrameTasks_h
+
+#include "FreshEssentials.h"
+#include "FreshThread.h"
+#include "FreshTime.h"
+#include <functional>
+#include <initializer_list>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace fr
+{
+	// FrameTasks is a graph of jobs for one frame. During the update phase, subsystems add() jobs that don't need the
+	// main thread--particle simulation, light rebuilds, path queries and the like--naming the jobs each one must follow.
+	// run() then executes them, independent jobs concurrently on the dispatch worker pool with the calling thread
+	// helping, and returns once all have finished. The Stage runs its graph at the end of each update step, so every
+	// job has finished before the frame renders.
+	//
+	// A job may only depend on jobs added before it, so the graph can't have cycles. On a single thread, jobs run
+	// in the order they were added.
+	//
+	// The graph keeps timings for each job name across runs. Jobs that share a name (every ParticleEmitter's, say)
+	// are totaled together.
+	//
+	class FrameTasks
+	{
+	public:
+
+		typedef size_t TaskId;
+
+		struct Timing
+		{
+			size_t nTasksLastRun = 0;
+			SystemClock lastRunClocks = 0;		// Summed over every task of the name, whichever thread ran it.
+			SystemClock peakRunClocks = 0;
+			SystemClock totalClocks = 0;
+			size_t nRuns = 0;
+		};
+
+		FrameTasks() = default;
+
+		TaskId add( const char* name, std::function< void() >&& fn, std::initializer_list< TaskId > dependencies = {} );
+		// REQUIRES( name is a string literal, or otherwise lasts until run() returns );
+		// REQUIRES( each dependency was returned by add() since the last run() );
+		// The task may run on any thread. It must not touch the display tree outside the objects it was given.
+
+		bool empty() const											{ return m_tasks.empty(); }
+		size_t size() const											{ return m_tasks.size(); }
+
+		void run( size_t maxThreads = DEFAULT_PARALLEL_FOR_THREADS );
+		// Runs every added task, each after its dependencies, then forgets them all.
+		// Task functions are destroyed on the calling thread.
+		// If a task throws, tasks that haven't started are skipped and the first exception is rethrown here.
+
+		void clear();
+		// Forgets the added tasks without running them.
+
+		SystemClock lastRunClocks() const							{ return m_lastRunClocks; }
+		// How long the last run() took from start to finish.
+
+		void forEachTiming( const std::function< void( const std::string&, const Timing& ) >& fn ) const;
+		void clearTimings();
+
+		void traceTimings( std::ostream& out ) const;
+
+	private:
+
+		static const size_t NO_LINK = size_t( -1 );
+
+		struct Task
+		{
+			const char* name;
+			std::function< void() > fn;
+			size_t nDependencies = 0;
+			size_t firstDependentLink = NO_LINK;
+			SystemClock clocks = 0;
+		};
+
+		// Each task's dependents form a list threaded through m_links, which keeps its capacity from run to run.
+		//
+		struct Link
+		{
+			TaskId dependent;
+			size_t next;
+		};
+
+		class Run;
+
+		std::vector< Task > m_tasks;
+		std::vector< Link > m_links;
+		std::map< std::string, Timing, std::less<> > m_timings;
+		SystemClock m_lastRunClocks = 0;
+
+		static void runTask( Task& task );
+		void runSerially();
+		void runConcurrently( size_t nThreads );
+		void recordTimings();
+
+		FRESH_PREVENT_COPYING( FrameTasks )
+	};
+}
+
+#endif
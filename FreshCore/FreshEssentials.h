@@ -22,6 +22,7 @@
 #include <functional>
 #include <type_traits>
 #include "StringTabulated.h"
+#include "Symbol.h"
 #include "FreshOptional.h"
 #include "FreshDebug.h"
 
@@ -174,8 +175,8 @@ namespace fr
 	typedef const std::string& PackageNameRef;
 	typedef std::string ClassName;
 	typedef const std::string& ClassNameRef;
-	typedef std::string ObjectName;
-	typedef const std::string& ObjectNameRef;
+	typedef Symbol ObjectName;
+	typedef const Symbol& ObjectNameRef;
 	typedef std::string PropertyName;
 	typedef const std::string& PropertyNameRef;
 	
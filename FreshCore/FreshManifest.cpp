@@ -130,7 +130,9 @@ namespace fr
 	{}
 	
 	Manifest::Value::~Value()
-	{}
+	{
+		delete m_parsed.load( std::memory_order_relaxed );
+	}
 	
 	///////////////////////////////////////////////////////////////////////////////
 	
@@ -238,6 +240,89 @@ namespace fr
 		}
 	}
 	
+	bool Manifest::operator==( const Manifest& other ) const
+	{
+		return m_directives.size() == other.m_directives.size() &&
+			std::equal( m_directives.begin(), m_directives.end(), other.m_directives.begin(), []( const std::shared_ptr< Directive >& a, const std::shared_ptr< Directive >& b )
+					   {
+						   return equivalent( *a, *b );
+					   } );
+	}
+	
+	bool Manifest::equivalent( const Directive& a, const Directive& b )
+	{
+		if( a.kind() != b.kind() || a.name() != b.name() )
+		{
+			return false;
+		}
+		
+		switch( a.kind() )
+		{
+			case Directive::Kind::Const:
+			{
+				const auto& constA = *a.as< Const >();
+				const auto& constB = *b.as< Const >();
+				return constA.type == constB.type && constA.value == constB.value;
+			}
+			case Directive::Kind::Object:
+			{
+				const auto& objectA = *a.as< Object >();
+				const auto& objectB = *b.as< Object >();
+				return objectA.className == objectB.className &&
+					( objectA.map && objectB.map ? equivalent( *objectA.map, *objectB.map ) : objectA.map == objectB.map );
+			}
+			case Directive::Kind::Class:
+			{
+				const auto& classA = *a.as< Class >();
+				const auto& classB = *b.as< Class >();
+				return classA.baseClassNames == classB.baseClassNames &&
+					( classA.map && classB.map ? equivalent( *classA.map, *classB.map ) : classA.map == classB.map );
+			}
+		}
+		return false;
+	}
+	
+	bool Manifest::equivalent( const Value& a, const Value& b )
+	{
+		if( a.type() != b.type() )
+		{
+			return false;
+		}
+		
+		switch( a.type() )
+		{
+			case Value::Type::String:
+				return a.get< std::string >() == b.get< std::string >();
+			case Value::Type::Map:
+				return equivalent( a.get< Map >(), b.get< Map >() );
+			case Value::Type::Array:
+				return equivalent( a.get< Array >(), b.get< Array >() );
+			case Value::Type::Object:
+				return equivalent( a.get< Object >(), b.get< Object >() );
+		}
+		return false;
+	}
+	
+	bool Manifest::equivalent( const Map& a, const Map& b )
+	{
+		return a.size() == b.size() &&
+			std::equal( a.begin(), a.end(), b.begin(), []( const Map::value_type& x, const Map::value_type& y )
+					   {
+						   return x.first == y.first &&
+							   x.second.second == y.second.second &&
+							   ( x.second.first && y.second.first ? equivalent( *x.second.first, *y.second.first ) : x.second.first == y.second.first );
+					   } );
+	}
+	
+	bool Manifest::equivalent( const Array& a, const Array& b )
+	{
+		return a.size() == b.size() &&
+			std::equal( a.begin(), a.end(), b.begin(), []( const std::shared_ptr< Value >& x, const std::shared_ptr< Value >& y )
+					   {
+						   return x && y ? equivalent( *x, *y ) : x == y;
+					   } );
+	}
+	
 	void Manifest::updateLineAndColumnNumber( int c )
 	{
 		if( c == '\n' )
@@ -693,6 +778,9 @@ namespace fr
 		
 		fr::Manifest subManifest;
 		subManifest.load( path.content, directives );
+		
+		m_includedPaths.push_back( path.content );
+		m_includedPaths.insert( m_includedPaths.end(), subManifest.m_includedPaths.begin(), subManifest.m_includedPaths.end() );
 	}
 	
 	std::shared_ptr< Manifest::Const > Manifest::constDirective( std::istream& in )
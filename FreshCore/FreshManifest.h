@@ -16,6 +16,7 @@
 #include <vector>
 #include <algorithm>
 #include <memory>
+#include <atomic>
 #include <cassert>
 #include "FreshXML.h"
 #include "FreshPath.h"
@@ -68,9 +69,42 @@ namespace fr
 			
 			Type type() const { return m_type; }
 			
+			// A string value's parsed, typed form, remembered by the first property to parse it so that loading the
+			// same node again (as every instance of a pseudoclass does) assigns rather than re-parses.
+			// Only the first value remembered is kept, and it is never replaced, so threads loading the same shared
+			// node may remember and read concurrently.
+			//
+			template< typename T >
+			const T* parsed() const;
+			// Returns null if no T has been remembered.
+			
+			template< typename T >
+			void setParsed( T&& parsedValue ) const;
+			// Does nothing if a value has already been remembered.
+			
 		private:
 			
+			struct ParsedBase
+			{
+				virtual ~ParsedBase() {}
+				const void* typeTag = nullptr;
+			};
+			
+			template< typename T >
+			struct Parsed : public ParsedBase
+			{
+				T value;
+			};
+			
+			template< typename T >
+			static const void* parsedTypeTag()
+			{
+				static const char tag = 0;
+				return &tag;
+			}
+			
 			Type m_type;
+			mutable std::atomic< ParsedBase* > m_parsed{ nullptr };
 			
 			union
 			{
@@ -175,6 +209,41 @@ namespace fr
 
 		void load( const XmlElement& rootElement );
 		void load( const XmlElement& rootElement, Directives& directives );
+		
+		// Compiled manifests.
+		// A compiled manifest holds the directives of a text or XML manifest, includes already expanded, in a binary form
+		// (see FreshManifestCompiled.cpp) that loads straight from a memory-mapped file without tokenizing or parsing.
+		//
+		static const char* const COMPILED_EXTENSION;		// ".freshc"
+		
+		static bool isCompiled( const path& path );
+		// True iff the file at path starts with the compiled manifest signature.
+		
+		static bool isCompiledUpToDate( const path& compiledPath, const path& sourcePath );
+		// True iff compiledPath holds a readable compiled manifest that is no older than the source manifest or
+		// any file the source included when it was compiled. True if the source doesn't exist.
+		
+		const std::vector< path >& includedPaths() const					{ return m_includedPaths; }
+		// The resource paths of every file that text manifests loaded so far included, directly or not.
+		// saveCompiled() records them so that isCompiledUpToDate() can check them.
+		
+		void loadCompiled( const path& path );
+		void loadCompiled( const path& path, Directives& directives );
+		void loadCompiled( const unsigned char* data, size_t size, Directives& directives );
+		
+		void saveCompiled( const path& path ) const;
+		void saveCompiled( std::ostream& out ) const;
+		void saveCompiled( std::ostream& out, const Directives& directives ) const;
+		
+		// Structural comparison: true iff both manifests hold equivalent directives in the same order.
+		//
+		bool operator==( const Manifest& other ) const;
+		bool operator!=( const Manifest& other ) const						{ return !operator==( other ); }
+		
+		static bool equivalent( const Directive& a, const Directive& b );
+		static bool equivalent( const Value& a, const Value& b );
+		static bool equivalent( const Map& a, const Map& b );
+		static bool equivalent( const Array& a, const Array& b );
 
 		// Internal parsing support.
 		//
@@ -230,6 +299,7 @@ namespace fr
 	private:
 		
 		Directives m_directives;
+		std::vector< path > m_includedPaths;
 
 		// Parsing Internals.
 		//
@@ -345,6 +415,33 @@ namespace fr
 		assert( is< Manifest::Object >() );
 		return *o;
 	}
+	
+	template< typename T >
+	const T* Manifest::Value::parsed() const
+	{
+		const ParsedBase* parsed = m_parsed.load( std::memory_order_acquire );
+		if( parsed && parsed->typeTag == parsedTypeTag< T >() )
+		{
+			return &static_cast< const Parsed< T >* >( parsed )->value;
+		}
+		return nullptr;
+	}
+	
+	template< typename T >
+	void Manifest::Value::setParsed( T&& parsedValue ) const
+	{
+		typedef typename std::decay< T >::type ValueT;
+		
+		std::unique_ptr< Parsed< ValueT >> holder( new Parsed< ValueT > );
+		holder->typeTag = parsedTypeTag< ValueT >();
+		holder->value = std::forward< T >( parsedValue );
+		
+		ParsedBase* expected = nullptr;
+		if( m_parsed.compare_exchange_strong( expected, holder.get(), std::memory_order_release, std::memory_order_relaxed ))
+		{
+			holder.release();
+		}
+	}
 }
 
 #ifdef _MSC_VER
@@ -0,0 +1,908 @@
+//
+//  FreshManifestCompiled.cpp
+//  Fresh
+//
+//	Compiled manifest format (version 2)
+//
+//	All numbers are little-endian uint32 "words". Offsets are byte offsets from the start of the file.
+//	Offset 0 is the header, so an offset of 0 means "none".
+//
+//	Header (8 words):
+//		signature ('F' 'R' 'M' 'C'), version, string count, string index offset,
+//		directive count, directive table offset, file size, dependency list node or 0.
+//
+//	Nodes, each starting with its kind. Every node is written after the nodes it refers to, so a node's
+//	children always lie at lower offsets. The loader relies on this to reject cycles.
+//		String:			[ 0, string ]
+//		Map:			[ 1, count, { key string, value node, attribute list node or 0 } * count ]
+//		Array:			[ 2, count, { value node } * count ]
+//		Object:			[ 3, name string, class name string, map node or 0 ]
+//		String list:	[ 4, count, { string } * count ]
+//
+//	Directive table, one 4-word record per directive, in manifest order. Includes are already expanded.
+//		Const:			[ 0, name string, type string, value string ]
+//		Object:			[ 1, name string, class name string, map node or 0 ]
+//		Class:			[ 2, name string, base class name list node, map node or 0 ]
+//
+//	The dependency list is a string list of the resource paths of every file the source manifest included,
+//	directly or not, so that a compiled manifest can be recognized as stale when any of them changes.
+//
+//	String index: { data offset, byte length } * string count, followed by the string bytes, each
+//	NUL-terminated. Every distinct string is stored once.
+//
+
+#include "FreshManifest.h"
+#include "ManifestDocument.h"
+#include "FreshException.h"
+#include "FreshFile.h"
+#include "MemoryMappedFile.h"
+#include "Profiler.h"
+#include <unordered_map>
+#include <fstream>
+#include <cstdint>
+#include <algorithm>
+
+namespace
+{
+	using namespace fr;
+
+	const unsigned char SIGNATURE[ 4 ] = { 'F', 'R', 'M', 'C' };
+	const uint32_t VERSION = 2;
+	const uint32_t HEADER_SIZE = 8 * sizeof( uint32_t );
+
+	enum NodeKind : uint32_t
+	{
+		NodeString,
+		NodeMap,
+		NodeArray,
+		NodeObject,
+		NodeStringList
+	};
+
+	enum DirectiveKind : uint32_t
+	{
+		ConstDirective,
+		ObjectDirective,
+		ClassDirective
+	};
+
+	///////////////////////////////////////////////////////////////////////////////
+
+	class CompiledManifestWriter
+	{
+	public:
+
+		void write( std::ostream& out, const Manifest::Directives& directives, const std::vector< path >& dependencies )
+		{
+			m_bytes.assign( HEADER_SIZE, 0 );
+
+			std::vector< uint32_t > records;
+			records.reserve( directives.size() * 4 );
+
+			for( const auto& directive : directives )
+			{
+				switch( directive->kind() )
+				{
+					case Manifest::Directive::Kind::Const:
+					{
+						const auto& directiveConst = *directive->as< Manifest::Const >();
+						records.insert( records.end(), { ConstDirective, stringIndex( directiveConst.name() ), stringIndex( directiveConst.type ), stringIndex( directiveConst.value ) } );
+						break;
+					}
+					case Manifest::Directive::Kind::Object:
+					{
+						const auto& directiveObject = *directive->as< Manifest::Object >();
+						const uint32_t mapNode = directiveObject.map ? map( *directiveObject.map ) : 0;
+						records.insert( records.end(), { ObjectDirective, stringIndex( directiveObject.name() ), stringIndex( directiveObject.className ), mapNode } );
+						break;
+					}
+					case Manifest::Directive::Kind::Class:
+					{
+						const auto& directiveClass = *directive->as< Manifest::Class >();
+						const uint32_t baseClassesNode = stringList( directiveClass.baseClassNames );
+						const uint32_t mapNode = directiveClass.map ? map( *directiveClass.map ) : 0;
+						records.insert( records.end(), { ClassDirective, stringIndex( directiveClass.name() ), baseClassesNode, mapNode } );
+						break;
+					}
+				}
+			}
+
+			std::vector< std::string > dependencyStrings;
+			for( const auto& dependency : dependencies )
+			{
+				dependencyStrings.push_back( dependency.string() );
+			}
+			const uint32_t dependencyListNode = dependencyStrings.empty() ? 0 : stringList( dependencyStrings );
+
+			const uint32_t directiveTableOffset = offset();
+			for( const auto record : records )
+			{
+				word( record );
+			}
+
+			const uint32_t stringIndexOffset = offset();
+			uint32_t stringDataOffset = stringIndexOffset + static_cast< uint32_t >( m_strings.size() * 2 * sizeof( uint32_t ));
+			for( const auto& string : m_strings )
+			{
+				word( stringDataOffset );
+				word( static_cast< uint32_t >( string.size() ));
+				stringDataOffset += static_cast< uint32_t >( string.size() + 1 );
+			}
+			for( const auto& string : m_strings )
+			{
+				m_bytes.insert( m_bytes.end(), string.begin(), string.end() );
+				m_bytes.push_back( 0 );
+			}
+
+			if( m_bytes.size() > UINT32_MAX )
+			{
+				FRESH_THROW( FreshException, "Manifest is too large to compile." );
+			}
+
+			// Fill in the header.
+			//
+			std::copy( std::begin( SIGNATURE ), std::end( SIGNATURE ), m_bytes.begin() );
+			patchWord( 1, VERSION );
+			patchWord( 2, static_cast< uint32_t >( m_strings.size() ));
+			patchWord( 3, stringIndexOffset );
+			patchWord( 4, static_cast< uint32_t >( directives.size() ));
+			patchWord( 5, directiveTableOffset );
+			patchWord( 6, offset() );
+			patchWord( 7, dependencyListNode );
+
+			out.write( reinterpret_cast< const char* >( m_bytes.data() ), m_bytes.size() );
+		}
+
+	private:
+
+		std::vector< unsigned char > m_bytes;
+		std::vector< std::string > m_strings;
+		std::unordered_map< std::string, uint32_t > m_stringIndices;
+
+		uint32_t offset() const
+		{
+			return static_cast< uint32_t >( m_bytes.size() );
+		}
+
+		void word( uint32_t w )
+		{
+			m_bytes.insert( m_bytes.end(), { static_cast< unsigned char >( w ), static_cast< unsigned char >( w >> 8 ), static_cast< unsigned char >( w >> 16 ), static_cast< unsigned char >( w >> 24 ) } );
+		}
+
+		void patchWord( size_t index, uint32_t w )
+		{
+			for( size_t i = 0; i < 4; ++i )
+			{
+				m_bytes[ index * 4 + i ] = static_cast< unsigned char >( w >> ( i * 8 ));
+			}
+		}
+
+		uint32_t stringIndex( const std::string& string )
+		{
+			const auto iter = m_stringIndices.find( string );
+			if( iter != m_stringIndices.end() )
+			{
+				return iter->second;
+			}
+
+			const uint32_t index = static_cast< uint32_t >( m_strings.size() );
+			m_strings.push_back( string );
+			m_stringIndices.emplace( string, index );
+			return index;
+		}
+
+		uint32_t stringList( const std::vector< std::string >& strings )
+		{
+			std::vector< uint32_t > indices;
+			indices.reserve( strings.size() );
+			for( const auto& string : strings )
+			{
+				indices.push_back( stringIndex( string ));
+			}
+
+			const uint32_t node = offset();
+			word( NodeStringList );
+			word( static_cast< uint32_t >( indices.size() ));
+			for( const auto index : indices )
+			{
+				word( index );
+			}
+			return node;
+		}
+
+		uint32_t value( const Manifest::Value& value )
+		{
+			switch( value.type() )
+			{
+				case Manifest::Value::Type::String:
+				{
+					const uint32_t index = stringIndex( value.get< std::string >() );
+					const uint32_t node = offset();
+					word( NodeString );
+					word( index );
+					return node;
+				}
+				case Manifest::Value::Type::Map:
+					return map( value.get< Manifest::Map >() );
+				case Manifest::Value::Type::Array:
+					return array( value.get< Manifest::Array >() );
+				case Manifest::Value::Type::Object:
+					return object( value.get< Manifest::Object >() );
+			}
+			return 0;
+		}
+
+		uint32_t map( const Manifest::Map& map )
+		{
+			std::vector< uint32_t > entries;
+			entries.reserve( map.size() * 3 );
+
+			for( const auto& mapping : map )
+			{
+				const auto& attributes = mapping.second.second;
+				entries.insert( entries.end(), {
+					stringIndex( mapping.first ),
+					mapping.second.first ? value( *mapping.second.first ) : 0,
+					attributes.empty() ? 0 : stringList( attributes ) } );
+			}
+
+			const uint32_t node = offset();
+			word( NodeMap );
+			word( static_cast< uint32_t >( map.size() ));
+			for( const auto entry : entries )
+			{
+				word( entry );
+			}
+			return node;
+		}
+
+		uint32_t array( const Manifest::Array& array )
+		{
+			std::vector< uint32_t > elements;
+			elements.reserve( array.size() );
+
+			for( const auto& element : array )
+			{
+				elements.push_back( element ? value( *element ) : 0 );
+			}
+
+			const uint32_t node = offset();
+			word( NodeArray );
+			word( static_cast< uint32_t >( elements.size() ));
+			for( const auto element : elements )
+			{
+				word( element );
+			}
+			return node;
+		}
+
+		uint32_t object( const Manifest::Object& object )
+		{
+			const uint32_t nameIndex = stringIndex( object.name() );
+			const uint32_t classNameIndex = stringIndex( object.className );
+			const uint32_t mapNode = object.map ? map( *object.map ) : 0;
+
+			const uint32_t node = offset();
+			word( NodeObject );
+			word( nameIndex );
+			word( classNameIndex );
+			word( mapNode );
+			return node;
+		}
+	};
+
+	///////////////////////////////////////////////////////////////////////////////
+
+#define corrupt( explanation ) FRESH_THROW( FreshException, "Compiled manifest '" << m_source << "' is corrupt: " << explanation << "." )
+
+	// Reads directly from the (mapped) bytes of a compiled manifest. Every offset and index is checked
+	// before use, so a truncated or corrupt file produces an exception rather than a crash.
+	//
+	// The writer refers to each node once, but a corrupt file may refer to a node from many places, and
+	// expanding such shared subtrees can grow exponentially. Every node takes at least 8 bytes, so a file can
+	// hold no more nodes than that allows; reading gives up once it has expanded more nodes than that.
+	//
+	class CompiledManifestReader
+	{
+	public:
+
+		CompiledManifestReader( const unsigned char* data, size_t size, const path& source )
+		:	m_data( data )
+		,	m_size( size )
+		,	m_source( source )
+		{
+			if( !data || size < HEADER_SIZE || !std::equal( std::begin( SIGNATURE ), std::end( SIGNATURE ), data ))
+			{
+				corrupt( "missing signature" );
+			}
+			if( word( 4 ) != VERSION )
+			{
+				corrupt( "unsupported version " << word( 4 ));
+			}
+			if( word( 24 ) != size )
+			{
+				corrupt( "expected " << word( 24 ) << " bytes but found " << size );
+			}
+
+			m_maxNodes = size / 8;
+
+			m_nStrings = word( 8 );
+			m_stringIndexOffset = word( 12 );
+			if( m_stringIndexOffset < HEADER_SIZE || m_nStrings > ( size - m_stringIndexOffset ) / 8 )
+			{
+				corrupt( "bad string index" );
+			}
+		}
+
+		void read( Manifest::Directives& directives )
+		{
+			uint32_t nDirectives, directiveTableOffset;
+			directiveTable( nDirectives, directiveTableOffset );
+
+			directives.reserve( directives.size() + nDirectives );
+
+			for( uint32_t i = 0; i < nDirectives; ++i )
+			{
+				const size_t record = directiveTableOffset + i * 16;
+				const uint32_t a = word( record + 8 );
+				const uint32_t b = word( record + 12 );
+
+				switch( word( record ))
+				{
+					case ConstDirective:
+						directives.push_back( std::make_shared< Manifest::Const >( string( word( record + 4 )), string( a ), string( b )));
+						break;
+					case ObjectDirective:
+						directives.push_back( std::make_shared< Manifest::Object >( string( word( record + 4 )), string( a ), optionalMap( b, directiveTableOffset )));
+						break;
+					case ClassDirective:
+						directives.push_back( std::make_shared< Manifest::Class >( string( word( record + 4 )), stringList( a, directiveTableOffset ), optionalMap( b, directiveTableOffset )));
+						break;
+					default:
+						corrupt( "unknown directive kind " << word( record ));
+				}
+			}
+		}
+
+		void readDependencies( std::vector< path >& dependencies )
+		{
+			uint32_t nDirectives, directiveTableOffset;
+			directiveTable( nDirectives, directiveTableOffset );
+
+			const uint32_t node = word( 28 );
+			if( node )
+			{
+				for( auto& dependency : stringList( node, directiveTableOffset ))
+				{
+					dependencies.push_back( path( std::move( dependency )));
+				}
+			}
+		}
+
+		// Builds ManifestDocument nodes in arena. Strings are views into the compiled bytes, which must outlive them.
+		//
+		const ManifestDocument::Directive* read( Arena& arena, size_t& nDirectivesOut )
+		{
+			uint32_t nDirectives, directiveTableOffset;
+			directiveTable( nDirectives, directiveTableOffset );
+
+			auto directives = arena.allocate< ManifestDocument::Directive >( nDirectives );
+
+			for( uint32_t i = 0; i < nDirectives; ++i )
+			{
+				const size_t record = directiveTableOffset + i * 16;
+				const uint32_t a = word( record + 8 );
+				const uint32_t b = word( record + 12 );
+
+				auto& directive = directives[ i ];
+				directive.name = stringView( word( record + 4 ));
+
+				switch( word( record ))
+				{
+					case ConstDirective:
+						directive.kind = Manifest::Directive::Kind::Const;
+						directive.type = stringView( a );
+						directive.value = stringView( b );
+						break;
+					case ObjectDirective:
+						directive.kind = Manifest::Directive::Kind::Object;
+						directive.type = stringView( a );
+						directive.map = b ? map( arena, b, directiveTableOffset ) : nullptr;
+						break;
+					case ClassDirective:
+						directive.kind = Manifest::Directive::Kind::Class;
+						directive.baseClassNames = stringList( arena, a, directiveTableOffset, directive.numBaseClassNames );
+						directive.map = b ? map( arena, b, directiveTableOffset ) : nullptr;
+						break;
+					default:
+						corrupt( "unknown directive kind " << word( record ));
+				}
+			}
+
+			nDirectivesOut = nDirectives;
+			return directives;
+		}
+
+		// The arena bytes that read( Arena&, ... ) will need. The writer lays the nodes out end to end before the
+		// directive table and refers to each once, so one linear pass over them, without following references, gives
+		// the exact figure. For a corrupt file this may fall short, in which case the arena simply grows.
+		//
+		size_t documentBytes() const
+		{
+			uint32_t nDirectives, directiveTableOffset;
+			directiveTable( nDirectives, directiveTableOffset );
+
+			size_t bytes = nDirectives * sizeof( ManifestDocument::Directive );
+
+			size_t node = HEADER_SIZE;
+			while( node + 8 <= directiveTableOffset )
+			{
+				const size_t count = word( node + 4 );
+				const size_t room = ( directiveTableOffset - node - 8 ) / 4;
+
+				switch( word( node ))
+				{
+					case NodeString:
+						node += 8;
+						break;
+					case NodeMap:
+						if( count > room / 3 )
+						{
+							return bytes;
+						}
+						bytes += sizeof( ManifestDocument::Map ) + count * sizeof( ManifestDocument::MapEntry );
+						node += 8 + count * 12;
+						break;
+					case NodeArray:
+						if( count > room )
+						{
+							return bytes;
+						}
+						bytes += sizeof( ManifestDocument::Array ) + count * sizeof( ManifestDocument::Value );
+						node += 8 + count * 4;
+						break;
+					case NodeObject:
+						bytes += sizeof( ManifestDocument::Object );
+						node += 16;
+						break;
+					case NodeStringList:
+						if( count > room )
+						{
+							return bytes;
+						}
+						bytes += count * sizeof( ManifestDocument::String );
+						node += 8 + count * 4;
+						break;
+					default:
+						return bytes;
+				}
+			}
+			return bytes;
+		}
+
+	private:
+
+		const unsigned char* m_data;
+		size_t m_size;
+		const path& m_source;
+		uint32_t m_nStrings = 0;
+		uint32_t m_stringIndexOffset = 0;
+		size_t m_maxNodes = 0;
+		mutable size_t m_nNodesExpanded = 0;
+
+		void countNode( uint32_t node ) const
+		{
+			if( ++m_nNodesExpanded > m_maxNodes )
+			{
+				corrupt( "node at " << node << " is shared too widely" );
+			}
+		}
+
+		uint32_t word( size_t offset ) const
+		{
+			if( offset > m_size - sizeof( uint32_t ))
+			{
+				corrupt( "offset " << offset << " out of range" );
+			}
+			const unsigned char* bytes = m_data + offset;
+			return uint32_t( bytes[ 0 ] ) | ( uint32_t( bytes[ 1 ] ) << 8 ) | ( uint32_t( bytes[ 2 ] ) << 16 ) | ( uint32_t( bytes[ 3 ] ) << 24 );
+		}
+
+		std::string string( uint32_t index ) const
+		{
+			const auto view = stringView( index );
+			return std::string( view.data(), view.size() );
+		}
+
+		std::string_view stringView( uint32_t index ) const
+		{
+			if( index >= m_nStrings )
+			{
+				corrupt( "string index " << index << " out of range" );
+			}
+			const size_t entry = m_stringIndexOffset + size_t( index ) * 8;
+			const uint32_t offset = word( entry );
+			const uint32_t length = word( entry + 4 );
+			if( offset > m_size || length > m_size - offset )
+			{
+				corrupt( "string " << index << " out of range" );
+			}
+			return std::string_view( reinterpret_cast< const char* >( m_data + offset ), length );
+		}
+
+		void directiveTable( uint32_t& nDirectives, uint32_t& directiveTableOffset ) const
+		{
+			nDirectives = word( 16 );
+			directiveTableOffset = word( 20 );
+			if( directiveTableOffset < HEADER_SIZE || nDirectives > ( m_size - directiveTableOffset ) / 16 )
+			{
+				corrupt( "bad directive table" );
+			}
+		}
+
+		// Checks that node is a node of the given kind lying before limit, where limit is the referring node.
+		//
+		void requireNode( uint32_t node, NodeKind kind, uint32_t limit ) const
+		{
+			if( node < HEADER_SIZE || node >= limit )
+			{
+				corrupt( "node offset " << node << " out of order" );
+			}
+			if( word( node ) != kind )
+			{
+				corrupt( "node at " << node << " has kind " << word( node ) << " but kind " << kind << " was expected" );
+			}
+			countNode( node );
+		}
+
+		std::vector< std::string > stringList( uint32_t node, uint32_t limit ) const
+		{
+			requireNode( node, NodeStringList, limit );
+			const uint32_t count = word( node + 4 );
+			if( count > ( limit - node ) / 4 )
+			{
+				corrupt( "string list at " << node << " too long" );
+			}
+
+			std::vector< std::string > strings;
+			strings.reserve( count );
+			for( uint32_t i = 0; i < count; ++i )
+			{
+				strings.push_back( string( word( node + 8 + i * 4 )));
+			}
+			return strings;
+		}
+
+		std::shared_ptr< Manifest::Map > optionalMap( uint32_t node, uint32_t limit ) const
+		{
+			return node ? map( node, limit ) : nullptr;
+		}
+
+		std::shared_ptr< Manifest::Map > map( uint32_t node, uint32_t limit ) const
+		{
+			requireNode( node, NodeMap, limit );
+			const uint32_t count = word( node + 4 );
+			if( count > ( limit - node ) / 12 )
+			{
+				corrupt( "map at " << node << " too long" );
+			}
+
+			auto map = std::make_shared< Manifest::Map >();
+			auto hint = map->end();
+			for( uint32_t i = 0; i < count; ++i )
+			{
+				const size_t entry = node + 8 + i * 12;
+				const uint32_t valueNode = word( entry + 4 );
+				const uint32_t attributesNode = word( entry + 8 );
+
+				// Keys were written in map order, so each insertion belongs at the end.
+				//
+				hint = map->emplace_hint( hint, string( word( entry )), std::make_pair(
+					valueNode ? value( valueNode, node ) : nullptr,
+					attributesNode ? stringList( attributesNode, node ) : Manifest::PropertyAttributes{} ));
+				++hint;
+			}
+			return map;
+		}
+
+		std::shared_ptr< Manifest::Array > array( uint32_t node, uint32_t limit ) const
+		{
+			requireNode( node, NodeArray, limit );
+			const uint32_t count = word( node + 4 );
+			if( count > ( limit - node ) / 4 )
+			{
+				corrupt( "array at " << node << " too long" );
+			}
+
+			auto array = std::make_shared< Manifest::Array >();
+			array->reserve( count );
+			for( uint32_t i = 0; i < count; ++i )
+			{
+				const uint32_t elementNode = word( node + 8 + i * 4 );
+				array->push_back( elementNode ? value( elementNode, node ) : nullptr );
+			}
+			return array;
+		}
+
+		std::shared_ptr< Manifest::Object > object( uint32_t node, uint32_t limit ) const
+		{
+			requireNode( node, NodeObject, limit );
+			return std::make_shared< Manifest::Object >( string( word( node + 4 )), string( word( node + 8 )), optionalMap( word( node + 12 ), node ));
+		}
+
+		std::shared_ptr< Manifest::Value > value( uint32_t node, uint32_t limit ) const
+		{
+			if( node < HEADER_SIZE || node >= limit )
+			{
+				corrupt( "node offset " << node << " out of order" );
+			}
+
+			switch( word( node ))
+			{
+				case NodeString:
+					countNode( node );
+					return std::make_shared< Manifest::Value >( string( word( node + 4 )));
+				case NodeMap:
+					return std::make_shared< Manifest::Value >( map( node, limit ));
+				case NodeArray:
+					return std::make_shared< Manifest::Value >( array( node, limit ));
+				case NodeObject:
+					return std::make_shared< Manifest::Value >( object( node, limit ));
+				default:
+					corrupt( "node at " << node << " has unexpected kind " << word( node ));
+					return nullptr;
+			}
+		}
+
+		// ManifestDocument nodes.
+		//
+		const ManifestDocument::String* stringList( Arena& arena, uint32_t node, uint32_t limit, size_t& count ) const
+		{
+			requireNode( node, NodeStringList, limit );
+			count = word( node + 4 );
+			if( count > ( limit - node ) / 4 )
+			{
+				corrupt( "string list at " << node << " too long" );
+			}
+
+			auto strings = arena.allocate< ManifestDocument::String >( count );
+			for( size_t i = 0; i < count; ++i )
+			{
+				strings[ i ] = stringView( word( node + 8 + i * 4 ));
+			}
+			return strings;
+		}
+
+		const ManifestDocument::Map* map( Arena& arena, uint32_t node, uint32_t limit ) const
+		{
+			requireNode( node, NodeMap, limit );
+			const uint32_t count = word( node + 4 );
+			if( count > ( limit - node ) / 12 )
+			{
+				corrupt( "map at " << node << " too long" );
+			}
+
+			auto map = arena.allocate< ManifestDocument::Map >();
+			auto entries = arena.allocate< ManifestDocument::MapEntry >( count );
+			map->entries = entries;
+			map->count = count;
+
+			for( uint32_t i = 0; i < count; ++i )
+			{
+				const size_t entry = node + 8 + i * 12;
+				const uint32_t valueNode = word( entry + 4 );
+				const uint32_t attributesNode = word( entry + 8 );
+
+				entries[ i ].key = stringView( word( entry ));
+
+				// ManifestDocument::Map::find() binary searches, so the keys must really be sorted.
+				//
+				if( i > 0 && !( entries[ i - 1 ].key < entries[ i ].key ))
+				{
+					corrupt( "map at " << node << " has unsorted keys" );
+				}
+
+				if( valueNode )
+				{
+					value( arena, valueNode, node, entries[ i ].value );
+				}
+				if( attributesNode )
+				{
+					entries[ i ].attributes = stringList( arena, attributesNode, node, entries[ i ].numAttributes );
+				}
+			}
+			return map;
+		}
+
+		const ManifestDocument::Array* array( Arena& arena, uint32_t node, uint32_t limit ) const
+		{
+			requireNode( node, NodeArray, limit );
+			const uint32_t count = word( node + 4 );
+			if( count > ( limit - node ) / 4 )
+			{
+				corrupt( "array at " << node << " too long" );
+			}
+
+			auto array = arena.allocate< ManifestDocument::Array >();
+			auto elements = arena.allocate< ManifestDocument::Value >( count );
+			array->elements = elements;
+			array->count = count;
+
+			for( uint32_t i = 0; i < count; ++i )
+			{
+				const uint32_t elementNode = word( node + 8 + i * 4 );
+				if( elementNode )
+				{
+					value( arena, elementNode, node, elements[ i ] );
+				}
+			}
+			return array;
+		}
+
+		const ManifestDocument::Object* object( Arena& arena, uint32_t node, uint32_t limit ) const
+		{
+			requireNode( node, NodeObject, limit );
+
+			auto object = arena.allocate< ManifestDocument::Object >();
+			object->name = stringView( word( node + 4 ));
+			object->className = stringView( word( node + 8 ));
+
+			const uint32_t mapNode = word( node + 12 );
+			object->map = mapNode ? map( arena, mapNode, node ) : nullptr;
+			return object;
+		}
+
+		void value( Arena& arena, uint32_t node, uint32_t limit, ManifestDocument::Value& result ) const
+		{
+			if( node < HEADER_SIZE || node >= limit )
+			{
+				corrupt( "node offset " << node << " out of order" );
+			}
+
+			result.present = true;
+
+			switch( word( node ))
+			{
+				case NodeString:
+					countNode( node );
+					result.type = Manifest::Value::Type::String;
+					result.string = stringView( word( node + 4 ));
+					break;
+				case NodeMap:
+					result.type = Manifest::Value::Type::Map;
+					result.node = map( arena, node, limit );
+					break;
+				case NodeArray:
+					result.type = Manifest::Value::Type::Array;
+					result.node = array( arena, node, limit );
+					break;
+				case NodeObject:
+					result.type = Manifest::Value::Type::Object;
+					result.node = object( arena, node, limit );
+					break;
+				default:
+					corrupt( "node at " << node << " has unexpected kind " << word( node ));
+			}
+		}
+	};
+
+#undef corrupt
+}
+
+namespace fr
+{
+	const char* const Manifest::COMPILED_EXTENSION = ".freshc";
+
+	bool Manifest::isCompiled( const path& path )
+	{
+		std::ifstream in( path.c_str(), std::ios::binary );
+
+		unsigned char signature[ sizeof( SIGNATURE ) ] = { 0 };
+		in.read( reinterpret_cast< char* >( signature ), sizeof( signature ));
+
+		return in && std::equal( std::begin( SIGNATURE ), std::end( SIGNATURE ), signature );
+	}
+
+	void Manifest::loadCompiled( const path& path )
+	{
+		loadCompiled( path, m_directives );
+	}
+
+	void Manifest::loadCompiled( const path& path, Directives& directives )
+	{
+		TIMER_AUTO( Manifest::loadCompiled )
+
+		const MemoryMappedFile file( getResourcePath( path ));
+
+		m_path = path;
+		try
+		{
+			loadCompiled( file.data(), file.size(), directives );
+		}
+		catch( ... )
+		{
+			m_path.clear();
+			throw;
+		}
+		m_path.clear();
+	}
+
+	bool Manifest::isCompiledUpToDate( const path& compiledPath, const path& sourcePath )
+	{
+		if( !exists( compiledPath ) || !isCompiled( compiledPath ))
+		{
+			return false;
+		}
+
+		// Builds may ship only compiled manifests.
+		//
+		if( !exists( sourcePath ))
+		{
+			return true;
+		}
+
+		const auto compiledTime = getFileLastModifiedTime( compiledPath );
+		if( compiledTime < getFileLastModifiedTime( sourcePath ))
+		{
+			return false;
+		}
+
+		// A compiled manifest that can't be read, perhaps because an older version wrote it, or whose dependencies
+		// can't be found, is stale: the source should be loaded instead.
+		//
+		try
+		{
+			std::vector< path > dependencies;
+			{
+				const MemoryMappedFile file( compiledPath );
+				CompiledManifestReader{ file.data(), file.size(), compiledPath }.readDependencies( dependencies );
+			}
+
+			return std::all_of( dependencies.begin(), dependencies.end(), [&]( const path& dependency )
+							   {
+								   return getFileLastModifiedTime( getResourcePath( dependency )) <= compiledTime;
+							   } );
+		}
+		catch( const std::exception& )
+		{
+			return false;
+		}
+	}
+
+	void Manifest::loadCompiled( const unsigned char* data, size_t size, Directives& directives )
+	{
+		CompiledManifestReader{ data, size, m_path }.read( directives );
+	}
+
+	size_t ManifestDocument::compiledDocumentBytes( const unsigned char* data, size_t size, const path& source )
+	{
+		return CompiledManifestReader{ data, size, source }.documentBytes();
+	}
+
+	void ManifestDocument::buildFromCompiled( const unsigned char* data, size_t size, const path& source )
+	{
+		m_directives = CompiledManifestReader{ data, size, source }.read( m_arena, m_numDirectives );
+	}
+
+	void Manifest::saveCompiled( const path& path ) const
+	{
+		std::ofstream out( path.c_str(), std::ios::binary );
+
+		if( !out )
+		{
+			FRESH_THROW( FreshException, "Could not open " << path << "." );
+		}
+
+		saveCompiled( out );
+	}
+
+	void Manifest::saveCompiled( std::ostream& out ) const
+	{
+		saveCompiled( out, m_directives );
+	}
+
+	void Manifest::saveCompiled( std::ostream& out, const Directives& directives ) const
+	{
+		CompiledManifestWriter{}.write( out, directives, m_includedPaths );
+	}
+}
@@ -12,10 +12,12 @@
 namespace
 {
 	std::vector< fr::Random > g_engines = { fr::Random( 1 ) };
+	fr::SeedFilter g_seedFilter;
 	
-	inline unsigned int now()
+	inline unsigned int randomizedSeed()
 	{
-		return (unsigned int) std::chrono::system_clock::now().time_since_epoch().count();
+		const auto seed = (unsigned int) std::chrono::system_clock::now().time_since_epoch().count();
+		return g_seedFilter ? g_seedFilter( seed ) : seed;
 	}
 }
 
@@ -29,7 +31,7 @@ namespace fr
 	
 	Random createRandomGenerator()
 	{
-		return createRandomGenerator( now() );
+		return createRandomGenerator( randomizedSeed() );
 	}
 	
 	Random& currentRandomGenerator()
@@ -40,7 +42,7 @@ namespace fr
 	
 	void pushRandomGeneratorRandomized()
 	{
-		g_engines.emplace_back( now() );
+		g_engines.emplace_back( randomizedSeed() );
 	}
 	
 	void pushRandomGenerator( unsigned int seed )
@@ -62,4 +64,9 @@ namespace fr
 		ASSERT( !g_engines.empty() );
 	}
 	
+	void randomizedSeedFilter( SeedFilter filter )
+	{
+		g_seedFilter = std::move( filter );
+	}
+	
 }
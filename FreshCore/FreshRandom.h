@@ -12,6 +12,7 @@
 #include "FreshRange.h"
 #include <random>
 #include <algorithm>    // For std::random_shuffle()
+#include <functional>
 
 namespace fr
 {
@@ -31,6 +32,12 @@ namespace fr
 	void pushRandomGenerator( const Random& generator );	// Adds a copy of an existing generator.
 	Random popRandomGenerator();
 	
+	// Every time-based seed (above) passes through this filter, if one is set. Input recording records the seeds
+	// and replay substitutes the recorded ones, so that a randomized run can be reproduced.
+	//
+	typedef std::function< unsigned int( unsigned int timeSeed ) > SeedFilter;
+	void randomizedSeedFilter( SeedFilter filter );
+	
 	inline bool pctChance( float percentChanceOfSuccess )
 	{
 		static std::uniform_real_distribution< float > distribution( 0.0, 100.0f );
@@ -0,0 +1,179 @@
+//
+//  FreshThread.cpp
+//  Fresh
+//
+
+#include "FreshThread.h"
+#include "FreshDebug.h"
+
+#if FRESH_ALLOW_THREADING
+#	include <condition_variable>
+#	include <exception>
+#endif
+
+namespace
+{
+	using namespace fr;
+
+#if FRESH_ALLOW_THREADING
+
+	// One call's worth of parallel work. The caller and the helpers it enqueues all take chunks from it.
+	// Helpers hold it by shared pointer because a helper may not start until the caller has finished and returned;
+	// such a helper finds nothing left to claim and never touches the caller's function.
+	//
+	class ParallelJob
+	{
+	public:
+
+		ParallelJob( size_t count, size_t grain, size_t nThreads, detail::ParallelRangeFunction fn, void* context )
+		:	m_fn( fn )
+		,	m_context( context )
+		,	m_count( count )
+		,	m_grain( std::max< size_t >( grain, 1 ))
+		,	m_nThreads( nThreads )
+		{}
+
+		void work()
+		{
+			size_t begin, end;
+			while( claim( begin, end ))
+			{
+				try
+				{
+					m_fn( m_context, begin, end );
+				}
+				catch( ... )
+				{
+					abandon( std::current_exception() );
+				}
+
+				complete( end - begin );
+			}
+		}
+
+		void wait()
+		{
+			std::unique_lock< std::mutex > lock{ m_mutex };
+			m_done.wait( lock, [this]() { return m_nCompleted == m_count; } );
+
+			if( m_exception )
+			{
+				std::rethrow_exception( m_exception );
+			}
+		}
+
+	private:
+
+		const detail::ParallelRangeFunction m_fn;
+		void* const m_context;
+		const size_t m_count;
+		const size_t m_grain;
+		const size_t m_nThreads;
+
+		std::atomic< size_t > m_next{ 0 };
+		std::atomic< size_t > m_nCompleted{ 0 };
+
+		std::mutex m_mutex;
+		std::condition_variable m_done;
+		std::exception_ptr m_exception;
+
+		// Guided self-scheduling: each claim takes a share of what remains, but never less than the grain.
+		//
+		bool claim( size_t& outBegin, size_t& outEnd )
+		{
+			size_t next = m_next.load();
+			size_t end;
+			do
+			{
+				if( next >= m_count )
+				{
+					return false;
+				}
+				end = std::min( m_count, next + std::max( m_grain, ( m_count - next ) / ( m_nThreads * 2 )));
+			}
+			while( !m_next.compare_exchange_weak( next, end ));
+
+			outBegin = next;
+			outEnd = end;
+			return true;
+		}
+
+		void complete( size_t n )
+		{
+			if( m_nCompleted.fetch_add( n ) + n == m_count )
+			{
+				std::lock_guard< std::mutex > lock{ m_mutex };
+				m_done.notify_all();
+			}
+		}
+
+		void abandon( std::exception_ptr exception )
+		{
+			{
+				std::lock_guard< std::mutex > lock{ m_mutex };
+				if( !m_exception )
+				{
+					m_exception = exception;
+				}
+			}
+
+			// Claim everything that's left and count it as done.
+			//
+			const size_t next = m_next.exchange( m_count );
+			if( next < m_count )
+			{
+				complete( m_count - next );
+			}
+		}
+	};
+
+#endif
+}
+
+namespace fr
+{
+	size_t numParallelThreads( size_t maxThreads )
+	{
+#if FRESH_ALLOW_THREADING
+		// More threads than cores only adds switching, so a single-core machine runs everything on the caller.
+		//
+		static const size_t nCores = std::max( std::thread::hardware_concurrency(), 1u );
+		const size_t available = std::min( dispatch::ConcurrentQueue::numWorkers() + 1, nCores );
+		return maxThreads == 0 ? available : std::min( maxThreads, available );
+#else
+		return 1;
+#endif
+	}
+
+	namespace detail
+	{
+		void parallelForRange( size_t count, size_t grain, size_t maxThreads, ParallelRangeFunction fn, void* context )
+		{
+			if( count == 0 )
+			{
+				return;
+			}
+
+			const size_t nThreads = std::min( numParallelThreads( maxThreads ), ( count + std::max< size_t >( grain, 1 ) - 1 ) / std::max< size_t >( grain, 1 ));
+
+			if( nThreads <= 1 )
+			{
+				fn( context, 0, count );
+				return;
+			}
+
+#if FRESH_ALLOW_THREADING
+			const auto job = std::make_shared< ParallelJob >( count, grain, nThreads, fn, context );
+
+			auto& queue = dispatch::globalQueue( dispatch::QoS::UserInteractive );
+			for( size_t i = 1; i < nThreads; ++i )
+			{
+				queue.async( std::make_shared< dispatch::Block >( [job]() { job->work(); } ));
+			}
+
+			job->work();
+			job->wait();
+#endif
+		}
+	}
+}
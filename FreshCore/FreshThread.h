@@ -10,6 +10,10 @@
 #define Fresh_FreshThread_h
 
 #include "Dispatch.h"
+#include "Grid2.h"
+#include <algorithm>
+#include <iterator>
+#include <vector>
 
 #if FRESH_ALLOW_THREADING
 #	include <thread>
@@ -19,59 +23,175 @@
 
 namespace fr
 {
+	// The parallel algorithms below run on the dispatch worker pool (see ConcurrentQueue) at UserInteractive QoS,
+	// with the calling thread doing its share, so they cost no thread creation and are cheap enough for per-frame work.
+	// Work is handed out in chunks that shrink as the range runs down, so early finishers pick up the slack of late ones.
+	// If a function throws, unstarted work is abandoned and the first exception is rethrown on the calling thread.
+	//
+	// maxThreads limits the number of threads working on a call, including the caller. 0 means the whole pool,
+	// up to one thread per core.
+	//
 #if FRESH_ALLOW_THREADING
-	const size_t DEFAULT_PARALLEL_FOR_THREADS = 4;
+	const size_t DEFAULT_PARALLEL_FOR_THREADS = 0;
 #else
 	const size_t DEFAULT_PARALLEL_FOR_THREADS = 1;
 #endif
-	
+
+	namespace detail
+	{
+		typedef void (*ParallelRangeFunction)( void* context, size_t begin, size_t end );
+
+		void parallelForRange( size_t count, size_t grain, size_t maxThreads, ParallelRangeFunction fn, void* context );
+	}
+
+	size_t numParallelThreads( size_t maxThreads = DEFAULT_PARALLEL_FOR_THREADS );
+	// The number of threads, including the caller, that a parallel algorithm may use.
+
+	// Calls fnRange( rangeBegin, rangeEnd ) over disjoint subranges that together cover [0, count).
+	// Subranges are at least grain long (but for the last).
+	//
+	template< typename FunctionT >
+	void parallelForRange( size_t count, FunctionT&& fnRange, size_t grain = 1, size_t maxThreads = DEFAULT_PARALLEL_FOR_THREADS )
+	{
+		typedef typename std::remove_reference< FunctionT >::type function_t;
+
+		detail::parallelForRange( count, grain, maxThreads, []( void* context, size_t begin, size_t end )
+								 {
+									 ( *static_cast< function_t* >( context ))( begin, end );
+								 }, const_cast< void* >( static_cast< const void* >( &fnRange )));
+	}
+
+	// Calls fnEach( element ) for each element in [begin, end). IterT must be random access.
+	//
 	template< typename IterT, typename FunctionT >
 	void parallelFor( IterT begin, const IterT end, FunctionT&& fnEach, size_t maxThreads = DEFAULT_PARALLEL_FOR_THREADS )
 	{
-#if FRESH_ALLOW_THREADING
-		
-		// The work function.
-		//
-		const auto work = [&]( IterT threadRangeBegin, const IterT threadRangeEnd )
+		parallelForRange( std::distance( begin, end ), [&]( size_t rangeBegin, size_t rangeEnd )
+						 {
+							 for( auto iter = begin + rangeBegin; iter != begin + rangeEnd; ++iter )
+							 {
+								 fnEach( *iter );
+							 }
+						 }, 1, maxThreads );
+	}
+
+	// Returns reduce( ... reduce( reduce( identity, map( e0 )), map( e1 )) ..., map( eN )), with the reductions grouped
+	// differently. reduce must be associative and identity must be its identity. The grouping is fixed for a given
+	// range size and thread count, so floating point results are repeatable.
+	//
+	template< typename IterT, typename ValueT, typename MapT, typename ReduceT >
+	ValueT parallelReduce( IterT begin, const IterT end, ValueT identity, MapT&& map, ReduceT&& reduce, size_t maxThreads = DEFAULT_PARALLEL_FOR_THREADS )
+	{
+		const size_t count = std::distance( begin, end );
+		const size_t nChunks = std::min( count, numParallelThreads( maxThreads ) * 4 );
+
+		if( nChunks <= 1 )
 		{
-			for( ; threadRangeBegin != threadRangeEnd; ++threadRangeBegin )
+			ValueT result = identity;
+			for( ; begin != end; ++begin )
 			{
-				fnEach( *threadRangeBegin );
+				result = reduce( result, map( *begin ));
 			}
-		};
-		
-		const size_t threadsToUseIncludingThisOne = maxThreads > 0 ? maxThreads : 1;
-		std::vector< std::thread > threads( threadsToUseIncludingThisOne - 1 );
-		
-		const size_t perThreadSpanSize = std::distance( begin, end ) / threadsToUseIncludingThisOne;
-		
-		for( size_t i = 0; i < threads.size(); ++i )
+			return result;
+		}
+
+		std::vector< ValueT > partials( nChunks, identity );
+
+		parallelForRange( nChunks, [&]( size_t chunkBegin, size_t chunkEnd )
+						 {
+							 for( size_t chunk = chunkBegin; chunk < chunkEnd; ++chunk )
+							 {
+								 ValueT partial = identity;
+								 const auto chunkLast = begin + count * ( chunk + 1 ) / nChunks;
+								 for( auto iter = begin + count * chunk / nChunks; iter != chunkLast; ++iter )
+								 {
+									 partial = reduce( partial, map( *iter ));
+								 }
+								 partials[ chunk ] = std::move( partial );
+							 }
+						 }, 1, maxThreads );
+
+		ValueT result = identity;
+		for( auto& partial : partials )
 		{
-			const auto threadBegin = begin + i * perThreadSpanSize;
-			const auto threadEnd = threadBegin + perThreadSpanSize;
-			
-			threads[ i ] = std::thread{ std::bind( work, threadBegin, threadEnd ) };
+			result = reduce( result, partial );
 		}
-		
-		// Do some of the work on this thread.
-		//
-		work( begin + threads.size() * perThreadSpanSize, end );
-		
-		// Wait for the other threads to complete.
-		//
-		for( auto& thread : threads )
+		return result;
+	}
+
+	// Sorts [begin, end) like std::sort (so not stably). Runs are sorted in parallel, then merged pairwise in parallel.
+	//
+	template< typename IterT, typename CompareT = std::less< typename std::iterator_traits< IterT >::value_type >>
+	void parallelSort( IterT begin, IterT end, CompareT&& compare = CompareT{}, size_t maxThreads = DEFAULT_PARALLEL_FOR_THREADS )
+	{
+		const size_t MIN_RUN_LENGTH = 4096;		// Shorter runs aren't worth a thread.
+
+		const size_t count = std::distance( begin, end );
+
+		size_t nRuns = 1;
+		while( nRuns < numParallelThreads( maxThreads ) && count / ( nRuns * 2 ) >= MIN_RUN_LENGTH )
 		{
-			thread.join();
+			nRuns *= 2;
 		}
-		
-#else
-		for( ; begin != end; ++begin )
+
+		if( nRuns == 1 )
 		{
-			fnEach( *begin );
+			std::sort( begin, end, compare );
+			return;
 		}
-#endif
+
+		const auto runBoundary = [&]( size_t run ) { return begin + count * run / nRuns; };
+
+		parallelForRange( nRuns, [&]( size_t runBegin, size_t runEnd )
+						 {
+							 for( size_t run = runBegin; run < runEnd; ++run )
+							 {
+								 std::sort( runBoundary( run ), runBoundary( run + 1 ), compare );
+							 }
+						 }, 1, maxThreads );
+
+		for( size_t runsPerMerge = 2; runsPerMerge <= nRuns; runsPerMerge *= 2 )
+		{
+			parallelForRange( nRuns / runsPerMerge, [&]( size_t mergeBegin, size_t mergeEnd )
+							 {
+								 for( size_t merge = mergeBegin; merge < mergeEnd; ++merge )
+								 {
+									 const size_t firstRun = merge * runsPerMerge;
+									 std::inplace_merge( runBoundary( firstRun ), runBoundary( firstRun + runsPerMerge / 2 ), runBoundary( firstRun + runsPerMerge ), compare );
+								 }
+							 }, 1, maxThreads );
+		}
+	}
+
+	// Calls fnEach( cell, cellPos ) for each cell in the grid, handing out rows.
+	//
+	template< typename CellT, typename FunctionT >
+	void parallelForGrid( Grid2< CellT >& grid, FunctionT&& fnEach, size_t maxThreads = DEFAULT_PARALLEL_FOR_THREADS )
+	{
+		const auto gridSize = grid.gridSize();
+		auto& cells = grid.cells();
+
+		parallelForRange( gridSize.y, [&]( size_t rowBegin, size_t rowEnd )
+						 {
+							 Vector2i cellPos;
+							 for( cellPos.y = int( rowBegin ); cellPos.y < int( rowEnd ); ++cellPos.y )
+							 {
+								 for( cellPos.x = 0; cellPos.x < gridSize.x; ++cellPos.x )
+								 {
+									 fnEach( cells[ cellPos.y * gridSize.x + cellPos.x ], cellPos );
+								 }
+							 }
+						 }, 1, maxThreads );
+	}
+
+	template< typename CellT, typename FunctionT >
+	void parallelForGrid( const Grid2< CellT >& grid, FunctionT&& fnEach, size_t maxThreads = DEFAULT_PARALLEL_FOR_THREADS )
+	{
+		parallelForGrid( const_cast< Grid2< CellT >& >( grid ), [&]( const CellT& cell, const Vector2i& cellPos )
+						{
+							fnEach( cell, cellPos );
+						}, maxThreads );
 	}
-	
 }
 
 #endif		// Fresh_FreshThread_h
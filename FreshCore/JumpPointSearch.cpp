@@ -0,0 +1,363 @@
+//
+//  JumpPointSearch.cpp
+//  Fresh
+//
+
+#include "JumpPointSearch.h"
+#include "FreshDebug.h"
+#include "FreshMath.h"
+#include <cstdlib>
+
+namespace fr
+{
+	void JumpPointGrid::reset( const Vector2i& extents )
+	{
+		REQUIRES( extents.x >= 0 && extents.y >= 0 );
+
+		m_extents = extents;
+		m_open.assign( size_t( extents.x ) * size_t( extents.y ), 0 );
+		m_jumps.clear();
+		m_rowJumps.assign( m_open.size() * 2, 0 );
+		m_isRowJumpsKnown.assign( size_t( extents.y ), 0 );
+
+		PROMISES( !hasJumpTable() );
+	}
+
+	void JumpPointGrid::isOpen( const Vector2i& pos, bool open )
+	{
+		REQUIRES( isInBounds( pos ));
+		m_open[ index( pos.x, pos.y ) ] = open;
+		m_jumps.clear();
+
+		// Whether a cell is forced depends on the rows above and below it.
+		//
+		for( int y = std::max( pos.y - 1, 0 ); y <= std::min( pos.y + 1, m_extents.y - 1 ); ++y )
+		{
+			m_isRowJumpsKnown[ y ] = false;
+		}
+	}
+
+	bool JumpPointGrid::isForcedHorizontally( int x, int y, int dx ) const
+	{
+		// A shortest path running horizontally only needs to turn vertically where it couldn't have turned a cell sooner.
+		//
+		return ( isOpen( x, y - 1 ) && !isOpen( x - dx, y - 1 )) ||
+			   ( isOpen( x, y + 1 ) && !isOpen( x - dx, y + 1 ));
+	}
+
+	void JumpPointGrid::computeRowJumps( int y, int* outEast, int* outWest, size_t stride ) const
+	{
+		// As in the jump table: n > 0 if a jump stops at a forced cell n cells away, or -n if it runs n cells into a wall.
+		// The distance from a cell is one more than the distance from the next, unless the next cell ends the jump.
+		//
+		const auto extend = [&]( int* distances, int x, int dx )
+		{
+			const int nextX = x + dx;
+			int& distance = distances[ x * stride ];
+			if( !isOpen( nextX, y ))
+			{
+				distance = 0;
+			}
+			else if( isForcedHorizontally( nextX, y, dx ))
+			{
+				distance = 1;
+			}
+			else
+			{
+				const int nextDistance = distances[ nextX * stride ];
+				distance = nextDistance > 0 ? nextDistance + 1 : nextDistance - 1;
+			}
+		};
+
+		for( int x = m_extents.x - 1; x >= 0; --x )
+		{
+			extend( outEast, x, 1 );
+		}
+		for( int x = 0; x < m_extents.x; ++x )
+		{
+			extend( outWest, x, -1 );
+		}
+	}
+
+	const int* JumpPointGrid::rowJumps( int y ) const
+	{
+		ASSERT( 0 <= y && y < m_extents.y );
+
+		int* const jumps = m_rowJumps.data() + size_t( index( 0, y )) * 2;
+		if( !m_isRowJumpsKnown[ y ] )
+		{
+			computeRowJumps( y, jumps, jumps + 1, 2 );
+			m_isRowJumpsKnown[ y ] = true;
+		}
+		return jumps;
+	}
+
+	int JumpPointGrid::jump( int x, int y, int dx, int dy ) const
+	{
+		if( hasJumpTable() )
+		{
+			return tableJump( x, y, dx, dy );
+		}
+		else
+		{
+			return dx != 0 ? jumpHorizontally( x, y, dx ) : jumpVertically( x, y, dy );
+		}
+	}
+
+	int JumpPointGrid::jumpHorizontally( int x, int y, int dx ) const
+	{
+		return endOfHorizontalJump( x, y, dx, rowJumps( y )[ x * 2 + ( dx > 0 ? 0 : 1 ) ] );
+	}
+
+	int JumpPointGrid::endOfHorizontalJump( int x, int y, int dx, int distance ) const
+	{
+		// Row jumps don't know the goal, so check whether this jump passes it.
+		//
+		const int toGoal = ( m_goal.x - x ) * dx;
+		if( m_goal.y == y && 0 < toGoal && toGoal <= std::abs( distance ))
+		{
+			return index( m_goal.x, m_goal.y );
+		}
+
+		return distance > 0 ? index( x + dx * distance, y ) : NO_CELL;
+	}
+
+	int JumpPointGrid::jumpVertically( int x, int y, int dy ) const
+	{
+		for( ;; )
+		{
+			y += dy;
+			if( !isOpen( x, y ))
+			{
+				return NO_CELL;
+			}
+
+			// Shortest paths may turn horizontally from anywhere on a vertical run, so stop wherever such a turn leads somewhere.
+			// The rows' jumps are remembered, so this doesn't scan them.
+			//
+			if(( x == m_goal.x && y == m_goal.y ) || jumpHorizontally( x, y, 1 ) != NO_CELL || jumpHorizontally( x, y, -1 ) != NO_CELL )
+			{
+				return index( x, y );
+			}
+		}
+	}
+
+	int JumpPointGrid::tableJump( int x, int y, int dx, int dy ) const
+	{
+		ASSERT( hasJumpTable() );
+
+		const auto direction = dx > 0 ? East : dx < 0 ? West : dy > 0 ? South : North;
+		const int distance = m_jumps[ index( x, y ) * NUM_DIRECTIONS + direction ];
+		const int reach = std::abs( distance );
+
+		// The table doesn't know the goal, so check whether this jump passes it, or passes the cell on the goal's row
+		// from which a horizontal jump would reach it.
+		//
+		if( dx != 0 )
+		{
+			return endOfHorizontalJump( x, y, dx, distance );
+		}
+		else
+		{
+			const int toGoalRow = ( m_goal.y - y ) * dy;
+			if( 0 < toGoalRow && toGoalRow <= reach )
+			{
+				if( m_goal.x == x )
+				{
+					return index( m_goal.x, m_goal.y );
+				}
+
+				const auto across = m_goal.x > x ? East : West;
+				if( std::abs( m_goal.x - x ) <= std::abs( m_jumps[ index( x, m_goal.y ) * NUM_DIRECTIONS + across ] ))
+				{
+					return index( x, m_goal.y );
+				}
+			}
+		}
+
+		return distance > 0 ? index( x + dx * distance, y + dy * distance ) : NO_CELL;
+	}
+
+	void JumpPointGrid::buildJumpTable()
+	{
+		m_jumps.assign( m_open.size() * NUM_DIRECTIONS, 0 );
+
+		const auto at = [&]( int x, int y, Direction direction ) -> int&
+		{
+			return m_jumps[ index( x, y ) * NUM_DIRECTIONS + direction ];
+		};
+
+		// Horizontal jumps stop at forced cells.
+		//
+		for( int y = 0; y < m_extents.y; ++y )
+		{
+			int* const row = m_jumps.data() + size_t( index( 0, y )) * NUM_DIRECTIONS;
+			computeRowJumps( y, row + East, row + West, NUM_DIRECTIONS );
+		}
+
+		// The distance from a cell is one more than the distance from the next, unless the next cell ends the jump.
+		//
+		const auto extend = [&]( int x, int y, int nextX, int nextY, Direction direction, bool isNextJumpPoint )
+		{
+			int& distance = at( x, y, direction );
+			if( !isOpen( nextX, nextY ))
+			{
+				distance = 0;
+			}
+			else if( isNextJumpPoint )
+			{
+				distance = 1;
+			}
+			else
+			{
+				const int nextDistance = at( nextX, nextY, direction );
+				distance = nextDistance > 0 ? nextDistance + 1 : nextDistance - 1;
+			}
+		};
+
+		// Vertical jumps stop at cells from which a horizontal jump stops.
+		//
+		const auto isVerticalJumpPoint = [&]( int x, int y )
+		{
+			return isOpen( x, y ) && ( at( x, y, East ) > 0 || at( x, y, West ) > 0 );
+		};
+
+		for( int x = 0; x < m_extents.x; ++x )
+		{
+			for( int y = m_extents.y - 1; y >= 0; --y )
+			{
+				extend( x, y, x, y + 1, South, isVerticalJumpPoint( x, y + 1 ));
+			}
+			for( int y = 0; y < m_extents.y; ++y )
+			{
+				extend( x, y, x, y - 1, North, isVerticalJumpPoint( x, y - 1 ));
+			}
+		}
+
+		PROMISES( hasJumpTable() || m_open.empty() );
+	}
+
+	size_t JumpPointGrid::successors( int node, int priorNode, int* outSuccessors ) const
+	{
+		const int x = node % m_extents.x;
+		const int y = node / m_extents.x;
+
+		size_t nSuccessors = 0;
+		const auto consider = [&]( int dx, int dy )
+		{
+			const int successor = jump( x, y, dx, dy );
+			if( successor != NO_CELL )
+			{
+				outSuccessors[ nSuccessors++ ] = successor;
+			}
+		};
+
+		if( priorNode == NO_CELL )
+		{
+			// The start goes every way.
+			//
+			consider(  1, 0 );
+			consider( -1, 0 );
+			consider( 0,  1 );
+			consider( 0, -1 );
+		}
+		else if( priorNode / m_extents.x == y )
+		{
+			// Arrived horizontally: carry on, or turn where forced.
+			//
+			const int dx = priorNode < node ? 1 : -1;
+			consider( dx, 0 );
+
+			for( int dy = -1; dy <= 1; dy += 2 )
+			{
+				if( isOpen( x, y + dy ) && !isOpen( x - dx, y + dy ))
+				{
+					consider( 0, dy );
+				}
+			}
+		}
+		else
+		{
+			// Arrived vertically: carry on, or turn either way.
+			//
+			ASSERT( priorNode % m_extents.x == x );
+			consider( 0, priorNode < node ? 1 : -1 );
+			consider(  1, 0 );
+			consider( -1, 0 );
+		}
+
+		return nSuccessors;
+	}
+
+	bool JumpPointGrid::findPath( const Vector2i& start, const Vector2i& goal, Path& outPath )
+	{
+		outPath.clear();
+
+		if( start == goal )
+		{
+			outPath.push_back( start );
+			return true;
+		}
+
+		if( !isOpen( start ) || !isOpen( goal ))
+		{
+			return false;
+		}
+
+		m_goal = goal;
+
+		const auto cellDistance = [this]( int a, int b )
+		{
+			return float( std::abs( a % m_extents.x - b % m_extents.x ) + std::abs( a / m_extents.x - b / m_extents.x ));
+		};
+
+		// Many paths share the shortest length, so many nodes tie. Stretching the heuristic by less than a step over the
+		// longest possible estimate breaks ties toward nodes nearer the goal without making any path longer.
+		//
+		const float tieBreak = 1.0f + 1.0f / float( m_extents.x + m_extents.y );
+		const auto heuristicEstimate = [&]( int a, int b )
+		{
+			return cellDistance( a, b ) * tieBreak;
+		};
+
+		auto pathFinder = makeHeapPathFinder< NUM_DIRECTIONS >( m_scratch,
+																index( start.x, start.y ),
+																index( goal.x, goal.y ),
+																int( NO_CELL ),
+																heuristicEstimate,
+																[this]( int node, int priorNode, int* outSuccessors ) { return successors( node, priorNode, outSuccessors ); },
+																cellDistance,
+																[]() { return 0; },
+																[]( int node ) { return size_t( node ); } );
+
+		bool ranOutOfTime = false;
+		if( !pathFinder.findPath( ranOutOfTime ))
+		{
+			return false;
+		}
+
+		// Fill in the cells between jump points, which always share a row or column.
+		//
+		const auto jumpPoints = pathFinder.path();
+		ASSERT( !jumpPoints.empty() );
+
+		Vector2i cell( jumpPoints.front() % m_extents.x, jumpPoints.front() / m_extents.x );
+		outPath.push_back( cell );
+
+		for( size_t i = 1; i < jumpPoints.size(); ++i )
+		{
+			const Vector2i next( jumpPoints[ i ] % m_extents.x, jumpPoints[ i ] / m_extents.x );
+			ASSERT( next.x == cell.x || next.y == cell.y );
+
+			const Vector2i step( sign( next.x - cell.x ), sign( next.y - cell.y ));
+			while( cell != next )
+			{
+				cell += step;
+				outPath.push_back( cell );
+			}
+		}
+
+		PROMISES( outPath.front() == start && outPath.back() == goal );
+		return true;
+	}
+}
@@ -0,0 +1,89 @@
+//
+//  JumpPointSearch.h
+//  Fresh
+//
+
+#ifndef Fresh_JumpPointSearch_h
+#define Fresh_JumpPointSearch_h
+
+#include "FreshVector.h"
+#include "FindPath.h"
+#include <vector>
+
+namespace fr
+{
+	// JumpPointGrid finds shortest paths across a uniform-cost, 4-connected grid of open and closed cells, where a step
+	// joins two open cells. It searches with Jump Point Search: of all the equally short paths, it only follows those
+	// that turn from a horizontal run to a vertical one where an obstacle forced the turn, so open areas are crossed
+	// in a few long jumps rather than cell by cell. Paths are as short as A*'s over the same cells.
+	//
+	// Without a table, a search works out each row's horizontal jumps the first time it crosses the row and keeps
+	// them until a cell on or beside the row changes, so vertical jumps, which must look both ways from every cell
+	// they cross, don't rescan the rows. buildJumpTable() precomputes, for every cell and direction, how far a jump
+	// goes (JPS+). Searches then read every jump from the table. The table must be rebuilt whenever a cell changes.
+	//
+	class JumpPointGrid
+	{
+	public:
+
+		typedef std::vector< Vector2i > Path;
+
+		void reset( const Vector2i& extents );
+		// REQUIRES( extents.x >= 0 && extents.y >= 0 );
+		// PROMISES( every cell is closed and there is no jump table );
+
+		const Vector2i& extents() const								{ return m_extents; }
+
+		bool isInBounds( const Vector2i& pos ) const				{ return 0 <= pos.x && pos.x < m_extents.x && 0 <= pos.y && pos.y < m_extents.y; }
+
+		bool isOpen( const Vector2i& pos ) const					{ return isInBounds( pos ) && m_open[ index( pos.x, pos.y ) ]; }
+		void isOpen( const Vector2i& pos, bool open );
+		// REQUIRES( isInBounds( pos ));
+		// Forgets the jump table and the horizontal jumps of the rows beside it.
+
+		void buildJumpTable();
+		bool hasJumpTable() const									{ return !m_jumps.empty(); }
+
+		bool findPath( const Vector2i& start, const Vector2i& goal, Path& outPath );
+		// Fills outPath with every cell from start to goal inclusive, each a step from the last.
+		// Returns false, with outPath empty, if there is no path.
+
+	private:
+
+		enum Direction { East, South, West, North, NUM_DIRECTIONS };
+
+		static const int NO_CELL = -1;
+
+		std::vector< unsigned char > m_open;
+		Vector2i m_extents;
+
+		// For each cell and direction: n > 0 if a jump stops n cells away, or -n if it runs n cells into a wall.
+		//
+		std::vector< int > m_jumps;
+
+		// Without a table: the East and West entries of rows worked out so far, and which rows they are.
+		//
+		mutable std::vector< int > m_rowJumps;
+		mutable std::vector< unsigned char > m_isRowJumpsKnown;
+
+		PathFinderScratch< int, float > m_scratch;
+
+		Vector2i m_goal;		// Of the search in progress.
+
+		int index( int x, int y ) const								{ return y * m_extents.x + x; }
+		bool isOpen( int x, int y ) const							{ return 0 <= x && x < m_extents.x && 0 <= y && y < m_extents.y && m_open[ index( x, y ) ]; }
+
+		bool isForcedHorizontally( int x, int y, int dx ) const;
+		void computeRowJumps( int y, int* outEast, int* outWest, size_t stride ) const;
+		const int* rowJumps( int y ) const;
+		int jump( int x, int y, int dx, int dy ) const;
+		int jumpHorizontally( int x, int y, int dx ) const;
+		int endOfHorizontalJump( int x, int y, int dx, int distance ) const;
+		int jumpVertically( int x, int y, int dy ) const;
+		int tableJump( int x, int y, int dx, int dy ) const;
+
+		size_t successors( int node, int priorNode, int* outSuccessors ) const;
+	};
+}
+
+#endif
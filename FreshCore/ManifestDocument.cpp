@@ -0,0 +1,406 @@
+//
+//  ManifestDocument.cpp
+//  Fresh
+//
+
+#include "ManifestDocument.h"
+#include "MemoryMappedFile.h"
+#include "FreshFile.h"
+#include "Profiler.h"
+
+namespace
+{
+	using namespace fr;
+
+	inline std::string toString( ManifestDocument::String string )
+	{
+		return std::string( string.data(), string.size() );
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+
+	// Copies a Manifest's nodes into an arena.
+	//
+	class DocumentBuilder
+	{
+	public:
+
+		explicit DocumentBuilder( Arena& arena ) : m_arena( arena ) {}
+
+		void directive( const Manifest::Directive& source, ManifestDocument::Directive& directive )
+		{
+			directive.kind = source.kind();
+			directive.name = string( source.name() );
+
+			switch( source.kind() )
+			{
+				case Manifest::Directive::Kind::Const:
+				{
+					const auto& directiveConst = *source.as< Manifest::Const >();
+					directive.type = string( directiveConst.type );
+					directive.value = string( directiveConst.value );
+					break;
+				}
+				case Manifest::Directive::Kind::Object:
+				{
+					const auto& directiveObject = *source.as< Manifest::Object >();
+					directive.type = string( directiveObject.className );
+					directive.map = directiveObject.map ? map( *directiveObject.map ) : nullptr;
+					break;
+				}
+				case Manifest::Directive::Kind::Class:
+				{
+					const auto& directiveClass = *source.as< Manifest::Class >();
+					directive.baseClassNames = stringList( directiveClass.baseClassNames, directive.numBaseClassNames );
+					directive.map = directiveClass.map ? map( *directiveClass.map ) : nullptr;
+					break;
+				}
+			}
+		}
+
+	private:
+
+		Arena& m_arena;
+
+		ManifestDocument::String string( const std::string& source )
+		{
+			return m_arena.copyString( source );
+		}
+
+		const ManifestDocument::String* stringList( const std::vector< std::string >& source, size_t& count )
+		{
+			count = source.size();
+			auto strings = m_arena.allocate< ManifestDocument::String >( count );
+			for( size_t i = 0; i < count; ++i )
+			{
+				strings[ i ] = string( source[ i ] );
+			}
+			return strings;
+		}
+
+		const ManifestDocument::Map* map( const Manifest::Map& source )
+		{
+			auto map = m_arena.allocate< ManifestDocument::Map >();
+			auto entries = m_arena.allocate< ManifestDocument::MapEntry >( source.size() );
+			map->entries = entries;
+			map->count = source.size();
+
+			// Manifest::Map is already ordered by key.
+			//
+			for( const auto& mapping : source )
+			{
+				entries->key = string( mapping.first );
+				if( mapping.second.first )
+				{
+					value( *mapping.second.first, entries->value );
+				}
+				entries->attributes = stringList( mapping.second.second, entries->numAttributes );
+				++entries;
+			}
+			return map;
+		}
+
+		const ManifestDocument::Array* array( const Manifest::Array& source )
+		{
+			auto array = m_arena.allocate< ManifestDocument::Array >();
+			auto elements = m_arena.allocate< ManifestDocument::Value >( source.size() );
+			array->elements = elements;
+			array->count = source.size();
+
+			for( const auto& element : source )
+			{
+				if( element )
+				{
+					value( *element, *elements );
+				}
+				++elements;
+			}
+			return array;
+		}
+
+		const ManifestDocument::Object* object( const Manifest::Object& source )
+		{
+			auto object = m_arena.allocate< ManifestDocument::Object >();
+			object->name = string( source.name() );
+			object->className = string( source.className );
+			object->map = source.map ? map( *source.map ) : nullptr;
+			return object;
+		}
+
+		void value( const Manifest::Value& source, ManifestDocument::Value& value )
+		{
+			value.type = source.type();
+			value.present = true;
+
+			switch( source.type() )
+			{
+				case Manifest::Value::Type::String:
+					value.string = string( source.get< std::string >() );
+					break;
+				case Manifest::Value::Type::Map:
+					value.node = map( source.get< Manifest::Map >() );
+					break;
+				case Manifest::Value::Type::Array:
+					value.node = array( source.get< Manifest::Array >() );
+					break;
+				case Manifest::Value::Type::Object:
+					value.node = object( source.get< Manifest::Object >() );
+					break;
+			}
+		}
+	};
+
+	// Adds up the arena bytes that DocumentBuilder will take for a manifest, so that the arena can allocate them at once.
+	//
+	class DocumentSizer
+	{
+	public:
+
+		size_t bytes = 0;
+
+		void directive( const Manifest::Directive& source )
+		{
+			bytes += sizeof( ManifestDocument::Directive ) + text( source.name() );
+
+			switch( source.kind() )
+			{
+				case Manifest::Directive::Kind::Const:
+				{
+					const auto& directiveConst = *source.as< Manifest::Const >();
+					bytes += text( directiveConst.type ) + text( directiveConst.value );
+					break;
+				}
+				case Manifest::Directive::Kind::Object:
+				{
+					const auto& directiveObject = *source.as< Manifest::Object >();
+					bytes += text( directiveObject.className );
+					optionalMap( directiveObject.map.get() );
+					break;
+				}
+				case Manifest::Directive::Kind::Class:
+				{
+					const auto& directiveClass = *source.as< Manifest::Class >();
+					stringList( directiveClass.baseClassNames );
+					optionalMap( directiveClass.map.get() );
+					break;
+				}
+			}
+		}
+
+	private:
+
+		// Copied strings are packed between nodes, which then start at the next aligned address.
+		//
+		static size_t text( const std::string& string )
+		{
+			const size_t alignment = alignof( ManifestDocument::MapEntry );
+			return ( string.size() + alignment - 1 ) / alignment * alignment;
+		}
+
+		void stringList( const std::vector< std::string >& source )
+		{
+			bytes += source.size() * sizeof( ManifestDocument::String );
+			for( const auto& string : source )
+			{
+				bytes += text( string );
+			}
+		}
+
+		void optionalMap( const Manifest::Map* source )
+		{
+			if( source )
+			{
+				map( *source );
+			}
+		}
+
+		void map( const Manifest::Map& source )
+		{
+			bytes += sizeof( ManifestDocument::Map ) + source.size() * sizeof( ManifestDocument::MapEntry );
+			for( const auto& mapping : source )
+			{
+				bytes += text( mapping.first );
+				if( mapping.second.first )
+				{
+					value( *mapping.second.first );
+				}
+				stringList( mapping.second.second );
+			}
+		}
+
+		void value( const Manifest::Value& source )
+		{
+			switch( source.type() )
+			{
+				case Manifest::Value::Type::String:
+					bytes += text( source.get< std::string >() );
+					break;
+				case Manifest::Value::Type::Map:
+					map( source.get< Manifest::Map >() );
+					break;
+				case Manifest::Value::Type::Array:
+				{
+					const auto& array = source.get< Manifest::Array >();
+					bytes += sizeof( ManifestDocument::Array ) + array.size() * sizeof( ManifestDocument::Value );
+					for( const auto& element : array )
+					{
+						if( element )
+						{
+							value( *element );
+						}
+					}
+					break;
+				}
+				case Manifest::Value::Type::Object:
+				{
+					const auto& object = source.get< Manifest::Object >();
+					bytes += sizeof( ManifestDocument::Object ) + text( object.name() ) + text( object.className );
+					optionalMap( object.map.get() );
+					break;
+				}
+			}
+		}
+	};
+
+	size_t documentBytes( const Manifest& manifest )
+	{
+		DocumentSizer sizer;
+		manifest.eachDirective( [&]( const Manifest::Directive& directive )
+							   {
+								   sizer.directive( directive );
+							   } );
+		return sizer.bytes;
+	}
+
+	std::vector< std::string > toStrings( const ManifestDocument::String* strings, size_t count )
+	{
+		std::vector< std::string > result;
+		result.reserve( count );
+		for( size_t i = 0; i < count; ++i )
+		{
+			result.push_back( toString( strings[ i ] ));
+		}
+		return result;
+	}
+}
+
+namespace fr
+{
+	std::shared_ptr< Manifest::Value > ManifestDocument::Value::toManifestValue() const
+	{
+		if( !present )
+		{
+			return nullptr;
+		}
+
+		switch( type )
+		{
+			case Manifest::Value::Type::String:
+				return std::make_shared< Manifest::Value >( toString( string ));
+			case Manifest::Value::Type::Map:
+				return std::make_shared< Manifest::Value >( map().toManifestMap() );
+			case Manifest::Value::Type::Array:
+				return std::make_shared< Manifest::Value >( array().toManifestArray() );
+			case Manifest::Value::Type::Object:
+				return std::make_shared< Manifest::Value >( object().toManifestObject() );
+		}
+		return nullptr;
+	}
+
+	const ManifestDocument::MapEntry* ManifestDocument::Map::find( String key ) const
+	{
+		const auto iter = std::lower_bound( begin(), end(), key, []( const MapEntry& entry, String key )
+										   {
+											   return entry.key < key;
+										   } );
+		return ( iter != end() && iter->key == key ) ? iter : nullptr;
+	}
+
+	std::shared_ptr< Manifest::Map > ManifestDocument::Map::toManifestMap() const
+	{
+		auto map = std::make_shared< Manifest::Map >();
+		auto hint = map->end();
+		for( const auto& entry : *this )
+		{
+			hint = map->emplace_hint( hint, toString( entry.key ), std::make_pair( entry.value.toManifestValue(), toStrings( entry.attributes, entry.numAttributes )));
+			++hint;
+		}
+		return map;
+	}
+
+	std::shared_ptr< Manifest::Array > ManifestDocument::Array::toManifestArray() const
+	{
+		auto array = std::make_shared< Manifest::Array >();
+		array->reserve( count );
+		for( const auto& element : *this )
+		{
+			array->push_back( element.toManifestValue() );
+		}
+		return array;
+	}
+
+	std::shared_ptr< Manifest::Object > ManifestDocument::Object::toManifestObject() const
+	{
+		return std::make_shared< Manifest::Object >( toString( name ), toString( className ), map ? map->toManifestMap() : nullptr );
+	}
+
+	std::shared_ptr< Manifest::Directive > ManifestDocument::Directive::toManifestDirective() const
+	{
+		switch( kind )
+		{
+			case Manifest::Directive::Kind::Const:
+				return std::make_shared< Manifest::Const >( toString( name ), toString( type ), toString( value ));
+			case Manifest::Directive::Kind::Object:
+				return std::make_shared< Manifest::Object >( toString( name ), toString( type ), map ? map->toManifestMap() : nullptr );
+			case Manifest::Directive::Kind::Class:
+				return std::make_shared< Manifest::Class >( toString( name ), toStrings( baseClassNames, numBaseClassNames ), map ? map->toManifestMap() : nullptr );
+		}
+		return nullptr;
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+
+	ManifestDocument::ManifestDocument()
+	{}
+
+	ManifestDocument::ManifestDocument( const path& compiledPath )
+	:	m_file( new MemoryMappedFile( getResourcePath( compiledPath )))
+	,	m_arena( compiledDocumentBytes( m_file->data(), m_file->size(), compiledPath ))
+	{
+		TIMER_AUTO( ManifestDocument::ManifestDocument( compiled ))
+		buildFromCompiled( m_file->data(), m_file->size(), compiledPath );
+	}
+
+	ManifestDocument::ManifestDocument( const Manifest& manifest )
+	:	m_arena( documentBytes( manifest ))
+	{
+		TIMER_AUTO( ManifestDocument::ManifestDocument( Manifest ))
+
+		size_t nDirectives = 0;
+		manifest.eachDirective( [&]( const Manifest::Directive& ) { ++nDirectives; } );
+
+		auto directives = m_arena.allocate< Directive >( nDirectives );
+		m_directives = directives;
+		m_numDirectives = nDirectives;
+
+		DocumentBuilder builder( m_arena );
+		manifest.eachDirective( [&]( const Manifest::Directive& directive )
+							   {
+								   builder.directive( directive, *directives++ );
+							   } );
+	}
+
+	ManifestDocument::~ManifestDocument()
+	{}
+
+	Manifest::Directives ManifestDocument::toManifestDirectives() const
+	{
+		Manifest::Directives directives;
+		directives.reserve( size() );
+		for( const auto& directive : *this )
+		{
+			directives.push_back( directive.toManifestDirective() );
+		}
+		return directives;
+	}
+}
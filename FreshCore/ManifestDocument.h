@@ -0,0 +1,148 @@
+//
+//  ManifestDocument.h
+//  Fresh
+//
+
+#ifndef Fresh_ManifestDocument_h
+#define Fresh_ManifestDocument_h
+
+#include "FreshManifest.h"
+#include "Arena.h"
+#include <string_view>
+
+namespace fr
+{
+	class MemoryMappedFile;
+
+	// ManifestDocument is a compact, read-only alternative to the Manifest DOM.
+	// Every node lives in an arena owned by the document, strings are views, and maps are flat arrays sorted by key.
+	// A document built from a compiled manifest views the strings in the mapped file itself, so loading copies no text.
+	// Nodes are trivially destructible: destroying the document frees its arena and unmaps its file, and that is all.
+	//
+	// Consumers written against Manifest can use the toManifest...() adapters, which build the classic DOM for one subtree.
+	//
+	class ManifestDocument
+	{
+	public:
+
+		typedef std::string_view String;
+
+		struct Map;
+		struct Array;
+		struct Object;
+
+		struct Value
+		{
+			Manifest::Value::Type type = Manifest::Value::Type::String;
+			String string;						// Valid iff type == String.
+			const void* node = nullptr;			// The Map, Array or Object for those types.
+			bool present = false;				// False for a missing value (a null Manifest::Value pointer).
+
+			explicit operator bool() const				{ return present; }
+			bool isString() const						{ return type == Manifest::Value::Type::String; }
+			bool isMap() const							{ return type == Manifest::Value::Type::Map; }
+			bool isArray() const						{ return type == Manifest::Value::Type::Array; }
+			bool isObject() const						{ return type == Manifest::Value::Type::Object; }
+
+			const Map& map() const						{ ASSERT( isMap() ); return *static_cast< const Map* >( node ); }
+			const Array& array() const					{ ASSERT( isArray() ); return *static_cast< const Array* >( node ); }
+			const Object& object() const				{ ASSERT( isObject() ); return *static_cast< const Object* >( node ); }
+
+			std::shared_ptr< Manifest::Value > toManifestValue() const;
+			// Returns null if !present.
+		};
+
+		struct MapEntry
+		{
+			String key;
+			Value value;
+			const String* attributes = nullptr;
+			size_t numAttributes = 0;
+		};
+
+		struct Map
+		{
+			const MapEntry* entries = nullptr;
+			size_t count = 0;
+
+			const MapEntry* begin() const				{ return entries; }
+			const MapEntry* end() const					{ return entries + count; }
+			size_t size() const							{ return count; }
+			bool empty() const							{ return count == 0; }
+
+			const MapEntry* find( String key ) const;
+			// Binary search. Returns null if there is no such key.
+
+			std::shared_ptr< Manifest::Map > toManifestMap() const;
+		};
+
+		struct Array
+		{
+			const Value* elements = nullptr;
+			size_t count = 0;
+
+			const Value* begin() const					{ return elements; }
+			const Value* end() const					{ return elements + count; }
+			size_t size() const							{ return count; }
+			const Value& operator[]( size_t i ) const	{ ASSERT( i < count ); return elements[ i ]; }
+
+			std::shared_ptr< Manifest::Array > toManifestArray() const;
+		};
+
+		struct Object
+		{
+			String name;
+			String className;
+			const Map* map = nullptr;			// May be null.
+
+			std::shared_ptr< Manifest::Object > toManifestObject() const;
+		};
+
+		struct Directive
+		{
+			Manifest::Directive::Kind kind = Manifest::Directive::Kind::Const;
+			String name;
+			String type;						// Const type, or Object class name.
+			String value;						// Const value.
+			const String* baseClassNames = nullptr;
+			size_t numBaseClassNames = 0;		// Class base class names.
+			const Map* map = nullptr;			// Object or Class map. May be null.
+
+			std::shared_ptr< Manifest::Directive > toManifestDirective() const;
+		};
+
+		ManifestDocument();
+
+		explicit ManifestDocument( const path& compiledPath );
+		// Maps the compiled manifest at compiledPath and builds the document over it. Throws FreshException on failure.
+
+		explicit ManifestDocument( const Manifest& manifest );
+		// Copies the manifest's strings into the arena.
+		
+		// Either way the arena's first block is sized to hold the whole document, so building it allocates once.
+
+		~ManifestDocument();
+
+		const Directive* begin() const					{ return m_directives; }
+		const Directive* end() const					{ return m_directives + m_numDirectives; }
+		size_t size() const								{ return m_numDirectives; }
+
+		Manifest::Directives toManifestDirectives() const;
+
+		const Arena& arena() const						{ return m_arena; }
+
+	private:
+
+		std::unique_ptr< MemoryMappedFile > m_file;		// Declared before m_arena, whose first block is sized from the file.
+		Arena m_arena;
+		const Directive* m_directives = nullptr;
+		size_t m_numDirectives = 0;
+
+		static size_t compiledDocumentBytes( const unsigned char* data, size_t size, const path& source );
+		void buildFromCompiled( const unsigned char* data, size_t size, const path& source );
+
+		FRESH_PREVENT_COPYING( ManifestDocument )
+	};
+}
+
+#endif
@@ -0,0 +1,117 @@
+//
+//  MemoryMappedFile.cpp
+//  Fresh
+//
+
+#include "MemoryMappedFile.h"
+#include "FreshException.h"
+
+#ifndef _WIN32
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <fcntl.h>
+#	include <unistd.h>
+#endif
+
+namespace fr
+{
+#ifdef _WIN32
+
+	MemoryMappedFile::MemoryMappedFile( const path& filePath )
+	{
+		m_file = ::CreateFileA( filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+		if( m_file == INVALID_HANDLE_VALUE )
+		{
+			FRESH_THROW( FreshException, "Could not open '" << filePath << "' for mapping." );
+		}
+
+		LARGE_INTEGER fileSize;
+		if( !::GetFileSizeEx( m_file, &fileSize ))
+		{
+			::CloseHandle( m_file );
+			FRESH_THROW( FreshException, "Could not determine the size of '" << filePath << "'." );
+		}
+		m_size = static_cast< size_t >( fileSize.QuadPart );
+
+		if( m_size == 0 )
+		{
+			return;		// Windows refuses to map empty files. Leave data() null.
+		}
+
+		m_mapping = ::CreateFileMappingA( m_file, NULL, PAGE_READONLY, 0, 0, NULL );
+		if( m_mapping )
+		{
+			m_data = static_cast< const unsigned char* >( ::MapViewOfFile( m_mapping, FILE_MAP_READ, 0, 0, 0 ));
+		}
+
+		if( !m_data )
+		{
+			if( m_mapping )
+			{
+				::CloseHandle( m_mapping );
+			}
+			::CloseHandle( m_file );
+			FRESH_THROW( FreshException, "Could not map '" << filePath << "'." );
+		}
+	}
+
+	MemoryMappedFile::~MemoryMappedFile()
+	{
+		if( m_data )
+		{
+			::UnmapViewOfFile( m_data );
+		}
+		if( m_mapping )
+		{
+			::CloseHandle( m_mapping );
+		}
+		if( m_file != INVALID_HANDLE_VALUE )
+		{
+			::CloseHandle( m_file );
+		}
+	}
+
+#else
+
+	MemoryMappedFile::MemoryMappedFile( const path& filePath )
+	{
+		const int fileDescriptor = ::open( filePath.c_str(), O_RDONLY );
+		if( fileDescriptor < 0 )
+		{
+			FRESH_THROW( FreshException, "Could not open '" << filePath << "' for mapping." );
+		}
+
+		struct stat status;
+		if( ::fstat( fileDescriptor, &status ) != 0 )
+		{
+			::close( fileDescriptor );
+			FRESH_THROW( FreshException, "Could not determine the size of '" << filePath << "'." );
+		}
+		m_size = static_cast< size_t >( status.st_size );
+
+		if( m_size > 0 )
+		{
+			void* mapped = ::mmap( nullptr, m_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0 );
+			if( mapped == MAP_FAILED )
+			{
+				::close( fileDescriptor );
+				FRESH_THROW( FreshException, "Could not map '" << filePath << "'." );
+			}
+			m_data = static_cast< const unsigned char* >( mapped );
+		}
+
+		// The mapping keeps its own reference to the file.
+		//
+		::close( fileDescriptor );
+	}
+
+	MemoryMappedFile::~MemoryMappedFile()
+	{
+		if( m_data )
+		{
+			::munmap( const_cast< unsigned char* >( m_data ), m_size );
+		}
+	}
+
+#endif
+}
@@ -0,0 +1,41 @@
+//
+//  MemoryMappedFile.h
+//  Fresh
+//
+
+#ifndef Fresh_MemoryMappedFile_h
+#define Fresh_MemoryMappedFile_h
+
+#include "FreshEssentials.h"
+#include "FreshPath.h"
+
+namespace fr
+{
+	// Maps a whole file read-only into memory for the lifetime of the object.
+	// Throws FreshException if the file cannot be opened or mapped.
+	//
+	class MemoryMappedFile
+	{
+	public:
+
+		explicit MemoryMappedFile( const path& filePath );
+		~MemoryMappedFile();
+
+		const unsigned char* data() const		{ return m_data; }
+		size_t size() const						{ return m_size; }
+
+	private:
+
+		const unsigned char* m_data = nullptr;
+		size_t m_size = 0;
+
+#ifdef _WIN32
+		HANDLE m_file = INVALID_HANDLE_VALUE;
+		HANDLE m_mapping = NULL;
+#endif
+
+		FRESH_PREVENT_COPYING( MemoryMappedFile )
+	};
+}
+
+#endif
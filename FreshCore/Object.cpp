@@ -3,8 +3,10 @@
 #include "Classes.h"
 #include "CommandProcessor.h"
 #include "ObjectLinker.h"
+#include "ObjectPool.h"
 #include "ObjectStreamFormatter.h"
 #include "Property.h"
+#include "Package.h"
 #include <ctime>
 
 #define TRACE_LOADING 0
@@ -57,13 +59,13 @@ namespace fr
 		getLoadingObjects().pop_back();
 	}
 	
-	Object::Name parseObjectName( Object::NameRef name )
+	Object::Name parseObjectName( const std::string& name )
 	{
 		// Go through the name looking for the '$^' substring, replacing it with the current loading object's name.
 		
 		// Find dollar signs in the name.
 		//
-		Object::Name amendedName( name );
+		std::string amendedName( name );
 		size_t dollarPos = 0;
 		while( true )
 		{
@@ -113,7 +115,7 @@ namespace fr
 					// Erase the "$^..." substring
 					//
 					amendedName.erase( dollarPos, symbolEndPos - dollarPos );
-					amendedName.insert( dollarPos, parentName );
+					amendedName.insert( dollarPos, parentName.str() );
 					dollarPos += parentName.size();
 				}
 			}
@@ -153,6 +155,7 @@ namespace fr
 		}
 		
 		++s_nObjectsCreated;
+		m_classInfo->onInstanceCreated();
 	}
 
 	Object::Object( CreateInertObject c )
@@ -163,6 +166,11 @@ namespace fr
 	{
 		ASSERT( m_nReferences == 0 );
 
+		if( m_classInfo && !isReflectionShuttingDown() )
+		{
+			m_classInfo->onInstanceDestroyed();
+		}
+
 		// Tell the fixup system to nevermind.
 		//
 		if( ObjectLinker::doesExist() )
@@ -177,6 +185,13 @@ namespace fr
 		}
 	}
 
+	void Object::assignClassInfo( const ClassInfo& ci )
+	{
+		ASSERT( !m_classInfo );
+		m_classInfo = &ci;
+		m_classInfo->onInstanceCreated();
+	}
+
 	void Object::rename( NameRef newName )
 	{
 		m_name = newName;
@@ -184,6 +199,8 @@ namespace fr
 		{
 			createDefaultName( m_name );
 		}
+		
+		Package::onObjectRenamed( *this );
 	}
 	
 	ClassNameRef Object::className() const
@@ -281,7 +298,14 @@ namespace fr
 		{
 			// Time to delete me.
 			//
-			::delete this;
+			if( m_isPooled )
+			{
+				ObjectPool::destroy( *this );
+			}
+			else
+			{
+				::delete this;
+			}
 			
 			return 0;
 		}
@@ -289,7 +313,7 @@ namespace fr
 		return m_nReferences;
 	}
 
-	void Object::createDefaultName( std::string& outName )
+	void Object::createDefaultName( Name& outName )
 	{
 		// Choose a unique name for this object.
 		//
@@ -297,7 +321,7 @@ namespace fr
 		std::ostringstream ss;
 		
 		ss << s_nObjectsCreated;
-		outName = ss.str();
+		std::string name = ss.str();
 		
 		if( s_useTimeCodedDefaultNames )
 		{
@@ -305,11 +329,12 @@ namespace fr
 			
 			while( theTime > 0 )
 			{
-				outName += 'a' + ( theTime & 0xF );		// Code in the least significant 4 bits.
+				name += 'a' + ( theTime & 0xF );		// Code in the least significant 4 bits.
 				theTime >>= 4;							// Chop off the least significant 4 bits.
 			}
 		}
 		
+		outName = std::move( name );
 	}
 	
 	void Object::load( const Manifest::Map& properties )
@@ -354,6 +379,53 @@ namespace fr
 		
 		trace_loading( "Done loading " << this );
 	}
+	
+	void Object::load( const ManifestDocument::Map& properties )
+	{
+		TIMER_AUTO( Object::load( ManifestDocument::Map ))
+		
+		trace_loading( "Loading " << this );
+		
+		checkDebugBreakpoint( "load", *this )
+		
+		const ClassInfo& myClassInfo = classInfo();
+		
+		pushCurrentLoadingObject( this );
+		
+		for( const auto& entry : properties )
+		{
+			if( entry.key == "passthrough" )
+			{
+				continue;
+			}
+			
+			auto property = myClassInfo.getPropertyByName( entry.key );
+			
+			if( !property )
+			{
+				dev_warning( "While loading " << objectId() << ", found an unrecognized property '" << entry.key << "'." );
+			}
+			else if(( !isInert() || property->shouldLoadDefaults() ) && entry.value )
+			{
+				// Strings, by far the common case, are parsed directly. Wrapping them in a temporary Manifest::Value
+				// would have the property remember the parsed value on a node that is about to die, parsing it twice
+				// and allocating to do so. Structured values are converted on demand.
+				//
+				if( entry.value.isString() )
+				{
+					property->setValueByString( this, std::string( entry.value.string ));
+				}
+				else
+				{
+					property->setValueByManifestValue( this, *entry.value.toManifestValue() );
+				}
+				trace_loading( "Assigned property '" << entry.key << "' to " << property->getValueByString( this ));
+			}
+		}
+		popCurrentLoadingObject();
+		
+		trace_loading( "Done loading " << this );
+	}
 
 	void Object::serialize( ObjectStreamFormatter& formatter, bool doWriteEvenIfDefault ) const
 	{
@@ -383,29 +455,35 @@ namespace fr
 	
 	Object::ptr Object::createClone( NameRef objectName ) const
 	{
-#if	0		// TODO: Reinstate eventually...?
+		TIMER_AUTO( Object::createClone )
 		
-		// Serialize properties.
+		// Copy property values straight across, as serializing and reloading would but without the text.
 		//
-		std::ostringstream out;
-		Stringifier stringifier( out );
-		ObjectStreamFormatterXml formatter( stringifier );
-		serialize( formatter );
-		
-		std::unique_ptr< XmlElement > xmlElement = stringToXmlElement( out.str() );
+		const ClassInfo& myClassInfo = classInfo();
 		
-		// Create a copy.
-		//
-		auto copy = createObject( *xmlElement );
+		auto copy = myClassInfo.factory().createObject( myClassInfo, objectName );
 		ASSERT( copy );
 		
-		// Rename it.
-		//
-		copy->rename( objectName );
-
+		copy->cloneProperties( *this );
+		
+		copy->postLoad();
+		copy->onAllLoaded();
+		
 		return copy;
-#endif
-		return nullptr;
+	}
+	
+	void Object::cloneProperties( const Object& original )
+	{
+		REQUIRES( &original.classInfo() == &classInfo() );
+		
+		for( const auto prop : classInfo().getFlattenedProperties() )
+		{
+			if( !prop->isTransient() &&							// Transient properties are not part of an object's saved state.
+			   ( !original.shallow() || !prop->deep() ))		// Shallow objects do not carry pointers.
+			{
+				prop->cloneValue( this, &original );
+			}
+		}
 	}
 	
 	void Object::postLoad()
@@ -14,6 +14,7 @@
 #include "ObjectPtr.h"
 #include "ObjectId.h"
 #include "FreshManifest.h"
+#include "ManifestDocument.h"
 
 // For each non-abstract Object-derived class (derived directly or indirectly), invoke this macro at the bottom of the class's declaration.
 // You must also invoke the FRESH_DEFINE_CLASS() macro. See below.
@@ -185,17 +186,25 @@ namespace fr
 		//
 		SYNTHESIZE( bool, shallow )		// Shallow objects do not save pointers to objects.
 		virtual void load( const Manifest::Map& properties );
+		virtual void load( const ManifestDocument::Map& properties );
+		// Loads straight from a ManifestDocument map. Classes that override load( Manifest::Map ) should override this
+		// too, typically by forwarding properties.toManifestMap().
 		virtual void serialize( class ObjectStreamFormatter& formatter, bool doWriteEvenIfDefault = false ) const;
 
 		virtual Object::ptr createClone( NameRef objectName = fr::DEFAULT_OBJECT_NAME ) const;
+		// Objects this one holds by SmartPtr are cloned along with it, unless they are shared resources.
+		
+		virtual bool isSharedResource() const					{ return false; }
+		// Shared resources (e.g. assets) are referred to, not owned: clones of their referrers share them.
 		
 		//
 		// INTERNALS. You really shouldn't care.
 		//
-		static void createDefaultName( std::string& outName );
+		static void createDefaultName( Name& outName );
 		static void useTimeCodedDefaultNames( bool use )		{ s_useTimeCodedDefaultNames = use; }
 		
-		SmartPtr< WeakPtrProxy > getWeakPtrProxy()	const		{ ASSERT( m_weakPtrProxy ); return m_weakPtrProxy; }
+		SmartPtr< WeakPtrProxy > getWeakPtrProxy()	const;
+		// Creates the proxy on first use.
 		
 		bool isInert() const									{ return m_isInert; }
 
@@ -217,12 +226,16 @@ namespace fr
 		
 	protected:
 
+		virtual void cloneProperties( const Object& original );
+		// Called on a new clone of original, before postLoad(). Copies every saved property.
+		// Override to leave out state that belongs to the original alone, such as links to its owner.
+
 		explicit Object( const ClassInfo& assignedClassInfo, NameRef objectName = DEFAULT_OBJECT_NAME );
 		explicit Object( CreateInertObject );
 
 		virtual ~Object();
 		
-		void assignClassInfo( const ClassInfo& ci )				{ ASSERT( !m_classInfo ); m_classInfo = &ci; }
+		void assignClassInfo( const ClassInfo& ci );
 
 	private:
 
@@ -231,10 +244,13 @@ namespace fr
 		
 		bool m_isInert = false;
 		bool m_shallow = false;
+		bool m_isPooled = false;		// Memory belongs to an ObjectPool.
 
 		mutable int m_nReferences = 0;
 		
-		SmartPtr< WeakPtrProxy > m_weakPtrProxy = new WeakPtrProxy();
+		// Most objects are never weakly referenced, so the proxy is only allocated when the first WeakPtr to this object is made.
+		//
+		mutable SmartPtr< WeakPtrProxy > m_weakPtrProxy;
 		
 		static size_t s_nObjectsCreated;
 		static bool s_useTimeCodedDefaultNames;
@@ -244,6 +260,7 @@ namespace fr
 		FRESH_PREVENT_COPYING( Object )
 
 		friend class ClassInfo;
+		friend class ObjectPool;
 		template< typename T > friend class ObjectFactory;
 	};
 	
@@ -268,7 +285,7 @@ namespace fr
 	void pushCurrentLoadingObject( Object::ptr object );
 	void popCurrentLoadingObject();
 
-	Object::Name parseObjectName( Object::NameRef name );
+	Object::Name parseObjectName( const std::string& name );
 	
 } //	END namespace fr
 
@@ -33,6 +33,15 @@ namespace fr
 		ASSERT( m_nReferences > 0 );
 	}
 
+	ALWAYS_INLINE SmartPtr< WeakPtrProxy > Object::getWeakPtrProxy() const
+	{
+		if( !m_weakPtrProxy )
+		{
+			m_weakPtrProxy = new WeakPtrProxy();
+		}
+		return m_weakPtrProxy;
+	}
+
 	inline std::ostream& operator<<( std::ostream& out, const Object* obj )
 	{
 		if( obj )
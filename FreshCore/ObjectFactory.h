@@ -12,6 +12,8 @@
 #include "FreshEssentials.h"
 #include "SmartPtr.h"
 #include "Profiler.h"
+#include "ObjectPool.h"
+#include <new>
 
 namespace fr
 {
@@ -31,6 +33,9 @@ namespace fr
 		virtual SmartPtr< Object > createInertObject( const ClassInfo& classInfo ) const = 0;
 
 		virtual ObjectFactoryBase* createFactoryClone() const = 0;
+
+		virtual size_t objectSize() const = 0;
+		virtual size_t objectAlignment() const = 0;
 	};
 	
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -47,6 +52,9 @@ namespace fr
 		virtual SmartPtr< Object > createInertObject( const ClassInfo& classInfo ) const override;
 		
 		virtual ObjectFactoryBase* createFactoryClone() const override;
+
+		virtual size_t objectSize() const override					{ return sizeof( T ); }
+		virtual size_t objectAlignment() const override				{ return alignof( T ); }
 		
 		SmartPtr< T > createObjectOfExactClass( const ClassInfo& classInfo, ObjectNameRef objectName ) const;
 
@@ -72,6 +80,24 @@ namespace fr
 	SmartPtr< T > ObjectFactory< T >::createObjectOfExactClass( const ClassInfo& classInfo, ObjectNameRef objectName ) const
 	{
 		TIMER_AUTO( ObjectFactory< T >::createObjectOfExactClass )
+
+		if( const auto pool = getObjectPool( classInfo ))
+		{
+			void* memory = pool->allocate();
+			T* object;
+			try
+			{
+				object = new( memory ) T( classInfo, objectName );
+			}
+			catch( ... )
+			{
+				pool->free( memory );
+				throw;
+			}
+			pool->adopt( *object );
+			return object;
+		}
+
 		return new T( classInfo, objectName );
 	}
 	
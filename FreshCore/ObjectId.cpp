@@ -48,11 +48,11 @@ namespace fr
 			if( iNextTick != std::string::npos )
 			{
 				m_className = objectIdStringForm.substr( 0, iFirstTick );
-				m_objectName = objectIdStringForm.substr( iFirstTick + 1, iNextTick - ( iFirstTick + 1 ));
+				std::string objectName = objectIdStringForm.substr( iFirstTick + 1, iNextTick - ( iFirstTick + 1 ));
 
-				divideObjectNameToObjectAndPackageName( m_objectName, m_packageName );
+				divideObjectNameToObjectAndPackageName( objectName, m_packageName );
 				
-				m_objectName = parseObjectName( m_objectName );
+				m_objectName = parseObjectName( objectName );
 			}
 			else
 			{
@@ -67,12 +67,12 @@ namespace fr
 		}
 	}
 
-	ObjectId::ObjectId( const StringTabulated& className, const std::string& objectName )
+	ObjectId::ObjectId( const StringTabulated& className, const Symbol& objectName )
 	:	m_className( className )
 	,	m_objectName( parseObjectName( objectName ))
 	{}
 	
-	ObjectId::ObjectId( const std::string& packageName, const StringTabulated& className, const std::string& objectName )
+	ObjectId::ObjectId( const std::string& packageName, const StringTabulated& className, const Symbol& objectName )
 	:	m_packageName( packageName )
 	,	m_className( className )
 	,	m_objectName( parseObjectName( objectName ))
@@ -80,16 +80,27 @@ namespace fr
 
 	ObjectId::ObjectId( const Manifest::Object& element )
 	{
-		m_className = element.className;
+		assignElement( element.className, element.name() );
+	}
+	
+	ObjectId::ObjectId( const ManifestDocument::Directive& element )
+	{
+		REQUIRES( element.kind == Manifest::Directive::Kind::Object );
+		assignElement( std::string( element.type ), std::string( element.name ));
+	}
+	
+	void ObjectId::assignElement( const std::string& className, const std::string& elementName )
+	{
+		m_className = className;
 		
 		// Assign the object name.
 		//
-		if( !element.name().empty() )
+		if( !elementName.empty() )
 		{
-			m_objectName = element.name();
+			std::string objectName = elementName;
 			
-			divideObjectNameToObjectAndPackageName( m_objectName, m_packageName );
-			m_objectName = parseObjectName( m_objectName );				
+			divideObjectNameToObjectAndPackageName( objectName, m_packageName );
+			m_objectName = parseObjectName( objectName );
 		}
 		else
 		{
@@ -122,7 +133,7 @@ namespace fr
 		return m_className;
 	}
 
-	const std::string& ObjectId::objectName() const
+	const Symbol& ObjectId::objectName() const
 	{
 		return m_objectName;
 	}
@@ -175,10 +186,11 @@ namespace fr
 				{
 					in.get();
 				}
-				fr::getline( in, outId.m_objectName, '\'' );
+				std::string objectName;
+				fr::getline( in, objectName, '\'' );
 				
-				divideObjectNameToObjectAndPackageName( outId.m_objectName, outId.m_packageName );
-				outId.m_objectName = parseObjectName( outId.m_objectName );
+				divideObjectNameToObjectAndPackageName( objectName, outId.m_packageName );
+				outId.m_objectName = parseObjectName( objectName );
 			}
 			
 			outId.m_className = std::move( strClassName );
@@ -11,7 +11,9 @@
 #define FRESH_OBJECT_ID_H_INCLUDED
 
 #include "StringTabulated.h"
+#include "Symbol.h"
 #include "FreshManifest.h"
+#include "ManifestDocument.h"
 #include <string>
 #include <iostream>
 
@@ -31,9 +33,10 @@ namespace fr
 
 		ObjectId() {}
 		explicit ObjectId( const std::string& objectIdStringForm );
-		ObjectId( const StringTabulated& className, const std::string& objectName );	// Blank package name.
-		ObjectId( const std::string& packageName, const StringTabulated& className, const std::string& objectName );
+		ObjectId( const StringTabulated& className, const Symbol& objectName );	// Blank package name.
+		ObjectId( const std::string& packageName, const StringTabulated& className, const Symbol& objectName );
 		explicit ObjectId( const Manifest::Object& element );
+		explicit ObjectId( const ManifestDocument::Directive& element );		// An object directive.
 
 		explicit operator std::string() const;
 		
@@ -46,7 +49,7 @@ namespace fr
 		
 		const std::string& packageName() const;
 		const StringTabulated& className() const;
-		const std::string& objectName() const;
+		const Symbol& objectName() const;
 		
 		bool operator==( const ObjectId& other ) const;
 		bool operator!=( const ObjectId& other ) const;
@@ -58,7 +61,9 @@ namespace fr
 		
 		std::string m_packageName;
 		StringTabulated m_className;
-		std::string m_objectName;
+		Symbol m_objectName;
+		
+		void assignElement( const std::string& className, const std::string& elementName );
 			
 		friend std::istream& operator>>( std::istream& in, ObjectId& outId );
 		friend std::ostream& operator<<( std::ostream& out, const ObjectId& id );
@@ -0,0 +1,239 @@
+//
+//  ObjectPool.cpp
+//  Fresh
+//
+
+#include "ObjectPool.h"
+#include "Object.h"
+#include "FreshException.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+
+#ifdef _WIN32
+#	include <malloc.h>
+#endif
+
+namespace
+{
+	using namespace fr;
+
+	// A slab must hold at least this many objects, or pooling them isn't worth a slab.
+	//
+	const size_t MIN_SLOTS_PER_SLAB = 8;
+
+	// How many freed slots a debugging pool holds back from reuse.
+	//
+	const size_t QUARANTINE_LENGTH = 1024;
+
+	const unsigned char POISON = 0xDB;
+
+	inline size_t roundUp( size_t n, size_t multiple )
+	{
+		return ( n + multiple - 1 ) / multiple * multiple;
+	}
+
+	// Pools must survive static destruction, since objects may be released during it.
+	//
+	std::mutex& poolsMutex()
+	{
+		static std::mutex* mutex = new std::mutex;
+		return *mutex;
+	}
+
+	std::vector< ObjectPool* >& pools()
+	{
+		static std::vector< ObjectPool* >* thePools = new std::vector< ObjectPool* >;
+		return *thePools;
+	}
+
+	// Slabs are kept for the life of the process, so there is no matching free.
+	// std::aligned_alloc isn't available everywhere (MSVC lacks it), so use each platform's own.
+	//
+	void* allocateAligned( size_t bytes, size_t alignment )
+	{
+#ifdef _WIN32
+		return _aligned_malloc( bytes, alignment );
+#else
+		void* memory = nullptr;
+		return ::posix_memalign( &memory, alignment, bytes ) == 0 ? memory : nullptr;
+#endif
+	}
+}
+
+namespace fr
+{
+	ObjectPool& ObjectPool::create( ClassNameRef className, size_t objectSize, size_t objectAlignment )
+	{
+		REQUIRES( objectSize > 0 );
+		REQUIRES( objectAlignment > 0 );
+
+		const size_t slotSize = roundUp( std::max( objectSize, sizeof( FreeSlot )), std::max( objectAlignment, alignof( FreeSlot )));
+		const size_t firstSlotOffset = roundUp( sizeof( SlabHeader ), std::max( objectAlignment, alignof( FreeSlot )));
+
+		if( objectAlignment > SLAB_BYTES || firstSlotOffset + slotSize * MIN_SLOTS_PER_SLAB > SLAB_BYTES )
+		{
+			FRESH_THROW( FreshException, "Objects of class " << className << " (" << objectSize << " bytes) are too large to pool." );
+		}
+
+		auto pool = new ObjectPool( className, objectSize, slotSize, firstSlotOffset );
+
+		std::lock_guard< std::mutex > lock( poolsMutex() );
+		pools().push_back( pool );
+		return *pool;
+	}
+
+	void ObjectPool::forEachPool( const std::function< void( const ObjectPool& ) >& fn )
+	{
+		std::lock_guard< std::mutex > lock( poolsMutex() );
+		for( const auto pool : pools() )
+		{
+			fn( *pool );
+		}
+	}
+
+	ObjectPool::ObjectPool( ClassNameRef className, size_t objectSize, size_t slotSize, size_t firstSlotOffset )
+	:	m_className( className )
+	,	m_objectSize( objectSize )
+	,	m_slotSize( slotSize )
+	,	m_firstSlotOffset( firstSlotOffset )
+	,	m_nSlotsPerSlab(( SLAB_BYTES - firstSlotOffset ) / slotSize )
+	{}
+
+	void* ObjectPool::allocate()
+	{
+		std::lock_guard< std::mutex > lock( m_mutex );
+
+		if( !m_freeSlots )
+		{
+			addSlab();
+		}
+
+		FreeSlot* slot = m_freeSlots;
+		m_freeSlots = slot->next;
+
+		++m_nAllocations;
+		m_nPeak = std::max( m_nPeak, ++m_nLive );
+		return slot;
+	}
+
+	void ObjectPool::adopt( Object& object )
+	{
+		REQUIRES( &poolFor( &object ) == this );
+		object.m_isPooled = true;
+	}
+
+	void ObjectPool::free( void* memory )
+	{
+		REQUIRES( &poolFor( memory ) == this );
+
+		std::lock_guard< std::mutex > lock( m_mutex );
+
+		ASSERT( m_nLive > 0 );
+		--m_nLive;
+
+		if( m_isDebugging )
+		{
+			std::memset( memory, POISON, m_slotSize );
+			m_quarantine.push_back( memory );
+
+			if( m_quarantine.size() > QUARANTINE_LENGTH )
+			{
+				releaseFromQuarantine();
+			}
+		}
+		else
+		{
+			recycle( memory );
+		}
+	}
+
+	void ObjectPool::destroy( const Object& object )
+	{
+		REQUIRES( object.m_isPooled );
+
+		ObjectPool& pool = poolFor( &object );
+
+		// The object may not start its slot if Object isn't its first base.
+		//
+		void* memory = pool.slotFor( &object );
+
+		const_cast< Object& >( object ).~Object();
+		pool.free( memory );
+	}
+
+	void ObjectPool::setDebugging( bool debugging )
+	{
+		std::lock_guard< std::mutex > lock( m_mutex );
+
+		if( !debugging )
+		{
+			while( !m_quarantine.empty() )
+			{
+				releaseFromQuarantine();
+			}
+		}
+
+		m_isDebugging = debugging;
+	}
+
+	ObjectPool& ObjectPool::poolFor( const void* memory )
+	{
+		const auto slab = reinterpret_cast< const SlabHeader* >( reinterpret_cast< uintptr_t >( memory ) & ~uintptr_t( SLAB_BYTES - 1 ));
+		ASSERT( slab->pool );
+		return *slab->pool;
+	}
+
+	void* ObjectPool::slotFor( const void* address ) const
+	{
+		const auto slab = reinterpret_cast< uintptr_t >( address ) & ~uintptr_t( SLAB_BYTES - 1 );
+		const auto offset = reinterpret_cast< uintptr_t >( address ) - slab - m_firstSlotOffset;
+		return reinterpret_cast< void* >( slab + m_firstSlotOffset + offset / m_slotSize * m_slotSize );
+	}
+
+	void ObjectPool::addSlab()
+	{
+		auto slab = static_cast< unsigned char* >( allocateAligned( SLAB_BYTES, SLAB_BYTES ));
+		if( !slab )
+		{
+			throw std::bad_alloc();
+		}
+
+		m_slabs.push_back( slab );
+		reinterpret_cast< SlabHeader* >( slab )->pool = this;
+
+		// Thread the slots backward so that allocation proceeds forward through the slab.
+		//
+		for( size_t i = m_nSlotsPerSlab; i > 0; --i )
+		{
+			recycle( slab + m_firstSlotOffset + ( i - 1 ) * m_slotSize );
+		}
+	}
+
+	void ObjectPool::recycle( void* memory )
+	{
+		const auto slot = static_cast< FreeSlot* >( memory );
+		slot->next = m_freeSlots;
+		m_freeSlots = slot;
+	}
+
+	void ObjectPool::releaseFromQuarantine()
+	{
+		ASSERT( !m_quarantine.empty() );
+
+		const auto memory = static_cast< const unsigned char* >( m_quarantine.front() );
+		m_quarantine.pop_front();
+
+		for( size_t i = 0; i < m_slotSize; ++i )
+		{
+			if( memory[ i ] != POISON )
+			{
+				release_error( "Pooled " << m_className << " at " << static_cast< const void* >( memory ) << " was written to " << i << " bytes in, after it was destroyed." );
+				break;
+			}
+		}
+
+		recycle( const_cast< unsigned char* >( memory ));
+	}
+}
@@ -0,0 +1,116 @@
+//
+//  ObjectPool.h
+//  Fresh
+//
+
+#ifndef Fresh_ObjectPool_h
+#define Fresh_ObjectPool_h
+
+#include "FreshEssentials.h"
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace fr
+{
+	class Object;
+	class ClassInfo;
+
+	// ObjectPool is a slab allocator for the instances of one class. Classes opt in with ClassInfo::useObjectPool(),
+	// after which the class's factory takes memory for new objects from its pool rather than from the general heap,
+	// and Object::release() hands the memory back.
+	//
+	// Memory comes in SLAB_BYTES slabs aligned to their own size, each headed by a pointer to its pool,
+	// so a pooled object finds its pool from its own address. Freed slots are reused most-recent first.
+	// Slabs are kept for the life of the pool; bytesReserved() shows how much that is.
+	//
+	// In debugging mode a freed slot is filled with a poison pattern and held in quarantine for a while before reuse.
+	// When it leaves quarantine the pool checks that the poison is intact and reports a use-after-free if it isn't.
+	// That is the only detection: reads of a freed object, and writes that happen after its slot is reused, go unnoticed.
+	//
+	// Pools are never destroyed: objects may outlive the ClassInfo that made them.
+	//
+	class ObjectPool
+	{
+	public:
+
+		static const size_t SLAB_BYTES = 64 * 1024;
+
+		static ObjectPool& create( ClassNameRef className, size_t objectSize, size_t objectAlignment );
+		// Throws a FreshException if objects of this size are too big to pool.
+
+		static void forEachPool( const std::function< void( const ObjectPool& ) >& fn );
+
+		void* allocate();
+		// Returns uninitialized memory for one object.
+
+		void adopt( Object& object );
+		// REQUIRES( object was constructed in memory from allocate() );
+		// Marks the object so that its release() returns it to this pool.
+
+		void free( void* memory );
+		// REQUIRES( memory came from allocate() and no object lives in it );
+
+		static void destroy( const Object& object );
+		// REQUIRES( object was adopted by some pool );
+		// Destroys the object and frees its memory back to its pool. Called by Object::release().
+
+		void setDebugging( bool debugging );
+		bool isDebugging() const									{ return m_isDebugging; }
+
+		ClassNameRef className() const								{ return m_className; }
+		size_t objectSize() const									{ return m_objectSize; }
+		size_t slotSize() const										{ return m_slotSize; }
+		size_t nLive() const										{ return m_nLive; }
+		size_t nPeak() const										{ return m_nPeak; }
+		size_t nAllocations() const									{ return m_nAllocations; }
+		size_t nSlabs() const										{ return m_slabs.size(); }
+		size_t bytesLive() const									{ return m_nLive * m_slotSize; }
+		size_t bytesReserved() const								{ return m_slabs.size() * SLAB_BYTES; }
+
+	private:
+
+		struct SlabHeader
+		{
+			ObjectPool* pool;
+		};
+
+		struct FreeSlot
+		{
+			FreeSlot* next;
+		};
+
+		const ClassName m_className;
+		const size_t m_objectSize;
+		const size_t m_slotSize;
+		const size_t m_firstSlotOffset;
+		const size_t m_nSlotsPerSlab;
+
+		mutable std::mutex m_mutex;
+		std::vector< void* > m_slabs;
+		FreeSlot* m_freeSlots = nullptr;
+		size_t m_nLive = 0;
+		size_t m_nPeak = 0;
+		size_t m_nAllocations = 0;
+
+		bool m_isDebugging = false;
+		std::deque< void* > m_quarantine;
+
+		ObjectPool( ClassNameRef className, size_t objectSize, size_t slotSize, size_t firstSlotOffset );
+
+		static ObjectPool& poolFor( const void* memory );
+		void* slotFor( const void* address ) const;
+
+		void addSlab();
+		void recycle( void* memory );
+		void releaseFromQuarantine();
+
+		FRESH_PREVENT_COPYING( ObjectPool )
+	};
+
+	ObjectPool* getObjectPool( const ClassInfo& classInfo );
+	// For ObjectFactory, which can't see ClassInfo's definition. Returns null if the class doesn't pool its objects.
+}
+
+#endif
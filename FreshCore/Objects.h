@@ -46,6 +46,14 @@ namespace fr
 	template< typename return_t = Object >
 	SmartPtr< return_t > createObject( const ObjectId& objectId, const Manifest::Map* properties = nullptr );
 	
+	// As above, initialized from a ManifestDocument map rather than a Manifest map.
+	template< typename return_t >
+	SmartPtr< return_t > createObject( SmartPtr< Package > package, const ClassInfo& desiredBase, ObjectNameRef objectName, const ManifestDocument::Map& properties );
+	// REQUIRES( classInfo.isKindOf( return_t::StaticGetClassInfo() ));
+
+	template< typename return_t = Object >
+	SmartPtr< return_t > createObject( const ObjectId& objectId, const ManifestDocument::Map& properties );
+	
 	//////////////////////////////////////////////////////////////
 	// Accessing objects
 	
@@ -84,6 +92,10 @@ namespace fr
 	template< typename return_t = Object >
 	SmartPtr< return_t > createOrGetObject( const Manifest::Object& initialization, bool applyElementIfGet = true );
 	
+	// As createOrGetObject( ObjectId, ... ), initialized from a ManifestDocument map.
+	template< typename return_t = Object >
+	SmartPtr< return_t > createOrGetObject( const ObjectId& objectId, const ManifestDocument::Map& properties, bool applyElementIfGet = true );
+	
 	//////////////////////////////////////////////////////////////
 	// isObject()
 	// Returns true iff the given pointer points to a real object
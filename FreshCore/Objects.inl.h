@@ -16,11 +16,11 @@
 
 namespace fr
 {	
-	template< typename return_t >
-	SmartPtr< return_t > createObject( Package::ptr package, const ClassInfo& desiredBase, ObjectNameRef objectName, const Manifest::Map* properties )
+	// The create functions below work alike for either kind of properties map.
+	//
+	template< typename return_t, typename PropertiesMapT >
+	SmartPtr< return_t > createObject_implementation( Package::ptr package, const ClassInfo& desiredBase, ObjectNameRef objectName, const PropertiesMapT* properties )
 	{
-		TIMER_AUTO( createObject( Package::ptr, const ClassInfo&, ObjectNameRef, const Manifest::Object* ))
-
 		ASSERT( &desiredBase );
 		
 		typedef SmartPtr< return_t > ptr_t;
@@ -104,17 +104,29 @@ namespace fr
 		return result;
 	}
 
+	template< typename return_t >
+	SmartPtr< return_t > createObject( Package::ptr package, const ClassInfo& desiredBase, ObjectNameRef objectName, const Manifest::Map* properties )
+	{
+		TIMER_AUTO( createObject( Package::ptr, const ClassInfo&, ObjectNameRef, const Manifest::Object* ))
+		return createObject_implementation< return_t >( package, desiredBase, objectName, properties );
+	}
+
+	template< typename return_t >
+	SmartPtr< return_t > createObject( Package::ptr package, const ClassInfo& desiredBase, ObjectNameRef objectName, const ManifestDocument::Map& properties )
+	{
+		TIMER_AUTO( createObject( Package::ptr, const ClassInfo&, ObjectNameRef, const ManifestDocument::Map& ))
+		return createObject_implementation< return_t >( package, desiredBase, objectName, &properties );
+	}
+
 	template< typename return_t >
 	SmartPtr< return_t > createObject( Package& package, ObjectNameRef objectName, const Manifest::Map* properties )
 	{
 		return createObject< return_t >( &package, return_t::StaticGetClassInfo(), objectName, properties );
 	}
 	
-	template< typename return_t >
-	SmartPtr< return_t > createObject( const ObjectId& id, const Manifest::Map* properties )
+	template< typename return_t, typename PropertiesMapT >
+	SmartPtr< return_t > createObjectById_implementation( const ObjectId& id, const PropertiesMapT* properties )
 	{
-		TIMER_AUTO( createObject( const ObjectId&, const Manifest::Object* ))
-		
 		Package::ptr package;
 		if( id.packageName().empty() == false )
 		{
@@ -137,7 +149,21 @@ namespace fr
 			FRESH_THROW( FreshException, "Error creating object " << id << ": Unrecognized class " << id.className() << "." );
 		}
 		
-		return createObject< return_t >( package, *desiredBase, id.objectName(), properties );
+		return createObject_implementation< return_t >( package, *desiredBase, id.objectName(), properties );
+	}
+	
+	template< typename return_t >
+	SmartPtr< return_t > createObject( const ObjectId& id, const Manifest::Map* properties )
+	{
+		TIMER_AUTO( createObject( const ObjectId&, const Manifest::Object* ))
+		return createObjectById_implementation< return_t >( id, properties );
+	}
+	
+	template< typename return_t >
+	SmartPtr< return_t > createObject( const ObjectId& id, const ManifestDocument::Map& properties )
+	{
+		TIMER_AUTO( createObject( const ObjectId&, const ManifestDocument::Map& ))
+		return createObjectById_implementation< return_t >( id, &properties );
 	}
 	
 	template< typename return_t >
@@ -269,8 +295,8 @@ namespace fr
 		return results;
 	}
 	
-	template< typename return_t >
-	SmartPtr< return_t > createOrGetObject( const ObjectId& objectId, const Manifest::Map* properties, bool applyElementIfGet )
+	template< typename return_t, typename PropertiesMapT >
+	SmartPtr< return_t > createOrGetObject_implementation( const ObjectId& objectId, const PropertiesMapT* properties, bool applyElementIfGet )
 	{
 		typedef typename std::remove_const< return_t >::type nonconst_return_t;
 		typedef SmartPtr< nonconst_return_t > ptr_t;
@@ -291,12 +317,24 @@ namespace fr
 		}
 		else
 		{
-			result = createObject< nonconst_return_t >( objectId, properties );
+			result = createObjectById_implementation< nonconst_return_t >( objectId, properties );
 		}
 		
 		return result;
 	}
 	
+	template< typename return_t >
+	SmartPtr< return_t > createOrGetObject( const ObjectId& objectId, const Manifest::Map* properties, bool applyElementIfGet )
+	{
+		return createOrGetObject_implementation< return_t >( objectId, properties, applyElementIfGet );
+	}
+	
+	template< typename return_t >
+	SmartPtr< return_t > createOrGetObject( const ObjectId& objectId, const ManifestDocument::Map& properties, bool applyElementIfGet )
+	{
+		return createOrGetObject_implementation< return_t >( objectId, &properties, applyElementIfGet );
+	}
+	
 	template< typename return_t >
 	SmartPtr< return_t > createOrGetObject( ObjectNameRef objectName, const Manifest::Map* properties, bool applyElementIfGet )
 	{
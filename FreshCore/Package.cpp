@@ -14,6 +14,7 @@
 #include "CommandProcessor.h"
 #include "FreshXML.h"
 #include "Constants.h"
+#include <mutex>
 
 #define TRACE_LOADING 0
 
@@ -42,6 +43,55 @@ namespace
 	}
 	
 	size_t g_fixupSuppressionDepth = 0;
+	
+	// The packages holding each object, so that Object::rename() reindexes only those packages. Packages on any thread
+	// share this, so it is guarded.
+	//
+	typedef std::unordered_multimap< const fr::Object*, fr::Package* > Memberships;
+	std::mutex g_membershipsMutex;
+	Memberships& getMemberships()
+	{
+		static Memberships memberships;
+		return memberships;
+	}
+	
+	void addMembership( const fr::Object* object, fr::Package* package )
+	{
+		std::lock_guard< std::mutex > lock( g_membershipsMutex );
+		getMemberships().emplace( object, package );
+	}
+	
+	void removeMembership( const fr::Object* object, fr::Package* package )
+	{
+		std::lock_guard< std::mutex > lock( g_membershipsMutex );
+		auto& memberships = getMemberships();
+		const auto range = memberships.equal_range( object );
+		for( auto iter = range.first; iter != range.second; ++iter )
+		{
+			if( iter->second == package )
+			{
+				memberships.erase( iter );
+				break;
+			}
+		}
+	}
+	
+	// Returns the path of an up-to-date compiled version of the manifest at sourcePath, or an empty path if there is none.
+	// The source itself need not exist, so that builds may ship only compiled manifests.
+	//
+	path findCompiledManifest( const path& sourcePath )
+	{
+		const path compiledPath = change_extension( sourcePath, Manifest::COMPILED_EXTENSION );
+		
+		if( Manifest::isCompiledUpToDate( compiledPath, sourcePath ))
+		{
+			return compiledPath;
+		}
+		else
+		{
+			return path{};
+		}
+	}
 }
 
 namespace fr
@@ -141,6 +191,14 @@ namespace fr
 
 	FRESH_IMPLEMENT_STANDARD_CONSTRUCTORS( Package )
 	
+	Package::~Package()
+	{
+		for( const auto& member : m_members )
+		{
+			removeMembership( member.identity, this );
+		}
+	}
+	
 	
 	bool Package::empty() const
 	{
@@ -195,9 +253,9 @@ namespace fr
 		Stringifier stringifier( out );
 		ObjectStreamFormatterXml formatter( stringifier, 1 );
 		
-		std::for_each( m_members.begin(), m_members.end(), [ & formatter, & forceSaveAllProperties ] ( const SwitchPtr< Object >& p )
+		std::for_each( m_members.begin(), m_members.end(), [ & formatter, & forceSaveAllProperties ] ( const Member& member )
 		{
-			p->serialize( formatter, forceSaveAllProperties );
+			member.object->serialize( formatter, forceSaveAllProperties );
 		} );
 		
 		out << "</objects>" << std::endl;
@@ -207,23 +265,8 @@ namespace fr
 	
 	std::vector< Object::ptr > Package::loadFromManifest( const Manifest& manifest )
 	{
-		trace_loads( "Starting." );
-		
-		tidy();
-		
-		m_isLoading = true;
-		
-		const bool wasActiveToBeginWith = activePackage() == this;
-		if( !wasActiveToBeginWith )
-		{
-			pushActivePackage( this );
-		}
-		
-		std::vector< Object::ptr > objects;
-		
+		return loadDirectives( [&]( std::vector< Object::ptr >& objects )
 		{
-			CAPTURE_FIXUP_FOR_PACKAGE( "While loading package '" << name() << "': " );
-			
 			manifest.eachDirective( [&]( const Manifest::Directive& directive )
 			{
 				switch( directive.kind() )
@@ -233,13 +276,7 @@ namespace fr
 						const Manifest::Const* const directiveConst = directive.as< Manifest::Const >();
 						ASSERT( directiveConst );
 						
-						const auto& constName = directive.name();
-						const auto& constType = directiveConst->type;
-						const auto& valueText = directiveConst->value;
-
-						trace_loads( "Adding constant " << constType << " named " << constName );
-						
-						fr::constant::setValueString( constType, fr::toLower( constName ), valueText );
+						addLoadedConstant( directiveConst->type, directive.name(), directiveConst->value );
 						break;
 					}
 						
@@ -248,28 +285,11 @@ namespace fr
 						const Manifest::Object* const directiveObject = directive.as< Manifest::Object >();
 						ASSERT( directiveObject );
 						
-						try
-						{
-							trace_loads( "Creating object with id: " << ObjectId{ *directiveObject } );
-							
-							Object::ptr object = createOrGetObject( *directiveObject, true /* apply element if found */ );
-							trace_loads( "After create object." );
-							ASSERT( object );
-							
-							trace_loads( "Created object with id: " << ObjectId{ *directiveObject } );
-							
-							objects.push_back( object );
-							
-							trace_loads( "Pushed it back." );
-						}
-						catch( FreshException& e )
-						{
-							con_error( "Package " << name() << " had exception while attempting to create " << ObjectId{ *directiveObject } << ": " << e.what() );
-						}
-							catch( ... )
-						{
-							con_error( "Package " << name() << " had unknown exception while attempting to create " << ObjectId{ *directiveObject });
-						}
+						const ObjectId id{ *directiveObject };
+						addLoadedObject( objects, id, [&]()
+										{
+											return createOrGetObject( id, directiveObject->map.get(), true /* apply element if found */ );
+										} );
 						break;
 					}
 						
@@ -278,37 +298,67 @@ namespace fr
 						const Manifest::Class* const directiveClass = directive.as< Manifest::Class >();
 						ASSERT( directiveClass );
 						
-						// Add a pseudoclass.
-						//
-						const auto& className = directiveClass->name();
-						
-						if( directiveClass->baseClassNames.size() != 1 )
-						{
-							dev_warning( "While loading package '" << name() << "', class " << className << " had "
-										<< directiveClass->baseClassNames.size()
-										<< " super classes. Needs exactly 1. Ignoring." );
-						}
-						else
-						{
-							const auto& baseClassName = directiveClass->baseClassNames.front();
-							
-							trace_loads( "Creating class " << className );
-							
-							ClassInfo::Placeable isPlaceable = ClassInfo::Placeable::Inherit;
-							
-							try
-							{
-								createClass( className, baseClassName, *directiveClass, isPlaceable );
-							}
-							catch( FreshException& e )
-							{
-								dev_warning( e.what() );
-							}
-						}
+						addLoadedClass( *directiveClass );
 						break;
 					}
 				}
 			} );
+		} );
+	}
+	
+	std::vector< Object::ptr > Package::loadFromDocument( const ManifestDocument& document )
+	{
+		return loadDirectives( [&]( std::vector< Object::ptr >& objects )
+		{
+			for( const auto& directive : document )
+			{
+				switch( directive.kind )
+				{
+					case Manifest::Directive::Kind::Const:
+						addLoadedConstant( std::string( directive.type ), std::string( directive.name ), std::string( directive.value ));
+						break;
+						
+					case Manifest::Directive::Kind::Object:
+					{
+						const ObjectId id{ directive };
+						addLoadedObject( objects, id, [&]()
+										{
+											return directive.map ? createOrGetObject( id, *directive.map, true /* apply element if found */ ) : createOrGetObject( id );
+										} );
+						break;
+					}
+						
+					case Manifest::Directive::Kind::Class:
+					{
+						const auto directiveClass = directive.toManifestDirective();
+						addLoadedClass( *directiveClass->as< Manifest::Class >() );
+						break;
+					}
+				}
+			}
+		} );
+	}
+	
+	std::vector< Object::ptr > Package::loadDirectives( const std::function< void( std::vector< Object::ptr >& ) >& loadEach )
+	{
+		trace_loads( "Starting." );
+		
+		tidy();
+		
+		m_isLoading = true;
+		
+		const bool wasActiveToBeginWith = activePackage() == this;
+		if( !wasActiveToBeginWith )
+		{
+			pushActivePackage( this );
+		}
+		
+		std::vector< Object::ptr > objects;
+		
+		{
+			CAPTURE_FIXUP_FOR_PACKAGE( "While loading package '" << name() << "': " );
+			
+			loadEach( objects );
 			
 		}	// This closes the capture, which causes pointer fixup.
 		
@@ -334,15 +384,88 @@ namespace fr
 		
 		tidy();
 		
+		onManifestLoaded( objects );
+		
 		trace_loads( "Done." );
 		
 		return objects;
 	}
 	
+	void Package::addLoadedConstant( const std::string& constType, const std::string& constName, const std::string& valueText )
+	{
+		trace_loads( "Adding constant " << constType << " named " << constName );
+		
+		fr::constant::setValueString( constType, fr::toLower( constName ), valueText );
+	}
+	
+	template< typename CreateFunctionT >
+	void Package::addLoadedObject( std::vector< Object::ptr >& objects, const ObjectId& id, CreateFunctionT&& create )
+	{
+		try
+		{
+			trace_loads( "Creating object with id: " << id );
+			
+			Object::ptr object = create();
+			trace_loads( "After create object." );
+			ASSERT( object );
+			
+			trace_loads( "Created object with id: " << id );
+			
+			objects.push_back( object );
+			
+			trace_loads( "Pushed it back." );
+		}
+		catch( FreshException& e )
+		{
+			con_error( "Package " << name() << " had exception while attempting to create " << id << ": " << e.what() );
+		}
+		catch( ... )
+		{
+			con_error( "Package " << name() << " had unknown exception while attempting to create " << id );
+		}
+	}
+	
+	void Package::addLoadedClass( const Manifest::Class& directiveClass )
+	{
+		// Add a pseudoclass.
+		//
+		const auto& className = directiveClass.name();
+		
+		if( directiveClass.baseClassNames.size() != 1 )
+		{
+			dev_warning( "While loading package '" << name() << "', class " << className << " had "
+						<< directiveClass.baseClassNames.size()
+						<< " super classes. Needs exactly 1. Ignoring." );
+		}
+		else
+		{
+			const auto& baseClassName = directiveClass.baseClassNames.front();
+			
+			trace_loads( "Creating class " << className );
+			
+			ClassInfo::Placeable isPlaceable = ClassInfo::Placeable::Inherit;
+			
+			try
+			{
+				createClass( className, baseClassName, directiveClass, isPlaceable );
+			}
+			catch( FreshException& e )
+			{
+				dev_warning( e.what() );
+			}
+		}
+	}
+	
 	void Package::forEachMember( std::function< void( const SmartPtr< Object >& ) >&& fn ) const
 	{
 		tidy();
-		const auto copy = m_members;
+		
+		std::vector< SwitchPtr< Object >> copy;
+		copy.reserve( m_members.size() );
+		for( const auto& member : m_members )
+		{
+			copy.push_back( member.object );
+		}
 		std::for_each( copy.begin(), copy.end(), fn );
 	}
 	
@@ -352,7 +475,27 @@ namespace fr
 		
 		auto extension = fr::toLower( fullPath.extension() );
 		
+		const path compiledPath = extension == Manifest::COMPILED_EXTENSION ? fullPath : findCompiledManifest( fullPath );
+		if( !compiledPath.empty() )
+		{
+			trace_loads( "Package loading compiled manifest '" << compiledPath << "'." );
+			
+			// The document views the mapped file, so it stays alive until every object has loaded.
+			//
+			std::unique_ptr< ManifestDocument > document;
+			try
+			{
+				document.reset( new ManifestDocument( compiledPath ));
+			}
+			catch( const std::exception& e )
+			{
+				FRESH_THROW( FreshException, "Unable to load package " << name() << " compiled manifest: " << e.what() );
+			}
+			return loadFromDocument( *document );
+		}
+		
 		Manifest manifest;
+		
 		if( extension == ".xml" )
 		{
 			// Load the package.
@@ -396,20 +539,25 @@ namespace fr
 	Object::ptr Package::findGeneric( const ClassInfo& classInfo, NameRef objectName ) const
 	{
 		REQUIRES( objectName.empty() == false );
-		auto iter = std::find_if( m_members.begin(), m_members.end(), [&classInfo, &objectName] ( const SwitchPtr< Object >& p )
-								 {
-									 SmartPtr< Object > q = p;	// Convert to SmartPtr<> to avoid repeated, expensive WeakPtr null checks.
-									 return q && q->hasName( objectName ) && q->isA( classInfo );
-								 });
 		
-		if( iter != m_members.end() )
-		{
-			return *iter;
-		}
-		else
+		Object::ptr found;
+		size_t foundSequence = 0;
+		
+		const auto range = m_membersByName.equal_range( objectName );
+		for( auto iter = range.first; iter != range.second; ++iter )
 		{
-			return nullptr;
+			const Member& member = *iter->second;
+			
+			SmartPtr< Object > q = member.object;	// Convert to SmartPtr<> to avoid repeated, expensive WeakPtr null checks.
+			if( q && q->isA( classInfo ) && ( !found || member.sequence < foundSequence ))
+			{
+				ASSERT( q->hasName( objectName ));
+				found = q;
+				foundSequence = member.sequence;
+			}
 		}
+		
+		return found;
 	}
 	
 	Object::ptr Package::requestGeneric( const ClassInfo& classInfo, NameRef objectName )
@@ -423,7 +571,7 @@ namespace fr
 		TIMER_AUTO( Package::has )
 		
 		REQUIRES( object );
-		return m_members.end() != std::find( m_members.begin(), m_members.end(), SwitchPtr< Object >( const_cast< Object* >( object.get() )));	// TODO bit of a hack
+		return m_members.end() != findMember( object.get() );
 	}
 	
 	void Package::add( Object::ptr object )
@@ -437,7 +585,24 @@ namespace fr
 
 		quickTidy();
 		
-		m_members.push_back( SwitchPtr< Object >( object, m_isRetained ));
+		// An unretained member that has since died may have left an entry for this same address.
+		//
+		auto stale = m_membersByIdentity.find( object.get() );
+		if( stale != m_membersByIdentity.end() )
+		{
+			eraseMember( stale->second );
+		}
+		
+		Member member;
+		member.object = SwitchPtr< Object >( object, m_isRetained );
+		member.identity = object.get();
+		member.indexedName = object->name();
+		member.sequence = m_nextMemberSequence++;
+		
+		const auto iter = m_members.insert( m_members.end(), std::move( member ));
+		m_membersByIdentity[ iter->identity ] = iter;
+		m_membersByName.emplace( iter->indexedName, iter );
+		addMembership( iter->identity, this );
 
 		PROMISES( has( object ));
 	}
@@ -524,10 +689,10 @@ namespace fr
 		REQUIRES( object );
 		REQUIRES( has( object ));
 		
-		auto iter = std::find( m_members.begin(), m_members.end(), object );
+		auto iter = findMember( object.get() );
 		REQUIRES( iter != m_members.end() );
 
-		m_members.erase( iter );
+		eraseMember( iter );
 
 		PROMISES( !has( object ));
 	}
@@ -543,9 +708,9 @@ namespace fr
 		StringifierObjectGraph::ObjectSet savedObjects;
 		StringifierObjectGraph::ObjectSet pendingObjects;
 		
-		std::for_each( m_members.begin(), m_members.end(), [&pendingObjects] ( const SwitchPtr< Object >& p )
+		std::for_each( m_members.begin(), m_members.end(), [&pendingObjects] ( const Member& member )
 					  {
-						  if( p ) pendingObjects.insert( SmartPtr< Object >( p ));
+						  if( member.object ) pendingObjects.insert( SmartPtr< Object >( member.object ));
 					  } );
 		
 		while( !pendingObjects.empty() )
@@ -605,7 +770,7 @@ namespace fr
 	{
 		if( !m_isRetained )
 		{
-			std::for_each( m_members.begin(), m_members.end(), std::mem_fn( &SwitchPtr< Object >::retain ));
+			std::for_each( m_members.begin(), m_members.end(), []( Member& member ) { member.object.retain(); } );
 			m_isRetained = true;
 		}
 		PROMISES( areMembersRetained() );
@@ -616,7 +781,7 @@ namespace fr
 	{
 		if( m_isRetained )
 		{
-			std::for_each( m_members.begin(), m_members.end(), std::mem_fn( &SwitchPtr< Object >::release ));
+			std::for_each( m_members.begin(), m_members.end(), []( Member& member ) { member.object.release(); } );
 			m_isRetained = false;
 			tidy();
 		}
@@ -636,10 +801,13 @@ namespace fr
 		
 		// Identify all members that are only alive by virtue of being referenced by this package.
 		//
-		std::copy_if( m_members.begin(), m_members.end(), std::back_inserter( zombies ), []( const Object::ptr& p )
+		for( const auto& member : m_members )
 		{
-			return p->getReferenceCount() <= 2;
-		} );
+			if( member.object->getReferenceCount() <= 2 )
+			{
+				zombies.push_back( member.object );
+			}
+		}
 		
 		if( !zombies.empty() )
 		{
@@ -666,7 +834,7 @@ namespace fr
 				trace( "deleting zombie " << zombie << " with bytes=" << nZombieBytes );
 #endif
 				
-				m_members.erase( std::find( m_members.begin(), m_members.end(), zombie ));
+				eraseMember( findMember( zombie.get() ));
 			}
 			
 #if DEV_MODE && 1
@@ -701,7 +869,7 @@ namespace fr
 	
 	size_t Package::numNullMembers() const
 	{
-		return std::count_if( m_members.begin(), m_members.end(), []( const SwitchPtr< Object >& p ) { return !p; } );
+		return std::count_if( m_members.begin(), m_members.end(), []( const Member& member ) { return !member.object; } );
 	}
 	
 	void Package::tidy() const
@@ -715,19 +883,27 @@ namespace fr
 		if( !areMembersRetained() )
 		{
 			Package* nonConstMe = const_cast< Package* >( this );
-			nonConstMe->m_members.remove_if( []( const SwitchPtr< Object >& p )
-											{
-												return !p;
-											} );
+			auto& members = nonConstMe->m_members;
+			for( auto iter = members.begin(); iter != members.end(); )
+			{
+				if( !iter->object )
+				{
+					iter = nonConstMe->eraseMember( iter );
+				}
+				else
+				{
+					++iter;
+				}
+			}
 		}
 		
 #if DEV_MODE && 0
 		// Verify that no two objects have the same class and name.
 		//
 		std::set< ObjectId > uniqueIds;
-		std::transform( m_members.begin(), m_members.end(), std::inserter( uniqueIds, uniqueIds.begin() ), []( const decltype( m_members )::value_type& member )
+		std::transform( m_members.begin(), m_members.end(), std::inserter( uniqueIds, uniqueIds.begin() ), []( const Member& member )
 					   {
-						   return member->objectId();
+						   return member.object->objectId();
 					   } );
 		
 		ASSERT( uniqueIds.size() == m_members.size() );		
@@ -737,6 +913,10 @@ namespace fr
 	void Package::quickTidy() const
 	{
 		TIMER_AUTO( Package::quickTidy )
+		
+		// Retained members can't go null, so there's nothing to tidy (as in tidy()).
+		//
+		if( areMembersRetained() ) { return; }
 
 		const auto nItemsToTidy = quickTidySize();
 		if( nItemsToTidy == 0 ) { return; }
@@ -758,11 +938,9 @@ namespace fr
 		
 		while( beginIter != endIter )
 		{
-			const auto& p = *beginIter;
-			
-			if( !p )
+			if( !beginIter->object )
 			{
-				beginIter = members.erase( beginIter );
+				beginIter = nonConstMe->eraseMember( beginIter );
 			}
 			else
 			{
@@ -777,5 +955,78 @@ namespace fr
 	{
 		return m_members.empty() ? 0 : std::max( static_cast< size_t >( 1 ), m_members.size() / 10 );
 	}
+	
+	Package::Members::iterator Package::findMember( const Object* object ) const
+	{
+		Package* nonConstMe = const_cast< Package* >( this );
+		
+		const auto found = m_membersByIdentity.find( object );
+		if( found != m_membersByIdentity.end() && found->second->object.get() == object )	// Stale entries (dead, unretained members) don't count.
+		{
+			return found->second;
+		}
+		else
+		{
+			return nonConstMe->m_members.end();
+		}
+	}
+	
+	Package::Members::iterator Package::eraseMember( Members::iterator iter )
+	{
+		ASSERT( iter != m_members.end() );
+		
+		const auto byIdentity = m_membersByIdentity.find( iter->identity );
+		if( byIdentity != m_membersByIdentity.end() && byIdentity->second == iter )
+		{
+			m_membersByIdentity.erase( byIdentity );
+		}
+		
+		unindexMemberName( iter );
+		removeMembership( iter->identity, this );
+		
+		return m_members.erase( iter );
+	}
+	
+	void Package::unindexMemberName( Members::iterator iter )
+	{
+		const auto range = m_membersByName.equal_range( iter->indexedName );
+		for( auto byName = range.first; byName != range.second; ++byName )
+		{
+			if( byName->second == iter )
+			{
+				m_membersByName.erase( byName );
+				break;
+			}
+		}
+	}
+	
+	void Package::reindexMemberName( Members::iterator iter )
+	{
+		unindexMemberName( iter );
+		
+		iter->indexedName = iter->object->name();
+		m_membersByName.emplace( iter->indexedName, iter );
+	}
+	
+	void Package::onObjectRenamed( const Object& object )
+	{
+		std::vector< Package* > packages;
+		{
+			std::lock_guard< std::mutex > lock( g_membershipsMutex );
+			const auto range = getMemberships().equal_range( &object );
+			for( auto iter = range.first; iter != range.second; ++iter )
+			{
+				packages.push_back( iter->second );
+			}
+		}
+		
+		for( Package* package : packages )
+		{
+			const auto iter = package->findMember( &object );
+			if( iter != package->m_members.end() )
+			{
+				package->reindexMemberName( iter );
+			}
+		}
+	}
 }
-
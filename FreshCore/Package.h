@@ -13,6 +13,7 @@
 #include "Object.h"
 #include "FreshPath.h"
 #include <list>
+#include <unordered_map>
 
 namespace fr
 {
@@ -22,13 +23,22 @@ namespace fr
 		FRESH_DECLARE_CLASS( Package, Object )
 	public:
 		
+		virtual ~Package();
+
 		void save( const path& fullPath, bool forceSaveAllProperties = false ) const;
 		virtual void save( std::ostream& out, bool forceSaveAllProperties = false ) const;
 
 		std::vector< Object::ptr > loadFile( const path& fullPath );
+		// Loads .xml, .fresh, or compiled (.freshc) manifests.
+		// When asked for a .fresh or .xml file that has a compiled counterpart alongside it (same name, .freshc extension)
+		// that is at least as new, loads the compiled file instead. Compiled files do not track changes to included files.
+		// Compiled files load through a ManifestDocument.
 		// REQUIRES( exists( fullPath ));
 		
-		virtual std::vector< Object::ptr > loadFromManifest( const Manifest& manifest );
+		std::vector< Object::ptr > loadFromManifest( const Manifest& manifest );
+		std::vector< Object::ptr > loadFromDocument( const ManifestDocument& document );
+		// Objects load straight from the document's maps. Pseudoclasses, which keep their configurations as Manifest maps,
+		// are converted.
 
 		bool empty() const;
 		size_t size() const;
@@ -169,8 +179,15 @@ namespace fr
 		ObjectName getUniqueName( const ClassInfo& classInfo, ObjectNameRef name ) const;
 		// REQUIRES( name.empty() == false );
 		
+		// Called by Object::rename() so that every package holding the object can re-index it under its new name.
+		//
+		static void onObjectRenamed( const Object& object );
+		
 	protected:
 		
+		virtual void onManifestLoaded( const std::vector< Object::ptr >& objects ) {}
+		// Called by loadFromManifest() and loadFromDocument() once the objects, in manifest order, have all loaded.
+		
 		virtual Object::ptr findGeneric( const ClassInfo& classInfo, NameRef objectName ) const;
 		// REQUIRES( objectName.empty() == false );
 		
@@ -197,9 +214,39 @@ namespace fr
 		bool m_isRetained = false;
 		bool m_isLoading = false;
 		
-		std::list< SwitchPtr< Object > > m_members;
+		// Members live in a list (stable iterators, stable order) and are indexed by identity and by name.
+		// The indexes make has(), find() and remove() O(1) rather than linear in the package size.
+		// Names are the primary key for find(); the class is then matched by isA() among the
+		// (usually one or two) members sharing that name.
+		//
+		struct Member
+		{
+			SwitchPtr< Object > object;
+			const Object* identity = nullptr;	// Kept even after an unretained referent dies so that its index entries can be erased.
+			ObjectName indexedName;
+			size_t sequence = 0;				// Insertion order. find() prefers the earliest matching member.
+		};
+		typedef std::list< Member > Members;
+		
+		Members m_members;
+		std::unordered_map< const Object*, Members::iterator > m_membersByIdentity;
+		std::unordered_multimap< ObjectName, Members::iterator > m_membersByName;
+		size_t m_nextMemberSequence = 0;
 		
 		mutable size_t m_nextQuickTidyBegin = 0;
+		
+		Members::iterator findMember( const Object* object ) const;
+		// Returns m_members.end() if the object is not a live member.
+		
+		std::vector< Object::ptr > loadDirectives( const std::function< void( std::vector< Object::ptr >& ) >& loadEach );
+		void addLoadedConstant( const std::string& constType, const std::string& constName, const std::string& valueText );
+		void addLoadedClass( const Manifest::Class& directiveClass );
+		template< typename CreateFunctionT >
+		void addLoadedObject( std::vector< Object::ptr >& objects, const ObjectId& id, CreateFunctionT&& create );
+		
+		Members::iterator eraseMember( Members::iterator iter );
+		void unindexMemberName( Members::iterator iter );
+		void reindexMemberName( Members::iterator iter );
 	};
 
 	///////////////////////////////////////////////////////////////
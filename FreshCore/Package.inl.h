@@ -61,11 +61,13 @@ namespace fr
 	std::vector< SmartPtr< return_t >> Package::findFiltered( const ObjectId& objectFilter ) const
 	{
 		std::vector< SmartPtr< return_t >> results;
-		std::copy_if( m_members.begin(), m_members.end(), std::back_inserter( results ), [ & objectFilter ]
-					 ( const typename decltype( m_members )::value_type& member )
-					 {
-						 return member && member->matchesFilters( objectFilter.className(), objectFilter.objectName() );
-					 } );
+		for( const auto& member : m_members )
+		{
+			if( member.object && member.object->matchesFilters( objectFilter.className(), objectFilter.objectName() ))
+			{
+				results.push_back( member.object );
+			}
+		}
 		return results;
 	}
 
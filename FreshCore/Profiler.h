@@ -2,6 +2,7 @@
 #pragma once
 
 #include "Singleton.h"
+#include "TraceRecorder.h"
 #include <memory>
 
 namespace fr
@@ -38,28 +39,59 @@ namespace fr
 		std::unique_ptr< class ProfilerImpl > m_impl;
 	};
 
+	// TIMER_AUTO( scope ) and TIMER_AUTO_FUNC record their enclosing scope with the trace recorder (see TraceRecorder.h).
+	// TIMER_BEGIN( scope ) and TIMER_END( scope ) bracket a scope by hand, on one thread.
+	// With FRESH_PROFILER_ENABLED, they also feed the Profiler's hierarchical timers, as they always have.
+
+#define FRESH_TRACE_CONCATENATE_( a, b ) a##b
+#define FRESH_TRACE_CONCATENATE( a, b ) FRESH_TRACE_CONCATENATE_( a, b )
+
+#if FRESH_TRACE_ENABLED
+
+	#define FRESH_TRACE_SCOPE_( name )	\
+		static const fr::trace::ScopeId FRESH_TRACE_CONCATENATE( trace_ScopeId_, __LINE__ ) = fr::trace::registerScope( name );	\
+		fr::trace::AutoScope FRESH_TRACE_CONCATENATE( trace_AutoScope_, __LINE__ )( FRESH_TRACE_CONCATENATE( trace_ScopeId_, __LINE__ ));
+
+	#define FRESH_TRACE_SCOPE_ID_( name )	\
+		[]() { static const fr::trace::ScopeId id = fr::trace::registerScope( name ); return id; }()
+
+	#define FRESH_TRACE_BEGIN_( name )	fr::trace::begin( FRESH_TRACE_SCOPE_ID_( name ));
+	#define FRESH_TRACE_END_( name )	fr::trace::end( FRESH_TRACE_SCOPE_ID_( name ));
+
+#else
+
+	#define FRESH_TRACE_SCOPE_( name )
+	#define FRESH_TRACE_BEGIN_( name )
+	#define FRESH_TRACE_END_( name )
+
+#endif
+
 #ifdef FRESH_PROFILER_ENABLED
 
 	#define FR_PROFILER_CURRENT_FUNCTION __PRETTY_FUNCTION__
 
 	#define TIMER_AUTO_FUNC	\
+		FRESH_TRACE_SCOPE_( FR_PROFILER_CURRENT_FUNCTION )	\
 		fr::Profiler::AutoTimer auto_Timer_( FR_PROFILER_CURRENT_FUNCTION );
 
 	#define TIMER_BEGIN( scope )	\
+		FRESH_TRACE_BEGIN_( #scope )	\
 		fr::Profiler::instance().timerBegin( #scope );
 
 	#define TIMER_END( scope )	\
-		fr::Profiler::instance().timerEnd( #scope );
+		fr::Profiler::instance().timerEnd( #scope );	\
+		FRESH_TRACE_END_( #scope )
 
 	#define TIMER_AUTO( scope )	\
+		FRESH_TRACE_SCOPE_( #scope )	\
 		fr::Profiler::AutoTimer auto_Timer_( #scope );
 
 #else
 
-	#define TIMER_BEGIN( scope )
-	#define TIMER_END( scope )
-	#define TIMER_AUTO( scope )
-	#define TIMER_AUTO_FUNC
+	#define TIMER_BEGIN( scope )	FRESH_TRACE_BEGIN_( #scope )
+	#define TIMER_END( scope )		FRESH_TRACE_END_( #scope )
+	#define TIMER_AUTO( scope )		FRESH_TRACE_SCOPE_( #scope )
+	#define TIMER_AUTO_FUNC			FRESH_TRACE_SCOPE_( FRESH_TRACE_CURRENT_FUNCTION )
 
 #endif
 
@@ -29,6 +29,58 @@ namespace fr
 		static PropertyAbstract::ControlType controlType() { return PropertyAbstract::ControlType::String; }
 		static ClassInfo::cptr referencedClass() { return nullptr; }
 		static bool deep() { return false; }
+		
+		template< typename T >
+		static void clone( T& to, const T& from ) { to = from; }
+	};
+	
+	// Object references are "deep": shallow objects neither save nor clone them.
+	// A clone owns clones of the objects its SmartPtrs hold, but shares shared resources. WeakPtrs are copied as they are.
+	//
+	template< typename ObjectT >
+	struct PropertyTypeTraits< SmartPtr< ObjectT >> : public PropertyTypeTraits< void >
+	{
+		static bool deep() { return true; }
+		
+		static void clone( SmartPtr< ObjectT >& to, const SmartPtr< ObjectT >& from )
+		{
+			if( from && !from->isSharedResource() )
+			{
+				to = dynamic_freshptr_cast< SmartPtr< ObjectT >>( from->createClone() );
+				ASSERT( to );
+			}
+			else
+			{
+				to = from;
+			}
+		}
+	};
+	
+	template< typename ObjectT >
+	struct PropertyTypeTraits< WeakPtr< ObjectT >> : public PropertyTypeTraits< void >
+	{
+		static bool deep() { return true; }
+	};
+	
+	template< typename ObjectT >
+	struct PropertyTypeTraits< std::vector< SmartPtr< ObjectT >>> : public PropertyTypeTraits< void >
+	{
+		static bool deep() { return true; }
+		
+		static void clone( std::vector< SmartPtr< ObjectT >>& to, const std::vector< SmartPtr< ObjectT >>& from )
+		{
+			to.resize( from.size() );
+			for( size_t i = 0; i < from.size(); ++i )
+			{
+				PropertyTypeTraits< SmartPtr< ObjectT >>::clone( to[ i ], from[ i ] );
+			}
+		}
+	};
+	
+	template< typename ObjectT >
+	struct PropertyTypeTraits< std::vector< WeakPtr< ObjectT >>> : public PropertyTypeTraits< void >
+	{
+		static bool deep() { return true; }
 	};
 	
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -46,6 +98,10 @@ namespace fr
 
 		void setValue( Object* object, const elementType& value ) const;
 		virtual void setValueByManifestValue( Object* object, const Manifest::Value& value ) const override;
+		
+		virtual void copyValue( Object* toObject, const Object* fromObject ) const override;
+		virtual void cloneValue( Object* toObject, const Object* fromObject ) const override;
+		virtual bool isValueCopyable( const Manifest::Value& value ) const override;
 
 		virtual std::string getValueByString( const Object* object ) const override;
 		
@@ -150,6 +206,24 @@ namespace fr
 		}
 	}
 
+	template< typename elementType >
+	void Property< elementType >::copyValue( Object* toObject, const Object* fromObject ) const
+	{
+		getPropertyRef< elementType >( *this, toObject ) = getPropertyRef< elementType >( *this, fromObject );
+	}
+	
+	template< typename elementType >
+	void Property< elementType >::cloneValue( Object* toObject, const Object* fromObject ) const
+	{
+		PropertyTypeTraits< elementType >::clone( getPropertyRef< elementType >( *this, toObject ), getPropertyRef< elementType >( *this, fromObject ));
+	}
+	
+	template< typename elementType >
+	bool Property< elementType >::isValueCopyable( const Manifest::Value& value ) const
+	{
+		return ParsedValueCaching< elementType >::enabled && value.is< std::string >() && ParsedValueCaching< elementType >::canCache( value.get< std::string >() );
+	}
+
 	template <typename elementType>
 	std::string Property< elementType >::getValueByString( const Object* object ) const
 	{
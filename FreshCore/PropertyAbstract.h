@@ -80,6 +80,16 @@ namespace fr
 		
 		virtual void setValueByManifestValue( Object* object, const Manifest::Value& value ) const = 0;
 		
+		virtual void copyValue( Object* toObject, const Object* fromObject ) const = 0;
+		// Assigns fromObject's value for this property to toObject. Pointers are copied, not the objects they refer to.
+		
+		virtual void cloneValue( Object* toObject, const Object* fromObject ) const = 0;
+		// As copyValue(), but objects held by SmartPtr are cloned in turn unless they are shared resources.
+		
+		virtual bool isValueCopyable( const Manifest::Value& value ) const = 0;
+		// True iff loading value into this property has no effect beyond setting the property to a value that
+		// depends only on value's text, so that copying the result from another object that loaded it is equivalent.
+		
 		virtual std::string getValueByString( const Object* object ) const = 0;
 
 		size_t getByteOffset() const { return m_byteOffset; }
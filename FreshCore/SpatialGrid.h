@@ -0,0 +1,520 @@
+//
+//  SpatialGrid.h
+//  Fresh
+//
+
+#ifndef Fresh_SpatialGrid_h
+#define Fresh_SpatialGrid_h
+
+#include "FreshDebug.h"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace fr
+{
+	// A broadphase for moving objects. Like SpatialHash, it hashes a uniform grid of cells into a fixed number of
+	// bins, but objects persist between frames: add() returns a stable handle, and move() only touches bins when
+	// an object crosses into different cells, so a world updates it in place rather than refilling it.
+	//
+	// eachPair() reports every overlapping pair exactly once without collecting and sorting them. Each pair belongs
+	// to the one cell that holds the minimum corner of the pair's intersection, and only that cell reports it.
+	// Pairs come out in a deterministic order for a given sequence of adds, moves and removes.
+	//
+	// Each object remembers where in each of its cells' bins it sits, so leaving a cell is a swap-remove
+	// rather than a search of the bin.
+	//
+	// Queries are const but not thread-safe: they stamp objects to avoid visiting them twice.
+	//
+	template< typename PosT, typename ValueT >
+	class SpatialGrid
+	{
+	public:
+
+		typedef PosT position_type;
+		typedef typename PosT::element_type real_type;
+
+		typedef ValueT value_type;
+		typedef ValueT& reference;
+		typedef const ValueT& const_reference;
+
+		typedef size_t Handle;
+		static const Handle INVALID_HANDLE = ~Handle( 0 );
+
+		SpatialGrid( size_t maxBins, real_type cellSize );
+		// REQUIRES( maxBins > 0 && cellSize > 0 );
+
+		size_t size() const											{ return m_proxies.size() - m_freeHandles.size(); }
+		bool empty() const											{ return size() == 0; }
+
+		void clear();
+
+		Handle add( const position_type& minCorner, const position_type& maxCorner, const_reference element );
+		// PROMISES( contains( result ));
+
+		void move( Handle handle, const position_type& minCorner, const position_type& maxCorner );
+		// REQUIRES( contains( handle ));
+
+		void remove( Handle handle );
+		// REQUIRES( contains( handle ));
+		// PROMISES( !contains( handle ));
+
+		bool contains( Handle handle ) const						{ return handle < m_proxies.size() && m_proxies[ handle ].isAlive; }
+
+		const_reference operator[]( Handle handle ) const			{ ASSERT( contains( handle )); return m_proxies[ handle ].value; }
+		reference operator[]( Handle handle )						{ ASSERT( contains( handle )); return m_proxies[ handle ].value; }
+
+		const position_type& minCorner( Handle handle ) const		{ ASSERT( contains( handle )); return m_proxies[ handle ].minCorner; }
+		const position_type& maxCorner( Handle handle ) const		{ ASSERT( contains( handle )); return m_proxies[ handle ].maxCorner; }
+
+		template< typename Function >
+		void eachPair( Function&& fn ) const;
+		// Calls fn( a, b ) once for each pair of elements whose boxes overlap.
+
+		template< typename Function >
+		void eachOverlapping( const position_type& minCorner, const position_type& maxCorner, Function&& fn ) const;
+		// Calls fn( element ) once for each element whose box overlaps the given one.
+
+		template< typename Function >
+		void eachOnRay( const position_type& start, const position_type& end, Function&& fn ) const;
+		// Calls fn( element, t ) once for each element whose box the segment from start to end crosses,
+		// where t in [0,1] is how far along the segment it enters the box. Elements come roughly in order of t.
+
+	protected:
+
+		struct Cells
+		{
+			int minX = 0, minY = 0, maxX = -1, maxY = -1;
+
+			bool operator==( const Cells& other ) const
+			{
+				return minX == other.minX && minY == other.minY && maxX == other.maxX && maxY == other.maxY;
+			}
+
+			bool contains( int x, int y ) const
+			{
+				return minX <= x && x <= maxX && minY <= y && y <= maxY;
+			}
+		};
+
+		struct Proxy
+		{
+			position_type minCorner;
+			position_type maxCorner;
+			value_type value;
+			Cells cells;
+			std::vector< size_t > slots;		// Per cell, row by row: the index of this object's entry in the cell's bin.
+			mutable unsigned int stamp = 0;
+			bool isAlive = false;
+		};
+
+		struct BinEntry
+		{
+			Handle handle;
+			size_t iCell;						// Which of the object's cells put it here, as an index into its slots.
+		};
+
+		typedef std::vector< BinEntry > Bin;
+
+		inline int cellCoordinate( real_type x ) const
+		{
+			return static_cast< int >( std::floor( x * m_inverseCellSize ));
+		}
+
+		inline Cells cellsFor( const position_type& minCorner, const position_type& maxCorner ) const
+		{
+			Cells cells;
+			cells.minX = cellCoordinate( minCorner[ 0 ] );
+			cells.minY = cellCoordinate( minCorner[ 1 ] );
+			cells.maxX = cellCoordinate( maxCorner[ 0 ] );
+			cells.maxY = cellCoordinate( maxCorner[ 1 ] );
+			return cells;
+		}
+
+		inline Bin& bin( int x, int y ) const
+		{
+			const size_t index = ( size_t( x ) * 1640531513ul ^ size_t( y ) * 2654435789ul ) % m_bins.size();
+			return const_cast< Bin& >( m_bins[ index ] );
+		}
+
+		static size_t cellIndex( const Cells& cells, int x, int y )
+		{
+			return size_t( y - cells.minY ) * size_t( cells.maxX - cells.minX + 1 ) + size_t( x - cells.minX );
+		}
+
+		static size_t numCells( const Cells& cells )
+		{
+			return size_t( cells.maxY - cells.minY + 1 ) * size_t( cells.maxX - cells.minX + 1 );
+		}
+
+		static bool overlaps( const Proxy& a, const position_type& minCorner, const position_type& maxCorner )
+		{
+			return a.minCorner[ 0 ] <= maxCorner[ 0 ] && minCorner[ 0 ] <= a.maxCorner[ 0 ] &&
+				   a.minCorner[ 1 ] <= maxCorner[ 1 ] && minCorner[ 1 ] <= a.maxCorner[ 1 ];
+		}
+
+		void insertIntoBins( Handle handle, const Cells& cells, const Cells& previous );
+		// Gives the proxy its new cells, keeping the entries of cells that it already had in previous.
+		void removeFromBins( Handle handle, const Cells& except );
+		// Removes the proxy's entries for its cells outside except.
+
+		unsigned int nextStamp() const;
+
+	private:
+
+		std::vector< Bin > m_bins;
+		real_type m_cellSize;
+		real_type m_inverseCellSize;
+
+		std::vector< Proxy > m_proxies;
+		std::vector< Handle > m_freeHandles;
+		std::vector< size_t > m_scratchSlots;
+
+		mutable unsigned int m_stamp = 0;
+	};
+
+
+	///////////////////////////////////////////////////////
+
+	template< typename PosT, typename ValueT >
+	SpatialGrid< PosT, ValueT >::SpatialGrid( size_t maxBins, real_type cellSize )
+	:	m_bins( maxBins )
+	,	m_cellSize( cellSize )
+	,	m_inverseCellSize( real_type( 1 ) / cellSize )
+	{
+		static_assert( position_type::nComponents == 2, "SpatialGrid requires a 2d-vector" );
+		REQUIRES( maxBins > 0 && cellSize > 0 );
+	}
+
+	template< typename PosT, typename ValueT >
+	void SpatialGrid< PosT, ValueT >::clear()
+	{
+		for( auto& bin : m_bins )
+		{
+			bin.clear();
+		}
+		m_proxies.clear();
+		m_freeHandles.clear();
+	}
+
+	template< typename PosT, typename ValueT >
+	typename SpatialGrid< PosT, ValueT >::Handle SpatialGrid< PosT, ValueT >::add( const position_type& minCorner, const position_type& maxCorner, const_reference element )
+	{
+		Handle handle;
+		if( m_freeHandles.empty() )
+		{
+			handle = m_proxies.size();
+			m_proxies.emplace_back();
+		}
+		else
+		{
+			handle = m_freeHandles.back();
+			m_freeHandles.pop_back();
+		}
+
+		auto& proxy = m_proxies[ handle ];
+		proxy.minCorner = minCorner;
+		proxy.maxCorner = maxCorner;
+		proxy.value = element;
+		proxy.stamp = 0;
+		proxy.isAlive = true;
+
+		insertIntoBins( handle, cellsFor( minCorner, maxCorner ), Cells{} );
+
+		PROMISES( contains( handle ));
+		return handle;
+	}
+
+	template< typename PosT, typename ValueT >
+	void SpatialGrid< PosT, ValueT >::move( Handle handle, const position_type& minCorner, const position_type& maxCorner )
+	{
+		REQUIRES( contains( handle ));
+
+		auto& proxy = m_proxies[ handle ];
+		proxy.minCorner = minCorner;
+		proxy.maxCorner = maxCorner;
+
+		// Most moves stay within the same cells and need no bin changes at all.
+		//
+		const Cells cells = cellsFor( minCorner, maxCorner );
+		if( !( cells == proxy.cells ))
+		{
+			const Cells previous = proxy.cells;
+			removeFromBins( handle, cells );
+			insertIntoBins( handle, cells, previous );
+		}
+	}
+
+	template< typename PosT, typename ValueT >
+	void SpatialGrid< PosT, ValueT >::remove( Handle handle )
+	{
+		REQUIRES( contains( handle ));
+
+		auto& proxy = m_proxies[ handle ];
+		removeFromBins( handle, Cells{} );
+		proxy.cells = Cells{};
+		proxy.slots.clear();
+		proxy.value = value_type{};
+		proxy.isAlive = false;
+		m_freeHandles.push_back( handle );
+
+		PROMISES( !contains( handle ));
+	}
+
+	template< typename PosT, typename ValueT >
+	void SpatialGrid< PosT, ValueT >::insertIntoBins( Handle handle, const Cells& cells, const Cells& previous )
+	{
+		auto& proxy = m_proxies[ handle ];
+
+		m_scratchSlots.resize( numCells( cells ));
+		for( int y = cells.minY; y <= cells.maxY; ++y )
+		{
+			for( int x = cells.minX; x <= cells.maxX; ++x )
+			{
+				const size_t iCell = cellIndex( cells, x, y );
+				auto& cellBin = bin( x, y );
+
+				if( previous.contains( x, y ))
+				{
+					// Still here: the entry stays put but is now known by its new cell index.
+					//
+					const size_t slot = proxy.slots[ cellIndex( previous, x, y ) ];
+					ASSERT( cellBin[ slot ].handle == handle );
+					cellBin[ slot ].iCell = iCell;
+					m_scratchSlots[ iCell ] = slot;
+				}
+				else
+				{
+					m_scratchSlots[ iCell ] = cellBin.size();
+					cellBin.push_back( BinEntry{ handle, iCell } );
+				}
+			}
+		}
+
+		proxy.slots.swap( m_scratchSlots );
+		proxy.cells = cells;
+	}
+
+	template< typename PosT, typename ValueT >
+	void SpatialGrid< PosT, ValueT >::removeFromBins( Handle handle, const Cells& except )
+	{
+		const Cells cells = m_proxies[ handle ].cells;
+		for( int y = cells.minY; y <= cells.maxY; ++y )
+		{
+			for( int x = cells.minX; x <= cells.maxX; ++x )
+			{
+				if( !except.contains( x, y ))
+				{
+					// Bins are unordered, so removal swaps the last entry into the hole and tells its owner where it went.
+					// The owner may be this same object, when another of its cells hashes to this bin.
+					//
+					auto& cellBin = bin( x, y );
+					const size_t slot = m_proxies[ handle ].slots[ cellIndex( cells, x, y ) ];
+					ASSERT( slot < cellBin.size() && cellBin[ slot ].handle == handle );
+
+					const BinEntry last = cellBin.back();
+					cellBin[ slot ] = last;
+					m_proxies[ last.handle ].slots[ last.iCell ] = slot;
+					cellBin.pop_back();
+				}
+			}
+		}
+	}
+
+	template< typename PosT, typename ValueT >
+	unsigned int SpatialGrid< PosT, ValueT >::nextStamp() const
+	{
+		if( ++m_stamp == 0 )
+		{
+			// Wrapped around. Forget all old stamps so that none matches by accident.
+			//
+			for( const auto& proxy : m_proxies )
+			{
+				proxy.stamp = 0;
+			}
+			m_stamp = 1;
+		}
+		return m_stamp;
+	}
+
+	template< typename PosT, typename ValueT >
+	template< typename Function >
+	void SpatialGrid< PosT, ValueT >::eachPair( Function&& fn ) const
+	{
+		for( Handle a = 0; a < m_proxies.size(); ++a )
+		{
+			const auto& proxyA = m_proxies[ a ];
+			if( !proxyA.isAlive )
+			{
+				continue;
+			}
+
+			const auto& cells = proxyA.cells;
+			for( int y = cells.minY; y <= cells.maxY; ++y )
+			{
+				for( int x = cells.minX; x <= cells.maxX; ++x )
+				{
+					// A bin may list an object more than once when several of its cells hash to it.
+					//
+					const auto stamp = nextStamp();
+
+					for( const auto& entry : bin( x, y ))
+					{
+						const Handle b = entry.handle;
+
+						// Each pair is reported by its lower handle...
+						//
+						if( b <= a )
+						{
+							continue;
+						}
+
+						const auto& proxyB = m_proxies[ b ];
+						if( proxyB.stamp == stamp )
+						{
+							continue;
+						}
+						proxyB.stamp = stamp;
+
+						if( !overlaps( proxyA, proxyB.minCorner, proxyB.maxCorner ))
+						{
+							continue;
+						}
+
+						// ...in the cell that holds the minimum corner of the pair's intersection.
+						//
+						const int ownerX = cellCoordinate( std::max( proxyA.minCorner[ 0 ], proxyB.minCorner[ 0 ] ));
+						const int ownerY = cellCoordinate( std::max( proxyA.minCorner[ 1 ], proxyB.minCorner[ 1 ] ));
+						if( ownerX == x && ownerY == y )
+						{
+							fn( proxyA.value, proxyB.value );
+						}
+					}
+				}
+			}
+		}
+	}
+
+	template< typename PosT, typename ValueT >
+	template< typename Function >
+	void SpatialGrid< PosT, ValueT >::eachOverlapping( const position_type& minCorner, const position_type& maxCorner, Function&& fn ) const
+	{
+		const auto cells = cellsFor( minCorner, maxCorner );
+		const auto stamp = nextStamp();
+
+		for( int y = cells.minY; y <= cells.maxY; ++y )
+		{
+			for( int x = cells.minX; x <= cells.maxX; ++x )
+			{
+				for( const auto& entry : bin( x, y ))
+				{
+					const auto& proxy = m_proxies[ entry.handle ];
+					if( proxy.stamp != stamp )
+					{
+						proxy.stamp = stamp;
+						if( overlaps( proxy, minCorner, maxCorner ))
+						{
+							fn( proxy.value );
+						}
+					}
+				}
+			}
+		}
+	}
+
+	template< typename PosT, typename ValueT >
+	template< typename Function >
+	void SpatialGrid< PosT, ValueT >::eachOnRay( const position_type& start, const position_type& end, Function&& fn ) const
+	{
+		const real_type delta[ 2 ] = { end[ 0 ] - start[ 0 ], end[ 1 ] - start[ 1 ] };
+		const auto stamp = nextStamp();
+
+		// Step through the cells the segment crosses, in order (Amanatides and Woo).
+		//
+		int cell[ 2 ] = { cellCoordinate( start[ 0 ] ), cellCoordinate( start[ 1 ] ) };
+		const int lastCell[ 2 ] = { cellCoordinate( end[ 0 ] ), cellCoordinate( end[ 1 ] ) };
+		int step[ 2 ];
+		real_type tMax[ 2 ];
+		real_type tDelta[ 2 ];
+		for( size_t i = 0; i < 2; ++i )
+		{
+			if( delta[ i ] > 0 )
+			{
+				step[ i ] = 1;
+				tDelta[ i ] = m_cellSize / delta[ i ];
+				tMax[ i ] = (( cell[ i ] + 1 ) * m_cellSize - start[ i ] ) / delta[ i ];
+			}
+			else if( delta[ i ] < 0 )
+			{
+				step[ i ] = -1;
+				tDelta[ i ] = m_cellSize / -delta[ i ];
+				tMax[ i ] = ( cell[ i ] * m_cellSize - start[ i ] ) / delta[ i ];
+			}
+			else
+			{
+				step[ i ] = 0;
+				tDelta[ i ] = tMax[ i ] = std::numeric_limits< real_type >::max();
+			}
+		}
+
+		while( true )
+		{
+			for( const auto& entry : bin( cell[ 0 ], cell[ 1 ] ))
+			{
+				const auto& proxy = m_proxies[ entry.handle ];
+				if( proxy.stamp == stamp )
+				{
+					continue;
+				}
+				proxy.stamp = stamp;
+
+				// Clip the segment against the box's slabs.
+				//
+				real_type tEnter = 0;
+				real_type tExit = 1;
+				for( size_t i = 0; i < 2 && tEnter <= tExit; ++i )
+				{
+					if( delta[ i ] == 0 )
+					{
+						if( start[ i ] < proxy.minCorner[ i ] || proxy.maxCorner[ i ] < start[ i ] )
+						{
+							tExit = -1;
+						}
+					}
+					else
+					{
+						real_type t0 = ( proxy.minCorner[ i ] - start[ i ] ) / delta[ i ];
+						real_type t1 = ( proxy.maxCorner[ i ] - start[ i ] ) / delta[ i ];
+						if( t1 < t0 )
+						{
+							std::swap( t0, t1 );
+						}
+						tEnter = std::max( tEnter, t0 );
+						tExit = std::min( tExit, t1 );
+					}
+				}
+
+				if( tEnter <= tExit )
+				{
+					fn( proxy.value, tEnter );
+				}
+			}
+
+			if( cell[ 0 ] == lastCell[ 0 ] && cell[ 1 ] == lastCell[ 1 ] )
+			{
+				break;
+			}
+
+			const size_t axis = tMax[ 0 ] < tMax[ 1 ] ? 0 : 1;
+			if( tMax[ axis ] > 1 )
+			{
+				break;		// Rounding kept us from landing exactly on the last cell.
+			}
+			cell[ axis ] += step[ axis ];
+			tMax[ axis ] += tDelta[ axis ];
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,161 @@
+//
+//  Symbol.cpp
+//  Fresh
+//
+
+#include "Symbol.h"
+#include "FreshDebug.h"
+#include <unordered_map>
+#include <mutex>
+#include <shared_mutex>
+
+namespace
+{
+	// The table is keyed by views onto the entries' own strings, so lookups need no allocation.
+	// Most conversions name a string that is already interned, so lookups share the lock and only
+	// insertion and removal take it exclusively.
+	//
+	struct SymbolTable
+	{
+		std::shared_mutex mutex;
+		std::unordered_map< std::string_view, void* > entries;
+	};
+	
+	SymbolTable& getTable()
+	{
+		static SymbolTable* table = new SymbolTable();		// Never destroyed, so that Symbols in other static objects may outlive it.
+		return *table;
+	}
+}
+
+namespace fr
+{
+	Symbol::Symbol( const char* sz )
+	{
+		ASSERT( sz );
+		if( *sz )
+		{
+			m_entry = intern( std::string( sz ));
+		}
+	}
+	
+	Symbol::Symbol( const std::string& s )
+	{
+		if( !s.empty() )
+		{
+			m_entry = intern( s );
+		}
+	}
+	
+	Symbol::Symbol( std::string&& s )
+	{
+		if( !s.empty() )
+		{
+			m_entry = intern( std::move( s ));
+		}
+	}
+	
+	Symbol Symbol::findExisting( const std::string& s )
+	{
+		if( s.empty() )
+		{
+			return Symbol{};
+		}
+		
+		return Symbol{ findAndReference( s ) };
+	}
+	
+	size_t Symbol::tableSize()
+	{
+		auto& table = getTable();
+		std::shared_lock< std::shared_mutex > lock( table.mutex );
+		return table.entries.size();
+	}
+	
+	const std::string& Symbol::emptyString()
+	{
+		static const std::string* empty = new std::string();
+		return *empty;
+	}
+	
+	Symbol::Entry* Symbol::findAndReference( const std::string& s )
+	{
+		auto& table = getTable();
+		std::shared_lock< std::shared_mutex > lock( table.mutex );
+		
+		// Entries are only deleted under the exclusive lock, so this one stays alive while we count our reference.
+		//
+		const auto iter = table.entries.find( std::string_view( s ));
+		if( iter == table.entries.end() )
+		{
+			return nullptr;
+		}
+		
+		Entry* entry = static_cast< Entry* >( iter->second );
+		entry->nReferences.fetch_add( 1, std::memory_order_relaxed );
+		return entry;
+	}
+	
+	Symbol::Entry* Symbol::intern( const std::string& s )
+	{
+		ASSERT( !s.empty() );
+		
+		if( Entry* entry = findAndReference( s ))
+		{
+			return entry;
+		}
+		
+		return insert( std::string( s ));
+	}
+	
+	Symbol::Entry* Symbol::intern( std::string&& s )
+	{
+		ASSERT( !s.empty() );
+		
+		if( Entry* entry = findAndReference( s ))
+		{
+			return entry;
+		}
+		
+		return insert( std::move( s ));
+	}
+	
+	Symbol::Entry* Symbol::insert( std::string&& s )
+	{
+		auto& table = getTable();
+		std::lock_guard< std::shared_mutex > lock( table.mutex );
+		
+		// Another thread may have interned the same string since our lookup.
+		//
+		const auto iter = table.entries.find( std::string_view( s ));
+		if( iter != table.entries.end() )
+		{
+			Entry* entry = static_cast< Entry* >( iter->second );
+			entry->nReferences.fetch_add( 1, std::memory_order_relaxed );
+			return entry;
+		}
+		
+		Entry* entry = new Entry{ std::move( s ), 0, { 1 } };
+		
+		const std::string_view key( entry->string );
+		entry->hash = std::hash< std::string_view >()( key );
+		table.entries.emplace( key, entry );
+		
+		return entry;
+	}
+	
+	void Symbol::releaseLast( Entry* entry )
+	{
+		auto& table = getTable();
+		std::lock_guard< std::shared_mutex > lock( table.mutex );
+		
+		// Someone may have found this entry in the table since our caller looked at the count. Only the
+		// thread that takes the count to zero (always under the lock) may remove the entry.
+		//
+		if( entry->nReferences.fetch_sub( 1, std::memory_order_acq_rel ) == 1 )
+		{
+			table.entries.erase( std::string_view( entry->string ));
+			delete entry;
+		}
+	}
+}
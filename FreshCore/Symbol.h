@@ -0,0 +1,236 @@
+//
+//  Symbol.h
+//  Fresh
+//
+
+#ifndef Fresh_Symbol_h
+#define Fresh_Symbol_h
+
+#include <string>
+#include <atomic>
+#include <iostream>
+#include <functional>
+
+namespace fr
+{
+
+	// A Symbol is an interned, immutable string.
+	// Every distinct string value has exactly one table entry, so two symbols are equal iff they point
+	// to the same entry. Comparison is a pointer compare and the hash is computed once, at interning.
+	//
+	// Like StringTabulated, Symbols convert implicitly to and from std::string so that code written against
+	// std::string names keeps compiling. Unlike StringTabulated, the table is thread-safe and entries are
+	// reference counted: a name that no Symbol refers to any more (such as an unnamed object's generated name)
+	// leaves the table.
+	//
+	// The empty string is represented without a table entry, so default-constructed Symbols are free.
+	//
+	class Symbol
+	{
+	public:
+
+		static const size_t npos = std::string::npos;
+
+		Symbol() {}
+		Symbol( const char* sz );				// Implicit
+		Symbol( const std::string& s );			// Implicit
+		Symbol( std::string&& s );				// Implicit
+
+		Symbol( const Symbol& s );
+		Symbol( Symbol&& s ) noexcept;
+		~Symbol();
+
+		Symbol& operator=( const Symbol& s );
+		Symbol& operator=( Symbol&& s ) noexcept;
+
+		operator const std::string&() const						{ return str(); }
+		const std::string& str() const;
+		const char* c_str() const								{ return str().c_str(); }
+
+		size_t hash() const;
+
+		// Returns the existing symbol for s or the empty symbol if s has never been interned.
+		// Useful for lookups: if there is no symbol, nothing can be named s.
+		//
+		static Symbol findExisting( const std::string& s );
+
+		static size_t tableSize();
+
+		// std::string-compatible read-only interface.
+		//
+		size_t size() const										{ return str().size(); }
+		size_t length() const									{ return size(); }
+		bool empty() const										{ return !m_entry; }
+		void clear()											{ *this = Symbol{}; }
+
+		char operator[]( size_t i ) const						{ return str()[ i ]; }
+		char front() const										{ return str().front(); }
+		char back() const										{ return str().back(); }
+		std::string::const_iterator begin() const				{ return str().begin(); }
+		std::string::const_iterator end() const					{ return str().end(); }
+
+		size_t find( const std::string& s, size_t pos = 0 ) const	{ return str().find( s, pos ); }
+		size_t find( const char* s, size_t pos = 0 ) const			{ return str().find( s, pos ); }
+		size_t find( char c, size_t pos = 0 ) const					{ return str().find( c, pos ); }
+		size_t rfind( const std::string& s, size_t pos = npos ) const	{ return str().rfind( s, pos ); }
+		size_t rfind( const char* s, size_t pos = npos ) const		{ return str().rfind( s, pos ); }
+		size_t rfind( char c, size_t pos = npos ) const				{ return str().rfind( c, pos ); }
+		size_t find_first_of( const char* s, size_t pos = 0 ) const	{ return str().find_first_of( s, pos ); }
+		size_t find_last_of( const char* s, size_t pos = npos ) const	{ return str().find_last_of( s, pos ); }
+		std::string substr( size_t pos = 0, size_t n = npos ) const	{ return str().substr( pos, n ); }
+		int compare( const std::string& s ) const					{ return str().compare( s ); }
+
+	private:
+
+		struct Entry
+		{
+			std::string string;
+			size_t hash;
+			std::atomic< int > nReferences;
+		};
+
+		Entry* m_entry = nullptr;
+
+		explicit Symbol( Entry* entry ) : m_entry( entry ) {}	// Adopts a reference already counted for us.
+
+		static const std::string& emptyString();
+		static Entry* intern( const std::string& s );
+		static Entry* intern( std::string&& s );
+		static Entry* findAndReference( const std::string& s );		// Returns null if s isn't interned.
+		static Entry* insert( std::string&& s );
+
+		void addReference() const								{ if( m_entry ) { m_entry->nReferences.fetch_add( 1, std::memory_order_relaxed ); } }
+		void release();
+		static void releaseLast( Entry* entry );
+
+		friend bool operator==( const Symbol& a, const Symbol& b );
+	};
+
+	///////////////////////////////////////////////////////////////////////////////////
+
+	inline bool operator==( const Symbol& a, const Symbol& b )			{ return a.m_entry == b.m_entry; }
+	inline bool operator!=( const Symbol& a, const Symbol& b )			{ return !( a == b ); }
+
+	// Comparisons to plain strings compare text without interning.
+	//
+	inline bool operator==( const Symbol& a, const std::string& b )		{ return a.str() == b; }
+	inline bool operator==( const std::string& a, const Symbol& b )		{ return a == b.str(); }
+	inline bool operator==( const Symbol& a, const char* b )			{ return a.str() == b; }
+	inline bool operator==( const char* a, const Symbol& b )			{ return a == b.str(); }
+	inline bool operator!=( const Symbol& a, const std::string& b )		{ return !( a == b ); }
+	inline bool operator!=( const std::string& a, const Symbol& b )		{ return !( a == b ); }
+	inline bool operator!=( const Symbol& a, const char* b )			{ return !( a == b ); }
+	inline bool operator!=( const char* a, const Symbol& b )			{ return !( a == b ); }
+
+	// Ordering is lexical, so that sorted containers of Symbols order just as they would with std::string.
+	//
+	inline bool operator<( const Symbol& a, const Symbol& b )			{ return a != b && a.str() < b.str(); }
+	inline bool operator>( const Symbol& a, const Symbol& b )			{ return b < a; }
+	inline bool operator<=( const Symbol& a, const Symbol& b )			{ return !( b < a ); }
+	inline bool operator>=( const Symbol& a, const Symbol& b )			{ return !( a < b ); }
+
+	inline std::string operator+( const Symbol& a, const std::string& b )	{ return a.str() + b; }
+	inline std::string operator+( const std::string& a, const Symbol& b )	{ return a + b.str(); }
+	inline std::string operator+( const Symbol& a, const char* b )			{ return a.str() + b; }
+	inline std::string operator+( const char* a, const Symbol& b )			{ return a + b.str(); }
+	inline std::string operator+( const Symbol& a, char b )					{ return a.str() + b; }
+	inline std::string operator+( const Symbol& a, const Symbol& b )		{ return a.str() + b.str(); }
+
+	inline std::ostream& operator<<( std::ostream& out, const Symbol& s )
+	{
+		out << s.str();
+		return out;
+	}
+
+	inline std::istream& operator>>( std::istream& in, Symbol& s )
+	{
+		std::string str;
+		in >> str;
+		s = std::move( str );
+		return in;
+	}
+
+	///////////////////////////////////////////////////////////////////////////////////
+	// Inline implementation
+
+	inline Symbol::Symbol( const Symbol& s )
+	:	m_entry( s.m_entry )
+	{
+		addReference();
+	}
+
+	inline Symbol::Symbol( Symbol&& s ) noexcept
+	:	m_entry( s.m_entry )
+	{
+		s.m_entry = nullptr;
+	}
+
+	inline Symbol::~Symbol()
+	{
+		release();
+	}
+
+	inline Symbol& Symbol::operator=( const Symbol& s )
+	{
+		if( m_entry != s.m_entry )
+		{
+			s.addReference();
+			release();
+			m_entry = s.m_entry;
+		}
+		return *this;
+	}
+
+	inline Symbol& Symbol::operator=( Symbol&& s ) noexcept
+	{
+		if( this != &s )
+		{
+			release();
+			m_entry = s.m_entry;
+			s.m_entry = nullptr;
+		}
+		return *this;
+	}
+
+	inline const std::string& Symbol::str() const
+	{
+		return m_entry ? m_entry->string : emptyString();
+	}
+
+	inline size_t Symbol::hash() const
+	{
+		return m_entry ? m_entry->hash : 0;
+	}
+
+	inline void Symbol::release()
+	{
+		if( m_entry )
+		{
+			// Only the holder of what might be the last reference needs the table lock.
+			//
+			int nReferences = m_entry->nReferences.load( std::memory_order_relaxed );
+			while( nReferences > 1 )
+			{
+				if( m_entry->nReferences.compare_exchange_weak( nReferences, nReferences - 1, std::memory_order_release, std::memory_order_relaxed ))
+				{
+					m_entry = nullptr;
+					return;
+				}
+			}
+
+			releaseLast( m_entry );
+			m_entry = nullptr;
+		}
+	}
+}
+
+namespace std
+{
+	template<>
+	struct hash< fr::Symbol >
+	{
+		size_t operator()( const fr::Symbol& s ) const		{ return s.hash(); }
+	};
+}
+
+#endif
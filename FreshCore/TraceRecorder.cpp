@@ -0,0 +1,406 @@
+//
+//  TraceRecorder.cpp
+//  Fresh
+//
+
+#include "TraceRecorder.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+	using namespace fr::trace;
+
+	// While a capture is running, an export skips this many of the oldest events in each full buffer,
+	// since their thread may be overwriting them.
+	//
+	const size_t EXPORT_SAFETY_MARGIN = 4096;
+
+	struct Event
+	{
+		uint64_t nanoseconds;
+		ScopeId scope;
+		uint32_t isEnd;
+	};
+
+	struct ThreadBuffer
+	{
+		std::unique_ptr< Event[] > events;				// Allocated when the thread first records. Set and reset under the registry lock.
+		std::atomic< uint64_t > nWritten{ 0 };			// Only the owning thread writes this.
+		uint64_t nWrittenAtCaptureStart = 0;
+		uint32_t threadIndex = 0;
+		std::string name;
+
+		// When the thread exits, the events an export could still read move here and the ring is freed.
+		//
+		bool hasExited = false;
+		std::vector< Event > retainedEvents;
+	};
+
+	// The registry is never destroyed, since threads may record during static destruction.
+	//
+	struct Registry
+	{
+		std::mutex mutex;
+		std::vector< std::string > scopeNames;
+		std::unordered_map< std::string, ScopeId > scopeIds;
+		std::vector< std::unique_ptr< ThreadBuffer >> threads;
+		uint32_t nThreadsRegistered = 0;
+		uint64_t captureStartNanoseconds = 0;
+	};
+
+	Registry& registry()
+	{
+		static Registry* theRegistry = new Registry;
+		return *theRegistry;
+	}
+
+	// The first event of a thread's buffer that an export may safely read.
+	//
+	uint64_t firstReadableEvent( const ThreadBuffer& thread, uint64_t nWritten, bool isStillCapturing )
+	{
+		uint64_t first = thread.nWrittenAtCaptureStart;
+		if( nWritten - first > EVENTS_PER_THREAD )
+		{
+			first = nWritten - EVENTS_PER_THREAD + ( isStillCapturing ? EXPORT_SAFETY_MARGIN : 0 );
+		}
+		return first;
+	}
+
+	// Calls fn( event ) for each event of the thread that an export may read, oldest first.
+	// REQUIRES( the registry lock is held );
+	//
+	template< typename FunctionT >
+	void forEachReadableEvent( const ThreadBuffer& thread, bool isStillCapturing, FunctionT&& fn )
+	{
+		if( thread.hasExited )
+		{
+			for( const Event& event : thread.retainedEvents )
+			{
+				if( !fn( event )) break;
+			}
+		}
+		else if( thread.events )
+		{
+			const uint64_t nWritten = thread.nWritten.load( std::memory_order_acquire );
+			for( uint64_t i = firstReadableEvent( thread, nWritten, isStillCapturing ); i < nWritten; ++i )
+			{
+				if( !fn( thread.events[ i & ( EVENTS_PER_THREAD - 1 ) ] )) break;
+			}
+		}
+	}
+
+	thread_local ThreadBuffer* t_buffer = nullptr;
+	thread_local bool t_hasExited = false;
+
+	// Frees the thread's ring when the thread exits, keeping only what an export could still read.
+	//
+	struct ThreadExit
+	{
+		~ThreadExit()
+		{
+			t_hasExited = true;
+			if( !t_buffer )
+			{
+				return;
+			}
+
+			auto& reg = registry();
+			std::lock_guard< std::mutex > lock{ reg.mutex };
+
+			ThreadBuffer& buffer = *t_buffer;
+			t_buffer = nullptr;
+
+			forEachReadableEvent( buffer, false, [&]( const Event& event ) { buffer.retainedEvents.push_back( event ); return true; } );
+			buffer.retainedEvents.shrink_to_fit();
+			buffer.events.reset();
+			buffer.hasExited = true;
+
+			if( buffer.retainedEvents.empty() )
+			{
+				reg.threads.erase( std::find_if( reg.threads.begin(), reg.threads.end(), [&]( const std::unique_ptr< ThreadBuffer >& thread ) { return thread.get() == &buffer; } ));
+			}
+		}
+	};
+
+	thread_local ThreadExit t_threadExit;
+
+	// Null once the thread has begun to exit.
+	//
+	ThreadBuffer* threadBuffer()
+	{
+		if( !t_buffer && !t_hasExited )
+		{
+			auto& reg = registry();
+			std::lock_guard< std::mutex > lock{ reg.mutex };
+
+			std::unique_ptr< ThreadBuffer > buffer{ new ThreadBuffer };
+			buffer->threadIndex = ++reg.nThreadsRegistered;
+			t_buffer = buffer.get();
+			reg.threads.push_back( std::move( buffer ));
+
+			( void ) &t_threadExit;		// Constructs it, so that it is destroyed when the thread exits.
+		}
+		return t_buffer;
+	}
+
+	void record( ScopeId scope, bool isEnd )
+	{
+		ThreadBuffer* const buffer = threadBuffer();
+		if( !buffer )
+		{
+			return;
+		}
+
+		if( !buffer->events )
+		{
+			// Exports read the pointer under the lock.
+			//
+			std::unique_ptr< Event[] > events{ new Event[ EVENTS_PER_THREAD ] };
+			std::lock_guard< std::mutex > lock{ registry().mutex };
+			buffer->events = std::move( events );
+		}
+
+		const uint64_t n = buffer->nWritten.load( std::memory_order_relaxed );
+		buffer->events[ n & ( EVENTS_PER_THREAD - 1 ) ] = Event{ nowNanoseconds(), scope, isEnd };
+		buffer->nWritten.store( n + 1, std::memory_order_release );
+	}
+
+	void writeJsonString( std::ostream& out, const std::string& s )
+	{
+		out << '"';
+		for( const char c : s )
+		{
+			switch( c )
+			{
+				case '"': out << "\\\""; break;
+				case '\\': out << "\\\\"; break;
+				case '\n': out << "\\n"; break;
+				case '\t': out << "\\t"; break;
+				default: out << c; break;
+			}
+		}
+		out << '"';
+	}
+}
+
+namespace fr
+{
+	namespace trace
+	{
+		static_assert(( EVENTS_PER_THREAD & ( EVENTS_PER_THREAD - 1 )) == 0, "EVENTS_PER_THREAD must be a power of two." );
+
+		namespace detail
+		{
+			std::atomic_bool g_isCapturing{ false };
+
+			void recordBegin( ScopeId scope )
+			{
+				record( scope, false );
+			}
+
+			void recordEnd( ScopeId scope )
+			{
+				record( scope, true );
+			}
+		}
+
+		ScopeId registerScope( const char* name )
+		{
+			auto& reg = registry();
+			std::lock_guard< std::mutex > lock{ reg.mutex };
+
+			const auto iter = reg.scopeIds.find( name );
+			if( iter != reg.scopeIds.end() )
+			{
+				return iter->second;
+			}
+
+			const ScopeId id = static_cast< ScopeId >( reg.scopeNames.size() );
+			reg.scopeNames.push_back( name );
+			reg.scopeIds[ name ] = id;
+			return id;
+		}
+
+		void nameThread( const char* name )
+		{
+			if( ThreadBuffer* const buffer = threadBuffer() )
+			{
+				std::lock_guard< std::mutex > lock{ registry().mutex };
+				buffer->name = name;
+			}
+		}
+
+		void startCapture()
+		{
+			auto& reg = registry();
+			std::lock_guard< std::mutex > lock{ reg.mutex };
+
+			// Threads that have exited have nothing to add to a new capture.
+			//
+			reg.threads.erase( std::remove_if( reg.threads.begin(), reg.threads.end(), []( const std::unique_ptr< ThreadBuffer >& thread ) { return thread->hasExited; } ),
+							   reg.threads.end() );
+
+			for( const auto& thread : reg.threads )
+			{
+				thread->nWrittenAtCaptureStart = thread->nWritten.load( std::memory_order_acquire );
+			}
+			reg.captureStartNanoseconds = nowNanoseconds();
+
+			detail::g_isCapturing = true;
+		}
+
+		void stopCapture()
+		{
+			detail::g_isCapturing = false;
+		}
+
+		void writeChromeTrace( std::ostream& out )
+		{
+			auto& reg = registry();
+			std::lock_guard< std::mutex > lock{ reg.mutex };
+
+			const bool isStillCapturing = isCapturing();
+
+			out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+			bool isFirst = true;
+			const auto separate = [&]()
+			{
+				out << ( isFirst ? "" : ",\n" );
+				isFirst = false;
+			};
+
+			out << std::fixed << std::setprecision( 3 );
+
+			for( const auto& thread : reg.threads )
+			{
+				if( !thread->name.empty() )
+				{
+					separate();
+					out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread->threadIndex << ",\"args\":{\"name\":";
+					writeJsonString( out, thread->name );
+					out << "}}";
+				}
+
+				// Ends whose beginnings were overwritten (or came before the capture) would confuse viewers.
+				//
+				size_t depth = 0;
+				forEachReadableEvent( *thread, isStillCapturing, [&]( const Event& event )
+				{
+					if( event.isEnd )
+					{
+						if( depth == 0 ) return true;
+						--depth;
+					}
+					else
+					{
+						++depth;
+					}
+
+					separate();
+					out << "{\"name\":";
+					writeJsonString( out, event.scope < reg.scopeNames.size() ? reg.scopeNames[ event.scope ] : "?" );
+					out << ",\"ph\":\"" << ( event.isEnd ? 'E' : 'B' ) << "\",\"pid\":1,\"tid\":" << thread->threadIndex
+						<< ",\"ts\":" << ( event.nanoseconds - std::min( event.nanoseconds, reg.captureStartNanoseconds )) / 1000.0 << "}";
+					return true;
+				} );
+			}
+
+			out << "\n]}\n";
+		}
+
+		uint64_t nowNanoseconds()
+		{
+			return std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::steady_clock::now().time_since_epoch() ).count();
+		}
+
+		std::vector< ScopeTotal > scopeTotals( uint64_t fromNanoseconds, uint64_t toNanoseconds, size_t maxScopes )
+		{
+			auto& reg = registry();
+			std::lock_guard< std::mutex > lock{ reg.mutex };
+
+			const bool isStillCapturing = isCapturing();
+			const uint64_t now = nowNanoseconds();
+
+			std::vector< ScopeTotal > totals;
+
+			struct OpenScope
+			{
+				ScopeId scope;
+				uint64_t beginNanoseconds;
+			};
+			std::vector< OpenScope > openScopes;
+			std::unordered_map< ScopeId, size_t > totalIndices;		// For the current thread.
+
+			const auto add = [&]( const ThreadBuffer& thread, ScopeId scope, uint64_t begin, uint64_t end )
+			{
+				begin = std::max( begin, fromNanoseconds );
+				end = std::min( end, toNanoseconds );
+				if( begin >= end )
+				{
+					return;
+				}
+
+				auto iter = totalIndices.find( scope );
+				if( iter == totalIndices.end() )
+				{
+					iter = totalIndices.emplace( scope, totals.size() ).first;
+
+					ScopeTotal total;
+					total.name = scope < reg.scopeNames.size() ? reg.scopeNames[ scope ] : "?";
+					total.threadName = thread.name;
+					totals.push_back( std::move( total ));
+				}
+
+				auto& total = totals[ iter->second ];
+				++total.nCalls;
+				total.nanoseconds += end - begin;
+			};
+
+			for( const auto& thread : reg.threads )
+			{
+				openScopes.clear();
+				totalIndices.clear();
+
+				forEachReadableEvent( *thread, isStillCapturing, [&]( const Event& event )
+				{
+					if( event.nanoseconds >= toNanoseconds )
+					{
+						return false;
+					}
+
+					if( !event.isEnd )
+					{
+						openScopes.push_back( OpenScope{ event.scope, event.nanoseconds } );
+					}
+					else if( !openScopes.empty() )
+					{
+						add( *thread, openScopes.back().scope, openScopes.back().beginNanoseconds, event.nanoseconds );
+						openScopes.pop_back();
+					}
+					return true;
+				} );
+
+				// Scopes still open were active through the end of the span (or are active now).
+				//
+				for( const auto& open : openScopes )
+				{
+					add( *thread, open.scope, open.beginNanoseconds, now );
+				}
+			}
+
+			std::sort( totals.begin(), totals.end(), []( const ScopeTotal& a, const ScopeTotal& b ) { return a.nanoseconds > b.nanoseconds; } );
+			if( totals.size() > maxScopes )
+			{
+				totals.resize( maxScopes );
+			}
+			return totals;
+		}
+	}
+}
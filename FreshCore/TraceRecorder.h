@@ -0,0 +1,137 @@
+//
+//  TraceRecorder.h
+//  Fresh
+//
+
+#ifndef Fresh_TraceRecorder_h
+#define Fresh_TraceRecorder_h
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// The trace recorder is cheap enough to leave compiled into release builds: while no capture is running,
+// a scope costs one relaxed load and a branch. Define FRESH_TRACE_ENABLED to 0 to compile it out altogether.
+//
+#ifndef FRESH_TRACE_ENABLED
+#	define FRESH_TRACE_ENABLED 1
+#endif
+
+#ifdef _MSC_VER
+#	define FRESH_TRACE_CURRENT_FUNCTION __FUNCSIG__
+#else
+#	define FRESH_TRACE_CURRENT_FUNCTION __PRETTY_FUNCTION__
+#endif
+
+namespace fr
+{
+	// The trace recorder records the beginning and end of each TIMER_AUTO() scope (see Profiler.h) while a capture
+	// is running, and writes what it recorded as Chrome trace JSON, which chrome://tracing and Perfetto can show.
+	//
+	// Each scope site registers its name once, in a function-local static, and records only the resulting id.
+	// Each thread records into its own ring buffer, so recording takes no locks; once a thread's buffer is full,
+	// its oldest events are overwritten. When a thread exits its buffer is freed, and only the events of the current
+	// capture are kept, until the next capture starts. Timestamps are in nanoseconds from a steady clock.
+	//
+	namespace trace
+	{
+		typedef uint32_t ScopeId;
+
+		const size_t EVENTS_PER_THREAD = 1 << 18;		// 4MB per recording thread.
+
+		ScopeId registerScope( const char* name );
+		// Returns the same id for the same name, however often it's called.
+
+		void nameThread( const char* name );
+		// Names the calling thread in exported traces.
+
+		void startCapture();
+		void stopCapture();
+
+		void writeChromeTrace( std::ostream& out );
+		// Writes the events of the last (or the current) capture.
+
+		uint64_t nowNanoseconds();
+		// The clock that recorded events are stamped with.
+
+		struct ScopeTotal
+		{
+			std::string name;
+			std::string threadName;
+			size_t nCalls = 0;
+			uint64_t nanoseconds = 0;
+		};
+
+		std::vector< ScopeTotal > scopeTotals( uint64_t fromNanoseconds, uint64_t toNanoseconds, size_t maxScopes );
+		// Totals the time each recorded scope, on each thread, spent between the given times, including scopes that
+		// began earlier or haven't ended yet. Returns the largest maxScopes totals, largest first.
+		// Nested scopes each count their full time.
+
+		namespace detail
+		{
+			extern std::atomic_bool g_isCapturing;
+
+			void recordBegin( ScopeId scope );
+			void recordEnd( ScopeId scope );
+		}
+
+		inline bool isCapturing()
+		{
+			return detail::g_isCapturing.load( std::memory_order_relaxed );
+		}
+
+		// Records a scope from construction to destruction. If a capture starts partway through the scope,
+		// the scope isn't recorded; if one stops, the end still is.
+		//
+		class AutoScope
+		{
+		public:
+
+			explicit AutoScope( ScopeId scope )
+			:	m_isRecording( isCapturing() )
+			,	m_scope( scope )
+			{
+				if( m_isRecording )
+				{
+					detail::recordBegin( m_scope );
+				}
+			}
+
+			~AutoScope()
+			{
+				if( m_isRecording )
+				{
+					detail::recordEnd( m_scope );
+				}
+			}
+
+		private:
+
+			const bool m_isRecording;
+			const ScopeId m_scope;
+
+			AutoScope( const AutoScope& ) = delete;
+			void operator=( const AutoScope& ) = delete;
+		};
+
+		inline void begin( ScopeId scope )
+		{
+			if( isCapturing() )
+			{
+				detail::recordBegin( scope );
+			}
+		}
+
+		inline void end( ScopeId scope )
+		{
+			if( isCapturing() )
+			{
+				detail::recordEnd( scope );
+			}
+		}
+	}
+}
+
+#endif
@@ -16,12 +16,89 @@
 
 namespace fr
 {
+	template< typename Real > class Vector2;
+	template< typename Real > class Vector3;
+	template< typename Real > class Vector4;
+	template< typename Real > class Rectangle;
+	template< typename T > class Range;
+	template< typename BaseT > class Angle;
+	class Color;
+	
+	// Whether a property type's parsed value may be remembered on the Manifest::Value it was parsed from
+	// (see Manifest::Value::parsed()) and simply assigned the next time that value is loaded.
+	// Only value types whose parsing depends on nothing but the text qualify. Object pointers do not: parsing them
+	// creates or finds objects and registers fixups.
+	//
+	template< typename T >
+	struct ParsedValueCaching
+	{
+		static const bool enabled = std::is_arithmetic< T >::value || std::is_enum< T >::value;
+		static bool canCache( const std::string& ) { return enabled; }
+	};
+	
+	template<>
+	struct ParsedValueCaching< std::string >
+	{
+		static const bool enabled = true;
+		
+		// String table references ("!identifier", as Destringifier reads them: a '!' before any other text) must be
+		// looked up every time, since the language may change. Other text may contain '!' freely.
+		static bool canCache( const std::string& text )
+		{
+			const auto start = text.find_first_not_of( " \t\n" );
+			return start == std::string::npos || text[ start ] != '!';
+		}
+	};
+	
+	template< typename T > struct ValueTypeParsedValueCaching
+	{
+		static const bool enabled = true;
+		static bool canCache( const std::string& ) { return true; }
+	};
+	
+	template< typename Real > struct ParsedValueCaching< Vector2< Real >> : public ValueTypeParsedValueCaching< Vector2< Real >> {};
+	template< typename Real > struct ParsedValueCaching< Vector3< Real >> : public ValueTypeParsedValueCaching< Vector3< Real >> {};
+	template< typename Real > struct ParsedValueCaching< Vector4< Real >> : public ValueTypeParsedValueCaching< Vector4< Real >> {};
+	template< typename Real > struct ParsedValueCaching< Rectangle< Real >> : public ValueTypeParsedValueCaching< Rectangle< Real >> {};
+	template< typename T > struct ParsedValueCaching< Range< T >> : public ValueTypeParsedValueCaching< Range< T >> {};
+	template< typename BaseT > struct ParsedValueCaching< Angle< BaseT >> : public ValueTypeParsedValueCaching< Angle< BaseT >> {};
+	template<> struct ParsedValueCaching< Color > : public ValueTypeParsedValueCaching< Color > {};
 	
 	template< typename PropertyT >
 	void assignObjectProperty( PropertyT& property, const Manifest::Value& value )
 	{
 		if( value.is< std::string >() )
 		{
+			if constexpr( ParsedValueCaching< PropertyT >::enabled )
+			{
+				if( const PropertyT* parsed = value.parsed< PropertyT >() )
+				{
+					property = *parsed;
+					return;
+				}
+				
+				if( ParsedValueCaching< PropertyT >::canCache( value.get< std::string >() ))
+				{
+					// Parse into the current value, exactly as uncached parsing does. Remember the result only if parsing
+					// into a fresh value gives the same, so that text that sets only part of a value isn't remembered
+					// along with whatever this object happened to hold.
+					//
+					{
+						Destringifier destringifier( value.get< std::string >() );
+						destringifier >> property;
+					}
+					
+					PropertyT fresh{};
+					Destringifier destringifier( value.get< std::string >() );
+					destringifier >> fresh;
+					if( fresh == property )
+					{
+						value.setParsed( std::move( fresh ));
+					}
+					return;
+				}
+			}
+			
 			Destringifier destringifier( value.get< std::string >() );
 			destringifier >> property;
 		}
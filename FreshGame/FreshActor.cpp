@@ -151,6 +151,21 @@ namespace fr
 			ASSERT( !m_controller->host() );
 			m_controller->possess( *this );
 		}
+		
+		if( const auto world = firstAncestorOfType< FreshWorld >( *this ))
+		{
+			world->registerActor( *this );
+		}
+	}
+	
+	void FreshActor::onRemovingFromStage()
+	{
+		if( m_registeredWorld )
+		{
+			m_registeredWorld->unregisterActor( *this );
+		}
+		
+		Super::onRemovingFromStage();
 	}
 	
 	void FreshActor::applyControllerImpulse( const vec2& i )
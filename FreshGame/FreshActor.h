@@ -68,6 +68,7 @@ namespace fr
 		
 		virtual void postLoad() override;
 		virtual void onAddedToStage() override;
+		virtual void onRemovingFromStage() override;
 		
 	protected:
 
@@ -116,6 +117,11 @@ namespace fr
 
 		bool m_areDynamicLightBlockersDirty = true;
 		
+		WeakPtr< FreshWorld > m_registeredWorld;
+		size_t m_broadphaseHandle = ~size_t( 0 );
+		
+		friend class FreshWorld;
+		
 		VAR( SmartPtr< FreshActorController >, m_controller );
 	};
 	
@@ -127,6 +127,7 @@ namespace fr
 	///////////////////////////////////////////////////////////////////////////////////
 
 	FRESH_DEFINE_CLASS( Tile )
+	FRESH_POOL_CLASS_OBJECTS( Tile )
 
 	DEFINE_VAR( Tile, TileTemplate::ptr, m_tileTemplate );
 	DEFINE_VAR( Tile, Solidity, m_solidity );
@@ -180,6 +181,8 @@ namespace fr
 	DEFINE_VAR( FreshTileGrid, bool, m_nullTemplateIsSolid );
 	DEFINE_VAR( FreshTileGrid, uint, m_collisionMask );
 	DEFINE_VAR( FreshTileGrid, uint, m_collisionRefusalMask );
+	DEFINE_VAR( FreshTileGrid, bool, m_useJumpPointSearch );
+	DEFINE_VAR( FreshTileGrid, bool, m_useJumpPointTable );
 
 	FRESH_IMPLEMENT_STANDARD_CONSTRUCTORS( FreshTileGrid )
 
@@ -310,21 +313,28 @@ namespace fr
 	}
 
     std::vector< int > FreshTileGrid::getNeighbors( int tileIndex, real actorSize ) const
+    {
+        int neighbors[ Direction::NUM_DIRECTIONS ];
+        return std::vector< int >( neighbors, neighbors + getNeighbors( tileIndex, neighbors, actorSize ));
+    }
+
+    size_t FreshTileGrid::getNeighbors( int tileIndex, int* outNeighbors, real actorSize ) const
     {
         Vector2i tilePos = tileIndexToVec( tileIndex );
     
-        std::vector< int > neighbors;
+        size_t nNeighbors = 0;
         
         for( Direction dir; dir.valid(); ++dir )
         {
             const Vector2i neighborPos = tilePos + dir;
             if( isValidPathingNeighbor( tilePos, neighborPos, actorSize, false ))       // TODO skip unreachable neighbors?
             {
-                neighbors.push_back( tileVecToIndex( neighborPos ) );
+                ASSERT( nNeighbors < Direction::NUM_DIRECTIONS );
+                outNeighbors[ nNeighbors++ ] = tileVecToIndex( neighborPos );
             }
         }
         
-        return neighbors;
+        return nNeighbors;
     }
 
 	void FreshTileGrid::loadGridFromVector( const Vector2i& extents, const std::vector< size_t >& templateIndices )
@@ -361,6 +371,7 @@ namespace fr
 
 		calcStaticBlockers();
 		markDirty();
+		navigationChanged();
 	}
 
 	void FreshTileGrid::loadGridFromTexture( const Texture& texture )
@@ -400,6 +411,7 @@ namespace fr
 
 		calcStaticBlockers();
 		markDirty();
+		navigationChanged();
 	}
 
 	void FreshTileGrid::loadGridFromText( const std::string& text )
@@ -471,6 +483,7 @@ namespace fr
 
 		calcStaticBlockers();
 		markDirty();
+		navigationChanged();
 	}
 
 	void FreshTileGrid::markDirty()
@@ -786,12 +799,13 @@ namespace fr
 
 	struct TileGridNavigationHelper
 	{
-		static FreshTileGrid::ptr tileGrid;
-		static real actorSize;
-
 		typedef int	    Node;
 		typedef real	Cost;
 
+		static FreshTileGrid::ptr tileGrid;
+		static real actorSize;
+		static PathFinderScratch< Node, Cost > scratch;		// Reused by every query.
+
 		static Tile& tile( Node n )
 		{
 			ASSERT( tileGrid );
@@ -805,10 +819,10 @@ namespace fr
             return fr::Direction( tileGrid->tileIndexToVec( to ) - tileGrid->tileIndexToVec( from ));
 		}
         
-        static std::vector< Node > getNeighbors( Node n )
+        static size_t getNeighbors( Node n, Node* outNeighbors )
         {
             ASSERT( tileGrid );
-            return tileGrid->getNeighbors( n );
+            return tileGrid->getNeighbors( n, outNeighbors );
         }
         
 		static Cost nodeDistance( Node fromIndex, Node toIndex )
@@ -846,6 +860,7 @@ namespace fr
 
 	FreshTileGrid::ptr TileGridNavigationHelper::tileGrid = nullptr;
 	real TileGridNavigationHelper::actorSize = 0;
+	PathFinderScratch< TileGridNavigationHelper::Node, TileGridNavigationHelper::Cost > TileGridNavigationHelper::scratch;
 
 	////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -871,12 +886,14 @@ namespace fr
 		m_tiles.resize( newExtents, oldOffsetIntoNew, {} );
 
 		fillNullTiles();
+		navigationChanged();
 	}
 
 	void FreshTileGrid::resizeToInclude( const Vector2i& pos )
 	{
 		m_tiles.resizeToInclude( pos, {} );
 		fillNullTiles();
+		navigationChanged();
 	}
 
 	void FreshTileGrid::resizeToInclude( const vec2& pos )
@@ -1170,22 +1187,37 @@ namespace fr
 
 	bool FreshTileGrid::findClosestPath( const Vector2i& start, const Vector2i& goal, Path& outPath, real actorRadius )
 	{
+		outPath.clear();
+
+		// Neighbors are always in bounds, so there's no path to or from outside.
+		//
+		if( !isInBounds( start ) || !isInBounds( goal ))
+		{
+			return false;
+		}
+
+		// Jump point search finds paths as short as A*'s. Like A*'s neighbors, it doesn't depend on actorRadius.
+		//
+		if( m_useJumpPointSearch && updateJumpPointGrid() )
+		{
+			return m_jumpPointGrid.findPath( start, goal, outPath );
+		}
+
 		TileGridNavigationHelper::tileGrid = this;
 		TileGridNavigationHelper::actorSize = actorRadius;
 
 		// Find a path through the graph.
 		//
-		PathFinder<
-            int,
-            SystemClock,
-            real
-		> pathFinder(tileVecToIndex( start ),
+		auto pathFinder = makeHeapPathFinder< Direction::NUM_DIRECTIONS >(
+					 TileGridNavigationHelper::scratch,
+					 tileVecToIndex( start ),
 					 tileVecToIndex( goal ),
 					 std::numeric_limits< int >::min(),
-					 std::bind( TileGridNavigationHelper::getHeuristicEstimate, _1, _2 ),
-                     std::bind( TileGridNavigationHelper::getNeighbors, _1 ),
-                     std::bind( TileGridNavigationHelper::nodeDistance, _1, _2 ),
-                     []() { return fr::getAbsoluteTimeClocks(); }
+					 []( int a, int b ) { return TileGridNavigationHelper::getHeuristicEstimate( a, b ); },
+					 []( int node, int* outNeighbors ) { return TileGridNavigationHelper::getNeighbors( node, outNeighbors ); },
+					 []( int a, int b ) { return TileGridNavigationHelper::nodeDistance( a, b ); },
+					 []() { return fr::getAbsoluteTimeClocks(); },
+					 []( int node ) { return size_t( node ); }
 					 );
 
 		bool needsMoreTime = true;
@@ -1195,7 +1227,6 @@ namespace fr
 			foundPath = pathFinder.findPath( needsMoreTime );
 		}
 
-		outPath.clear();
 		if( foundPath )
 		{
             const auto pathIndexes = pathFinder.path();
@@ -1207,6 +1238,67 @@ namespace fr
 		return foundPath;
 	}
 
+	void FreshTileGrid::navigationChanged()
+	{
+		m_isJumpPointGridCurrent = false;
+	}
+
+	bool FreshTileGrid::updateJumpPointGrid()
+	{
+		if( m_isJumpPointGridCurrent )
+		{
+			return m_isJumpPointGridUsable;
+		}
+		m_isJumpPointGridCurrent = true;
+		m_isJumpPointGridUsable = false;
+
+		// A tile is open if it may be entered and left in every direction. Tiles that allow only some directions, or
+		// that cost more or less than the rest, need A*.
+		//
+		m_jumpPointGrid.reset( extents() );
+
+		real uniformCost = -1;
+		for( Vector2i pos( 0, 0 ); pos.y < extents().y; ++pos.y )
+		{
+			for( pos.x = 0; pos.x < extents().x; ++pos.x )
+			{
+				const auto& tile = getTile( pos );
+
+				Direction dir;
+				const bool isNavigable = tile.isNavigable( dir );
+				for( ++dir; dir.valid(); ++dir )
+				{
+					if( tile.isNavigable( dir ) != isNavigable )
+					{
+						return false;
+					}
+				}
+
+				if( isNavigable )
+				{
+					const real cost = tile.navDistanceScalar();
+					if( uniformCost < 0 )
+					{
+						uniformCost = cost;
+					}
+					else if( cost != uniformCost )
+					{
+						return false;
+					}
+					m_jumpPointGrid.isOpen( pos, true );
+				}
+			}
+		}
+
+		if( m_useJumpPointTable )
+		{
+			m_jumpPointGrid.buildJumpTable();
+		}
+
+		m_isJumpPointGridUsable = true;
+		return true;
+	}
+
 	bool FreshTileGrid::findClosestPath( const Vector2i& start, const Vector2i& goal, WorldSpacePath& outPath, real actorRadius )
 	{
 		Path path;
@@ -14,6 +14,7 @@
 #include "FreshMath.h"
 #include "Grid2.h"
 #include "Segment.h"
+#include "JumpPointSearch.h"
 
 namespace fr
 {
@@ -234,6 +235,10 @@ namespace fr
 			return findClosestPath( worldToTileSpace( start ), worldToTileSpace( goal ), outPath, actorRadius );
 		}
 
+		void navigationChanged();
+		// With jump point search enabled, paths come from a snapshot of each tile's navigability and cost.
+		// setTile(), resize() and loading refresh it; call this after changing tiles in place.
+
 		template< typename IterT >
 		void convertToWorldSpacePath( Path::const_iterator begin, Path::const_iterator end, IterT out );
 
@@ -247,6 +252,9 @@ namespace fr
 		// REQUIRES( minDistance >= 0 );
 		
 		std::vector< int > getNeighbors( int tileIndex, real actorSize = 0 ) const;
+		size_t getNeighbors( int tileIndex, int* outNeighbors, real actorSize = 0 ) const;
+		// REQUIRES( outNeighbors has room for Direction::NUM_DIRECTIONS );
+		// Returns the number written.
 
 		void loadGridFromVector( const Vector2i& extents, const std::vector< size_t >& templateIndices );
 		void loadGridFromTexture( const Texture& texture );
@@ -304,7 +312,19 @@ namespace fr
 		DVAR( uint, m_collisionMask, ~0 );
 		DVAR( uint, m_collisionRefusalMask, 0 );
 
+		// Jump point search replaces A* in findClosestPath() while every navigable tile costs the same and is navigable
+		// from every direction. The jump table (JPS+) makes searches faster still, but must be rebuilt on every change.
+		//
+		DVAR( bool, m_useJumpPointSearch, false );
+		DVAR( bool, m_useJumpPointTable, false );
+
 		Tiles m_tiles;
+		
+		JumpPointGrid m_jumpPointGrid;
+		bool m_isJumpPointGridCurrent = false;
+		bool m_isJumpPointGridUsable = false;
+		
+		bool updateJumpPointGrid();
         
         bool m_hasAddedStockTemplates = false;
 		
@@ -373,6 +393,7 @@ namespace fr
     {
         ASSERT( isInBounds( pos ));
         m_tiles.setCellAt( pos, tile );
+        navigationChanged();
     }
 
     inline void FreshTileGrid::setTile( const vec2& pos, Tile::ptr tile )
@@ -13,6 +13,7 @@
 #include "Camera.h"
 #include "Lighting.h"
 #include "Stage.h"
+#include "FreshThread.h"
 
 namespace fr
 {
@@ -46,6 +47,10 @@ namespace fr
 	DEFINE_VAR( FreshWorld, vec2, m_gravity );
 	DEFINE_VAR( FreshWorld, SmartPtr< Camera >, m_camera );
 	DEFINE_VAR( FreshWorld, std::vector< Attachment::ptr >, m_attachments );
+	DEFINE_VAR( FreshWorld, real, m_broadphaseCellSize );
+	DEFINE_VAR( FreshWorld, real, m_broadphaseMargin );
+	DEFINE_VAR( FreshWorld, bool, m_resolveTileCollisionsInParallel );
+	DEFINE_VAR( FreshWorld, bool, m_resolveNestedWorldActors );
 	FRESH_IMPLEMENT_STANDARD_CONSTRUCTOR_INERT( FreshWorld )
 	
 	FRESH_CUSTOM_STANDARD_CONSTRUCTOR_NAMING( FreshWorld )
@@ -62,15 +67,18 @@ namespace fr
 		
 		updateAttachments();
 		
-		// Build a list of actor descendants.
+		// Visit the actors in display-tree order, the order in which they collide. Holding a copy of the list keeps
+		// actors removed from the stage during this step safe to visit.
 		//
-		std::vector< FreshActor::ptr > actors;
-		forEachDescendant< FreshActor >( [&]( FreshActor& actor )
-										{
-											actors.push_back( &actor );
-										} );
+		if( m_isActorOrderStale
+		   || m_actorOrderVersion != DisplayObjectContainer::childOrderVersion()
+		   || m_actorOrderIncludesNestedWorlds != m_resolveNestedWorldActors )
+		{
+			refreshActorOrder();
+		}
 		
-		updateActors( actors );
+		m_stepActors = m_orderedActors;
+		updateActors( m_stepActors );
 
 		// Update the camera.
 		//
@@ -96,28 +104,188 @@ namespace fr
 	{
 		// Resolve actor-tilegrid collisions.
 		//
+		// Each actor only moves itself here, so the actors may be resolved concurrently if their handlers allow it.
+		//
 		forEachChild< FreshTileGrid >( [&]( FreshTileGrid& tileGrid )
 									  {
-										  for( auto actor : actors )
+										  if( m_resolveTileCollisionsInParallel )
+										  {
+											  parallelFor( actors.begin(), actors.end(), [&]( const FreshActor::ptr& actor )
+														  {
+															  actor->resolveTileCollisions( tileGrid );
+														  } );
+										  }
+										  else
 										  {
-											  actor->resolveTileCollisions( tileGrid );
+											  for( auto actor : actors )
+											  {
+												  actor->resolveTileCollisions( tileGrid );
+											  }
 										  }
 									  } );
 		
 		// Resolve actor-actor collisions.
+		// Bring the broadphase up to date with where the actors are now, and map each one's handle to its place in the list.
 		//
-		for( auto outer = actors.begin(); outer != actors.end(); ++outer )
+		auto& grid = broadphase();
+		
+		const size_t NOT_STEPPING = ~size_t( 0 );
+		m_stepIndexByHandle.assign( m_stepIndexByHandle.size(), NOT_STEPPING );
+		
+		for( size_t i = 0; i < actors.size(); ++i )
 		{
-			for( auto inner = outer + 1; inner != actors.end(); ++inner )
+			auto& actor = *actors[ i ];
+			const auto handle = broadphaseHandle( actor );
+			if( handle == Broadphase::INVALID_HANDLE )
+			{
+				// Not on the stage under this world, so not in the broadphase.
+				//
+				continue;
+			}
+			
+			const auto bounds = actor.collisionBounds();
+			grid.move( handle, bounds.ulCorner() - vec2( m_broadphaseMargin ), bounds.brCorner() + vec2( m_broadphaseMargin ));
+			
+			if( handle >= m_stepIndexByHandle.size() )
 			{
-				const auto outerActor = *outer;
-				const auto innerActor = *inner;
-				
-				ASSERT( outerActor != innerActor );
-				
-				outerActor->resolveActorCollision( *innerActor );
+				m_stepIndexByHandle.resize( handle + 1, NOT_STEPPING );
 			}
+			m_stepIndexByHandle[ handle ] = i;
 		}
+		
+		// Gather the candidate pairs, then visit them in the order the full nested loop would have:
+		// by the first actor's place in the list, then the second's.
+		//
+		// Actors registered since the list was made aren't in it.
+		//
+		const auto stepIndex = [&]( const FreshActor& actor )
+		{
+			const auto handle = broadphaseHandle( actor );
+			return handle < m_stepIndexByHandle.size() ? m_stepIndexByHandle[ handle ] : NOT_STEPPING;
+		};
+		
+		m_candidatePairs.clear();
+		grid.eachPair( [&]( FreshActor* a, FreshActor* b )
+					  {
+						  size_t first = stepIndex( *a );
+						  size_t second = stepIndex( *b );
+						  
+						  if( first == NOT_STEPPING || second == NOT_STEPPING )
+						  {
+							  return;
+						  }
+						  
+						  if( second < first )
+						  {
+							  std::swap( first, second );
+						  }
+						  m_candidatePairs.emplace_back( first, second );
+					  } );
+		
+		std::sort( m_candidatePairs.begin(), m_candidatePairs.end() );
+		
+		for( const auto& pair : m_candidatePairs )
+		{
+			ASSERT( actors[ pair.first ] != actors[ pair.second ] );
+			actors[ pair.first ]->resolveActorCollision( *actors[ pair.second ] );
+		}
+	}
+	
+	FreshWorld::Broadphase& FreshWorld::broadphase()
+	{
+		if( !m_broadphase )
+		{
+			m_broadphase.reset( new Broadphase( 1024, m_broadphaseCellSize ));
+		}
+		return *m_broadphase;
+	}
+	
+	void FreshWorld::refreshActorOrder()
+	{
+		auto& grid = broadphase();
+		
+		// Nested worlds' actors get entries of their own in this world's broadphase. Rebuild them along with the order.
+		//
+		for( const auto& nestedActor : m_nestedActorHandles )
+		{
+			grid.remove( nestedActor.second );
+		}
+		m_nestedActorHandles.clear();
+		
+		m_orderedActors.clear();
+		forEachDescendant< FreshActor >( [&]( FreshActor& actor )
+										{
+											if( isActorRegistered( actor ))
+											{
+												m_orderedActors.push_back( &actor );
+											}
+											else if( m_resolveNestedWorldActors && actor.m_registeredWorld )
+											{
+												// Registered with its nearest world, which must be nested inside this one.
+												//
+												const auto bounds = actor.collisionBounds();
+												m_nestedActorHandles[ &actor ] = grid.add( bounds.ulCorner() - vec2( m_broadphaseMargin ), bounds.brCorner() + vec2( m_broadphaseMargin ), &actor );
+												m_orderedActors.push_back( &actor );
+											}
+										} );
+		
+		m_actorOrderVersion = DisplayObjectContainer::childOrderVersion();
+		m_actorOrderIncludesNestedWorlds = m_resolveNestedWorldActors;
+		m_isActorOrderStale = false;
+	}
+	
+	size_t FreshWorld::broadphaseHandle( const FreshActor& actor ) const
+	{
+		if( isActorRegistered( actor ))
+		{
+			return actor.m_broadphaseHandle;
+		}
+		
+		const auto iter = m_nestedActorHandles.find( &actor );
+		return iter != m_nestedActorHandles.end() ? iter->second : Broadphase::INVALID_HANDLE;
+	}
+	
+	void FreshWorld::registerActor( FreshActor& actor )
+	{
+		if( actor.m_registeredWorld )
+		{
+			actor.m_registeredWorld->unregisterActor( actor );
+		}
+		
+		const auto bounds = actor.collisionBounds();
+		actor.m_broadphaseHandle = broadphase().add( bounds.ulCorner() - vec2( m_broadphaseMargin ), bounds.brCorner() + vec2( m_broadphaseMargin ), &actor );
+		actor.m_registeredWorld = this;
+		
+		m_registeredActors.push_back( &actor );
+		m_isActorOrderStale = true;
+		
+		PROMISES( isActorRegistered( actor ));
+	}
+	
+	void FreshWorld::unregisterActor( FreshActor& actor )
+	{
+		if( !isActorRegistered( actor ))
+		{
+			return;
+		}
+		
+		ASSERT( m_broadphase );
+		m_broadphase->remove( actor.m_broadphaseHandle );
+		actor.m_broadphaseHandle = Broadphase::INVALID_HANDLE;
+		actor.m_registeredWorld = nullptr;
+		
+		auto iter = std::find( m_registeredActors.begin(), m_registeredActors.end(), &actor );
+		ASSERT( iter != m_registeredActors.end() );
+		*iter = m_registeredActors.back();
+		m_registeredActors.pop_back();
+		m_isActorOrderStale = true;
+		
+		PROMISES( !isActorRegistered( actor ));
+	}
+	
+	bool FreshWorld::isActorRegistered( const FreshActor& actor ) const
+	{
+		return actor.m_registeredWorld == this;
 	}
 	
 	void FreshWorld::updateCamera()
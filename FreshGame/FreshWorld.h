@@ -11,6 +11,8 @@
 
 #include "DisplayObjectContainer.h"
 #include "TimeServer.h"
+#include "SpatialGrid.h"
+#include <unordered_map>
 
 namespace fr
 {
@@ -60,6 +62,23 @@ namespace fr
 		
 		virtual TimeType time() const override;
 		
+		// Actors register themselves with their nearest world while they are on the stage.
+		// The world keeps them in a broadphase so that only nearby pairs are tested for collision.
+		// Each step resolves them in display-tree order, as a walk of the world's descendants finds them.
+		// The world remembers that order and walks again only after the display tree changes.
+		//
+		// Unless m_resolveNestedWorldActors is off, a world also steps the actors of worlds nested inside it,
+		// resolving them against its own actors (and, again, against one another) as well as their own world does.
+		//
+		void registerActor( FreshActor& actor );
+		// PROMISES( isActorRegistered( actor ));
+		// An actor registered with another world leaves it.
+		void unregisterActor( FreshActor& actor );
+		// PROMISES( !isActorRegistered( actor ));
+		// Does nothing if the actor is not registered here.
+		bool isActorRegistered( const FreshActor& actor ) const;
+		size_t numRegisteredActors() const						{ return m_registeredActors.size(); }
+		
 	protected:
 		
 		SYNTHESIZE_SET_DECL( SmartPtr< Camera >, camera );
@@ -71,10 +90,39 @@ namespace fr
 		
 	private:
 		
+		typedef SpatialGrid< vec2, FreshActor* > Broadphase;
+		
 		DVAR( vec2, m_gravity, vec2( 0, 200 ));
 		VAR( SmartPtr< Camera >, m_camera );
 
 		VAR( std::vector< Attachment::ptr >, m_attachments );
+		
+		DVAR( real, m_broadphaseCellSize, 64 );
+		DVAR( real, m_broadphaseMargin, 4 );					// Catches pairs pushed into contact while resolving others.
+		DVAR( bool, m_resolveTileCollisionsInParallel, false );	// Only if tile collision handlers are thread-safe.
+		DVAR( bool, m_resolveNestedWorldActors, true );			// Also step the actors of nested worlds.
+		
+		std::unique_ptr< Broadphase > m_broadphase;
+		std::vector< SmartPtr< FreshActor > > m_registeredActors;		// Unordered. Keeps alive the actors that the broadphase points to.
+		
+		// The actors each step visits, in display-tree order, and the broadphase entries of those that belong to nested worlds.
+		// Refreshed when the display tree or the registry has changed since.
+		//
+		std::vector< SmartPtr< FreshActor > > m_orderedActors;
+		std::unordered_map< const FreshActor*, size_t > m_nestedActorHandles;
+		size_t m_actorOrderVersion = ~size_t( 0 );
+		bool m_isActorOrderStale = true;
+		bool m_actorOrderIncludesNestedWorlds = false;
+		
+		// Scratch, kept to reuse its capacity from step to step.
+		//
+		std::vector< SmartPtr< FreshActor > > m_stepActors;
+		std::vector< size_t > m_stepIndexByHandle;
+		std::vector< std::pair< size_t, size_t > > m_candidatePairs;
+		
+		Broadphase& broadphase();
+		void refreshActorOrder();
+		size_t broadphaseHandle( const FreshActor& actor ) const;
 	};
 	
 }
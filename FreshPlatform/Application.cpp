@@ -8,9 +8,12 @@
 
 #include "Application.h"
 #include "CommandProcessor.h"
+#include "InputRecording.h"
+#include "FreshRandom.h"
 #include "FreshFile.h"
 #include "FreshTime.h"
 #include "FreshThread.h"
+#include "TraceRecorder.h"
 #include "ObjectLinker.h"
 #include "AudioSystem.h"
 #include "Renderer.h"
@@ -50,6 +53,8 @@ namespace fr
 	APP_CONFIG_VAR( std::string, telemetryURL );
 	APP_CONFIG_DVAR( bool, gameCenterEnabled, true );
 	APP_CONFIG_DVAR( bool, startFullScreen, false );
+	APP_CONFIG_DVAR( TimeType, mainQueuePollBudgetSeconds, 0 );
+	APP_CONFIG_DVAR( size_t, mainQueuePollMaxBlocks, 0 );
 	FRESH_IMPLEMENT_STANDARD_CONSTRUCTORS( AppConfig )
 
 	/////////////////////////////////////////////////////////////////////////////
@@ -186,6 +191,14 @@ namespace fr
 			}
 		}
 
+		trace::nameThread( "main" );
+
+		// Apps may bound the main queue's work per frame, so that a burst of completions from background loads
+		// spreads over several frames rather than stalling one. By default there is no bound.
+		//
+		dispatch::mainQueue().pollBudget( std::chrono::duration_cast< dispatch::Duration >( std::chrono::duration< TimeType >( m_config->mainQueuePollBudgetSeconds() )),
+										  m_config->mainQueuePollMaxBlocks() );
+
 		// Load asset database.
 		//
 		release_trace( "Loading asset database " << m_config->assetDatabasePath() << "." );
@@ -433,6 +446,44 @@ namespace fr
 	{
 		TIMER_AUTO_FUNC
 
+		// Replayed input arrives where it was recorded: just before the frame that followed it.
+		//
+		if( m_inputReplayer )
+		{
+			for( const auto& record : m_inputReplayer->beginFrame( *m_gamepadManager ))
+			{
+				if( record.type == InputReplayer::Record::Type::Key )
+				{
+					const auto event = record.keyboardEvent();
+					if( record.isDown )
+					{
+						onKeyDown( event );
+					}
+					else
+					{
+						onKeyUp( event );
+					}
+					Keyboard::onKeyStateChanged( record.key, record.isDown );
+				}
+				else
+				{
+					const auto begin = record.touches.cbegin();
+					const auto end = record.touches.cend();
+					switch( record.phase )
+					{
+						case EventTouch::TouchPhase::Begin: onTouchesBegin( begin, end ); break;
+						case EventTouch::TouchPhase::Move: onTouchesMove( begin, end ); break;
+						case EventTouch::TouchPhase::End: onTouchesEnd( begin, end ); break;
+						case EventTouch::TouchPhase::Cancelled: onTouchesCancelled( begin, end ); break;
+						case EventTouch::TouchPhase::WheelMove: onWheelMove( begin, end ); break;
+						default:
+							release_warning( "Input replay skipping touches with phase " << int( record.phase ) << "." );
+							break;
+					}
+				}
+			}
+		}
+
 		if( m_nUpdates == 0 )
 		{
 			// Create the render and audio system.
@@ -477,7 +528,19 @@ namespace fr
 		// The gamepads.
 		//
 		ASSERT( m_gamepadManager );
-		m_gamepadManager->update();
+		if( m_inputReplayer )
+		{
+			m_gamepadManager->updateReplayed();
+		}
+		else
+		{
+			m_gamepadManager->update();
+		}
+
+		if( m_inputRecorder )
+		{
+			m_inputRecorder->recordGamepads( *m_gamepadManager );
+		}
 
 		// The main dispatch queue.
 		//
@@ -517,9 +580,145 @@ namespace fr
 		}
 #endif
 
+		if( m_inputRecorder )
+		{
+			m_inputRecorder->endFrame();
+		}
+
+		if( m_inputReplayer )
+		{
+			m_inputReplayer->endFrame();
+
+			if( m_inputReplayer->isFinished() )
+			{
+				release_trace( "Input replay finished after " << m_inputReplayer->numFrames() << " frames." );
+				m_inputReplayer.reset();
+				randomizedSeedFilter( nullptr );
+			}
+		}
+
 		++m_nUpdates;
 	}
 
+	void Application::startInputRecording( const path& filePath )
+	{
+		REQUIRES( !isRecordingInput() && !isReplayingInput() );
+
+		m_inputRecorder.reset( new InputRecorder( filePath, isFixedTimestep() ));
+		randomizedSeedFilter( std::bind( &InputRecorder::recordSeed, m_inputRecorder.get(), std::placeholders::_1 ));
+
+		release_trace( "Recording input to " << filePath << "." );
+	}
+
+	void Application::stopInputRecording()
+	{
+		if( m_inputRecorder )
+		{
+			release_trace( "Recorded " << m_inputRecorder->nFrames() << " frames of input." );
+			randomizedSeedFilter( nullptr );
+			m_inputRecorder.reset();
+		}
+	}
+
+	bool Application::isRecordingInput() const
+	{
+		return !!m_inputRecorder;
+	}
+
+	void Application::startInputReplay( const path& filePath )
+	{
+		REQUIRES( !isRecordingInput() && !isReplayingInput() );
+
+		m_inputReplayer.reset( new InputReplayer( filePath ));
+		randomizedSeedFilter( std::bind( &InputReplayer::seed, m_inputReplayer.get(), std::placeholders::_1 ));
+
+		// Step the way the recorded run stepped.
+		//
+		fixedTimestep( m_inputReplayer->wasFixedTimestep() );
+
+		if( m_inputReplayer->isFinished() )
+		{
+			release_warning( "Input recording " << filePath << " has no frames." );
+			m_inputReplayer.reset();
+			randomizedSeedFilter( nullptr );
+		}
+	}
+
+	bool Application::isReplayingInput() const
+	{
+		return !!m_inputReplayer;
+	}
+
+	size_t Application::numInputReplayFramesRemaining() const
+	{
+		return m_inputReplayer ? m_inputReplayer->numFramesRemaining() : 0;
+	}
+
+	SystemClock Application::realFrameDuration( SystemClock measuredDuration )
+	{
+		if( m_inputReplayer )
+		{
+			return m_inputReplayer->frameDuration( measuredDuration );
+		}
+		else if( m_inputRecorder )
+		{
+			return m_inputRecorder->recordFrameDuration( measuredDuration );
+		}
+		return measuredDuration;
+	}
+
+	void Application::processInputCommandLine( int argc, const char* argv[] )
+	{
+		for( int i = 1; i + 1 < argc; ++i )
+		{
+			const std::string arg( argv[ i ] );
+			if( arg != "--record-input" && arg != "--replay-input" )
+			{
+				continue;
+			}
+
+			const path filePath( argv[ ++i ] );
+
+			if( isRecordingInput() || isReplayingInput() )
+			{
+				release_error( "Ignoring " << arg << " " << filePath << ": input may be recorded or replayed, not both." );
+				continue;
+			}
+
+			try
+			{
+				if( arg == "--record-input" )
+				{
+					startInputRecording( filePath );
+				}
+				else
+				{
+					startInputReplay( filePath );
+				}
+			}
+			catch( const std::exception& e )
+			{
+				release_error( e.what() );
+			}
+		}
+	}
+
+	void Application::recordInput( const EventKeyboard& event )
+	{
+		if( m_inputRecorder )
+		{
+			m_inputRecorder->recordKey( event );
+		}
+	}
+
+	void Application::recordInput( EventTouch::TouchPhase phase, TouchIter begin, TouchIter end )
+	{
+		if( m_inputRecorder )
+		{
+			m_inputRecorder->recordTouches( phase, begin, end );
+		}
+	}
+
 	void Application::update()
 	{
 		TIMER_AUTO_FUNC
@@ -616,6 +815,8 @@ namespace fr
 
 	void Application::atExit()
 	{
+		stopInputRecording();
+
 #if FRESH_TELEMETRY_ENABLED
 		if( m_telemetry )
 		{
@@ -16,7 +16,10 @@
 #include "StringTable.h"
 #include "FreshVector.h"
 #include "EventKeyboard.h"
+#include "EventTouch.h"
 #include "Gamepad.h"
+#include "FreshTime.h"
+#include <ostream>
 
 #ifdef FRESH_PROFILER_ENABLED
 #	include "Profiler.h"
@@ -28,6 +31,8 @@ namespace fr
 	class GameCenter;
 	class Social;
 	class AudioSystem;
+	class InputRecorder;
+	class InputReplayer;
 	
 #define APP_CONFIG_VAR( type, name )	\
 	public: SYNTHESIZE( type, name )	\
@@ -54,6 +59,8 @@ namespace fr
 		APP_CONFIG_VAR( std::string, telemetryURL );
 		APP_CONFIG_DVAR( bool, gameCenterEnabled, true );
 		APP_CONFIG_DVAR( bool, startFullScreen, false );
+		APP_CONFIG_DVAR( TimeType, mainQueuePollBudgetSeconds, 0 );		// How long the main queue may run blocks each frame. 0 means no limit.
+		APP_CONFIG_DVAR( size_t, mainQueuePollMaxBlocks, 0 );				// How many blocks it may run each frame. 0 means no limit.
 	};
 	
 #undef APP_CONFIG_VAR
@@ -133,6 +140,32 @@ namespace fr
 
 		void swapBuffers();
 
+		bool isFixedTimestep() const			{ return m_isFixedTimestep; }
+		void fixedTimestep( bool fixed )		{ m_isFixedTimestep = fixed; }
+		// When the timestep is fixed, each frame advances the simulation by exactly one step, however much real
+		// time the frame took. Headless runs fix it so that N frames always simulate the same N steps.
+
+		const path& startupPackagePath() const	{ return m_startupPackagePath; }
+		void startupPackagePath( const path& packagePath )	{ m_startupPackagePath = packagePath; }
+		// A package to start with instead of the configured one, such as a headless run's "--package". Subclasses
+		// that load a startup package honor it in onPreFirstUpdate(). Empty (the default) means the configured one.
+
+		// Input recording and replay. See InputRecording.h.
+		//
+		void startInputRecording( const path& filePath );
+		// REQUIRES( !isRecordingInput() && !isReplayingInput() );
+		void stopInputRecording();
+		bool isRecordingInput() const;
+
+		void startInputReplay( const path& filePath );
+		// REQUIRES( !isRecordingInput() && !isReplayingInput() );
+		bool isReplayingInput() const;
+		size_t numInputReplayFramesRemaining() const;
+
+		SystemClock realFrameDuration( SystemClock measuredDuration );
+		// Real-time substepping passes each frame's measured duration through here, so that recordings capture
+		// it and replays substitute the recorded one.
+
 		SYNTHESIZE_GET( bool, didStartupWithAlternativeKeyDown )
 		
 		// Functions to override in subclasses.
@@ -143,6 +176,8 @@ namespace fr
 		// Called every frame.
 		virtual void onResize( int newWidth, int newHeight ) {}
 		// Called when the window size changes.
+		virtual void traceFrameStats( std::ostream& out ) const {}
+		// Writes whatever per-frame measurements the application keeps. Headless runs call this as they finish.
 		
 		// Touch-related stuff.
 		//
@@ -216,6 +251,13 @@ namespace fr
 		
 		void loadStringTable();
 		
+		void processInputCommandLine( int argc, const char* argv[] );
+		// Handles --record-input <file> and --replay-input <file>. Platforms call this as the main loop starts.
+
+		void recordInput( const EventKeyboard& event );
+		void recordInput( EventTouch::TouchPhase phase, TouchIter begin, TouchIter end );
+		// Input handlers call these as input arrives. They do nothing unless recording.
+		
 		void createAudioSystem();
 		
 		bool wantsFullScreenStartup() const;
@@ -237,6 +279,8 @@ namespace fr
 
 		bool m_didStartupWithAlternativeKeyDown = false;
 		bool m_terminating = false;
+		bool m_isFixedTimestep = false;
+		path m_startupPackagePath;
 		size_t m_nUpdates = 0;
 
 		std::unique_ptr< GameCenter > m_gameCenter;
@@ -244,6 +288,9 @@ namespace fr
 		
 		SmartPtr< AudioSystem > m_audioSystem;
 
+		std::unique_ptr< InputRecorder > m_inputRecorder;
+		std::unique_ptr< InputReplayer > m_inputReplayer;
+
 #if FRESH_TELEMETRY_ENABLED
 		std::unique_ptr< class UserTelemetry > m_telemetry;
 #endif
@@ -18,6 +18,7 @@
 #include "FreshThread.h"
 #include "Property.h"
 #include "AudioSystemImpl.h"
+#include <mutex>
 
 #if TARGET_OS_MAC
 #	define FRESH_DECODING_APPLE 1
@@ -638,6 +639,7 @@ namespace fr
 #if !FRESH_RETAIN_RAW_AUDIO_DATA
 					strongThis->m_fileData.clear();
 #endif
+					host->accountPayloadBytes( strongThis->m_nBytes + strongThis->m_fileData.size() );
 				}
 			}
 		};
@@ -721,28 +723,33 @@ namespace
 		if( toLower( fileExtension ) == ".mp3" )
 		{
 			// Use libMpg123 to load mp3 file.
+			// Loads run concurrently on the global queues, and libMpg123 must be initialized once, before any handle is made,
+			// and not exited while handles remain. So initialize it once and for all.
 
-			int err = mpg123_init();
+			static std::once_flag s_mpg123InitFlag;
+			static int s_mpg123InitResult = MPG123_OK;
+			std::call_once( s_mpg123InitFlag, []() { s_mpg123InitResult = mpg123_init(); } );
+
+			int err = s_mpg123InitResult;
 			if( err != MPG123_OK )
 			{
-				FRESH_THROW( FreshException, "Could not init libMpg123: " << mpg123_plain_strerror( err ));
+				RETURN_ERROR( "Could not init libMpg123: " << mpg123_plain_strerror( err ));
 			}
 
 			mpg123_handle* mpgLoader = mpg123_new( NULL, &err );
 			if( !mpgLoader )
 			{
-				FRESH_THROW( FreshException, "Could not create libMpg123 handle: " << mpg123_plain_strerror( err ));
+				RETURN_ERROR( "Could not create libMpg123 handle: " << mpg123_plain_strerror( err ));
 			}
 
 			// Open the file.
 			err = mpg123_open( mpgLoader, filePath.c_str() );
 			if( err != MPG123_OK )
 			{
-				FRESH_THROW( FreshException, "Could not create open mp3 file: " << mpg123_plain_strerror( err ));
+				mpg123_delete( mpgLoader );
+				RETURN_ERROR( "Could not open mp3 file '" << filePath << "': " << mpg123_plain_strerror( err ));
 			}
 
-			ASSERT( mpgLoader );
-
 			// Peek into track and get first output format.
 			//
 			int encoding = 0;
@@ -752,7 +759,10 @@ namespace
 
 			if( err != MPG123_OK )
 			{
-				FRESH_THROW( FreshException, "Could not get mp3 file encoding: " << mpg123_strerror( mpgLoader ));
+				const std::string message = mpg123_strerror( mpgLoader );
+				mpg123_close( mpgLoader );
+				mpg123_delete( mpgLoader );
+				RETURN_ERROR( "Could not get mp3 file encoding for '" << filePath << "': " << message );
 			}
 
 			ASSERT( encoding == MPG123_ENC_SIGNED_16 );
@@ -789,7 +799,6 @@ namespace
 
 			mpg123_close( mpgLoader );
 			mpg123_delete( mpgLoader );
-			mpg123_exit();
 
 			fileData.resize( nBytes );
 
@@ -801,7 +810,11 @@ namespace
 		else
 		{
 			// Use ALUT for wavs and whatever else it supports.
+			// ALUT keeps its error in a global, and loads may run on several global queue threads at once,
+			// so each load and its error check happen under one lock.
 			//
+			static std::mutex s_alutMutex;
+			std::unique_lock< std::mutex > alutLock( s_alutMutex );
 
 			// Load the data.
 			//
@@ -810,9 +823,12 @@ namespace
 			// Check for errors.
 			//
 			const ALenum err = alutGetError();
+			alutLock.unlock();
+
 			if( !rawData || err != ALUT_ERROR_NO_ERROR )
 			{
-				FRESH_THROW( FreshException, "ALUT failed to load audio from '" << filePath << "' with error: " << alutGetErrorString( err ) );
+				std::free( rawData );
+				RETURN_ERROR( "ALUT failed to load audio from '" << filePath << "' with error: " << alutGetErrorString( err ));
 			}
 
 			// Copy the memory.
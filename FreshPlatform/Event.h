@@ -19,7 +19,7 @@ namespace fr
 	{
 	public:
 		
-		typedef std::string Type;
+		typedef Symbol Type;
 		typedef const Type& TypeRef;
 		
 		enum Phase
@@ -11,8 +11,8 @@
 namespace fr
 {
 	
-	const char* EventKeyboard::KEY_DOWN = "KeyDown";
-	const char* EventKeyboard::KEY_UP = "KeyUp";
+	const Event::Type EventKeyboard::KEY_DOWN = "KeyDown";
+	const Event::Type EventKeyboard::KEY_UP = "KeyUp";
 	
 }
 
@@ -19,8 +19,8 @@ namespace fr
 	{
 	public:
 		
-		static const char* KEY_DOWN;
-		static const char* KEY_UP;
+		static const Event::Type KEY_DOWN;
+		static const Event::Type KEY_UP;
 
 		EventKeyboard( TypeRef type_,
 					  Object::ptr target_,
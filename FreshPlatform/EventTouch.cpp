@@ -12,11 +12,11 @@
 namespace fr
 {
 
-	const char* EventTouch::TOUCH_BEGIN = "TouchBegin";
-	const char* EventTouch::TOUCH_MOVE = "TouchMove";
-	const char* EventTouch::TOUCH_END = "TouchEnd";
-	const char* EventTouch::TOUCH_CANCELLED = "TouchCancelled";
-	const char* EventTouch::WHEEL_MOVE = "WheelMove";
+	const Event::Type EventTouch::TOUCH_BEGIN = "TouchBegin";
+	const Event::Type EventTouch::TOUCH_MOVE = "TouchMove";
+	const Event::Type EventTouch::TOUCH_END = "TouchEnd";
+	const Event::Type EventTouch::TOUCH_CANCELLED = "TouchCancelled";
+	const Event::Type EventTouch::WHEEL_MOVE = "WheelMove";
 	
 }
 
@@ -24,11 +24,11 @@ namespace fr
 		
 		typedef void* TouchId;
 		
-		static const char* TOUCH_BEGIN;
-		static const char* TOUCH_MOVE;
-		static const char* TOUCH_END;
-		static const char* TOUCH_CANCELLED;
-		static const char* WHEEL_MOVE;
+		static const Event::Type TOUCH_BEGIN;
+		static const Event::Type TOUCH_MOVE;
+		static const Event::Type TOUCH_END;
+		static const Event::Type TOUCH_CANCELLED;
+		static const Event::Type WHEEL_MOVE;
 		
 		enum class TouchPhase		// Based on iPhone Touch phases. Not all seem useful.
 		{
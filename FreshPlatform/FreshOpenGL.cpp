@@ -27,7 +27,7 @@
 	PFNGLDISCARDFRAMEBUFFEREXTPROC glDiscardFramebufferEXT = nullptr;
 #	endif
 
-#elif !GL_ES_VERSION_2_0 && ( defined( _WIN32 ) || defined( __linux__ ))
+#elif !GL_ES_VERSION_2_0 && !FRESH_HEADLESS && ( defined( _WIN32 ) || defined( __linux__ ))
 
 #	define FRESH_USE_GLEW 1
 #	if defined( _MSC_VER ) && !defined( GLEW_STATIC )
@@ -105,6 +105,25 @@
 #	define GL_HALF_FLOAT GL_HALF_FLOAT_OES
 #	define FRESH_GL_MULTISAMPLE_TYPE GL_RGBA8_OES
 
+#elif FRESH_HEADLESS
+
+	// Desktop OpenGL with an EGL context and no window system. GLEW looks its entry points up through GLX, which
+	// a headless machine may not have, so link libglvnd's libOpenGL, which exports the core entry points and
+	// dispatches them to the current EGL context. Anything beyond it would come from eglGetProcAddress().
+	//
+#	ifndef GL_GLEXT_PROTOTYPES
+#		define GL_GLEXT_PROTOTYPES 1
+#	endif
+#	include <GL/gl.h>
+#	include <GL/glext.h>
+#	include <EGL/egl.h>
+
+#	define FRESH_GL_MULTISAMPLE_TYPE GL_RGBA8
+#	define FRESH_SUPPORTS_RENDERBUFFER_MULTISAMPLE 1
+
+#	undef	GL_VERTEX_ARRAY_OBJECTS_SUPPORTED
+#	define	GL_VERTEX_ARRAY_OBJECTS_SUPPORTED 0
+
 #else
 
 #if defined( _MSC_VER ) && !defined( GLEW_STATIC )
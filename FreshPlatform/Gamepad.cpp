@@ -19,9 +19,9 @@ namespace fr
 	FRESH_DEFINE_CLASS( Gamepad )
 	FRESH_IMPLEMENT_STANDARD_CONSTRUCTORS( Gamepad )
 
-	const char* Gamepad::BUTTON_DOWN = "GamepadButtonDown";
-	const char* Gamepad::BUTTON_UP = "GamepadButtonUp";
-	const char* Gamepad::AXIS_MOVED = "GamepadAxisMoved";
+	const Event::Type Gamepad::BUTTON_DOWN = "GamepadButtonDown";
+	const Event::Type Gamepad::BUTTON_UP = "GamepadButtonUp";
+	const Event::Type Gamepad::AXIS_MOVED = "GamepadAxisMoved";
 
 	bool Gamepad::button( Button index ) const
 	{
@@ -81,11 +81,24 @@ namespace fr
 		}
 	}
 	
+	void Gamepad::setReplayedState( const bool buttons[], const float axes[] )
+	{
+		REQUIRES( attached() && !payload() );
+
+		std::copy_n( buttons, size_t( Button::NUM ), m_gatheringButtons );
+		std::copy_n( axes, size_t( Axis::NUM ), m_gatheringAxes );
+	}
+
 	void Gamepad::update()
 	{
 		REQUIRES( attached() );
 		
-		updateStates();
+		// Replayed gamepads have no hardware to read.
+		//
+		if( m_payload )
+		{
+			updateStates();
+		}
 		
 		if( attached() )
 		{
@@ -123,8 +136,8 @@ namespace fr
 		construct();
 	}
 
-	const char* GamepadManager::GAMEPAD_ATTACHED = "GamepadAttached";
-	const char* GamepadManager::GAMEPAD_DETACHED = "GamepadDetached";
+	const Event::Type GamepadManager::GAMEPAD_ATTACHED = "GamepadAttached";
+	const Event::Type GamepadManager::GAMEPAD_DETACHED = "GamepadDetached";
 
 	size_t GamepadManager::numAttachedGamepads() const
 	{
@@ -158,6 +171,18 @@ namespace fr
 		updateGamepads();
 	}
 	
+	void GamepadManager::updateReplayed()
+	{
+		for( auto gamepad : m_gamepads )
+		{
+			ASSERT( gamepad );
+			if( gamepad->attached() && !gamepad->payload() )
+			{
+				gamepad->update();
+			}
+		}
+	}
+
 	void GamepadManager::updateGamepads()
 	{
 		for( auto gamepad : m_gamepads )
@@ -206,5 +231,24 @@ namespace fr
 		
 		m_gamepads.erase( std::find( m_gamepads.begin(), m_gamepads.end(), gamepad ));
 	}
+
+	Gamepad::ptr GamepadManager::attachReplayedGamepad()
+	{
+		auto gamepad = createGamepad();
+		gamepad->m_attached = true;
+
+		onGamepadAttached( gamepad );
+
+		PROMISES( gamepad && gamepad->attached() && !gamepad->payload() );
+		return gamepad;
+	}
+
+	void GamepadManager::detachReplayedGamepad( Gamepad::ptr gamepad )
+	{
+		REQUIRES( gamepad && gamepad->attached() && !gamepad->payload() );
+
+		onGamepadDetached( gamepad );
+		gamepad->m_attached = false;
+	}
 }
 
@@ -60,9 +60,9 @@ namespace fr
 
 		// Event types.
 		//
-		static const char* BUTTON_DOWN;
-		static const char* BUTTON_UP;
-		static const char* AXIS_MOVED;
+		static const Event::Type BUTTON_DOWN;
+		static const Event::Type BUTTON_UP;
+		static const Event::Type AXIS_MOVED;
 
 		virtual ~Gamepad();
 
@@ -82,6 +82,10 @@ namespace fr
 		void setAxisValue( size_t index, float value );
 		SYNTHESIZE_GET( void*, payload );
 
+		void setReplayedState( const bool buttons[], const float axes[] );
+		// REQUIRES( attached() && !payload() );
+		// For gamepads with no hardware behind them, whose states come from an input replay (see InputRecording.h).
+
 	protected:
 
 		void construct();
@@ -201,8 +205,8 @@ namespace fr
 
 		// Event types.
 		//
-		static const char* GAMEPAD_ATTACHED;
-		static const char* GAMEPAD_DETACHED;
+		static const Event::Type GAMEPAD_ATTACHED;
+		static const Event::Type GAMEPAD_DETACHED;
 
 		size_t numAttachedGamepads() const;
 
@@ -214,12 +218,20 @@ namespace fr
 
 		void update();	// Call me once per "tick" or "update".
 
+		void updateReplayed();
+		// Call instead of update() while input is being replayed. Reads no hardware: only replayed gamepads change.
+
 		// FOR INTERNAL USE.
 		//
 		Gamepad::ptr createGamepad();
 		void onGamepadAttached( Gamepad::ptr gamepad );
 		void onGamepadDetached( Gamepad::ptr gamepad );
 
+		Gamepad::ptr attachReplayedGamepad();
+		// PROMISES( result && result->attached() && !result->payload() );
+		void detachReplayedGamepad( Gamepad::ptr gamepad );
+		// REQUIRES( gamepad && gamepad->attached() && !gamepad->payload() );
+
 	protected:
 
 		void construct();
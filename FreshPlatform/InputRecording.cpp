@@ -0,0 +1,414 @@
+//
+//  InputRecording.cpp
+//  Fresh
+//
+
+#include "InputRecording.h"
+#include "FreshDebug.h"
+#include "FreshException.h"
+
+namespace
+{
+	using namespace fr;
+
+	// The file is a header followed by tagged records in the order they happened. Each frame's records end with
+	// a FRAME_END. Values are written in the machine's own byte order, since recordings are replayed where
+	// they are made.
+	//
+	const char MAGIC[ 4 ] = { 'F', 'R', 'I', 'N' };
+	const uint32_t VERSION = 1;
+
+	const char KEY = 'K';
+	const char TOUCHES = 'T';
+	const char GAMEPAD_COUNT = 'P';
+	const char GAMEPAD_STATE = 'G';
+	const char FRAME_DURATION = 'D';
+	const char SEED = 'S';
+	const char FRAME_END = 'F';
+
+	enum Modifier : uint8_t
+	{
+		AltOption = 1 << 0,
+		CtrlCommand = 1 << 1,
+		Shift = 1 << 2,
+		HeldRepeat = 1 << 3,
+	};
+
+	const size_t NUM_BUTTONS = size_t( Gamepad::Button::NUM );
+	const size_t NUM_AXES = size_t( Gamepad::Axis::NUM );
+
+	inline uint64_t clocksPerSecond()
+	{
+		return secondsToClocks( 1.0 );
+	}
+
+	template< typename T >
+	inline void write( std::ostream& out, const T& value )
+	{
+		static_assert( std::is_trivially_copyable< T >::value, "Only plain values may be written." );
+		out.write( reinterpret_cast< const char* >( &value ), sizeof( value ));
+	}
+
+	template< typename T >
+	inline T read( std::istream& in )
+	{
+		static_assert( std::is_trivially_copyable< T >::value, "Only plain values may be read." );
+		T value{};
+		in.read( reinterpret_cast< char* >( &value ), sizeof( value ));
+		if( !in )
+		{
+			FRESH_THROW( FreshException, "Input recording ended mid-record." );
+		}
+		return value;
+	}
+
+	inline void writeVector( std::ostream& out, const vec2& v )
+	{
+		write( out, float( v.x ));
+		write( out, float( v.y ));
+	}
+
+	inline vec2 readVector( std::istream& in )
+	{
+		const float x = read< float >( in );
+		const float y = read< float >( in );
+		return vec2( x, y );
+	}
+}
+
+namespace fr
+{
+
+	InputRecorder::InputRecorder( const path& filePath, bool isFixedTimestep )
+	:	m_file( filePath.c_str(), std::ios::out | std::ios::binary | std::ios::trunc )
+	{
+		if( !m_file )
+		{
+			FRESH_THROW( FreshException, "Could not create input recording " << filePath << "." );
+		}
+
+		m_file.write( MAGIC, sizeof( MAGIC ));
+		write( m_file, VERSION );
+		write( m_file, uint64_t( clocksPerSecond() ));
+		write( m_file, uint8_t( isFixedTimestep ));
+	}
+
+	InputRecorder::~InputRecorder()
+	{
+		m_file.flush();
+	}
+
+	void InputRecorder::recordKey( const EventKeyboard& event )
+	{
+		const uint8_t modifiers = ( event.isAltOptionDown() ? AltOption : 0 )
+								| ( event.isCtrlCommandDown() ? CtrlCommand : 0 )
+								| ( event.isShiftDown() ? Shift : 0 )
+								| ( event.isAHeldRepeat() ? HeldRepeat : 0 );
+
+		write( m_file, KEY );
+		write( m_file, uint8_t( event.type() == EventKeyboard::KEY_DOWN ));
+		write( m_file, uint32_t( event.charCode() ));
+		write( m_file, uint16_t( event.key() ));
+		write( m_file, modifiers );
+	}
+
+	void InputRecorder::recordTouches( EventTouch::TouchPhase phase, Application::TouchIter begin, Application::TouchIter end )
+	{
+		const auto nTouches = std::distance( begin, end );
+		ASSERT( nTouches <= 0xFF );
+
+		write( m_file, TOUCHES );
+		write( m_file, uint8_t( phase ));
+		write( m_file, uint8_t( nTouches ));
+
+		for( ; begin != end; ++begin )
+		{
+			writeVector( m_file, begin->position );
+			writeVector( m_file, begin->lastPosition );
+			writeVector( m_file, begin->wheelDelta );
+			write( m_file, int32_t( begin->iTouch ));
+			write( m_file, int32_t( begin->nTouches ));
+			write( m_file, int32_t( begin->nTaps ));
+			write( m_file, uint64_t( reinterpret_cast< uintptr_t >( begin->touchId )));
+		}
+	}
+
+	void InputRecorder::recordGamepads( const GamepadManager& gamepads )
+	{
+		const size_t nGamepads = gamepads.numAttachedGamepads();
+		ASSERT( nGamepads <= 0xFF );
+
+		if( nGamepads != m_gamepads.size() )
+		{
+			write( m_file, GAMEPAD_COUNT );
+			write( m_file, uint8_t( nGamepads ));
+			m_gamepads.resize( nGamepads );
+		}
+
+		for( size_t i = 0; i < nGamepads; ++i )
+		{
+			const auto gamepad = gamepads.gamepadAt( i );
+
+			GamepadState state;
+			for( size_t iButton = 0; iButton < NUM_BUTTONS; ++iButton )
+			{
+				if( gamepad->button( Gamepad::Button( iButton )))
+				{
+					state.buttons |= uint16_t( 1 << iButton );
+				}
+			}
+			for( size_t iAxis = 0; iAxis < NUM_AXES; ++iAxis )
+			{
+				state.axes[ iAxis ] = gamepad->axis( Gamepad::Axis( iAxis ));
+			}
+
+			auto& lastState = m_gamepads[ i ];
+			if( state.buttons != lastState.buttons || !std::equal( state.axes, state.axes + NUM_AXES, lastState.axes ))
+			{
+				write( m_file, GAMEPAD_STATE );
+				write( m_file, uint8_t( i ));
+				write( m_file, state.buttons );
+				m_file.write( reinterpret_cast< const char* >( state.axes ), sizeof( state.axes ));
+				lastState = state;
+			}
+		}
+	}
+
+	SystemClock InputRecorder::recordFrameDuration( SystemClock duration )
+	{
+		write( m_file, FRAME_DURATION );
+		write( m_file, uint64_t( duration ));
+		return duration;
+	}
+
+	unsigned int InputRecorder::recordSeed( unsigned int seed )
+	{
+		write( m_file, SEED );
+		write( m_file, uint32_t( seed ));
+		return seed;
+	}
+
+	void InputRecorder::endFrame()
+	{
+		write( m_file, FRAME_END );
+		++m_nFrames;
+
+		if( !m_file )
+		{
+			release_error( "Input recording failed to write frame " << m_nFrames << "." );
+		}
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+
+	InputReplayer::InputReplayer( const path& filePath )
+	{
+		std::ifstream file( filePath.c_str(), std::ios::in | std::ios::binary );
+		if( !file )
+		{
+			FRESH_THROW( FreshException, "Could not open input recording " << filePath << "." );
+		}
+
+		char magic[ sizeof( MAGIC ) ] = { 0 };
+		file.read( magic, sizeof( magic ));
+		if( !file || !std::equal( magic, magic + sizeof( magic ), MAGIC ))
+		{
+			FRESH_THROW( FreshException, filePath << " is not an input recording." );
+		}
+
+		const auto version = read< uint32_t >( file );
+		if( version != VERSION )
+		{
+			FRESH_THROW( FreshException, "Input recording " << filePath << " has version " << version << "; expected " << VERSION << "." );
+		}
+
+		const auto recordedClocksPerSecond = read< uint64_t >( file );
+		m_wasFixedTimestep = read< uint8_t >( file ) != 0;
+
+		// Clocks only need converting when the recording came from a machine that counts them differently.
+		//
+		const bool convertClocks = recordedClocksPerSecond != clocksPerSecond();
+
+		Frame frame;
+
+		char tag = 0;
+		while( file.get( tag ))
+		{
+			switch( tag )
+			{
+				case KEY:
+				{
+					Record record;
+					record.type = Record::Type::Key;
+					record.isDown = read< uint8_t >( file ) != 0;
+					record.charCode = read< uint32_t >( file );
+					record.key = Keyboard::Key( read< uint16_t >( file ));
+					record.modifiers = read< uint8_t >( file );
+					frame.input.push_back( std::move( record ));
+					break;
+				}
+				case TOUCHES:
+				{
+					Record record;
+					record.type = Record::Type::Touches;
+					record.phase = EventTouch::TouchPhase( read< uint8_t >( file ));
+					const auto nTouches = read< uint8_t >( file );
+					for( size_t i = 0; i < nTouches; ++i )
+					{
+						Application::Touch touch;
+						touch.position = readVector( file );
+						touch.lastPosition = readVector( file );
+						touch.wheelDelta = readVector( file );
+						touch.iTouch = read< int32_t >( file );
+						touch.nTouches = read< int32_t >( file );
+						touch.nTaps = read< int32_t >( file );
+						touch.touchId = reinterpret_cast< Application::Touch::Id >( uintptr_t( read< uint64_t >( file )));
+						record.touches.push_back( touch );
+					}
+					frame.input.push_back( std::move( record ));
+					break;
+				}
+				case GAMEPAD_COUNT:
+				{
+					Record record;
+					record.type = Record::Type::GamepadCount;
+					record.iGamepad = read< uint8_t >( file );
+					frame.gamepads.push_back( std::move( record ));
+					break;
+				}
+				case GAMEPAD_STATE:
+				{
+					Record record;
+					record.type = Record::Type::GamepadState;
+					record.iGamepad = read< uint8_t >( file );
+					record.buttons = read< uint16_t >( file );
+					for( size_t iAxis = 0; iAxis < NUM_AXES; ++iAxis )
+					{
+						record.axes[ iAxis ] = clamp( read< float >( file ), -1.0f, 1.0f );
+					}
+					frame.gamepads.push_back( std::move( record ));
+					break;
+				}
+				case FRAME_DURATION:
+				{
+					const auto clocks = read< uint64_t >( file );
+					frame.durations.push_back( convertClocks ? secondsToClocks( clocks / double( recordedClocksPerSecond )) : clocks );
+					break;
+				}
+				case SEED:
+					frame.seeds.push_back( read< uint32_t >( file ));
+					break;
+				case FRAME_END:
+					m_frames.push_back( std::move( frame ));
+					frame = Frame();
+					break;
+				default:
+					FRESH_THROW( FreshException, "Input recording " << filePath << " has an unknown record '" << tag << "'." );
+			}
+		}
+
+		if( !frame.input.empty() || !frame.gamepads.empty() || !frame.durations.empty() || !frame.seeds.empty() )
+		{
+			release_warning( "Input recording " << filePath << " ends mid-frame. Ignoring that frame." );
+		}
+
+		release_trace( "Loaded input recording " << filePath << ": " << m_frames.size() << " frames." );
+	}
+
+	EventKeyboard InputReplayer::Record::keyboardEvent() const
+	{
+		REQUIRES( type == Type::Key );
+
+		return EventKeyboard( isDown ? EventKeyboard::KEY_DOWN : EventKeyboard::KEY_UP,
+							  nullptr,
+							  charCode,
+							  key,
+							  ( modifiers & AltOption ) != 0,
+							  ( modifiers & CtrlCommand ) != 0,
+							  ( modifiers & Shift ) != 0,
+							  ( modifiers & HeldRepeat ) != 0 );
+	}
+
+	const std::vector< InputReplayer::Record >& InputReplayer::beginFrame( GamepadManager& gamepads )
+	{
+		REQUIRES( !isFinished() );
+
+		const auto& frame = m_frames[ m_iFrame ];
+
+		for( const auto& record : frame.gamepads )
+		{
+			applyGamepad( gamepads, record );
+		}
+
+		return frame.input;
+	}
+
+	void InputReplayer::applyGamepad( GamepadManager& gamepads, const Record& record )
+	{
+		if( record.type == Record::Type::GamepadCount )
+		{
+			while( m_gamepads.size() < record.iGamepad )
+			{
+				m_gamepads.push_back( gamepads.attachReplayedGamepad() );
+			}
+			while( m_gamepads.size() > record.iGamepad )
+			{
+				gamepads.detachReplayedGamepad( m_gamepads.back() );
+				m_gamepads.pop_back();
+			}
+		}
+		else
+		{
+			ASSERT( record.type == Record::Type::GamepadState );
+
+			if( record.iGamepad >= m_gamepads.size() )
+			{
+				release_warning( "Input replay has a state for gamepad " << record.iGamepad << " of " << m_gamepads.size() << "." );
+				return;
+			}
+
+			bool buttons[ NUM_BUTTONS ];
+			for( size_t iButton = 0; iButton < NUM_BUTTONS; ++iButton )
+			{
+				buttons[ iButton ] = ( record.buttons & ( 1 << iButton )) != 0;
+			}
+
+			m_gamepads[ record.iGamepad ]->setReplayedState( buttons, record.axes );
+		}
+	}
+
+	SystemClock InputReplayer::frameDuration( SystemClock measuredDuration )
+	{
+		ASSERT( m_iFrame < m_frames.size() );
+		const auto& durations = m_frames[ m_iFrame ].durations;
+
+		if( m_iDuration >= durations.size() )
+		{
+			return measuredDuration;
+		}
+
+		return durations[ m_iDuration++ ];
+	}
+
+	unsigned int InputReplayer::seed( unsigned int timeSeed )
+	{
+		ASSERT( m_iFrame < m_frames.size() );
+		const auto& seeds = m_frames[ m_iFrame ].seeds;
+
+		if( m_iSeed >= seeds.size() )
+		{
+			release_warning( "Input replay ran out of seeds recorded in frame " << m_iFrame << ". The replay has diverged from the recording." );
+			return timeSeed;
+		}
+
+		return seeds[ m_iSeed++ ];
+	}
+
+	void InputReplayer::endFrame()
+	{
+		ASSERT( m_iFrame < m_frames.size() );
+		++m_iFrame;
+		m_iDuration = 0;
+		m_iSeed = 0;
+	}
+}
@@ -0,0 +1,141 @@
+//
+//  InputRecording.h
+//  Fresh
+//
+//  Capture and deterministic replay of everything that makes one run of an application differ from the next:
+//  keyboard, touch and gamepad input, the real duration of each frame (which drives the Stage's real-time
+//  substepping), and the seeds of time-randomized random generators. Replaying a recording from launch
+//  reproduces the recorded run frame for frame, so a hitch that someone saw once can be profiled again and again.
+//
+//  Run with --record-input <file> to record and --replay-input <file> to replay. Replays are best run with the
+//  headless backend (FRESH_HEADLESS), which has no input of its own and plays frames back to back.
+//
+
+#ifndef Fresh_InputRecording_h
+#define Fresh_InputRecording_h
+
+#include "Application.h"
+#include "EventTouch.h"
+#include "FreshTime.h"
+#include <fstream>
+
+namespace fr
+{
+	class InputRecorder
+	{
+	public:
+
+		InputRecorder( const path& filePath, bool isFixedTimestep );
+		// Throws FreshException if the file cannot be created.
+
+		~InputRecorder();
+
+		void recordKey( const EventKeyboard& event );
+		void recordTouches( EventTouch::TouchPhase phase, Application::TouchIter begin, Application::TouchIter end );
+		void recordGamepads( const GamepadManager& gamepads );
+		// Call once per frame, after the gamepads update. Only changes are written.
+
+		SystemClock recordFrameDuration( SystemClock duration );
+		unsigned int recordSeed( unsigned int seed );
+		// PROMISES( result == seed );
+
+		void endFrame();
+
+		SYNTHESIZE_GET( size_t, nFrames )
+
+	private:
+
+		struct GamepadState
+		{
+			uint16_t buttons = 0;
+			float axes[ size_t( Gamepad::Axis::NUM ) ] = { 0 };
+		};
+
+		std::ofstream m_file;
+		std::vector< GamepadState > m_gamepads;		// As last written.
+		size_t m_nFrames = 0;
+
+		FRESH_PREVENT_COPYING( InputRecorder )
+	};
+
+	class InputReplayer
+	{
+	public:
+
+		explicit InputReplayer( const path& filePath );
+		// Throws FreshException if the file cannot be read or is not an input recording.
+
+		SYNTHESIZE_GET( bool, wasFixedTimestep )
+
+		struct Record
+		{
+			enum class Type
+			{
+				Key,
+				Touches,
+				GamepadCount,
+				GamepadState,
+			};
+			Type type = Type::Key;
+
+			// Keyboard.
+			bool isDown = false;
+			unsigned int charCode = 0;
+			Keyboard::Key key = Keyboard::Unsupported;
+			uint8_t modifiers = 0;
+
+			EventKeyboard keyboardEvent() const;
+			// REQUIRES( type == Type::Key );
+
+			// Touches.
+			EventTouch::TouchPhase phase = EventTouch::TouchPhase::Begin;
+			Application::Touches touches;
+
+			// Gamepads. For a count, iGamepad is the number attached.
+			size_t iGamepad = 0;
+			uint16_t buttons = 0;
+			float axes[ size_t( Gamepad::Axis::NUM ) ] = { 0 };
+		};
+
+		// Everything recorded between the end of one frame and the end of the next.
+		//
+		struct Frame
+		{
+			std::vector< Record > input;				// Keyboard and touches.
+			std::vector< Record > gamepads;
+			std::vector< SystemClock > durations;
+			std::vector< unsigned int > seeds;
+		};
+
+		size_t numFrames() const									{ return m_frames.size(); }
+		size_t numFramesRemaining() const							{ return m_frames.size() - m_iFrame; }
+		bool isFinished() const										{ return m_iFrame >= m_frames.size(); }
+
+		const std::vector< Record >& beginFrame( GamepadManager& gamepads );
+		// REQUIRES( !isFinished() );
+		// Sets the replayed gamepads' states and returns the frame's keyboard and touch input, in order, for the
+		// caller to send.
+
+		SystemClock frameDuration( SystemClock measuredDuration );
+		unsigned int seed( unsigned int timeSeed );
+		// These return the current frame's recorded values in turn, or their arguments once the frame's recorded
+		// ones run out, so a replay that diverges stays in step with the recording from the next frame on.
+
+		void endFrame();
+
+	private:
+
+		void applyGamepad( GamepadManager& gamepads, const Record& record );
+
+		std::vector< Frame > m_frames;
+		std::vector< Gamepad::ptr > m_gamepads;
+		size_t m_iFrame = 0;
+		size_t m_iDuration = 0;						// Within the current frame.
+		size_t m_iSeed = 0;							// Within the current frame.
+		bool m_wasFixedTimestep = false;
+
+		FRESH_PREVENT_COPYING( InputReplayer )
+	};
+}
+
+#endif
@@ -0,0 +1,453 @@
+//
+//  Application_Headless.cpp
+//  Fresh
+//
+//  A windowless Application backend for Linux machines without a display or GPU, such as build machines.
+//  It renders into an EGL pbuffer (Mesa renders in software where there is no GPU) and receives no input.
+//  OpenGL comes from libOpenGL rather than GLEW, which needs GLX (see FreshOpenGL.h).
+//
+//  Rather than running until quit, it runs a fixed number of frames back to back, with a fixed timestep,
+//  and then reports how long they took and how much rendering they submitted:
+//
+//		<app> [--package <file>] [--frames N] [--report <file>] [--replay-input <file>]
+//
+//  The package replaces the configured startup package (for ApplicationStaged, the stage), so that one
+//  build can time any scene. N defaults to 600, or to the length of the replay. The report goes to the log
+//  and, if requested, to the file too. A replay (see InputRecording.h) reproduces a recorded run, timestep
+//  and all, as fast as it renders.
+//
+
+#include "Application.h"
+#include "FreshDebug.h"
+#include "FreshOpenGL.h"
+#include "FreshFile.h"
+#include "FreshTime.h"
+#include "FrameStats.h"
+#include "Objects.h"
+#include "Assets.h"
+#include "CommandProcessor.h"
+#include "Renderer.h"
+#include <EGL/egl.h>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <cstdlib>
+
+using namespace fr;
+
+namespace
+{
+	const size_t DEFAULT_FRAMES = 600;
+
+	inline double toMilliseconds( uint64_t nanoseconds )
+	{
+		return nanoseconds / 1000000.0;
+	}
+}
+
+namespace fr
+{
+
+	class ApplicationImplementation
+	{
+	public:
+
+		ApplicationImplementation( Application* owner, CommandProcessor::ptr commandProcessor )
+		:	m_owner( owner )
+		,	m_commandProcessor( commandProcessor )
+		,	m_desiredFramesPerSecond( owner->config().desiredFramesPerSecond() )
+		{
+			REQUIRES( owner );
+
+			const auto& desiredRect = m_owner->config().desiredWindowRect();
+			m_dimensions.set( desiredRect.right() - desiredRect.left(), desiredRect.bottom() - desiredRect.top() );
+
+			if( m_dimensions.x <= 0 )
+			{
+				m_dimensions.x = 1280;
+			}
+			if( m_dimensions.y <= 0 )
+			{
+				m_dimensions.y = 800;
+			}
+
+			// Before the main loop starts, so that input recordings see it and replays may override it.
+			//
+			m_owner->fixedTimestep( true );
+		}
+
+		~ApplicationImplementation()
+		{
+			shutdownOpenGL();
+		}
+
+		void createContext()
+		{
+			ASSERT( m_display == EGL_NO_DISPLAY );
+			m_display = eglGetDisplay( EGL_DEFAULT_DISPLAY );
+			if( m_display == EGL_NO_DISPLAY || !eglInitialize( m_display, nullptr, nullptr ))
+			{
+				FRESH_THROW( FreshException, "Could not initialize the EGL display." );
+			}
+
+			const EGLint configAttributes[] = {	EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+												EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+												EGL_RED_SIZE, 8,
+												EGL_GREEN_SIZE, 8,
+												EGL_BLUE_SIZE, 8,
+												EGL_ALPHA_SIZE, 8,
+												EGL_STENCIL_SIZE, 8,		// For Renderer::setStencilMode().
+												EGL_NONE };
+			EGLConfig config;
+			EGLint nConfigs = 0;
+			if( !eglChooseConfig( m_display, configAttributes, &config, 1, &nConfigs ) || nConfigs < 1 )
+			{
+				FRESH_THROW( FreshException, "Could not find an EGL config for an OpenGL pbuffer." );
+			}
+
+			const EGLint surfaceAttributes[] = { EGL_WIDTH, m_dimensions.x, EGL_HEIGHT, m_dimensions.y, EGL_NONE };
+			m_surface = eglCreatePbufferSurface( m_display, config, surfaceAttributes );
+			if( m_surface == EGL_NO_SURFACE )
+			{
+				FRESH_THROW( FreshException, "Could not create an EGL pbuffer surface." );
+			}
+
+			eglBindAPI( EGL_OPENGL_API );
+			m_context = eglCreateContext( m_display, config, EGL_NO_CONTEXT, nullptr );
+			if( m_context == EGL_NO_CONTEXT )
+			{
+				FRESH_THROW( FreshException, "Could not create OpenGL context." );
+			}
+
+			eglMakeCurrent( m_display, m_surface, m_surface, m_context );
+
+			GLint err = glGetError();
+			if( err != GL_NO_ERROR )
+			{
+				FRESH_THROW( FreshException, "Failed to initialize OpenGL." );
+			}
+		}
+
+		Application::ExitCode runMainLoop( int argc, const char* argv[] )
+		{
+			REQUIRES( !m_isInMainLoop );
+
+			size_t nFrames = m_owner->isReplayingInput() ? m_owner->numInputReplayFramesRemaining() : DEFAULT_FRAMES;
+			std::string reportPath;
+			for( int i = 1; i < argc; ++i )
+			{
+				const std::string arg( argv[ i ] );
+				if( arg == "--frames" && i + 1 < argc )
+				{
+					nFrames = std::strtoul( argv[ ++i ], nullptr, 10 );
+				}
+				else if( arg == "--report" && i + 1 < argc )
+				{
+					reportPath = argv[ ++i ];
+				}
+				else if( arg == "--package" && i + 1 < argc )
+				{
+					m_owner->startupPackagePath( argv[ ++i ] );
+				}
+			}
+
+			createContext();
+
+			m_isInMainLoop = true;
+
+			try
+			{
+				DurationHistogram frameHistogram;
+				Renderer::Counters totalCounters;
+
+				const uint64_t startNanoseconds = trace::nowNanoseconds();
+
+				for( size_t iFrame = 0; iFrame < nFrames && !m_wantsQuit; ++iFrame )
+				{
+					if( Renderer::doesExist() )
+					{
+						Renderer::instance().resetCounters();
+					}
+
+					const uint64_t frameStartNanoseconds = trace::nowNanoseconds();
+
+					m_owner->updateFrame();
+
+					frameHistogram.record( trace::nowNanoseconds() - frameStartNanoseconds );
+
+					// The Renderer is created during the first frame.
+					//
+					if( Renderer::doesExist() )
+					{
+						totalCounters += Renderer::instance().counters();
+					}
+				}
+
+				const uint64_t totalNanoseconds = trace::nowNanoseconds() - startNanoseconds;
+
+				report( frameHistogram, totalNanoseconds, totalCounters, reportPath );
+
+				m_isInMainLoop = false;
+				return m_exitCode;
+			}
+			catch( const std::exception& e )
+			{
+				m_isInMainLoop = false;
+				release_trace( "Exception while running main loop: " << e.what() );
+				return -1;
+			}
+			catch( ... )
+			{
+				m_isInMainLoop = false;
+				release_trace( "Unknown exception while running main loop." );
+				return -2;
+			}
+		}
+
+		void quit( Application::ExitCode exitCode )
+		{
+			if( m_isInMainLoop )
+			{
+				m_wantsQuit = true;
+				m_exitCode = exitCode;
+			}
+			else
+			{
+				exit( exitCode );
+			}
+		}
+
+		void swapBuffers()
+		{
+			// A pbuffer has nothing to present, but waiting for the frame's rendering to finish keeps
+			// its cost in the frame that caused it.
+			//
+			glFinish();
+			eglSwapBuffers( m_display, m_surface );
+		}
+
+		void desiredFramesPerSecond( TimeType fps )
+		{
+			m_desiredFramesPerSecond = fps;
+		}
+
+		Vector2i getWindowDimensions() const
+		{
+			return m_dimensions;
+		}
+
+		real pixelsPerScreenInch() const
+		{
+			// As for a 17-in (diagonal) desktop, as on Unix.
+			//
+			const real monitorWidthInches = 14.57f;
+			return m_dimensions.x / monitorWidthInches;
+		}
+
+		std::string windowTitle() const
+		{
+			return m_windowTitle.empty() ? m_owner->config().desiredTitle() : m_windowTitle;
+		}
+
+		void windowTitle( const std::string& value )
+		{
+			m_windowTitle = value;
+		}
+
+		bool isMainLoopRunning() const
+		{
+			return m_isInMainLoop;
+		}
+
+	protected:
+
+		void report( const DurationHistogram& frames, uint64_t totalNanoseconds, const Renderer::Counters& counters, const std::string& reportPath ) const
+		{
+			const size_t nFrames = std::max( frames.count(), size_t( 1 ));
+
+			std::ostringstream out;
+			out << std::fixed << std::setprecision( 2 );
+			out << "HEADLESS RUN: " << frames.count() << " frames of " << m_dimensions.x << "x" << m_dimensions.y
+				<< " in " << totalNanoseconds / 1e9 << " s (" << frames.count() / std::max( totalNanoseconds / 1e9, 1e-9 ) << " frames per second).\n";
+
+			out << "Whole frame ms: mean " << toMilliseconds( frames.meanNanoseconds() )
+				<< "  p50 " << toMilliseconds( frames.percentileNanoseconds( 50 ))
+				<< "  p95 " << toMilliseconds( frames.percentileNanoseconds( 95 ))
+				<< "  p99 " << toMilliseconds( frames.percentileNanoseconds( 99 ))
+				<< "  max " << toMilliseconds( frames.maxNanoseconds() ) << "\n";
+
+			out << "Per frame: " << double( counters.nDrawCalls ) / nFrames << " draw calls, "
+				<< double( counters.nVertices ) / nFrames << " vertices, "
+				<< double( counters.nTextureBinds ) / nFrames << " texture binds, "
+				<< double( counters.nShaderProgramChanges ) / nFrames << " shader program changes, "
+				<< double( counters.nBlendModeChanges ) / nFrames << " blend mode changes, "
+				<< double( counters.nStencilModeChanges ) / nFrames << " stencil mode changes, "
+				<< double( counters.nClears ) / nFrames << " clears.\n";
+
+			m_owner->traceFrameStats( out );
+
+			release_trace( out.str() );
+
+			// The log isn't flushed line by line, and the report is what the run is for.
+			//
+			std::cout.flush();
+			DevLog::flushLogStream();
+
+			if( !reportPath.empty() )
+			{
+				std::ofstream file( reportPath );
+				file << out.str();
+				if( !file )
+				{
+					release_error( "Could not write the headless run report to " << reportPath );
+				}
+			}
+		}
+
+		void shutdownOpenGL()
+		{
+			if( m_display != EGL_NO_DISPLAY )
+			{
+				eglMakeCurrent( m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT );
+				if( m_context != EGL_NO_CONTEXT )
+				{
+					eglDestroyContext( m_display, m_context );
+					m_context = EGL_NO_CONTEXT;
+				}
+				if( m_surface != EGL_NO_SURFACE )
+				{
+					eglDestroySurface( m_display, m_surface );
+					m_surface = EGL_NO_SURFACE;
+				}
+				eglTerminate( m_display );
+				m_display = EGL_NO_DISPLAY;
+			}
+		}
+
+	private:
+
+		Application* m_owner;
+		SmartPtr< CommandProcessor > m_commandProcessor;
+		bool m_isInMainLoop = false;
+		bool m_wantsQuit = false;
+		Application::ExitCode m_exitCode = 0;
+		TimeType m_desiredFramesPerSecond;
+
+		Vector2i m_dimensions;
+		std::string m_windowTitle;
+
+		EGLDisplay m_display = EGL_NO_DISPLAY;
+		EGLSurface m_surface = EGL_NO_SURFACE;
+		EGLContext m_context = EGL_NO_CONTEXT;
+	};
+
+	std::string Application::getPromptedFilePath( bool forSaveElseOpen, const char* semicolonSeparatedFileExtensions )
+	{
+		return "";
+	}
+
+	void Application::constructImplementation()
+	{
+		m_impl = new ApplicationImplementation( this, m_commandProcessor );
+	}
+
+	void Application::destroyImplementation()
+	{
+		delete m_impl;
+		m_impl = nullptr;
+	}
+
+	void Application::quit( ExitCode exitCode /*= 0*/ )
+	{
+		m_impl->quit( exitCode );
+	}
+
+	bool Application::isMultitouch() const
+	{
+		return false;
+	}
+
+	void Application::swapBuffers()
+	{
+		m_impl->swapBuffers();
+	}
+
+	rect Application::safeAreaInsets() const
+	{
+		return {};
+	}
+
+	std::string Application::userLanguageCode() const
+	{
+		return "";
+	}
+
+	void Application::desiredFramesPerSecondDetail( TimeType fps )
+	{
+		m_impl->desiredFramesPerSecond( fps );
+	}
+
+	Vector2i Application::getScreenDimensions() const
+	{
+		return m_impl->getWindowDimensions();
+	}
+
+	Vector2i Application::getWindowDimensions() const
+	{
+		return m_impl->getWindowDimensions();
+	}
+
+	real Application::pixelsPerScreenInch() const
+	{
+		return m_impl->pixelsPerScreenInch();
+	}
+
+	std::string Application::windowTitle() const
+	{
+		return m_impl->windowTitle();
+	}
+
+	void Application::windowTitle( const std::string& value )
+	{
+		m_impl->windowTitle( value );
+	}
+
+	Application::ExitCode Application::runMainLoop( int argc, const char* argv[] )
+	{
+		REQUIRES( !isMainLoopRunning() );
+		processInputCommandLine( argc, argv );
+		return m_impl->runMainLoop( argc, argv );
+	}
+
+	bool Application::isMainLoopRunning() const
+	{
+		return m_impl->isMainLoopRunning();
+	}
+
+	std::vector< std::string > Application::getPlatformConfigFileSuffixes() const
+	{
+		// The same configuration as a windowed Unix build, so that both run the same scenes.
+		//
+		return { "-Unix" };
+	}
+
+	std::vector< std::string > Application::getVariantConfigFileSuffixes( const std::string& platformSuffix ) const
+	{
+		return {};
+	}
+
+	bool Application::isFullscreen() const
+	{
+		return false;
+	}
+
+	void Application::goFullscreen( bool fullscreenElseWindowed )
+	{}
+
+	bool Application::isApplicationAlternativeStartupKeyDown() const
+	{
+		return false;
+	}
+}
@@ -52,12 +52,29 @@ namespace
         fn( g_appTouches[ static_cast< int >( type ) ] );
     }
     
+    bool isReplayingInput()
+    {
+        return fr::Application::doesExist() && fr::Application::instance().isReplayingInput();
+    }
+
     void sendInputEvents()
     {
         auto& app = fr::Application::instance();
         
         std::lock_guard< std::mutex > guard( g_inputMutex );
         
+        // While input is being replayed, the replay is the only input.
+        //
+        if( app.isReplayingInput() )
+        {
+            for( auto& appTouches : g_appTouches )
+            {
+                appTouches.clear();
+            }
+            g_appKeyboardEvents.clear();
+            return;
+        }
+        
         // Send touches
         //
         {
@@ -555,6 +572,7 @@ namespace fr
 	Application::ExitCode Application::runMainLoop( int argc, const char* argv[] )
 	{
 		REQUIRES( !isMainLoopRunning() );
+		processInputCommandLine( argc, argv );
 
 		try
 		{
@@ -811,7 +829,7 @@ static void createAppTouches( NSView* view, CGSize viewSize, NSEvent* theEvent,
 
 - (void)scrollWheel:(NSEvent *)theEvent
 {
-	if( !Application::doesExist() )
+	if( !Application::doesExist() || isReplayingInput() )
 	{
 		return;
 	}
@@ -1004,7 +1022,7 @@ if(( newFlagsDown & mask ) != ( lastFlagsDown & mask ))	\
 	static NSUInteger lastFlagsDown = 0;
 	NSUInteger newFlagsDown = [theEvent modifierFlags];
 
-	if( Application::doesExist() )
+	if( Application::doesExist() && !isReplayingInput() )
 	{
 		FLAGS_CHANGED_CASE( Keyboard::Shift, NSShiftKeyMask )
 		FLAGS_CHANGED_CASE( Keyboard::AltOption, NSAlternateKeyMask )
@@ -1017,7 +1035,7 @@ if(( newFlagsDown & mask ) != ( lastFlagsDown & mask ))	\
 - (void)keyDown:(NSEvent *)theEvent
 {
 	Keyboard::Key key = getKeyForMacKeyCode( [theEvent keyCode] );
-	if( key != Keyboard::Unsupported )
+	if( key != Keyboard::Unsupported && !isReplayingInput() )
 	{
 		Keyboard::onKeyStateChanged( key, true );
 	}
@@ -1028,7 +1046,7 @@ if(( newFlagsDown & mask ) != ( lastFlagsDown & mask ))	\
 - (void)keyUp:(NSEvent *)theEvent
 {
 	Keyboard::Key key = getKeyForMacKeyCode( [theEvent keyCode] );
-	if( key != Keyboard::Unsupported )
+	if( key != Keyboard::Unsupported && !isReplayingInput() )
 	{
 		Keyboard::onKeyStateChanged( key, false );
 	}
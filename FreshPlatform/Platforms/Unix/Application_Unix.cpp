@@ -429,6 +429,14 @@ namespace fr
 
 		void handleEvent( const XEvent& event )
 		{
+			// While input is being replayed, the replay is the only input.
+			//
+			const bool isInput = event.type == KeyPress || event.type == KeyRelease || event.type == ButtonPress || event.type == ButtonRelease || event.type == MotionNotify;
+			if( isInput && Application::instance().isReplayingInput() )
+			{
+				return;
+			}
+
 			switch( event.type )
 			{
 				case KeyPress:
@@ -756,6 +764,7 @@ namespace fr
 	Application::ExitCode Application::runMainLoop( int argc, const char* argv[] )
 	{
 		REQUIRES( !isMainLoopRunning() );
+		processInputCommandLine( argc, argv );
 		return m_impl->runMainLoop( argc, argv );
 	}
 
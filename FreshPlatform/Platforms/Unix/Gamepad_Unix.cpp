@@ -395,8 +395,7 @@ namespace fr
 					
 					bool isDuplicate = std::any_of( m_gamepads.begin(), m_gamepads.end(), [&]( Gamepad::ptr gamepad )
 					{
-						auto& payload = payloadForGamepad( gamepad );
-						return payload.hasPath( fileName );
+						return gamepad->payload() && payloadForGamepad( gamepad ).hasPath( fileName );
 					} );
 
 					if( isDuplicate ) 
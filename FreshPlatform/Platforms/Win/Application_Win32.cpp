@@ -948,6 +948,7 @@ namespace fr
 	Application::ExitCode Application::runMainLoop( int argc, const char* argv[] )
 	{
 		REQUIRES( !isMainLoopRunning() );
+		processInputCommandLine( argc, argv );
 		return m_impl->runMainLoop( argc, argv );
 	}
 
@@ -984,6 +985,25 @@ namespace fr
 
 namespace 
 {
+	bool isLiveInputMessage( UINT message )
+	{
+		switch( message )
+		{
+		case WM_LBUTTONDOWN:
+		case WM_LBUTTONUP:
+		case WM_MOUSEMOVE:
+		case WM_MOUSELEAVE:
+		case WM_MOUSEWHEEL:
+		case WM_KEYDOWN:
+		case WM_SYSKEYDOWN:
+		case WM_KEYUP:
+		case WM_SYSKEYUP:
+			return true;
+		default:
+			return false;
+		}
+	}
+
 	LRESULT CALLBACK WndProc( HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam )
 	{
 		if( !Application::doesExist() )
@@ -991,6 +1011,13 @@ namespace
 			return ::DefWindowProc(hWnd, message, wParam, lParam);
 		}
 
+		// While input is being replayed, the replay is the only input. The system still sees keys, so that Alt-F4 quits.
+		//
+		if( Application::instance().isReplayingInput() && isLiveInputMessage( message ))
+		{
+			return ::DefWindowProc(hWnd, message, wParam, lParam);
+		}
+
 		switch( message )
 		{
 		case WM_SETFOCUS:
@@ -663,8 +663,7 @@ namespace fr
 					// Have we already registered a joystick with this ID?
 					//
 					if( m_gamepads.end() != std::find_if( m_gamepads.begin(), m_gamepads.end(), [&]( Gamepad::ptr gamepad ) {
-							const auto& payload = payloadForGamepad( gamepad );
-							return payload.hasID(  joystickID );
+							return gamepad->payload() && payloadForGamepad( gamepad ).hasID(  joystickID );
 						} ))
 					{
 						continue;
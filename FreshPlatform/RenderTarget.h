@@ -47,6 +47,8 @@ namespace fr
 
 		bool isCreated() const							{ return m_idFrameBuffer != 0; }
 
+		virtual bool isSharedResource() const override	{ return true; }
+
 		struct BufferFormat : public SerializableStruct< BufferFormat >
 		{
 			ColorComponentType colorComponentType;
@@ -110,6 +112,7 @@ namespace fr
 		unsigned int height() const						{ return m_height; }
 
 		virtual void load( const Manifest::Map& properties ) override;
+		virtual void load( const ManifestDocument::Map& properties ) override		{ load( *properties.toManifestMap() ); }
 
 	protected:
 
@@ -90,6 +90,19 @@ namespace fr
 	Renderer::~Renderer()
 	{}
 
+	Renderer::Counters& Renderer::Counters::operator+=( const Counters& other )
+	{
+		nDrawCalls += other.nDrawCalls;
+		nVertices += other.nVertices;
+		nTextureBinds += other.nTextureBinds;
+		nShaderProgramChanges += other.nShaderProgramChanges;
+		nBlendModeChanges += other.nBlendModeChanges;
+		nStencilModeChanges += other.nStencilModeChanges;
+		nViewportChanges += other.nViewportChanges;
+		nClears += other.nClears;
+		return *this;
+	}
+
 	void Renderer::setPerspectiveProjection( real halfFOVDegrees, real aspectRatio, real zNear, real zFar )
 	{
 		ASSERT( 0 < halfFOVDegrees && halfFOVDegrees <= 180 );
@@ -284,6 +297,7 @@ namespace fr
 			m_currentRenderState.currentTextureId[ iSampler ] = idTexture;
 			
 			glBindTexture( GL_TEXTURE_2D, idTexture );
+			++m_counters.nTextureBinds;
 			
 			// Go back to unit 0 so that future calls with iSampler==0 (the most common case) can avoid calling glActiveTexture().
 			//
@@ -307,6 +321,7 @@ namespace fr
 		if( m_currentShaderProgram != shaderProgram )
 		{
 			m_currentShaderProgram = shaderProgram;
+			++m_counters.nShaderProgramChanges;
 			
 			if( shaderProgram && shaderProgram->isLinked() )
 			{
@@ -397,6 +412,8 @@ namespace fr
 #endif
 		
 		glDrawArrays( static_cast< GLenum >( primitiveType ), static_cast< GLint >( offset ), static_cast< GLsizei >( nVertices ));
+		++m_counters.nDrawCalls;
+		m_counters.nVertices += nVertices;
 		
 		HANDLE_GL_ERRORS();
 	}
@@ -433,6 +450,7 @@ namespace fr
 		{
 			m_viewportArea = viewport;
 			glViewport( m_viewportArea.left(), m_viewportArea.top(), m_viewportArea.width(), m_viewportArea.height() );
+			++m_counters.nViewportChanges;
 			HANDLE_GL_ERRORS();
 		}
 	}
@@ -471,6 +489,7 @@ namespace fr
 #endif
 		
 		glClear( GL_COLOR_BUFFER_BIT );								// TODO depth/stencil buffers too?
+		++m_counters.nClears;
 		HANDLE_GL_ERRORS();
 	}
 	
@@ -502,6 +521,8 @@ namespace fr
 	{
 		if( m_currentRenderState.blendMode != blendMode )
 		{
+			++m_counters.nBlendModeChanges;
+			
 			if( m_currentRenderState.blendMode == BlendMode::None )
 			{
 				// Previously none. Restore blending.
@@ -559,6 +580,7 @@ namespace fr
 		if( m_currentRenderState.stencilMode != stencilMode || ( stencilMode == StencilMode::DrawToStencil && beginNewStencil ))
 		{
 			m_currentRenderState.stencilMode = stencilMode;
+			++m_counters.nStencilModeChanges;
 			
 			switch( stencilMode )
 			{
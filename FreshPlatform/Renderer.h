@@ -66,6 +66,23 @@ namespace fr
 			MaskExclusive,		// Draw to the color buffer, allowing painting of pixels only where stencil has NOT been "touched".
 		};
 		
+		// Counts of the work the renderer has submitted to OpenGL since the last resetCounters().
+		// State changes count only real changes, not redundant calls that the renderer filtered out.
+		//
+		struct Counters
+		{
+			size_t nDrawCalls = 0;
+			size_t nVertices = 0;
+			size_t nTextureBinds = 0;
+			size_t nShaderProgramChanges = 0;
+			size_t nBlendModeChanges = 0;
+			size_t nStencilModeChanges = 0;
+			size_t nViewportChanges = 0;
+			size_t nClears = 0;
+
+			Counters& operator+=( const Counters& other );
+		};
+
 		virtual ~Renderer();
 		
 		ShaderProgram::ptr createShaderProgram();
@@ -177,6 +194,9 @@ namespace fr
 		void wireframeMode( bool wireframe );
 		void toggleWireframeMode();
 		
+		const Counters& counters() const																			{ return m_counters; }
+		void resetCounters()																						{ m_counters = Counters{}; }
+		
 	protected:
 		
 		MatrixStack& getMatrix( MatrixIdentifier whichMatrix );
@@ -221,6 +241,8 @@ namespace fr
 		};
 		
 		RenderState m_currentRenderState;
+		
+		Counters m_counters;
 
 		typedef std::pair< Color, Color > ColorState;
 		std::vector< ColorState > m_stackColor;
@@ -200,8 +200,7 @@ namespace fr
 		if( modifiedVertexStructureName.empty() )
 		{
 			// Invent a name.
-			modifiedVertexStructureName = "VS_";
-			modifiedVertexStructureName += name();
+			modifiedVertexStructureName = "VS_" + name();
 		}
 		
 		
@@ -13,6 +13,7 @@
 namespace fr
 {
 	FRESH_DEFINE_CLASS( SimpleMesh )
+	FRESH_POOL_CLASS_OBJECTS( SimpleMesh )
 	
 	DEFINE_VAR( SimpleMesh, VertexBuffer::ptr, m_buffer );
 	DEFINE_VAR( SimpleMesh, Renderer::PrimitiveType, m_primitiveType );
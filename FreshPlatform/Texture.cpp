@@ -71,6 +71,8 @@ namespace fr
 			glDeleteTextures( 1, &m_idTexture );
 			m_idTexture = 0;
 			HANDLE_GL_ERRORS();
+
+			accountPayloadBytes( 0 );
 		}
 	}
 
@@ -175,6 +177,8 @@ namespace fr
 						   } );
 		}
 
+		accountPayloadBytes( getMemorySize() + m_retainedTexelData.size() * sizeof( Color ));
+
 		HANDLE_GL_ERRORS();
 	}
 
@@ -190,6 +194,7 @@ namespace fr
 		if( retainTexelData )
 		{
 			m_retainedTexelData = colors;
+			accountPayloadBytes( getMemorySize() + m_retainedTexelData.size() * sizeof( Color ));
 		}
 	}
 
@@ -321,6 +326,8 @@ namespace fr
 		m_idTexture = idTexture;
 		m_dimensions = dimensions;
 		m_originalDimensions = m_dimensions * static_cast< uint >( Application::instance().config().contentScale());
+
+		accountPayloadBytes( getMemorySize() );
 	}
 
 	size_t Texture::getMemorySize() const
@@ -20,7 +20,14 @@ namespace
 		fr::VertexStructure::ptr m_vertexStructure;
 	};
 	
-	std::vector< std::unique_ptr< VirtualVAO >> g_vaos;
+	// Never destroyed: vertex buffers owned by class default objects are released during static destruction.
+	//
+	std::vector< std::unique_ptr< VirtualVAO >>& vaos()
+	{
+		static auto* const allVAOs = new std::vector< std::unique_ptr< VirtualVAO >>();
+		return *allVAOs;
+	}
+	
 	VirtualVAO* g_boundVAO = nullptr;
 	
 	void bindVertexArray( GLuint iVAO )
@@ -29,8 +36,9 @@ namespace
 		{
 			--iVAO;
 			
-			ASSERT( iVAO < g_vaos.size() );
-			const auto& vao = g_vaos[ iVAO ];
+			const auto& allVAOs = vaos();
+			ASSERT( iVAO < allVAOs.size() );
+			const auto& vao = allVAOs[ iVAO ];
 			ASSERT( vao );
 			glBindBuffer( GL_ARRAY_BUFFER, vao->m_idVBO );
 
@@ -52,36 +60,32 @@ namespace
 	{
 		// Find an available VAO slot.
 		//
-		auto iter = std::find_if( g_vaos.begin(), g_vaos.end(), []( const std::unique_ptr< VirtualVAO >& innerVAO )
+		auto& allVAOs = vaos();
+		auto iter = std::find_if( allVAOs.begin(), allVAOs.end(), []( const std::unique_ptr< VirtualVAO >& innerVAO )
 				  {
 					  return !innerVAO;
 				  } );
 		
-		if( g_vaos.end() == iter )
+		if( allVAOs.end() == iter )
 		{
-			g_vaos.emplace_back( new VirtualVAO{ 0, nullptr } );
-			*vao = g_vaos.size();		// Not -1, because they're 1-indexed.
+			allVAOs.emplace_back( new VirtualVAO{ 0, nullptr } );
+			*vao = allVAOs.size();		// Not -1, because they're 1-indexed.
 		}
 		else
 		{
 			(*iter).reset( new VirtualVAO{ 0, nullptr } );
-			*vao = ( iter - g_vaos.begin() ) + 1;
+			*vao = ( iter - allVAOs.begin() ) + 1;
 		}
 	}
 	
 	void deleteVertexArrays( GLsizei n, GLuint* vaoArray )
 	{
-		if( g_vaos.empty() )
-		{
-			// Global already destructed. Never mind.
-			return;
-		}
-
+		auto& allVAOs = vaos();
 		for( GLsizei i = 0; i < n; ++i )
 		{
 			auto index = vaoArray[ i ] - 1;
-			ASSERT( index < g_vaos.size() );
-			auto& vao = g_vaos[ index ];
+			ASSERT( index < allVAOs.size() );
+			auto& vao = allVAOs[ index ];
 			ASSERT( vao );
 			
 			if( vao.get() == g_boundVAO )
@@ -163,6 +167,7 @@ namespace fr
 {
 
 	FRESH_DEFINE_CLASS( VertexBuffer )
+	FRESH_POOL_CLASS_OBJECTS( VertexBuffer )
 
 	DEFINE_VAR( VertexBuffer, VertexStructure::ptr, m_vertexStructure );
 
@@ -219,6 +224,8 @@ namespace fr
 			glDeleteBuffers( 1, &m_idVertexBufferObject );
 			m_idVertexBufferObject = 0;
 		}
+
+		accountPayloadBytes( 0 );
 	}
 	
 	void VertexBuffer::loadRaw( const unsigned char* begin, size_t nBytes )
@@ -264,6 +271,7 @@ namespace fr
 		bindBuffer( GL_ARRAY_BUFFER, 0 );
 		
 		m_nBytesLoaded = nBytes;
+		accountPayloadBytes( m_nBytesLoaded );
 	}
 	
 	bool VertexBuffer::isLoaded() const
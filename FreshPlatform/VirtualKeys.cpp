@@ -12,8 +12,8 @@
 namespace fr
 {
 
-	const char* EventVirtualKey::VIRTUAL_KEY_DOWN = "VirtualKeyDown";
-	const char* EventVirtualKey::VIRTUAL_KEY_UP = "VirtualKeyUp";
+	const Event::Type EventVirtualKey::VIRTUAL_KEY_DOWN = "VirtualKeyDown";
+	const Event::Type EventVirtualKey::VIRTUAL_KEY_UP = "VirtualKeyUp";
 
 	/////////////////////////////////////
 	
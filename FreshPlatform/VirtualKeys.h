@@ -18,8 +18,8 @@ namespace fr
 	{
 	public:
 		
-		static const char* VIRTUAL_KEY_DOWN;
-		static const char* VIRTUAL_KEY_UP;
+		static const Event::Type VIRTUAL_KEY_DOWN;
+		static const Event::Type VIRTUAL_KEY_UP;
 		
 		typedef std::string KeyName;
 		typedef const std::string& KeyNameRef;
@@ -68,6 +68,7 @@ namespace fr
 		// Serialization.
 		//
 		virtual void load( const Manifest::Map& properties ) override;
+		virtual void load( const ManifestDocument::Map& properties ) override		{ load( *properties.toManifestMap() ); }
 
 		void loadBindings( const std::string& bindingScript );
 		void bindByScript( const std::string& bindCommand );
@@ -118,7 +118,12 @@ namespace fr
 	
 		const AppStageConfig* const myConfig = dynamic_cast< const AppStageConfig* >( &config() );
 		
-		if( !myConfig )
+		if( !startupPackagePath().empty() )
+		{
+			dev_trace( "Using startup package path: " << startupPackagePath() );
+			m_stage = loadStagePackage( startupPackagePath() );
+		}
+		else if( !myConfig )
 		{
 			con_error( "ApplicationStaged's config object was not of type AppStageConfig. We need an AppStageConfig with a valid stageManifestPath path!" );
 		}
@@ -271,30 +276,40 @@ namespace fr
 
 	void ApplicationStaged::onTouchesBegin( TouchIter begin, TouchIter end )
 	{
+		recordInput( EventTouch::TouchPhase::Begin, begin, end );
+
 		if( m_stage && begin != end )
 			SEND_TOUCHES( onTouchBegin, EventTouch::TOUCH_BEGIN, EventTouch::TouchPhase::Begin )
 	}
 	
 	void ApplicationStaged::onTouchesMove( TouchIter begin, TouchIter end )
 	{
+		recordInput( EventTouch::TouchPhase::Move, begin, end );
+
 		if( m_stage && begin != end  )
 			SEND_TOUCHES( onTouchMove, EventTouch::TOUCH_MOVE, EventTouch::TouchPhase::Move )
 	}
 	
 	void ApplicationStaged::onTouchesEnd( TouchIter begin, TouchIter end )
 	{
+		recordInput( EventTouch::TouchPhase::End, begin, end );
+
 		if( m_stage && begin != end  )
 			SEND_TOUCHES( onTouchEnd, EventTouch::TOUCH_END, EventTouch::TouchPhase::End )
 	}
 	
 	void ApplicationStaged::onTouchesCancelled( TouchIter begin, TouchIter end )
 	{
+		recordInput( EventTouch::TouchPhase::Cancelled, begin, end );
+
 		if( m_stage && begin != end  )
 			SEND_TOUCHES( onTouchCancelled, EventTouch::TOUCH_CANCELLED, EventTouch::TouchPhase::Cancelled )
 	}
 	
 	void ApplicationStaged::onWheelMove( TouchIter begin, TouchIter end )
 	{
+		recordInput( EventTouch::TouchPhase::WheelMove, begin, end );
+
 		if( m_stage && begin != end  )
 			SEND_TOUCHES( onWheelMove, EventTouch::WHEEL_MOVE, EventTouch::TouchPhase::WheelMove )
 	}
@@ -303,6 +318,8 @@ namespace fr
 
 	void ApplicationStaged::onKeyUp( const EventKeyboard& event )
 	{
+		recordInput( event );
+
 		if( m_stage )
 		{
 			m_stage->onKeyUp( EventKeyboard( event.type(),
@@ -319,6 +336,8 @@ namespace fr
 	
 	void ApplicationStaged::onKeyDown( const EventKeyboard& event )
 	{
+		recordInput( event );
+
 		if( m_stage )
 		{
 			m_stage->onKeyDown( EventKeyboard( event.type(),
@@ -356,4 +375,12 @@ namespace fr
 			m_stage->onWindowReshape( getWindowDimensions() );
 		}
 	}
+
+	void ApplicationStaged::traceFrameStats( std::ostream& out ) const
+	{
+		if( m_stage )
+		{
+			m_stage->frameStats().traceStats( out );
+		}
+	}
 }
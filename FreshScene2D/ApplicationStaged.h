@@ -51,6 +51,7 @@ namespace fr
 		virtual void onGainedFocus() override;
 		virtual void onLostFocus() override;
 		virtual void onWindowReshape() override;
+		virtual void traceFrameStats( std::ostream& out ) const override;
 
 		virtual void onTerminationThreat() override;
 		virtual void onTerminating() override;
@@ -32,10 +32,10 @@ namespace
 
 namespace fr
 {
-	const char* DisplayObject::TAPPED = "Tapped";
-	const char* DisplayObject::DRAG_BEGIN = "DragBegin";
-	const char* DisplayObject::DRAG_MOVE = "DragMove";
-	const char* DisplayObject::DRAG_END = "DragEnd";
+	const Event::Type DisplayObject::TAPPED = "Tapped";
+	const Event::Type DisplayObject::DRAG_BEGIN = "DragBegin";
+	const Event::Type DisplayObject::DRAG_MOVE = "DragMove";
+	const Event::Type DisplayObject::DRAG_END = "DragEnd";
 
 	bool DisplayObject::RenderInjector::preDraw( TimeType relativeFrameTime, DisplayObject& object )
 	{
@@ -1070,17 +1070,14 @@ namespace fr
 		stage().removeEventListener( EventTouch::TOUCH_CANCELLED, FRESH_CALLBACK( onTouchEndAnywhereForDrag ));
 	}
 
-	Object::ptr DisplayObject::createClone( NameRef name ) const
+	void DisplayObject::cloneProperties( const Object& original )
 	{
-		auto copy = dynamic_freshptr_cast< DisplayObject::ptr >( Super::createClone( name ));
-		ASSERT( copy );
+		Super::cloneProperties( original );
 		
-		if( copy->parent() )
-		{
-			copy->onRemovingFromParent();
-		}
-
-		return copy;
+		// A clone starts out unattached. Its clones of my children adopt it in postLoad().
+		//
+		m_parent = nullptr;
+		m_stage = nullptr;
 	}
 	
 	bool DisplayObject::verifyTree() const
@@ -36,10 +36,10 @@ namespace fr
 		FRESH_DECLARE_CLASS( DisplayObject, EventDispatcher )
 	public:
 		
-		static const char* TAPPED;
-		static const char* DRAG_BEGIN;
-		static const char* DRAG_MOVE;
-		static const char* DRAG_END;
+		static const Event::Type TAPPED;
+		static const Event::Type DRAG_BEGIN;
+		static const Event::Type DRAG_MOVE;
+		static const Event::Type DRAG_END;
 
 		virtual ~DisplayObject();
 		
@@ -278,8 +278,6 @@ namespace fr
 		virtual void onRemovingFromParent();
 		virtual void onRemovingFromStage();
 		
-		virtual Object::ptr createClone( NameRef name = DEFAULT_OBJECT_NAME ) const override;
-		
 		// Components.
 		//
 		bool hasComponent( SmartPtr< DisplayObjectComponent > component ) const;
@@ -306,6 +304,8 @@ namespace fr
 				
 	protected:
 				
+		virtual void cloneProperties( const Object& original ) override;
+		
 		VAR( vec2, m_position );
 		VAR( angle, m_rotation );
 		DVAR( vec2, m_scale, vec2( 1.0f, 1.0f ));
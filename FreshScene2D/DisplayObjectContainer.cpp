@@ -29,6 +29,8 @@ namespace fr
 
 	FRESH_IMPLEMENT_STANDARD_CONSTRUCTORS( DisplayObjectContainer )
 
+	size_t DisplayObjectContainer::s_childOrderVersion = 0;
+
 	DisplayObjectContainer::~DisplayObjectContainer()
 	{
 		onEndPlay();
@@ -48,6 +50,7 @@ namespace fr
 		REQUIRES( getChildIndex( displayObject ) == size_t( -1 ));
 		
 		m_children.insert( m_children.begin() + index, displayObject );
+		++s_childOrderVersion;
 
 		displayObject->parent( this );
 		displayObject->propagateParentNotification();
@@ -93,6 +96,7 @@ namespace fr
 		displayObject->onRemovingFromParent();
 		
 		m_children.erase( m_children.begin() + iChild );
+		++s_childOrderVersion;
 		
 		if( m_enableNewChildCatcher )
 		{
@@ -108,6 +112,7 @@ namespace fr
 		if( firstToRemove != m_children.end() )
 		{
 			m_children.erase( firstToRemove, m_children.end());
+			++s_childOrderVersion;
 		}
 	}
 
@@ -164,6 +169,7 @@ namespace fr
 		REQUIRES( iChildB < numChildren() );
 		
 		std::swap( m_children[ iChildA ], m_children[ iChildB ] );
+		++s_childOrderVersion;
 	}
 
 	bool DisplayObjectContainer::hasDescendant( DisplayObject::cptr displayObject ) const
@@ -341,6 +347,8 @@ namespace fr
 	{
 		Super::postLoad();
 		
+		++s_childOrderVersion;
+		
 		// Kill any remaining null children.
 		
 		auto firstNullChild = std::remove( m_children.begin(), m_children.end(), nullptr );
@@ -380,31 +388,6 @@ namespace fr
 		}
 	}
 
-	Object::ptr DisplayObjectContainer::createClone( NameRef name ) const
-	{
-		auto copy = dynamic_freshptr_cast< DisplayObjectContainer::ptr >( Super::createClone( name ));
-		ASSERT( copy );
-		
-		// Clone all children.
-		//
-		decltype( m_children ) cloneChildren;
-		
-		for( size_t i = 0; i < copy->m_children.size(); ++i )
-		{
-			auto childCopy = copy->m_children[ i ]->createClone()->as< DisplayObject >();
-			cloneChildren.push_back( childCopy );
-		}
-		
-		copy->m_children.clear();
-		
-		std::for_each( cloneChildren.begin(), cloneChildren.end(), [&]( DisplayObject::ptr child )
-					  {
-						  copy->addChild( child );
-					  } );
-		
-		return copy;
-	}	
-
 	bool DisplayObjectContainer::verifyTree() const
 	{
 #ifdef DEBUG
@@ -102,6 +102,7 @@ namespace fr
 		void removeChildren( PredicateT&& predicate )
 		{
 			fr::removeElements( m_children, std::move( predicate ));
+			++s_childOrderVersion;
 		}
 		
 		bool hasChild( DisplayObject::cptr displayObject ) const;
@@ -144,8 +145,14 @@ namespace fr
 		void sortChildren( Comparator&& comparator )
 		{
 			std::sort( m_children.begin(), m_children.end(), std::forward< Comparator >( comparator ));
+			++s_childOrderVersion;
 		}
 
+		// Changes whenever any container's children are added, removed or reordered,
+		// so that anything caching display-tree order can tell when to refresh it.
+		//
+		static size_t childOrderVersion()									{ return s_childOrderVersion; }
+		
 		virtual void update() override;
 		
 		virtual void onTouchBegin( const EventTouch& event ) override;
@@ -181,8 +188,6 @@ namespace fr
 		
 		virtual void postLoad() override;
 		
-		Object::ptr createClone( NameRef name = DEFAULT_OBJECT_NAME ) const override;
-		
 		virtual bool verifyTree() const override;
 				
 	protected:
@@ -228,6 +233,8 @@ namespace fr
 		bool	 m_enableNewChildCatcher = false;		// When true, all newly added children are also added to m_newChildCatcher. Removed children are also removed from there.
 		std::set< DisplayObject::wptr > m_newChildCatcher;
 		
+		static size_t s_childOrderVersion;
+		
 		FRESH_DECLARE_CLASS( DisplayObjectContainer, DisplayObject )
 	};
 	
@@ -41,9 +41,9 @@ namespace fr
 		out << "\">\n";
 	}
 	
-	std::vector< Object::ptr > DisplayPackage::loadFromManifest( const Manifest& manifest )
+	void DisplayPackage::onManifestLoaded( const std::vector< Object::ptr >& objects )
 	{
-		auto objects = Super::loadFromManifest( manifest );
+		Super::onManifestLoaded( objects );
 		
 		DisplayObject::ptr frontAsDisplayObject = objects.empty() ? nullptr : objects.front()->as< DisplayObject >();
 		
@@ -55,8 +55,6 @@ namespace fr
 		{
 			con_error( "DisplayPackage " << name() << " contained no display objects!" );
 		}
-		
-		return objects;
 	}
 }
 
@@ -25,10 +25,9 @@ namespace fr
 		SYNTHESIZE_GET( SmartPtr< DisplayObject >, root );
 		void root( SmartPtr< DisplayObject > root );
 		
-		virtual std::vector< Object::ptr > loadFromManifest( const Manifest& manifest ) override;
-		
 	protected:
 		
+		virtual void onManifestLoaded( const std::vector< Object::ptr >& objects ) override;
 		virtual void writeRootElement( std::ostream& out ) const override;
 
 	private:
@@ -77,8 +77,8 @@ namespace fr
 	DEFINE_METHOD( MovieClip, play )
 	DEFINE_METHOD( MovieClip, stop )
 
-	const char* MovieClip::TWEEN_FINISHED = "TweenFinished";
-	const char* MovieClip::PLAYBACK_REACHED_END = "PlaybackReachedEnd";
+	const Event::Type MovieClip::TWEEN_FINISHED = "TweenFinished";
+	const Event::Type MovieClip::PLAYBACK_REACHED_END = "PlaybackReachedEnd";
 
 	FRESH_IMPLEMENT_STANDARD_CONSTRUCTOR_INERT( MovieClip )
 
@@ -21,8 +21,8 @@ namespace fr
 	public:
 		
 		static const size_t INVALID_FRAME_INDEX = -1;
-		static const char* TWEEN_FINISHED;		// Event type for receiving a callback whenever a tween completes. Even "instant" (duration==0) and "failed" (requested label doesn't exist) tweens dispatch this event.
-		static const char* PLAYBACK_REACHED_END;
+		static const Event::Type TWEEN_FINISHED;		// Event type for receiving a callback whenever a tween completes. Even "instant" (duration==0) and "failed" (requested label doesn't exist) tweens dispatch this event.
+		static const Event::Type PLAYBACK_REACHED_END;
 		
 		typedef std::string Label;
 		typedef const Label& LabelRef;
@@ -176,6 +176,7 @@ namespace fr
 		virtual void update() override;
 
 		virtual void load( const Manifest::Map& properties ) override;
+		virtual void load( const ManifestDocument::Map& properties ) override		{ load( *properties.toManifestMap() ); }
 		virtual void serialize( class ObjectStreamFormatter& formatter, bool doWriteEvenIfDefault = false ) const override;
 		virtual void postLoad() override;
 		virtual void onAddedToStage() override;
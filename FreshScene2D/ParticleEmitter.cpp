@@ -151,6 +151,7 @@ namespace fr
 
 	void ParticleEmitter::reset()
 	{
+		m_hasPendingStep = false;
 		m_iBeginLiveParticles = m_iEndLiveParticles = 0;
 		m_spawnTimeAccumulator = 0;
 	}
@@ -208,6 +209,8 @@ namespace fr
 
 		if( oldMaxParticles != particles )
 		{
+			finishPendingStep();
+			
 			normalizeIndices();
 			
 			//
@@ -310,6 +313,8 @@ namespace fr
 
 		// Spawn a bunch of particles immediately, all at the same time, with a delay afterward, so that there is a simultaneous burst of particles.
 		
+		finishPendingStep();
+		
 		TimeType now = stage().time();
 		
 		for( size_t i = 0; i < nParticles; ++i )
@@ -378,6 +383,7 @@ namespace fr
 
 	void ParticleEmitter::velocityDamping( float damping )
 	{
+		finishPendingStep();
 		m_velocityDamping = damping;
 		
 		m_twoMinusVelocityDamping = 2.0f - m_velocityDamping;
@@ -386,6 +392,7 @@ namespace fr
 
 	void ParticleEmitter::angularDamping( float damping )
 	{
+		finishPendingStep();
 		m_angularDamping = damping;
 		
 		m_twoMinusAngularDamping = 2.0f - m_angularDamping;
@@ -404,6 +411,7 @@ namespace fr
 	
 	void ParticleEmitter::addAttractorRepulsor( const Vector2f& location, float power, bool usesInverseDistance, float lateralDisplacement )
 	{
+		finishPendingStep();
 		m_attractorRepulsors.emplace_back( AttractorRepulsor( location, power, usesInverseDistance, lateralDisplacement ));
 	}
 	
@@ -411,6 +419,7 @@ namespace fr
 	{
 		REQUIRES( which < numAttractorRepulsors() );
 
+		finishPendingStep();
 		m_attractorRepulsors.erase( m_attractorRepulsors.begin() + which );
 	}
 	
@@ -418,6 +427,7 @@ namespace fr
 	{
 		REQUIRES( which < numAttractorRepulsors() );
 		
+		finishPendingStep();
 		m_attractorRepulsors[ which ] = AttractorRepulsor( location, power, usesInverseDistance, lateralDisplacement );
 	}
 	
@@ -449,6 +459,10 @@ namespace fr
 
 	rect ParticleEmitter::localBounds() const
 	{
+		// The bounds should reflect this frame's step, even if another object asks during the update.
+		//
+		const_cast< ParticleEmitter* >( this )->finishPendingStep();
+		
 		rect bounds( 0, 0, 0, 0 );		// Minimal bounds.
 		
 		for( size_t iParticle = m_iBeginLiveParticles; iParticle < m_iEndLiveParticles; ++iParticle )
@@ -486,7 +500,30 @@ namespace fr
 			m_lastAnimStepTime = now;
 		}
 		
-		updateParticles( now, shouldStepAnimations );
+		// Spawning uses the shared random generator, so it happens here, in update order.
+		// The step only touches this emitter's particles, so it can run alongside other work in a frame task.
+		// Stepping the particles that were live before spawning, minus any the spawns displaced,
+		// comes to the same thing as stepping first and then spawning.
+		//
+		finishPendingStep();
+		sortKeyframes();
+		
+		const size_t iEndStepped = m_iEndLiveParticles;
+		spawnParticles( now );
+		
+		if( m_iBeginLiveParticles < iEndStepped )
+		{
+			const TimeType deltaTime = stage().secondsPerFrame();
+			
+			m_hasPendingStep = true;
+			m_iBeginPendingStep = m_iBeginLiveParticles;
+			m_iEndPendingStep = iEndStepped;
+			m_doStepAnimationsPendingStep = shouldStepAnimations;
+			m_forceTimesDeltaTimeSquaredPendingStep = m_particleForce * static_cast< float >( deltaTime * deltaTime );
+			
+			ParticleEmitter::ptr self = this;
+			stage().frameTasks().add( "ParticleEmitter", [self]() { self->finishPendingStep(); } );
+		}
 		
 		// If all the particles are dead, perhaps the emitter should kill itself.
 		//
@@ -530,6 +567,8 @@ namespace fr
 
 	void ParticleEmitter::recordPreviousState( bool recursive )
 	{
+		finishPendingStep();
+		
 		m_previousParticles = m_particles;
 		
 		Super::recordPreviousState( recursive );
@@ -555,6 +594,28 @@ namespace fr
 	}
 
 	void ParticleEmitter::updateParticles( TimeType now, bool doStepAnimations )
+	{
+		finishPendingStep();
+		sortKeyframes();
+		
+		// Update particle physics.
+		//
+		const TimeType deltaTime = stage().secondsPerFrame();
+		stepParticles( m_iBeginLiveParticles, m_iEndLiveParticles, doStepAnimations, m_particleForce * static_cast< float >( deltaTime * deltaTime ));
+		
+		spawnParticles( now );
+	}
+	
+	void ParticleEmitter::finishPendingStep()
+	{
+		if( m_hasPendingStep )
+		{
+			m_hasPendingStep = false;
+			stepParticles( m_iBeginPendingStep, m_iEndPendingStep, m_doStepAnimationsPendingStep, m_forceTimesDeltaTimeSquaredPendingStep );
+		}
+	}
+	
+	void ParticleEmitter::sortKeyframes()
 	{
 		// Ensure that the keyframe vectors are sorted.
 		//
@@ -568,20 +629,19 @@ namespace fr
 			std::sort( m_vecKeyframesScale.begin(), m_vecKeyframesScale.end(), compareTimeKeyframesVector2f );
 			m_isVecKeyframesScaleSorted = true;
 		}
-		
-		// Update particle physics.
-		//
-		const TimeType deltaTime = stage().secondsPerFrame();
-		const Vector2f forceTimesDeltaTimeSquared = m_particleForce * static_cast< float >( deltaTime * deltaTime );
-		
-		ASSERT( m_iBeginLiveParticles <= m_iEndLiveParticles );
-		for( size_t iParticle = m_iBeginLiveParticles; iParticle < m_iEndLiveParticles; ++iParticle )
+	}
+	
+	void ParticleEmitter::stepParticles( size_t iBegin, size_t iEnd, bool doStepAnimations, const Vector2f& forceTimesDeltaTimeSquared )
+	{
+		ASSERT( iBegin <= iEnd );
+		for( size_t iParticle = iBegin; iParticle < iEnd; ++iParticle )
 		{
 			updateParticle( m_particles[ iParticle % m_particles.size() ], doStepAnimations, forceTimesDeltaTimeSquared );
 		}
-		
-		// Spawn new particles.
-		//
+	}
+	
+	void ParticleEmitter::spawnParticles( TimeType now )
+	{
 		if( m_isSpawningEnabled && m_particlesPerSecond > 0 )
 		{
 			const TimeType secondsPerSpawn = 1.0 / m_particlesPerSecond;
@@ -918,6 +978,8 @@ namespace fr
 
 	void ParticleEmitter::forEachParticle( std::function< bool( Particle& ) >&& fnPerParticle )
 	{
+		finishPendingStep();
+		
 		ASSERT( m_iBeginLiveParticles <= m_iEndLiveParticles );
 		for( size_t iParticle = m_iBeginLiveParticles; iParticle < m_iEndLiveParticles; ++iParticle )
 		{
@@ -195,6 +195,11 @@ namespace fr
 		void forEachParticle( std::function< bool( Particle& ) >&& fnPerParticle );
 	
 		virtual void updateParticles( TimeType now, bool doStepAnimations );
+			// Steps and spawns particles immediately. update() instead spawns, then steps the particles in a stage frame task.
+		
+		void finishPendingStep();
+			// If update() left a step of the particles to a frame task that hasn't run yet, does the step now.
+			// Anything that reads or changes the particles outside the task calls this first.
 		
 		virtual void draw( TimeType relativeFrameTime, RenderInjector* injector = nullptr ) override;
 		
@@ -206,6 +211,9 @@ namespace fr
 		float getRandomSpawnAngularVelocity() const;
 		Vector2f getRandomSpawnScale() const;
 		void spawnParticle( TimeType birthDate );
+		void spawnParticles( TimeType now );
+		void sortKeyframes();
+		void stepParticles( size_t iBegin, size_t iEnd, bool doStepAnimations, const Vector2f& forceTimesDeltaTimeSquared );
 		
 		Color getKeyframedColor( TimeType normalizedTime ) const;
 		Vector2f getKeyframedScale( TimeType normalizedTime ) const;
@@ -299,6 +307,14 @@ namespace fr
 		DVAR( bool,				m_doRandomizeAnimStart, true );	// Only relevant if m_animFramesPerSecond > 0. Iff true, each particle starts with a random subdivision.
 		
 		TimeType m_lastAnimStepTime = -1;
+		
+		// A step left to a frame task by update().
+		//
+		bool m_hasPendingStep = false;
+		size_t m_iBeginPendingStep = 0;
+		size_t m_iEndPendingStep = 0;
+		bool m_doStepAnimationsPendingStep = false;
+		Vector2f m_forceTimesDeltaTimeSquaredPendingStep;
 			 
 		// Creation parameters
 		//
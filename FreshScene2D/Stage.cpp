@@ -21,6 +21,11 @@ namespace fr
 	DEFINE_VAR( Stage, vec2, m_stageDimensions );
 	DEFINE_VAR( Stage, bool, m_substepForRealTimeAdjustment );
 	DEFINE_VAR( Stage, bool, m_doShowTimingStatistics );
+	DEFINE_VAR( Stage, TimeType, m_frameBudgetSeconds );
+	DEFINE_VAR( Stage, TimeType, m_updateBudgetSeconds );
+	DEFINE_VAR( Stage, TimeType, m_renderBudgetSeconds );
+	DEFINE_VAR( Stage, bool, m_doTraceFrameBudgetOverruns );
+	DEFINE_VAR( Stage, bool, m_doCaptureScopesForFrameBudgetOverruns );
 	DEFINE_VAR( Stage, TimeType, m_minFrameRateForRealTimeAdjustment );
 	DEFINE_VAR( Stage, VirtualKeys::ptr, m_virtualKeys );
 	DEFINE_VAR( Stage, DisplayObject::ptr, m_keyboardFocusHolder );
@@ -30,6 +35,8 @@ namespace fr
 	DEFINE_ACCESSOR( Stage, float, timeFloat );
 	DEFINE_ACCESSOR( Stage, float, realTimeFloat );
 
+	const Event::Type Stage::FRAME_BUDGET_OVERRUN = "FrameBudgetOverrun";
+
 	FRESH_IMPLEMENT_STANDARD_CONSTRUCTOR_INERT( Stage )
 
 	Stage::Stage( const ClassInfo& assignedClassInfo, NameRef objectName )
@@ -55,6 +62,33 @@ namespace fr
 			auto caller = stream_function< void() >( std::bind( &Stage::traceSceneTree, this ) );
 			auto command = CommandProcessor::instance().registerCommand( this, "dlist", "displays the scene graph for the current stage.", caller );
 		}
+
+		// Create the frametasks command.
+		//
+		{
+			auto caller = stream_function< void() >( std::bind( &Stage::traceFrameTasks, this ) );
+			auto command = CommandProcessor::instance().registerCommand( this, "frametasks", "displays timings for the stage's frame tasks.", caller );
+		}
+
+		// Create the framestats command.
+		//
+		{
+			auto caller = make_caller< void, const std::string& >( std::bind( &Stage::traceFrameStats, this, std::placeholders::_1 ) );
+			auto command = CommandProcessor::instance().registerCommand( this, "framestats", "displays frame, update and render time percentiles and budget overruns.", caller );
+			command->addArgument( CommandProcessor::CommandAbstract::Argument( { "reset", true, "pass 'reset' to clear the statistics after displaying them" } ));
+		}
+
+		m_frameStats.alertListener( [this]( const FrameStats::Alert& alert )
+		{
+			if( m_doTraceFrameBudgetOverruns )
+			{
+				release_trace( "FRAME BUDGET: " << FrameStats::phaseName( alert.phase ) << " " << alert.frame << " took "
+							  << alert.nanoseconds / 1000000.0 << "ms; the budget is " << alert.budgetNanoseconds / 1000000.0 << "ms." );
+			}
+
+			Event event( FRAME_BUDGET_OVERRUN, this );
+			dispatchEvent( &event );
+		} );
 	}
 
 	Stage::~Stage()
@@ -121,6 +155,19 @@ namespace fr
 
 		TIMER_AUTO_FUNC
 
+		m_frameStats.budgetSeconds( FrameStats::Phase::Frame, m_frameBudgetSeconds );
+		m_frameStats.budgetSeconds( FrameStats::Phase::Update, m_updateBudgetSeconds );
+		m_frameStats.budgetSeconds( FrameStats::Phase::Render, m_renderBudgetSeconds );
+
+		if( m_doCaptureScopesForFrameBudgetOverruns && !trace::isCapturing() )
+		{
+			trace::startCapture();
+		}
+
+		m_frameStats.beginFrame();
+		m_frameStats.beginUpdate();
+		size_t nStepsTaken = 0;
+
 		try
 		{
 			TIMER_AUTO( Stage::update )
@@ -136,7 +183,7 @@ namespace fr
 
 				const SystemClock now = getAbsoluteTimeClocks();
 
-				if( m_substepForRealTimeAdjustment )
+				if( isSubsteppingForRealTime() )
 				{
 					// Update until we have exhausted the amount of alloted time for the frame.
 					//
@@ -145,7 +192,7 @@ namespace fr
 						m_frameStartTimeReal = now;
 					}
 
-					SystemClock deltaTimeReal = m_lastFrameDurationReal = now - m_frameStartTimeReal;
+					SystemClock deltaTimeReal = m_lastFrameDurationReal = Application::instance().realFrameDuration( now - m_frameStartTimeReal );
 
 					// Prevent excessive time being spent looping over updates. If the frame rate < 10fps, we'll just have to suck it up.
 					//
@@ -168,9 +215,6 @@ namespace fr
 
 					const SystemClock clocksToSpend = clocksPerFrame();
 
-#if DEV_MODE && 1
-					int nStepsTaken = 0;
-#endif
 					while( m_timeAccumulator >= clocksToSpend )
 					{
 						// Record the prior state for all DisplayObjects before changing them.
@@ -178,9 +222,7 @@ namespace fr
 						recordPreviousState( true );
 
 						updateStep();
-#if DEV_MODE && 1
 						++nStepsTaken;
-#endif
 
 						m_timeAccumulator -= clocksToSpend;
 					}
@@ -210,6 +252,7 @@ namespace fr
 				else
 				{
 					updateStep();
+					++nStepsTaken;
 				}
 
 				m_frameStartTimeReal = now;
@@ -223,11 +266,18 @@ namespace fr
 		{
 			con_error( "Unknown exception." );
 		}
+
+		m_frameStats.endUpdate( nStepsTaken );
+	}
+
+	bool Stage::isSubsteppingForRealTime() const
+	{
+		return m_substepForRealTimeAdjustment && !( Application::doesExist() && Application::instance().isFixedTimestep() );
 	}
 
 	TimeType Stage::getProportionTimeThroughFrame() const
 	{
-		if( m_substepForRealTimeAdjustment )
+		if( isSubsteppingForRealTime() )
 		{
 			return
 			(( m_nUpdates > 1 ) && m_timeAccumulator <= clocksPerFrame() ) ?
@@ -250,6 +300,10 @@ namespace fr
 		updateScheduledCallbacks();
 
 		DisplayObjectContainer::update();
+
+		// Run the jobs that the update queued. They all finish here, before anything renders.
+		//
+		m_frameTasks.run();
 	}
 
 	void Stage::traceSceneTree()
@@ -257,6 +311,25 @@ namespace fr
 		traceSceneTreeRecursive( this );
 	}
 
+	void Stage::traceFrameTasks()
+	{
+		std::ostringstream stream;
+		m_frameTasks.traceTimings( stream );
+		trace( stream.str() );
+	}
+
+	void Stage::traceFrameStats( const std::string& option )
+	{
+		std::ostringstream stream;
+		m_frameStats.traceStats( stream );
+		trace( stream.str() );
+
+		if( option == "reset" )
+		{
+			m_frameStats.reset();
+		}
+	}
+
 	void Stage::traceSceneTreeRecursive( DisplayObject::ptr root, int depth, int maxDepth )
 	{
 		std::ostringstream stream;
@@ -312,10 +385,20 @@ namespace fr
 				}
 			}
 
+			if( m_isRootOfRendering )
+			{
+				m_frameStats.beginRender();
+			}
+
 			// Render all objects at this tweened position.
 			//
 			DisplayObjectContainer::preRender( proportionTimeThroughFrame );
 			DisplayObjectContainer::render( proportionTimeThroughFrame, injector );
+
+			if( m_isRootOfRendering )
+			{
+				m_frameStats.endRender();
+			}
 		}
 	}
 
@@ -17,6 +17,8 @@
 #include "EventKeyboard.h"
 #include "VirtualKeys.h"
 #include "DisplayPackage.h"
+#include "FrameTasks.h"
+#include "FrameStats.h"
 
 namespace fr
 {
@@ -107,20 +109,43 @@ namespace fr
 		SYNTHESIZE( bool, isRootOfRendering );
 		
 		SYNTHESIZE_GET( VirtualKeys::ptr, virtualKeys )
+
+		FrameTasks& frameTasks()								{ return m_frameTasks; }
+		// Jobs added here during update run, concurrently where they can, at the end of the update step.
+
+		static const Event::Type FRAME_BUDGET_OVERRUN;
+		// Dispatched when a frame, its update or its render takes longer than its budget.
+		// The overrun is described by frameStats().recentAlerts().back().
+
+		FrameStats& frameStats()								{ return m_frameStats; }
+		const FrameStats& frameStats() const					{ return m_frameStats; }
 				
 	protected:
 		
 		DVAR( bool, m_substepForRealTimeAdjustment, true );
 		DVAR( bool, m_doShowTimingStatistics, false );
+
+		// Budgets for the real time taken by each frame, update and render. 0 means no budget.
+		//
+		DVAR( TimeType, m_frameBudgetSeconds, 0.1 );
+		DVAR( TimeType, m_updateBudgetSeconds, 0 );
+		DVAR( TimeType, m_renderBudgetSeconds, 0 );
+		DVAR( bool, m_doTraceFrameBudgetOverruns, true );
+		DVAR( bool, m_doCaptureScopesForFrameBudgetOverruns, false );		// Keeps a trace capture running so overruns can show what ran.
 	
 		virtual void updateStep();
 		
 		void computeStageDimensions( const vec2& windowDimensions );
 		
 		void traceSceneTree();
+		void traceFrameTasks();
+		void traceFrameStats( const std::string& option );
 		static void traceSceneTreeRecursive( DisplayObject::ptr root, int depth = 0, int maxDepth = 0 );
 		
 		TimeType getProportionTimeThroughFrame() const;
+		
+		bool isSubsteppingForRealTime() const;
+		// True if updates substep to keep up with real time, unless the Application has fixed the timestep.
 
 		virtual void onTouchCommon( const EventTouch& event, const std::function< void( const EventTouch& ) >& superMethod );
 		
@@ -155,6 +180,9 @@ namespace fr
 		
 		mat4 m_cachedTransformMatrix = mat4::IDENTITY;
 
+		FrameTasks m_frameTasks;
+		FrameStats m_frameStats;
+
 		DVAR( Color, m_clearColor, Color( 0.2f, 0.2f, 0.25f ));
 		DVAR( bool, m_wantsClear, true );
 		
@@ -11,7 +11,7 @@
 
 namespace fr
 {
-	const char* TimeServer::SCHEDULED = "Scheduled";
+	const Event::Type TimeServer::SCHEDULED = "Scheduled";
 
 	FRESH_DEFINE_CLASS( CallbackScheduler )
 	
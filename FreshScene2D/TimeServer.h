@@ -64,7 +64,7 @@ namespace fr
 	{
 	public:
 		
-		static const char* SCHEDULED;		// Event type used by scheduled callbacks.
+		static const Event::Type SCHEDULED;		// Event type used by scheduled callbacks.
 		
 		explicit TimeServer( CallbackScheduler::ptr scheduler = nullptr ) : m_scheduler( scheduler ) {}
 		
@@ -26,9 +26,9 @@ namespace fr
 	DEFINE_VAR( UIEditBox, std::string, m_initialText );
 	FRESH_IMPLEMENT_STANDARD_CONSTRUCTORS( UIEditBox )
 	
-	const char* UIEditBox::BEGIN_EDITING = "BeginEditing";
-	const char* UIEditBox::END_EDITING = "EndEditing";
-	const char* UIEditBox::CHANGED = "Changed";
+	const Event::Type UIEditBox::BEGIN_EDITING = "BeginEditing";
+	const Event::Type UIEditBox::END_EDITING = "EndEditing";
+	const Event::Type UIEditBox::CHANGED = "Changed";
 	
 	void UIEditBox::dimensions( const vec2& d )
 	{
@@ -25,9 +25,9 @@ namespace fr
 		
 		// Events
 		//
-		static const char* BEGIN_EDITING;
-		static const char* END_EDITING;
-		static const char* CHANGED;
+		static const Event::Type BEGIN_EDITING;
+		static const Event::Type END_EDITING;
+		static const Event::Type CHANGED;
 		
 		// Properties
 		//
@@ -12,8 +12,8 @@
 namespace fr
 {
 
-	const char* UIPopup::SHOWN = "Shown";
-	const char* UIPopup::HIDDEN = "Hidden";
+	const Event::Type UIPopup::SHOWN = "Shown";
+	const Event::Type UIPopup::HIDDEN = "Hidden";
 	
 	FRESH_DEFINE_CLASS( UIPopup )
 	DEFINE_VAR( UIPopup, DisplayObjectContainer::ptr, m_host );
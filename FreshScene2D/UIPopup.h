@@ -19,8 +19,8 @@ namespace fr
 		FRESH_DECLARE_CLASS( UIPopup, MovieClip )
 	public:
 
-		static const char* SHOWN;
-		static const char* HIDDEN;
+		static const Event::Type SHOWN;
+		static const Event::Type HIDDEN;
 
 		SYNTHESIZE_GET( DisplayObjectContainer::ptr, host );
 		SYNTHESIZE( bool, startHidden );
@@ -15,7 +15,7 @@ namespace fr
 	DEFINE_VAR( UIRadioButtons, size_t, m_creationSelection );
 	FRESH_IMPLEMENT_STANDARD_CONSTRUCTORS( UIRadioButtons )
 	
-	const char* UIRadioButtons::SELECTION_CHANGED = "Selection Changed";
+	const Event::Type UIRadioButtons::SELECTION_CHANGED = "Selection Changed";
 	
 	void UIRadioButtons::onAllLoaded()
 	{
@@ -18,7 +18,7 @@ namespace fr
 	{
 	public:
 		
-		static const char* SELECTION_CHANGED;
+		static const Event::Type SELECTION_CHANGED;
 		
 		size_t numChildButtons() const;
 		
@@ -44,6 +44,7 @@ namespace fr
         if( iter != m_spriteTileTemplates.end() )
         {
             iter->second->isSolid( solid );
+            m_tileGrid->navigationChanged();
         }
         else
         {
@@ -181,11 +181,11 @@ namespace luacpp
 
 namespace fr
 {
-	const char* FantasyConsole::COMMAND = "Command";
-	const char* FantasyConsole::MESSAGE = "Message";
-	const char* FantasyConsole::VIRTUAL_CONTROLS_SHOW = "VIRTUAL_CONTROLS_SHOW";
-	const char* FantasyConsole::VIRTUAL_CONTROLS_HIDE = "VIRTUAL_CONTROLS_HIDE";
-	const char* FantasyConsole::VIRTUAL_TRACKBALL_USED = "VIRTUAL_TRACKBALL_USED";
+	const Event::Type FantasyConsole::COMMAND = "Command";
+	const Event::Type FantasyConsole::MESSAGE = "Message";
+	const Event::Type FantasyConsole::VIRTUAL_CONTROLS_SHOW = "VIRTUAL_CONTROLS_SHOW";
+	const Event::Type FantasyConsole::VIRTUAL_CONTROLS_HIDE = "VIRTUAL_CONTROLS_HIDE";
+	const Event::Type FantasyConsole::VIRTUAL_TRACKBALL_USED = "VIRTUAL_TRACKBALL_USED";
 
 
 	FRESH_DEFINE_CLASS( FantasyConsole )
@@ -203,7 +203,8 @@ namespace fr
 	FantasyConsole::~FantasyConsole()
 	{
 		// This insanity is to resolve problems with essential self-deletion during destruction.
-		if( !Application::instance().terminating() )
+		// The default object outlives the application, so there may be no application to ask.
+		if( Application::doesExist() && !Application::instance().terminating() )
 		{
 			destroyLua();
 		}
@@ -1140,6 +1141,13 @@ namespace fr
 				console_trace( "Loading map, expected separator ',', but got '" << separator << "'. Ignoring." );
 			}
 		}
+
+        if( layer == 0 )
+        {
+            // The tiles changed in place.
+            //
+            m_tileGrid->navigationChanged();
+        }
 	}
 
     vec2i FantasyConsole::screenDims() const
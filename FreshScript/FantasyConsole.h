@@ -31,11 +31,11 @@ namespace fr
 		FRESH_DECLARE_CLASS( FantasyConsole, Sprite );
 	public:
 
-		static const char* COMMAND;
-		static const char* MESSAGE;
-		static const char* VIRTUAL_CONTROLS_SHOW;
-		static const char* VIRTUAL_CONTROLS_HIDE;
-		static const char* VIRTUAL_TRACKBALL_USED;
+		static const Event::Type COMMAND;
+		static const Event::Type MESSAGE;
+		static const Event::Type VIRTUAL_CONTROLS_SHOW;
+		static const Event::Type VIRTUAL_CONTROLS_HIDE;
+		static const Event::Type VIRTUAL_TRACKBALL_USED;
 
 		class ConsoleEvent : public Event
 		{
@@ -12,7 +12,7 @@ using namespace fr;
 int main( int argc, char* argv[] )
 {
 	ApplicationStaged app( "assets/config.fresh" );
-	int retVal = app.runMainLoop( argc, argv );
+	int retVal = app.runMainLoop( argc, const_cast< const char** >( argv ));
 	
     return retVal;
 }
@@ -7,14 +7,69 @@
 //
 
 #include "FreshManifest.h"
+#include "FreshTime.h"
 #include <iostream>
 #include <fstream>
 #include <cassert>
+#include <cstring>
 
 using namespace std;
 
+namespace
+{
+	// fr_test --compile <manifest.fresh> [<output.freshc>]
+	//
+	// Compiles a text manifest, loads the compiled file back, and verifies that the two are equivalent.
+	// Returns 0 on success, 3 if the round trip differs.
+	//
+	int compileAndVerify( const fr::path& sourcePath, fr::path compiledPath )
+	{
+		if( compiledPath.empty() )
+		{
+			compiledPath = fr::change_extension( sourcePath, fr::Manifest::COMPILED_EXTENSION );
+		}
+		
+		fr::Manifest source;
+		fr::Manifest compiled;
+		double textSeconds = 0, compiledSeconds = 0;
+		
+		try
+		{
+			auto start = fr::getAbsoluteTimeClocks();
+			source.load( sourcePath );
+			textSeconds = fr::clocksToSeconds( fr::getAbsoluteTimeClocks() - start );
+			
+			source.saveCompiled( compiledPath );
+			
+			start = fr::getAbsoluteTimeClocks();
+			compiled.loadCompiled( compiledPath );
+			compiledSeconds = fr::clocksToSeconds( fr::getAbsoluteTimeClocks() - start );
+		}
+		catch( const std::exception& e )
+		{
+			cerr << "Exception while compiling manifest: '" << e.what() << "'.\n";
+			return 2;
+		}
+		
+		if( source != compiled )
+		{
+			cerr << "Round trip of '" << sourcePath << "' through '" << compiledPath << "' did not reproduce the manifest.\n";
+			return 3;
+		}
+		
+		cout << "Compiled '" << sourcePath << "' to '" << compiledPath << "'. Round trip verified.\n"
+			 << "Text load: " << textSeconds * 1000.0 << " ms. Compiled load: " << compiledSeconds * 1000.0 << " ms.\n";
+		return 0;
+	}
+}
+
 int main(int argc, const char * argv[])
 {
+	if( argc > 2 && std::strcmp( argv[ 1 ], "--compile" ) == 0 )
+	{
+		return compileAndVerify( argv[ 2 ], argc > 3 ? argv[ 3 ] : "" );
+	}
+	
 	std::istream* in = &cin;
 	
 	std::ifstream file;
@@ -0,0 +1,193 @@
+//
+//  BenchAabbTree.cpp
+//  fresh_bench
+//
+
+#include "Benchmark.h"
+#include "FreshVector.h"
+#include "SpatialHash.h"
+#include "AabbTree.h"
+#include <random>
+
+using namespace fr;
+
+namespace
+{
+	struct Mover
+	{
+		vec2 min;
+		vec2 max;
+		vec2 velocity;
+	};
+
+	inline bool overlaps( const Mover& m, const vec2& min, const vec2& max )
+	{
+		return m.min.x <= max.x && min.x <= m.max.x && m.min.y <= max.y && min.y <= m.max.y;
+	}
+
+	// A large, sparse world: mostly actor-sized objects, with one in twenty the size of a building or a light's reach.
+	//
+	std::vector< Mover > scatter( size_t n, real worldSize )
+	{
+		std::mt19937 random{ 1 };
+		std::uniform_real_distribution< real > position( 0, worldSize );
+		std::uniform_real_distribution< real > smallSize( 8, 48 );
+		std::uniform_real_distribution< real > largeSize( 200, 1200 );
+		std::uniform_real_distribution< real > speed( -3, 3 );
+
+		std::vector< Mover > movers( n );
+		for( size_t i = 0; i < n; ++i )
+		{
+			auto& mover = movers[ i ];
+			const bool isLarge = i % 20 == 0;
+			mover.min.set( position( random ), position( random ));
+			mover.max = mover.min + ( isLarge ? vec2( largeSize( random ), largeSize( random )) : vec2( smallSize( random ), smallSize( random )));
+			mover.velocity.set( speed( random ), speed( random ));
+		}
+		return movers;
+	}
+
+	void step( std::vector< Mover >& movers )
+	{
+		for( auto& mover : movers )
+		{
+			mover.min += mover.velocity;
+			mover.max += mover.velocity;
+		}
+	}
+}
+
+FRESH_BENCHMARK( AabbTree )
+{
+	const real binSize = 64;
+	const real margin = 8;
+	const size_t nQueries = 100;
+
+	for( size_t n : { 1000, 10000, 50000 } )
+	{
+		const real worldSize = std::sqrt( real( n )) * 400;
+		auto movers = scatter( n, worldSize );
+
+		std::mt19937 random{ 2 };
+		std::uniform_real_distribution< real > position( 0, worldSize );
+		std::vector< vec2 > points( nQueries * 2 );
+		for( auto& point : points )
+		{
+			point.set( position( random ), position( random ));
+		}
+
+		// Keeping the structure current as everything moves.
+		//
+		SpatialHash< vec2, size_t > hash( n * 2, binSize );
+		reporter.measure( "SpatialHash step, clear+add", n, n, [&]()
+						 {
+							 step( movers );
+							 hash.clear();
+							 for( size_t i = 0; i < n; ++i )
+							 {
+								 hash.add( movers[ i ].min, movers[ i ].max, i );
+							 }
+						 } );
+
+		AabbTree< vec2, size_t > tree( margin );
+		std::vector< AabbTree< vec2, size_t >::Handle > handles( n );
+		for( size_t i = 0; i < n; ++i )
+		{
+			handles[ i ] = tree.add( movers[ i ].min, movers[ i ].max, i );
+		}
+
+		reporter.measure( "AabbTree step, move", n, n, [&]()
+						 {
+							 step( movers );
+							 for( size_t i = 0; i < n; ++i )
+							 {
+								 tree.move( handles[ i ], movers[ i ].min, movers[ i ].max, movers[ i ].velocity );
+							 }
+						 } );
+
+		// Screen-sized region queries, as for hit testing or culling.
+		//
+		reporter.measure( "SpatialHash::eachOverlapping (1024x640)", n, nQueries, [&]()
+						 {
+							 size_t nFound = 0;
+							 for( size_t i = 0; i < nQueries; ++i )
+							 {
+								 const vec2 min = points[ i ];
+								 const vec2 max = min + vec2( 1024, 640 );
+								 hash.eachOverlapping( min, max, [&]( size_t j )
+													  {
+														  nFound += overlaps( movers[ j ], min, max );
+													  } );
+							 }
+							 bench::keep( nFound );
+						 } );
+
+		reporter.measure( "AabbTree::eachOverlapping (1024x640)", n, nQueries, [&]()
+						 {
+							 size_t nFound = 0;
+							 for( size_t i = 0; i < nQueries; ++i )
+							 {
+								 tree.eachOverlapping( points[ i ], points[ i ] + vec2( 1024, 640 ), [&]( size_t )
+													  {
+														  ++nFound;
+													  } );
+							 }
+							 bench::keep( nFound );
+						 } );
+
+		// Line-of-sight rays a screen long, light lookups and nearest-actor queries.
+		//
+		reporter.measure( "AabbTree::eachOnRay (1024)", n, nQueries, [&]()
+						 {
+							 size_t nFound = 0;
+							 for( size_t i = 0; i < nQueries; ++i )
+							 {
+								 const auto& start = points[ i * 2 ];
+								 const vec2 direction = ( points[ i * 2 + 1 ] - start ).normal();
+								 tree.eachOnRay( start, start + direction * 1024, [&]( size_t, real )
+												{
+													++nFound;
+												} );
+							 }
+							 bench::keep( nFound );
+						 } );
+
+		reporter.measure( "AabbTree::firstOnRay (1024)", n, nQueries, [&]()
+						 {
+							 size_t nFound = 0;
+							 for( size_t i = 0; i < nQueries; ++i )
+							 {
+								 const auto& start = points[ i * 2 ];
+								 const vec2 direction = ( points[ i * 2 + 1 ] - start ).normal();
+								 nFound += tree.firstOnRay( start, start + direction * 1024 ) != tree.INVALID_HANDLE;
+							 }
+							 bench::keep( nFound );
+						 } );
+
+		reporter.measure( "AabbTree::eachWithinRadius (300)", n, nQueries, [&]()
+						 {
+							 size_t nFound = 0;
+							 for( size_t i = 0; i < nQueries; ++i )
+							 {
+								 tree.eachWithinRadius( points[ i ], 300, [&]( size_t )
+													   {
+														   ++nFound;
+													   } );
+							 }
+							 bench::keep( nFound );
+						 } );
+
+		reporter.measure( "AabbTree::eachNearest (k=8)", n, nQueries, [&]()
+						 {
+							 real total = 0;
+							 for( size_t i = 0; i < nQueries; ++i )
+							 {
+								 tree.eachNearest( points[ i ], 8, [&]( size_t, real distanceSquared )
+												  {
+													  total += distanceSquared;
+												  } );
+							 }
+							 bench::keep( total );
+						 } );
+	}
+}
@@ -0,0 +1,236 @@
+//
+//  BenchClassInfo.cpp
+//  fresh_bench
+//
+
+#include "Benchmark.h"
+#include "Objects.h"
+#include "Classes.h"
+#include "Property.h"
+#include "Package.h"
+#include <sstream>
+
+using namespace fr;
+
+namespace bench
+{
+	// A small native hierarchy with a realistic number of properties per level.
+	//
+	class BenchNativeBase : public Object
+	{
+		FRESH_DECLARE_CLASS( BenchNativeBase, Object );
+	public:
+	private:
+		DVAR( int, baseA, 0 ); DVAR( int, baseB, 0 ); DVAR( int, baseC, 0 ); DVAR( int, baseD, 0 );
+		DVAR( int, baseE, 0 ); DVAR( int, baseF, 0 ); DVAR( int, baseG, 0 ); DVAR( int, baseH, 0 );
+		DVAR( float, baseX, 0 ); DVAR( float, baseY, 0 ); DVAR( std::string, baseText, "" ); DVAR( bool, baseFlag, false );
+	};
+
+	class BenchNativeDerived : public BenchNativeBase
+	{
+		FRESH_DECLARE_CLASS( BenchNativeDerived, BenchNativeBase );
+	public:
+	private:
+		DVAR( int, derivedA, 0 ); DVAR( int, derivedB, 0 ); DVAR( int, derivedC, 0 ); DVAR( int, derivedD, 0 );
+		DVAR( int, derivedE, 0 ); DVAR( int, derivedF, 0 ); DVAR( int, derivedG, 0 ); DVAR( int, derivedH, 0 );
+		DVAR( float, derivedX, 0 ); DVAR( float, derivedY, 0 ); DVAR( std::string, derivedText, "" ); DVAR( bool, derivedFlag, false );
+	};
+
+	FRESH_DEFINE_CLASS( BenchNativeBase )
+	DEFINE_VAR( BenchNativeBase, int, baseA ); DEFINE_VAR( BenchNativeBase, int, baseB ); DEFINE_VAR( BenchNativeBase, int, baseC ); DEFINE_VAR( BenchNativeBase, int, baseD );
+	DEFINE_VAR( BenchNativeBase, int, baseE ); DEFINE_VAR( BenchNativeBase, int, baseF ); DEFINE_VAR( BenchNativeBase, int, baseG ); DEFINE_VAR( BenchNativeBase, int, baseH );
+	DEFINE_VAR( BenchNativeBase, float, baseX ); DEFINE_VAR( BenchNativeBase, float, baseY ); DEFINE_VAR( BenchNativeBase, std::string, baseText ); DEFINE_VAR( BenchNativeBase, bool, baseFlag );
+	FRESH_IMPLEMENT_STANDARD_CONSTRUCTORS( BenchNativeBase )
+
+	FRESH_DEFINE_CLASS( BenchNativeDerived )
+	DEFINE_VAR( BenchNativeDerived, int, derivedA ); DEFINE_VAR( BenchNativeDerived, int, derivedB ); DEFINE_VAR( BenchNativeDerived, int, derivedC ); DEFINE_VAR( BenchNativeDerived, int, derivedD );
+	DEFINE_VAR( BenchNativeDerived, int, derivedE ); DEFINE_VAR( BenchNativeDerived, int, derivedF ); DEFINE_VAR( BenchNativeDerived, int, derivedG ); DEFINE_VAR( BenchNativeDerived, int, derivedH );
+	DEFINE_VAR( BenchNativeDerived, float, derivedX ); DEFINE_VAR( BenchNativeDerived, float, derivedY ); DEFINE_VAR( BenchNativeDerived, std::string, derivedText ); DEFINE_VAR( BenchNativeDerived, bool, derivedFlag );
+	FRESH_IMPLEMENT_STANDARD_CONSTRUCTORS( BenchNativeDerived )
+
+	namespace
+	{
+		std::shared_ptr< Manifest::Value > stringValue( const std::string& s )
+		{
+			return std::make_shared< Manifest::Value >( s );
+		}
+
+		// Builds a chain of pseudoclasses on top of BenchNativeDerived, as a game manifest would,
+		// each level overriding a couple of properties. Returns the most derived class.
+		//
+		ClassInfo::ptr createPseudoclassChain( size_t depth )
+		{
+			std::string baseName = "BenchNativeDerived";
+			ClassInfo::ptr classInfo = nullptr;
+
+			for( size_t i = 0; i < depth; ++i )
+			{
+				std::ostringstream name;
+				name << "BenchPseudoclass" << i;
+
+				auto map = std::make_shared< Manifest::Map >();
+				( *map )[ "derivedA" ] = std::make_pair( stringValue( "1" ), Manifest::PropertyAttributes{} );
+				( *map )[ "baseB" ] = std::make_pair( stringValue( "2" ), Manifest::PropertyAttributes{} );
+
+				Manifest::Class directive( name.str(), { baseName }, std::move( map ));
+				classInfo = createClass( name.str(), baseName, directive );
+				baseName = name.str();
+			}
+
+			return classInfo;
+		}
+
+		// A pseudoclass like a game's spawnable enemy: one level configuring most of the native properties,
+		// a second level overriding a few.
+		//
+		ClassInfo::ptr createSpawnablePseudoclass()
+		{
+			auto map = std::make_shared< Manifest::Map >();
+			const std::vector< std::pair< const char*, const char* >> configuration = {
+				{ "baseA", "12" }, { "baseB", "-4" }, { "baseC", "1000" }, { "baseD", "7" },
+				{ "baseX", "3.75" }, { "baseY", "-0.125" }, { "baseText", "Goblin" }, { "baseFlag", "true" },
+				{ "derivedA", "5" }, { "derivedB", "6" }, { "derivedX", "0.5" }, { "derivedY", "1e-3" },
+				{ "derivedText", "\"Carries a club\"" }, { "derivedFlag", "false" } };
+			for( const auto& pair : configuration )
+			{
+				( *map )[ pair.first ] = std::make_pair( stringValue( pair.second ), Manifest::PropertyAttributes{} );
+			}
+			Manifest::Class directive( "BenchSpawnableBase", { "BenchNativeDerived" }, std::move( map ));
+			createClass( "BenchSpawnableBase", "BenchNativeDerived", directive );
+
+			auto overrides = std::make_shared< Manifest::Map >();
+			( *overrides )[ "baseA" ] = std::make_pair( stringValue( "20" ), Manifest::PropertyAttributes{} );
+			( *overrides )[ "baseText" ] = std::make_pair( stringValue( "Goblin Chief" ), Manifest::PropertyAttributes{} );
+			Manifest::Class derivedDirective( "BenchSpawnable", { "BenchSpawnableBase" }, std::move( overrides ));
+			return createClass( "BenchSpawnable", "BenchSpawnableBase", derivedDirective );
+		}
+
+		// Per-instance values of every type the classes declare, each valid for its property, and each as
+		// getPropertyValue() prints it back.
+		//
+		struct PropertyValue
+		{
+			const char* name;
+			const char* text;
+			const char* printed;
+		};
+		
+		const std::vector< PropertyValue >& objectPropertyValues()
+		{
+			static const std::vector< PropertyValue > values = {
+				{ "baseA", "1", "1" }, { "baseC", "-2", "-2" }, { "baseE", "30", "30" }, { "baseG", "4", "4" },
+				{ "baseX", "0.5", "0.5" }, { "baseText", "Orc", "\"Orc\"" }, { "baseFlag", "true", "true" },
+				{ "derivedB", "6", "6" }, { "derivedD", "7", "7" }, { "derivedF", "-8", "-8" }, { "derivedH", "9", "9" },
+				{ "derivedY", "2.25", "2.25" }, { "derivedText", "Carries a spear", "\"Carries a spear\"" } };
+			return values;
+		}
+		
+		Manifest::Map objectProperties()
+		{
+			Manifest::Map properties;
+			for( const auto& value : objectPropertyValues() )
+			{
+				properties[ value.name ] = std::make_pair( stringValue( value.text ), Manifest::PropertyAttributes{} );
+			}
+			return properties;
+		}
+	}
+}
+
+FRESH_BENCHMARK( ClassInfo )
+{
+	const size_t depth = 8;
+	ClassInfo::ptr pseudoclass = bench::createPseudoclassChain( depth );
+
+	const std::vector< std::string > names = { "baseA", "BaseH", "baseText", "derivedA", "derivedFlag", "passthrough", "name" };
+	const size_t nOps = 100000;
+
+	reporter.measure( "ClassInfo::getPropertyByName", depth, nOps, [&]()
+					 {
+						 for( size_t i = 0; i < nOps; ++i )
+						 {
+							 bench::keep( pseudoclass->getPropertyByName( names[ i % names.size() ] ));
+						 }
+					 } );
+
+	// isKindOf() against near and far ancestors, and against an unrelated class.
+	//
+	const std::vector< const ClassInfo* > possibleBases = { getClass( "BenchPseudoclass6" ), &bench::BenchNativeBase::StaticGetClassInfo(), &Object::StaticGetClassInfo(), &Package::StaticGetClassInfo() };
+	
+	reporter.measure( "ClassInfo::isKindOf", depth, nOps, [&]()
+					 {
+						 for( size_t i = 0; i < nOps; ++i )
+						 {
+							 bench::keep( pseudoclass->isKindOf( *possibleBases[ i % possibleBases.size() ] ));
+						 }
+					 } );
+	
+	reporter.measure( "ClassInfo::getSuperClassDepth", depth, nOps, [&]()
+					 {
+						 for( size_t i = 0; i < nOps; ++i )
+						 {
+							 bench::keep( pseudoclass->getSuperClassDepth( *possibleBases[ i % possibleBases.size() ] ));
+						 }
+					 } );
+
+	const auto properties = bench::objectProperties();
+	auto object = createObject< Object >( *pseudoclass );
+	const size_t nLoads = 10000;
+
+	reporter.measure( "Object::load (13 properties)", depth, nLoads, [&]()
+					 {
+						 for( size_t i = 0; i < nLoads; ++i )
+						 {
+							 object->load( properties );
+						 }
+					 } );
+	
+	for( const auto& value : bench::objectPropertyValues() )
+	{
+		FRESH_BENCH_CHECK( object->getPropertyValue( value.name ) == value.printed );
+	}
+}
+
+FRESH_BENCHMARK( Pseudoclass )
+{
+	ClassInfo::ptr spawnable = bench::createSpawnablePseudoclass();
+
+	const size_t nInstances = 10000;
+	std::vector< Object::ptr > instances;
+	instances.reserve( nInstances );
+
+	reporter.measure( "createObject (pseudoclass, 16 configured properties)", 2, nInstances, [&]()
+					 {
+						 instances.clear();
+						 for( size_t i = 0; i < nInstances; ++i )
+						 {
+							 instances.push_back( createObject< Object >( *spawnable ));
+						 }
+					 } );
+
+	// Per-instance properties overlap the configuration, so configurations must be pared.
+	//
+	Manifest::Map placement;
+	placement[ "baseX" ] = std::make_pair( bench::stringValue( "100.5" ), Manifest::PropertyAttributes{} );
+	placement[ "baseY" ] = std::make_pair( bench::stringValue( "-20" ), Manifest::PropertyAttributes{} );
+
+	reporter.measure( "createObject (pseudoclass, with placement)", 2, nInstances, [&]()
+					 {
+						 instances.clear();
+						 for( size_t i = 0; i < nInstances; ++i )
+						 {
+							 instances.push_back( createObject< Object >( *spawnable, DEFAULT_OBJECT_NAME, &placement ));
+						 }
+					 } );
+
+	auto original = createObject< Object >( *spawnable, DEFAULT_OBJECT_NAME, &placement );
+	reporter.measure( "Object::createClone", 2, nInstances, [&]()
+					 {
+						 instances.clear();
+						 for( size_t i = 0; i < nInstances; ++i )
+						 {
+							 instances.push_back( original->createClone() );
+						 }
+					 } );
+	instances.clear();
+}
@@ -0,0 +1,222 @@
+//
+//  BenchDispatch.cpp
+//  fresh_bench
+//
+
+#include "Benchmark.h"
+#include "Dispatch.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace fr;
+
+namespace bench
+{
+	namespace
+	{
+		// Counts finished blocks and lets the benchmark wait for all of them, whatever queue runs them.
+		//
+		class Countdown
+		{
+		public:
+
+			void reset( size_t n )
+			{
+				m_remaining = n;
+			}
+
+			void finishOne()
+			{
+				if( --m_remaining == 0 )
+				{
+					std::lock_guard< std::mutex > lock{ m_mutex };
+					m_done.notify_all();
+				}
+			}
+
+			void wait()
+			{
+				std::unique_lock< std::mutex > lock{ m_mutex };
+				m_done.wait( lock, [this]() { return m_remaining == 0; } );
+			}
+
+		private:
+
+			std::atomic< size_t > m_remaining{ 0 };
+			std::mutex m_mutex;
+			std::condition_variable m_done;
+		};
+
+		// Busy work standing in for decoding or parsing, roughly proportional to n.
+		//
+		unsigned int spin( size_t n )
+		{
+			unsigned int x = 1;
+			for( size_t i = 0; i < n; ++i )
+			{
+				x = x * 1664525u + 1013904223u;
+			}
+			return x;
+		}
+
+		// Many small blocks with a few long ones mixed in, as when loading a level's sounds alongside its small assets.
+		//
+		template< typename QueueT >
+		void submitMixedWork( QueueT& queue, Countdown& countdown, size_t nSmall, size_t nLong )
+		{
+			countdown.reset( nSmall + nLong );
+			for( size_t i = 0; i < nSmall + nLong; ++i )
+			{
+				const size_t work = ( i % ( nSmall / nLong + 1 ) == 0 ) ? 2000000 : 2000;
+				queue.async( std::make_shared< dispatch::Block >( [&countdown, work]()
+																 {
+																	 keep( spin( work ));
+																	 countdown.finishOne();
+																 } ));
+			}
+		}
+	}
+}
+
+FRESH_BENCHMARK( Dispatch )
+{
+	std::cout << "(" << dispatch::ConcurrentQueue::numWorkers() << " workers)" << std::endl;
+
+	const size_t nSmall = 10000;
+	const size_t nLong = 8;
+	bench::Countdown countdown;
+
+	dispatch::Queue serialQueue{ "bench_serial_queue" };
+	serialQueue.run();
+
+	reporter.measure( "Queue (serial), mixed blocks", nSmall + nLong, nSmall + nLong, [&]()
+					 {
+						 bench::submitMixedWork( serialQueue, countdown, nSmall, nLong );
+						 countdown.wait();
+					 } );
+
+	serialQueue.stop();
+
+	dispatch::ConcurrentQueue concurrentQueue{ "bench_concurrent_queue" };
+
+	reporter.measure( "ConcurrentQueue, mixed blocks", nSmall + nLong, nSmall + nLong, [&]()
+					 {
+						 bench::submitMixedWork( concurrentQueue, countdown, nSmall, nLong );
+						 concurrentQueue.wait();
+					 } );
+
+	// The same work on pools of 1, 2, 4 and one-per-hardware-thread workers, to show how it scales.
+	//
+	std::vector< size_t > workerCounts{ 1, 2, 4 };
+	const size_t nHardwareThreads = std::max< size_t >( 1, std::thread::hardware_concurrency() );
+	if( std::find( workerCounts.begin(), workerCounts.end(), nHardwareThreads ) == workerCounts.end() )
+	{
+		workerCounts.push_back( nHardwareThreads );
+	}
+
+	double oneWorkerNsPerOp = 0;
+	for( const size_t nWorkers : workerCounts )
+	{
+		dispatch::ConcurrentQueue scalingQueue{ "bench_scaling_queue", dispatch::QoS::Utility, nWorkers };
+		const std::string workers = std::to_string( nWorkers ) + ( nWorkers == 1 ? " worker" : " workers" );
+
+		reporter.measure( "ConcurrentQueue (" + workers + "), mixed blocks", nSmall + nLong, nSmall + nLong, [&]()
+						 {
+							 bench::submitMixedWork( scalingQueue, countdown, nSmall, nLong );
+							 scalingQueue.wait();
+						 } );
+
+		const double nsPerOp = reporter.results().back().nsPerOp;
+		if( nWorkers == 1 )
+		{
+			oneWorkerNsPerOp = nsPerOp;
+		}
+		std::cout << "(" << workers << ": " << oneWorkerNsPerOp / nsPerOp << "x the speed of 1, on " << nHardwareThreads << " hardware threads)" << std::endl;
+	}
+
+	// Blocks that fan out into more blocks, which stay on the submitting worker unless stolen.
+	//
+	const size_t nParents = 100;
+	const size_t nChildren = 100;
+
+	reporter.measure( "ConcurrentQueue, nested blocks", nParents * nChildren, nParents * nChildren, [&]()
+					 {
+						 for( size_t i = 0; i < nParents; ++i )
+						 {
+							 concurrentQueue.async( std::make_shared< dispatch::Block >( [&]()
+																						{
+																							for( size_t j = 0; j < nChildren; ++j )
+																							{
+																								concurrentQueue.async( std::make_shared< dispatch::Block >( []() { bench::keep( bench::spin( 2000 )); } ));
+																							}
+																						} ));
+						 }
+						 concurrentQueue.wait();
+					 } );
+
+	// Background threads posting completions to a polled queue, as loaders do to the main queue.
+	//
+	const size_t nProducers = 4;
+	const size_t nPostsPerProducer = 20000;
+	dispatch::Queue polledQueue{ "bench_polled_queue" };
+
+	reporter.measure( "Queue, posts from 4 threads while polling", nProducers * nPostsPerProducer, nProducers * nPostsPerProducer, [&]()
+					 {
+						 std::atomic< size_t > nRun{ 0 };
+						 std::vector< std::thread > producers;
+						 for( size_t i = 0; i < nProducers; ++i )
+						 {
+							 producers.emplace_back( [&]()
+													{
+														for( size_t j = 0; j < nPostsPerProducer; ++j )
+														{
+															polledQueue.async( std::make_shared< dispatch::Block >( [&nRun]() { ++nRun; } ));
+														}
+													} );
+						 }
+
+						 while( nRun < nProducers * nPostsPerProducer )
+						 {
+							 polledQueue.poll();
+						 }
+
+						 for( auto& producer : producers )
+						 {
+							 producer.join();
+						 }
+					 } );
+
+	const auto stats = polledQueue.stats();
+	std::cout << "(" << stats.nExecuted << " run, peak depth " << stats.peakDepth
+			  << ", latency mean " << std::chrono::duration_cast< std::chrono::microseconds >( stats.meanLatency ).count() << "us"
+			  << " max " << std::chrono::duration_cast< std::chrono::microseconds >( stats.maxLatency ).count() << "us)" << std::endl;
+
+	// A burst of slow completions against a per-poll budget: the worst poll is what a frame would feel.
+	//
+	const size_t nBurst = 200;
+	polledQueue.pollBudget( std::chrono::milliseconds{ 4 } );
+
+	for( size_t i = 0; i < nBurst; ++i )
+	{
+		polledQueue.async( std::make_shared< dispatch::Block >( []() { bench::keep( bench::spin( 200000 )); } ));
+	}
+
+	dispatch::Duration worstPoll{};
+	size_t nPolls = 0;
+	while( polledQueue.stats().depth > 0 )
+	{
+		const auto start = dispatch::Clock::now();
+		polledQueue.poll();
+		worstPoll = std::max( worstPoll, dispatch::Clock::now() - start );
+		++nPolls;
+	}
+
+	std::cout << "(burst of " << nBurst << " blocks with a 4ms budget: " << nPolls << " polls, worst "
+			  << std::chrono::duration_cast< std::chrono::microseconds >( worstPoll ).count() << "us)" << std::endl;
+}
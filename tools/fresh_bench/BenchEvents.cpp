@@ -0,0 +1,95 @@
+//
+//  BenchEvents.cpp
+//  fresh_bench
+//
+
+#include "Benchmark.h"
+#include "EventDispatcher.h"
+#include "Objects.h"
+
+using namespace fr;
+
+namespace bench
+{
+	class BenchListener : public Object
+	{
+		FRESH_DECLARE_CLASS( BenchListener, Object );
+	public:
+
+		size_t nHeard() const		{ return m_nHeard; }
+
+		FRESH_DECLARE_CALLBACK( BenchListener, onPing, Event );
+
+	private:
+		size_t m_nHeard = 0;
+	};
+
+	FRESH_DEFINE_CLASS( BenchListener )
+	FRESH_IMPLEMENT_STANDARD_CONSTRUCTORS( BenchListener )
+
+	FRESH_DEFINE_CALLBACK( BenchListener, onPing, Event )
+	{
+		++m_nHeard;
+	}
+}
+
+FRESH_BENCHMARK( EventDispatcher )
+{
+	const Event::Type PING( "ping" );
+	const Event::Type OTHER( "other" );
+
+	for( size_t nListeners : { 1, 8, 64 } )
+	{
+		auto dispatcher = createObject< EventDispatcher >();
+
+		// As many listeners again listen for another event type, which dispatch must pass over.
+		//
+		std::vector< SmartPtr< bench::BenchListener >> listeners;
+		for( size_t i = 0; i < nListeners; ++i )
+		{
+			listeners.push_back( createObject< bench::BenchListener >() );
+			dispatcher->addEventListener( PING, listeners.back()->FRESH_CALLBACK( onPing ));
+
+			listeners.push_back( createObject< bench::BenchListener >() );
+			dispatcher->addEventListener( OTHER, listeners.back()->FRESH_CALLBACK( onPing ));
+		}
+
+		const Event ping( PING, dispatcher );
+		const size_t nDispatches = 10000;
+
+		reporter.measure( "dispatchEvent (weak listeners)", nListeners, nDispatches, [&]()
+						 {
+							 for( size_t i = 0; i < nDispatches; ++i )
+							 {
+								 dispatcher->dispatchEvent( &ping );
+							 }
+						 } );
+
+		dispatcher->clearEventListeners();
+		for( size_t i = 0; i < listeners.size(); ++i )
+		{
+			dispatcher->addEventListener( i % 2 ? OTHER : PING, listeners[ i ]->FRESH_CALLBACK( onPing ), true /* strong */ );
+		}
+
+		reporter.measure( "dispatchEvent (strong listeners)", nListeners, nDispatches, [&]()
+						 {
+							 for( size_t i = 0; i < nDispatches; ++i )
+							 {
+								 dispatcher->dispatchEvent( &ping );
+							 }
+						 } );
+
+		dispatcher->clearEventListeners();
+		reporter.measure( "addEventListener + removeEventListener", nListeners, listeners.size(), [&]()
+						 {
+							 for( const auto& listener : listeners )
+							 {
+								 dispatcher->addEventListener( PING, listener->FRESH_CALLBACK( onPing ));
+							 }
+							 for( const auto& listener : listeners )
+							 {
+								 dispatcher->removeEventListener( PING, listener->FRESH_CALLBACK( onPing ));
+							 }
+						 } );
+	}
+}
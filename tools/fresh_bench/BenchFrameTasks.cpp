@@ -0,0 +1,86 @@
+//
+//  BenchFrameTasks.cpp
+//  fresh_bench
+//
+
+#include "Benchmark.h"
+#include "FrameTasks.h"
+#include <iostream>
+#include <vector>
+
+using namespace fr;
+
+namespace bench
+{
+	namespace
+	{
+		// Stands in for one emitter's particle step: independent of every other job.
+		//
+		void stepParticles( std::vector< float >& particles )
+		{
+			for( auto& x : particles )
+			{
+				for( int i = 0; i < 8; ++i )
+				{
+					x = x * 0.999f + 0.5f;
+				}
+			}
+		}
+	}
+}
+
+FRESH_BENCHMARK( FrameTasks )
+{
+	std::cout << "(" << numParallelThreads() << " threads)" << std::endl;
+
+	// A frame's worth of independent jobs, each the size of a modest particle emitter.
+	//
+	const size_t nEmitters = 64;
+	std::vector< std::vector< float >> emitters( nEmitters, std::vector< float >( 2000, 1.0f ));
+
+	reporter.measure( "serial update", nEmitters, 200, [&]()
+					 {
+						 for( size_t frame = 0; frame < 200; ++frame )
+						 {
+							 for( auto& emitter : emitters )
+							 {
+								 bench::stepParticles( emitter );
+							 }
+						 }
+					 } );
+
+	FrameTasks tasks;
+
+	reporter.measure( "FrameTasks, independent jobs", nEmitters, 200, [&]()
+					 {
+						 for( size_t frame = 0; frame < 200; ++frame )
+						 {
+							 for( auto& emitter : emitters )
+							 {
+								 tasks.add( "emitter", [&emitter]() { bench::stepParticles( emitter ); } );
+							 }
+							 tasks.run();
+						 }
+					 } );
+
+	bench::keep( emitters.front().front() );
+
+	// The scheduling cost alone: empty jobs in a diamond per group, so each has dependencies to resolve.
+	//
+	const size_t nGroups = 64;
+
+	reporter.measure( "FrameTasks, empty diamond jobs", nGroups * 4, 1000, [&]()
+					 {
+						 for( size_t frame = 0; frame < 1000; ++frame )
+						 {
+							 for( size_t group = 0; group < nGroups; ++group )
+							 {
+								 const auto top = tasks.add( "top", []() {} );
+								 const auto left = tasks.add( "left", []() {}, { top } );
+								 const auto right = tasks.add( "right", []() {}, { top } );
+								 tasks.add( "bottom", []() {}, { left, right } );
+							 }
+							 tasks.run();
+						 }
+					 } );
+}
@@ -0,0 +1,160 @@
+//
+//  BenchJumpPointSearch.cpp
+//  fresh_bench
+//
+
+#include "Benchmark.h"
+#include "JumpPointSearch.h"
+#include <random>
+#include <cstdlib>
+
+using namespace fr;
+
+namespace
+{
+	// A large, mostly open map: scattered blocks a few cells across, covering about a tenth of it.
+	//
+	std::vector< bool > scatterBlocks( int size )
+	{
+		std::vector< bool > open( size_t( size * size ), true );
+
+		std::mt19937 random{ 1 };
+		std::uniform_int_distribution< int > position( 0, size - 1 );
+		std::uniform_int_distribution< int > extent( 1, 6 );
+
+		for( int i = 0, nBlocks = size * size / 120; i < nBlocks; ++i )
+		{
+			const int left = position( random );
+			const int top = position( random );
+			const int width = extent( random );
+			const int height = extent( random );
+			for( int y = top; y < std::min( top + height, size ); ++y )
+			{
+				for( int x = left; x < std::min( left + width, size ); ++x )
+				{
+					open[ y * size + x ] = false;
+				}
+			}
+		}
+
+		// Keep the corners clear for the queries.
+		//
+		open.front() = open.back() = true;
+		open[ size - 1 ] = open[ ( size - 1 ) * size ] = true;
+		return open;
+	}
+
+	struct Query
+	{
+		Vector2i start;
+		Vector2i goal;
+	};
+
+	std::vector< Query > queries( int size )
+	{
+		return {
+			{ Vector2i( 0, 0 ), Vector2i( size - 1, size - 1 ) },
+			{ Vector2i( size - 1, 0 ), Vector2i( 0, size - 1 ) },
+		};
+	}
+
+	size_t findWithAStar( const std::vector< bool >& open, int size, const Query& query, PathFinderScratch< int, float >& scratch )
+	{
+		auto pathFinder = makeHeapPathFinder< 4 >( scratch,
+												  query.start.y * size + query.start.x,
+												  query.goal.y * size + query.goal.x,
+												  -1,
+												  [&]( int a, int b ) { return float( std::abs( a % size - b % size ) + std::abs( a / size - b / size )); },
+												  [&]( int node, int* outNeighbors )
+												  {
+													  const int x = node % size;
+													  const int y = node / size;
+													  size_t nNeighbors = 0;
+													  const auto consider = [&]( int nx, int ny )
+													  {
+														  if( 0 <= nx && nx < size && 0 <= ny && ny < size && open[ ny * size + nx ] )
+														  {
+															  outNeighbors[ nNeighbors++ ] = ny * size + nx;
+														  }
+													  };
+													  consider( x + 1, y );
+													  consider( x - 1, y );
+													  consider( x, y + 1 );
+													  consider( x, y - 1 );
+													  return nNeighbors;
+												  },
+												  []( int, int ) { return 1.0f; },
+												  []() { return 0; },
+												  []( int node ) { return size_t( node ); } );
+
+		bool ranOutOfTime = false;
+		return pathFinder.findPath( ranOutOfTime ) ? pathFinder.path().size() : 0;
+	}
+}
+
+FRESH_BENCHMARK( JumpPointSearch )
+{
+	PathFinderScratch< int, float > scratch;
+
+	for( int size : { 256, 512, 1024 } )
+	{
+		const auto open = scatterBlocks( size );
+		const auto corners = queries( size );
+
+		JumpPointGrid grid;
+		grid.reset( Vector2i( size, size ));
+		for( int y = 0; y < size; ++y )
+		{
+			for( int x = 0; x < size; ++x )
+			{
+				grid.isOpen( Vector2i( x, y ), open[ y * size + x ] );
+			}
+		}
+
+		JumpPointGrid::Path path;
+
+		reporter.measure( "HeapPathFinder A* corner to corner", size, corners.size(), [&]()
+						 {
+							 size_t length = 0;
+							 for( const auto& query : corners )
+							 {
+								 length += findWithAStar( open, size, query, scratch );
+							 }
+							 bench::keep( length );
+						 } );
+
+		reporter.measure( "JumpPointGrid JPS corner to corner", size, corners.size(), [&]()
+						 {
+							 size_t length = 0;
+							 for( const auto& query : corners )
+							 {
+								 grid.findPath( query.start, query.goal, path );
+								 length += path.size();
+							 }
+							 bench::keep( length );
+						 } );
+
+		reporter.measure( "JumpPointGrid::buildJumpTable", size, 1, [&]()
+						 {
+							 grid.buildJumpTable();
+							 bench::keep( grid.hasJumpTable() );
+						 } );
+
+		reporter.measure( "JumpPointGrid JPS+ corner to corner", size, corners.size(), [&]()
+						 {
+							 size_t length = 0;
+							 for( const auto& query : corners )
+							 {
+								 grid.findPath( query.start, query.goal, path );
+								 length += path.size();
+							 }
+							 bench::keep( length );
+						 } );
+
+		for( const auto& query : corners )
+		{
+			grid.findPath( query.start, query.goal, path );
+			FRESH_BENCH_CHECK( path.size() == findWithAStar( open, size, query, scratch ));
+		}
+	}
+}
@@ -0,0 +1,186 @@
+//
+//  BenchManifest.cpp
+//  fresh_bench
+//
+
+#include "Benchmark.h"
+#include "FreshManifest.h"
+#include "ManifestDocument.h"
+#include "FreshFile.h"
+#include "Objects.h"
+#include "Classes.h"
+#include "Package.h"
+#include <fstream>
+#include <iostream>
+
+using namespace fr;
+
+namespace
+{
+	// Writes a manifest shaped like a game's asset and stage packages: constants, pseudoclasses, and objects with
+	// nested maps, arrays and inline objects.
+	//
+	void writeSceneManifest( std::ostream& out, size_t nObjects )
+	{
+		for( size_t i = 0; i < 50; ++i )
+		{
+			out << "const float benchConst" << i << " \"" << i * 0.5 << "\"\n";
+		}
+		for( size_t i = 0; i < 50; ++i )
+		{
+			out << "class BenchSceneClass" << i << " extends MovieClip {\n\tscale \"" << i << "\"\n\tcolor \"Red\"\n}\n";
+		}
+		for( size_t i = 0; i < nObjects; ++i )
+		{
+			out << "object MovieClip sceneObject" << i << " {\n"
+				<< "\tposition \"" << i << "," << i * 2 << "\"\n"
+				<< "\tscale \"1.5\"\n"
+				<< "\trotation \"" << ( i % 360 ) << "\"\n"
+				<< "\tcolor \"White\"\n"
+				<< "\tchildren [\n"
+				<< "\t\tobject Sprite {\n\t\t\ttexture \"Texture'tex" << ( i % 40 ) << "'\"\n\t\t}\n"
+				<< "\t\tobject TextField {\n\t\t\ttext \"Label " << i << "\"\n\t\t\tfont \"Font'body'\"\n\t\t}\n"
+				<< "\t]\n"
+				<< "\tpassthrough [\n"
+				<< "\t\tobject keyframe {\n\t\t\trel_s \"1.0\"\n"
+				<< "\t\t\tchildren [\n\t\t\t\tobject child \"$1\" {\n\t\t\t\t\trotation \"359\"\n\t\t\t\t}\n\t\t\t]\n"
+				<< "\t\t\ttween object Linear {\n\t\t\t}\n\t\t}\n"
+				<< "\t]\n"
+				<< "}\n";
+		}
+	}
+
+	// Objects of a real (bench) class, so that the package can actually instantiate them.
+	//
+	void writePackageManifest( std::ostream& out, size_t nObjects )
+	{
+		for( size_t i = 0; i < nObjects; ++i )
+		{
+			out << "object BenchNativeDerived benchObject" << i << " {\n"
+				<< "\tbaseA \"" << i << "\"\n\tbaseX \"2.5\"\n\tbaseText \"Object number " << i << "\"\n"
+				<< "\tderivedB \"7\"\n\tderivedY \"3.25\"\n\tderivedFlag \"true\"\n"
+				<< "}\n";
+		}
+	}
+
+	// Writes the text manifest and its compiled form. The compiled file gets a different name so that
+	// Package::loadFile() of the text file really loads the text.
+	//
+	template< typename WriterT >
+	std::pair< path, path > writeManifestPair( const std::string& name, size_t nObjects, WriterT&& writer )
+	{
+		const path textPath = getTempDirectoryPath() / ( name + ".fresh" );
+		const path compiledPath = getTempDirectoryPath() / ( name + "_compiled" + Manifest::COMPILED_EXTENSION );
+		{
+			std::ofstream out( textPath.c_str() );
+			writer( out, nObjects );
+		}
+
+		Manifest manifest;
+		manifest.load( textPath );
+		manifest.saveCompiled( compiledPath );
+		return std::make_pair( textPath, compiledPath );
+	}
+}
+
+FRESH_BENCHMARK( Manifest )
+{
+	for( size_t n : { 100, 1000 } )
+	{
+		path textPath, compiledPath;
+		std::tie( textPath, compiledPath ) = writeManifestPair( "fresh_bench_scene", n, writeSceneManifest );
+
+		reporter.measure( "Manifest::load (text)", n, 1, [&]()
+						 {
+							 Manifest manifest;
+							 manifest.load( textPath );
+						 } );
+
+		reporter.measure( "Manifest::loadCompiled", n, 1, [&]()
+						 {
+							 Manifest manifest;
+							 manifest.loadCompiled( compiledPath );
+						 } );
+
+		// Build and teardown both count: teardown of the shared_ptr DOM is a free per node.
+		//
+		reporter.measure( "ManifestDocument (compiled)", n, 1, [&]()
+						 {
+							 ManifestDocument document( compiledPath );
+							 bench::keep( document.size() );
+						 } );
+
+		const ManifestDocument document( compiledPath );
+		std::cout << "    document arena: " << document.arena().bytesAllocated() << " bytes in " << document.arena().numBlocks() << " block(s)\n";
+	}
+
+	// Loading an object's properties from each kind of map.
+	//
+	{
+		path textPath, compiledPath;
+		std::tie( textPath, compiledPath ) = writeManifestPair( "fresh_bench_package_small", 1, writePackageManifest );
+
+		Manifest manifest;
+		manifest.loadCompiled( compiledPath );
+		const ManifestDocument document( compiledPath );
+
+		const Manifest::Map* manifestMapPointer = nullptr;
+		manifest.eachDirective( [&]( const Manifest::Directive& directive )
+							   {
+								   manifestMapPointer = directive.as< Manifest::Object >()->map.get();
+							   } );
+		const auto& manifestMap = *manifestMapPointer;
+		const auto& documentMap = *document.begin()->map;
+
+		auto object = createObject< Object >( *getClass( "BenchNativeDerived" ));
+
+		// Loading one map again and again favors Manifest::Map, whose nodes remember the values parsed from them on the
+		// first load. A document's maps are loaded once each, by Package::loadFile(), and parse every time.
+		//
+		const size_t nLoads = 1000;
+		reporter.measure( "Object::load (Manifest::Map)", manifestMap.size(), nLoads, [&]()
+						 {
+							 for( size_t i = 0; i < nLoads; ++i )
+							 {
+								 object->load( manifestMap );
+							 }
+						 } );
+		reporter.measure( "Object::load (ManifestDocument::Map)", documentMap.size(), nLoads, [&]()
+						 {
+							 for( size_t i = 0; i < nLoads; ++i )
+							 {
+								 object->load( documentMap );
+							 }
+						 } );
+	}
+
+	// Startup: a whole package, from file to live objects.
+	//
+	for( size_t n : { 1000 } )
+	{
+		path textPath, compiledPath;
+		std::tie( textPath, compiledPath ) = writeManifestPair( "fresh_bench_package", n, writePackageManifest );
+
+		reporter.measure( "Package::loadFile (text)", n, 1, [&]()
+						 {
+							 auto package = createPackage();
+							 package->loadFile( textPath );
+						 } );
+
+		// What loadFile() did for compiled files before it loaded them through a ManifestDocument.
+		//
+		reporter.measure( "Package::loadFromManifest (compiled)", n, 1, [&]()
+						 {
+							 Manifest manifest;
+							 manifest.loadCompiled( compiledPath );
+							 auto package = createPackage();
+							 package->loadFromManifest( manifest );
+						 } );
+
+		reporter.measure( "Package::loadFile (compiled)", n, 1, [&]()
+						 {
+							 auto package = createPackage();
+							 package->loadFile( compiledPath );
+						 } );
+	}
+}
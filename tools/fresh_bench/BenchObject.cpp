@@ -0,0 +1,186 @@
+//
+//  BenchObject.cpp
+//  fresh_bench
+//
+
+#include "Benchmark.h"
+#include "Objects.h"
+#include "Classes.h"
+#include "Property.h"
+#include "ObjectPool.h"
+
+using namespace fr;
+
+namespace bench
+{
+	// Stands in for FreshTileGrid's Tile: a small object created by the thousand and rarely referenced weakly.
+	//
+	class BenchTile : public Object
+	{
+		FRESH_DECLARE_CLASS( BenchTile, Object );
+	public:
+	private:
+		DVAR( int, material, 0 ); DVAR( bool, isSolid, false ); DVAR( float, friction, 1.0f );
+	};
+
+	FRESH_DEFINE_CLASS( BenchTile )
+	DEFINE_VAR( BenchTile, int, material ); DEFINE_VAR( BenchTile, bool, isSolid ); DEFINE_VAR( BenchTile, float, friction );
+	FRESH_IMPLEMENT_STANDARD_CONSTRUCTORS( BenchTile )
+
+	// Tiles allocated from the general heap and from an ObjectPool. Their class names are the same length
+	// so that their default object names cost the same.
+	//
+	class BenchHeapTile : public BenchTile
+	{
+		FRESH_DECLARE_CLASS( BenchHeapTile, BenchTile );
+	};
+
+	class BenchPoolTile : public BenchTile
+	{
+		FRESH_DECLARE_CLASS( BenchPoolTile, BenchTile );
+	};
+
+	FRESH_DEFINE_CLASS( BenchHeapTile )
+	FRESH_IMPLEMENT_STANDARD_CONSTRUCTORS( BenchHeapTile )
+
+	FRESH_DEFINE_CLASS( BenchPoolTile )
+	FRESH_POOL_CLASS_OBJECTS( BenchPoolTile )
+	FRESH_IMPLEMENT_STANDARD_CONSTRUCTORS( BenchPoolTile )
+
+	// Stands in for a DisplayObjectContainer tree: children are held strongly, parents weakly.
+	//
+	class BenchNode : public Object
+	{
+		FRESH_DECLARE_CLASS( BenchNode, Object );
+	public:
+
+		void addChild( SmartPtr< BenchNode > child )
+		{
+			child->m_parent = this;
+			m_children.push_back( child );
+		}
+
+	private:
+		std::vector< SmartPtr< BenchNode >> m_children;
+		WeakPtr< BenchNode > m_parent;
+	};
+
+	FRESH_DEFINE_CLASS( BenchNode )
+	FRESH_IMPLEMENT_STANDARD_CONSTRUCTORS( BenchNode )
+
+	namespace
+	{
+		void populate( BenchNode& node, size_t branching, size_t depth )
+		{
+			if( depth == 0 )
+			{
+				return;
+			}
+
+			for( size_t i = 0; i < branching; ++i )
+			{
+				auto child = createObject< BenchNode >();
+				node.addChild( child );
+				populate( *child, branching, depth - 1 );
+			}
+		}
+	}
+}
+
+FRESH_BENCHMARK( Object )
+{
+	const size_t gridSize = 128;
+	const size_t nTiles = gridSize * gridSize;
+	std::vector< SmartPtr< bench::BenchTile >> tiles;
+	tiles.reserve( nTiles );
+
+	reporter.measure( "createObject (tile grid)", gridSize, nTiles, [&]()
+					 {
+						 tiles.clear();
+						 for( size_t i = 0; i < nTiles; ++i )
+						 {
+							 tiles.push_back( createObject< bench::BenchTile >() );
+						 }
+					 } );
+
+	std::vector< WeakPtr< bench::BenchTile >> weakTiles( nTiles );
+	reporter.measure( "WeakPtr assignment (tile grid)", gridSize, nTiles, [&]()
+					 {
+						 for( size_t i = 0; i < nTiles; ++i )
+						 {
+							 weakTiles[ i ] = tiles[ i ].get();
+						 }
+					 } );
+
+	// Every tile weakly referenced as soon as it is made: the case that still pays for a proxy.
+	//
+	reporter.measure( "createObject + WeakPtr (tile grid)", gridSize, nTiles, [&]()
+					 {
+						 tiles.clear();
+						 for( size_t i = 0; i < nTiles; ++i )
+						 {
+							 tiles.push_back( createObject< bench::BenchTile >() );
+							 weakTiles[ i ] = tiles.back().get();
+						 }
+					 } );
+	weakTiles.clear();
+	tiles.clear();
+
+	// Churn: a grid's worth of tiles created and destroyed over and over, as when rebuilding a level section.
+	//
+	reporter.measure( "create and destroy (heap tile grid)", gridSize, nTiles, [&]()
+					 {
+						 for( size_t i = 0; i < nTiles; ++i )
+						 {
+							 tiles.push_back( createObject< bench::BenchHeapTile >() );
+						 }
+						 tiles.clear();
+					 } );
+
+	reporter.measure( "create and destroy (pooled tile grid)", gridSize, nTiles, [&]()
+					 {
+						 for( size_t i = 0; i < nTiles; ++i )
+						 {
+							 tiles.push_back( createObject< bench::BenchPoolTile >() );
+						 }
+						 tiles.clear();
+					 } );
+
+	// The allocators alone.
+	//
+	const auto& poolClass = bench::BenchPoolTile::StaticGetClassInfo();
+	const size_t objectSize = poolClass.factory().objectSize();
+	std::vector< void* > memory( nTiles );
+
+	reporter.measure( "operator new + delete (tile)", gridSize, nTiles, [&]()
+					 {
+						 for( auto& p : memory ) { p = ::operator new( objectSize ); }
+						 for( auto p : memory ) { ::operator delete( p ); }
+					 } );
+
+	reporter.measure( "ObjectPool allocate + free (tile)", gridSize, nTiles, [&]()
+					 {
+						 for( auto& p : memory ) { p = poolClass.objectPool()->allocate(); }
+						 for( auto p : memory ) { poolClass.objectPool()->free( p ); }
+					 } );
+
+	// 8^5 leaves under 4681 containers, each child pointing weakly at its parent.
+	//
+	const size_t branching = 8;
+	const size_t depth = 5;
+	const size_t nNodes = 37449;
+	SmartPtr< bench::BenchNode > root;
+
+	reporter.measure( "createObject (display tree)", depth, nNodes, [&]()
+					 {
+						 root = createObject< bench::BenchNode >();
+						 bench::populate( *root, branching, depth );
+					 } );
+
+	reporter.measure( "create and destroy (display tree)", depth, nNodes, [&]()
+					 {
+						 root = createObject< bench::BenchNode >();
+						 bench::populate( *root, branching, depth );
+						 root = nullptr;
+					 } );
+}
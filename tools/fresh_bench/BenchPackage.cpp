@@ -0,0 +1,65 @@
+//
+//  BenchPackage.cpp
+//  fresh_bench
+//
+
+#include "Benchmark.h"
+#include "Objects.h"
+#include <sstream>
+
+using namespace fr;
+
+namespace
+{
+	std::string memberName( size_t i )
+	{
+		std::ostringstream name;
+		name << "member" << i;
+		return name.str();
+	}
+}
+
+FRESH_BENCHMARK( Package )
+{
+	for( size_t n : { 1000, 10000, 100000 } )
+	{
+		auto package = createPackage();
+		package->retainMembers();
+		
+		std::vector< Object::ptr > members;
+		std::vector< std::string > names;
+		for( size_t i = 0; i < n; ++i )
+		{
+			names.push_back( memberName( i ));
+			members.push_back( createObject< Object >( package, Object::StaticGetClassInfo(), names.back() ));
+		}
+		
+		const size_t nLookups = 10000;
+		
+		reporter.measure( "Package::find", n, nLookups, [&]()
+						 {
+							 for( size_t i = 0; i < nLookups; ++i )
+							 {
+								 bench::keep( package->find( names[ ( i * 7919 ) % n ] ));
+							 }
+						 } );
+		
+		reporter.measure( "Package::has", n, nLookups, [&]()
+						 {
+							 for( size_t i = 0; i < nLookups; ++i )
+							 {
+								 bench::keep( package->has( members[ ( i * 7919 ) % n ] ));
+							 }
+						 } );
+		
+		reporter.measure( "Package::remove+add", n, nLookups, [&]()
+						 {
+							 for( size_t i = 0; i < nLookups; ++i )
+							 {
+								 const auto& member = members[ ( i * 7919 ) % n ];
+								 package->remove( member );
+								 package->add( member );
+							 }
+						 } );
+	}
+}
@@ -0,0 +1,149 @@
+//
+//  BenchPathFinder.cpp
+//  fresh_bench
+//
+
+#include "Benchmark.h"
+#include "FreshEssentials.h"
+#include <functional>
+#include <unordered_map>
+#include <limits>
+#include <algorithm>
+#include <cstdlib>
+#include "FindPath.h"
+
+using namespace fr;
+
+namespace
+{
+	// A square, 4-connected grid of cells, some solid. Nodes are cell indices.
+	//
+	struct Grid
+	{
+		int size = 0;
+		std::vector< bool > solid;
+
+		Grid( int size_, bool withWalls )
+		:	size( size_ )
+		,	solid( size_t( size_ * size_ ), false )
+		{
+			if( withWalls )
+			{
+				// Vertical walls every 8 columns, open alternately at the bottom and the top,
+				// so that the path snakes across the whole grid.
+				//
+				for( int x = 4; x < size; x += 8 )
+				{
+					const bool openAtBottom = ( x / 8 ) % 2 == 0;
+					for( int y = 0; y < size; ++y )
+					{
+						const bool isGap = openAtBottom ? y >= size - 2 : y < 2;
+						solid[ index( x, y ) ] = !isGap;
+					}
+				}
+			}
+		}
+
+		int index( int x, int y ) const			{ return y * size + x; }
+
+		std::vector< int > neighbors( int node ) const
+		{
+			int buffer[ 4 ];
+			return std::vector< int >( buffer, buffer + neighbors( node, buffer ));
+		}
+
+		size_t neighbors( int node, int* outNeighbors ) const
+		{
+			const int x = node % size;
+			const int y = node / size;
+
+			size_t nNeighbors = 0;
+
+			const auto consider = [&]( int nx, int ny )
+			{
+				if( 0 <= nx && nx < size && 0 <= ny && ny < size && !solid[ index( nx, ny ) ] )
+				{
+					outNeighbors[ nNeighbors++ ] = index( nx, ny );
+				}
+			};
+
+			consider( x - 1, y );
+			consider( x + 1, y );
+			consider( x, y - 1 );
+			consider( x, y + 1 );
+			return nNeighbors;
+		}
+
+		float manhattan( int a, int b ) const
+		{
+			return float( std::abs( a % size - b % size ) + std::abs( a / size - b / size ));
+		}
+	};
+
+	size_t findCornerToCorner( const Grid& grid )
+	{
+		PathFinder< int, double, float > pathFinder( 0,
+													 grid.index( grid.size - 1, grid.size - 1 ),
+													 -1,
+													 [&]( int a, int b ) { return grid.manhattan( a, b ); },
+													 [&]( int node ) { return grid.neighbors( node ); },
+													 []( int, int ) { return 1.0f; },
+													 []() { return 0.0; } );
+
+		bool ranOutOfTime = false;
+		const bool found = pathFinder.findPath( ranOutOfTime );
+		FRESH_BENCH_CHECK( found );
+		return found ? pathFinder.path().size() : 0;
+	}
+
+	size_t findCornerToCornerWithHeap( const Grid& grid, PathFinderScratch< int, float >& scratch )
+	{
+		auto pathFinder = makeHeapPathFinder< 4 >( scratch,
+												  0,
+												  grid.index( grid.size - 1, grid.size - 1 ),
+												  -1,
+												  [&]( int a, int b ) { return grid.manhattan( a, b ); },
+												  [&]( int node, int* outNeighbors ) { return grid.neighbors( node, outNeighbors ); },
+												  []( int, int ) { return 1.0f; },
+												  []() { return 0.0; },
+												  []( int node ) { return size_t( node ); } );
+
+		bool ranOutOfTime = false;
+		const bool found = pathFinder.findPath( ranOutOfTime );
+		FRESH_BENCH_CHECK( found );
+		return found ? pathFinder.path().size() : 0;
+	}
+}
+
+FRESH_BENCHMARK( PathFinder )
+{
+	PathFinderScratch< int, float > scratch;
+
+	for( int size : { 32, 64, 128 } )
+	{
+		const Grid open( size, false );
+		reporter.measure( "PathFinder corner to corner (open)", size, 1, [&]()
+						 {
+							 bench::keep( findCornerToCorner( open ));
+						 } );
+
+		reporter.measure( "HeapPathFinder corner to corner (open)", size, 1, [&]()
+						 {
+							 bench::keep( findCornerToCornerWithHeap( open, scratch ));
+						 } );
+
+		const Grid walled( size, true );
+		reporter.measure( "PathFinder corner to corner (walls)", size, 1, [&]()
+						 {
+							 bench::keep( findCornerToCorner( walled ));
+						 } );
+
+		reporter.measure( "HeapPathFinder corner to corner (walls)", size, 1, [&]()
+						 {
+							 bench::keep( findCornerToCornerWithHeap( walled, scratch ));
+						 } );
+
+		FRESH_BENCH_CHECK( findCornerToCornerWithHeap( open, scratch ) == findCornerToCorner( open ));
+		FRESH_BENCH_CHECK( findCornerToCornerWithHeap( walled, scratch ) == findCornerToCorner( walled ));
+	}
+}
@@ -0,0 +1,105 @@
+//
+//  BenchSmartPtr.cpp
+//  fresh_bench
+//
+
+#include "Benchmark.h"
+#include "Objects.h"
+
+using namespace fr;
+
+// Reference churn on objects that already exist: the traffic of passing pointers around, storing them briefly,
+// and checking weak references, as opposed to the creation and destruction that BenchObject measures.
+//
+FRESH_BENCHMARK( SmartPtr )
+{
+	for( size_t n : { 1000, 100000 } )
+	{
+		std::vector< Object::ptr > objects;
+		std::vector< Object::wptr > weakObjects;
+		for( size_t i = 0; i < n; ++i )
+		{
+			objects.push_back( createObject< Object >() );
+			weakObjects.push_back( objects.back() );
+		}
+
+		const size_t nOps = 100000;
+		std::vector< Object::ptr > copies( 64 );
+		std::vector< Object::wptr > weakCopies( 64 );
+
+		reporter.measure( "SmartPtr copy + release", n, nOps, [&]()
+						 {
+							 for( size_t i = 0; i < nOps; ++i )
+							 {
+								 copies[ i & 63 ] = objects[ ( i * 7919 ) % n ];
+							 }
+						 } );
+
+		reporter.measure( "SmartPtr move", n, nOps, [&]()
+						 {
+							 for( size_t i = 0; i < nOps; ++i )
+							 {
+								 Object::ptr moved = std::move( objects[ ( i * 7919 ) % n ] );
+								 objects[ ( i * 7919 ) % n ] = std::move( moved );
+							 }
+						 } );
+
+		reporter.measure( "WeakPtr copy + release", n, nOps, [&]()
+						 {
+							 for( size_t i = 0; i < nOps; ++i )
+							 {
+								 weakCopies[ i & 63 ] = weakObjects[ ( i * 7919 ) % n ];
+							 }
+						 } );
+
+		reporter.measure( "WeakPtr from SmartPtr", n, nOps, [&]()
+						 {
+							 for( size_t i = 0; i < nOps; ++i )
+							 {
+								 weakCopies[ i & 63 ] = objects[ ( i * 7919 ) % n ];
+							 }
+						 } );
+
+		reporter.measure( "WeakPtr::lock", n, nOps, [&]()
+						 {
+							 for( size_t i = 0; i < nOps; ++i )
+							 {
+								 bench::keep( weakObjects[ ( i * 7919 ) % n ].lock() );
+							 }
+						 } );
+
+		reporter.measure( "WeakPtr::isNull", n, nOps, [&]()
+						 {
+							 size_t nLive = 0;
+							 for( size_t i = 0; i < nOps; ++i )
+							 {
+								 nLive += !weakObjects[ ( i * 7919 ) % n ].isNull();
+							 }
+							 bench::keep( nLive );
+						 } );
+
+		copies.clear();
+		weakCopies.clear();
+
+		// Every object released while weakly referenced, then every weak reference noticing and letting go.
+		//
+		reporter.measure( "release weakly held + recreate", n, n, [&]()
+						 {
+							 objects.clear();
+							 for( auto& weak : weakObjects )
+							 {
+								 if( weak.isNull() )
+								 {
+									 weak = nullptr;
+								 }
+							 }
+							 bench::keep( weakObjects.size() );
+
+							 for( size_t i = 0; i < n; ++i )
+							 {
+								 objects.push_back( createObject< Object >() );
+								 weakObjects[ i ] = objects.back();
+							 }
+						 } );
+	}
+}
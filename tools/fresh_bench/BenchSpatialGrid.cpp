@@ -0,0 +1,203 @@
+//
+//  BenchSpatialGrid.cpp
+//  fresh_bench
+//
+
+#include "Benchmark.h"
+#include "FreshVector.h"
+#include "SpatialHash.h"
+#include "SpatialGrid.h"
+#include <random>
+
+using namespace fr;
+
+namespace
+{
+	struct Mover
+	{
+		vec2 min;
+		vec2 max;
+		vec2 velocity;
+	};
+
+	inline bool overlaps( const Mover& a, const Mover& b )
+	{
+		return a.min.x <= b.max.x && b.min.x <= a.max.x && a.min.y <= b.max.y && b.min.y <= a.max.y;
+	}
+
+	// Actors of a few sizes wandering a square world at up to a few units per step.
+	//
+	std::vector< Mover > scatter( size_t n, real worldSize )
+	{
+		std::mt19937 random{ 1 };
+		std::uniform_real_distribution< real > position( 0, worldSize );
+		std::uniform_real_distribution< real > size( 8, 48 );
+		std::uniform_real_distribution< real > speed( -3, 3 );
+
+		std::vector< Mover > movers( n );
+		for( auto& mover : movers )
+		{
+			mover.min.set( position( random ), position( random ));
+			mover.max = mover.min + vec2( size( random ), size( random ));
+			mover.velocity.set( speed( random ), speed( random ));
+		}
+		return movers;
+	}
+
+	void step( std::vector< Mover >& movers, real worldSize )
+	{
+		for( auto& mover : movers )
+		{
+			for( size_t i = 0; i < 2; ++i )
+			{
+				if( mover.min[ i ] + mover.velocity[ i ] < 0 || mover.max[ i ] + mover.velocity[ i ] > worldSize )
+				{
+					mover.velocity[ i ] = -mover.velocity[ i ];
+				}
+			}
+			mover.min += mover.velocity;
+			mover.max += mover.velocity;
+		}
+	}
+}
+
+FRESH_BENCHMARK( SpatialGrid )
+{
+	const real cellSize = 64;
+
+	for( size_t n : { 1000, 10000, 50000 } )
+	{
+		// Keep the density constant as the count grows.
+		//
+		const real worldSize = std::sqrt( real( n )) * 96;
+
+		// Each frame moves every actor and then visits the overlapping pairs. SpatialHash has to be refilled to
+		// do that; SpatialGrid is moved in place.
+		//
+		{
+			auto movers = scatter( n, worldSize );
+			SpatialHash< vec2, size_t > hash( n * 2, cellSize );
+
+			reporter.measure( "SpatialHash frame (step, clear+add, eachPair)", n, n, [&]()
+							 {
+								 step( movers, worldSize );
+								 hash.clear();
+								 for( size_t i = 0; i < n; ++i )
+								 {
+									 hash.add( movers[ i ].min, movers[ i ].max, i );
+								 }
+								 size_t nPairs = 0;
+								 hash.eachPair( [&]( size_t a, size_t b )
+											   {
+												   nPairs += overlaps( movers[ a ], movers[ b ] );
+											   } );
+								 bench::keep( nPairs );
+							 } );
+		}
+
+		{
+			auto movers = scatter( n, worldSize );
+			SpatialGrid< vec2, size_t > grid( n * 2, cellSize );
+			std::vector< SpatialGrid< vec2, size_t >::Handle > handles( n );
+			for( size_t i = 0; i < n; ++i )
+			{
+				handles[ i ] = grid.add( movers[ i ].min, movers[ i ].max, i );
+			}
+
+			reporter.measure( "SpatialGrid frame (step, move, eachPair)", n, n, [&]()
+							 {
+								 step( movers, worldSize );
+								 for( size_t i = 0; i < n; ++i )
+								 {
+									 grid.move( handles[ i ], movers[ i ].min, movers[ i ].max );
+								 }
+								 size_t nPairs = 0;
+								 grid.eachPair( [&]( size_t a, size_t b )
+											   {
+												   ++nPairs;
+											   } );
+								 bench::keep( nPairs );
+							 } );
+
+			reporter.measure( "SpatialGrid::move", n, n, [&]()
+							 {
+								 step( movers, worldSize );
+								 for( size_t i = 0; i < n; ++i )
+								 {
+									 grid.move( handles[ i ], movers[ i ].min, movers[ i ].max );
+								 }
+							 } );
+
+			reporter.measure( "SpatialGrid::eachPair", n, n, [&]()
+							 {
+								 size_t nPairs = 0;
+								 grid.eachPair( [&]( size_t a, size_t b )
+											   {
+												   ++nPairs;
+											   } );
+								 bench::keep( nPairs );
+							 } );
+
+			// Queries about the size of a screen, and rays across a quarter of the world.
+			//
+			const size_t nQueries = 100;
+			std::mt19937 random{ 2 };
+			std::uniform_real_distribution< real > position( 0, worldSize );
+			std::vector< vec2 > points( nQueries * 2 );
+			for( auto& point : points )
+			{
+				point.set( position( random ), position( random ));
+			}
+
+			reporter.measure( "SpatialGrid::eachOverlapping (512x320)", n, nQueries, [&]()
+							 {
+								 size_t nFound = 0;
+								 for( size_t i = 0; i < nQueries; ++i )
+								 {
+									 grid.eachOverlapping( points[ i ], points[ i ] + vec2( 512, 320 ), [&]( size_t )
+														  {
+															  ++nFound;
+														  } );
+								 }
+								 bench::keep( nFound );
+							 } );
+
+			reporter.measure( "SpatialGrid::eachOnRay", n, nQueries, [&]()
+							 {
+								 size_t nFound = 0;
+								 for( size_t i = 0; i < nQueries; ++i )
+								 {
+									 const auto& start = points[ i * 2 ];
+									 const vec2 direction = ( points[ i * 2 + 1 ] - start ).normal();
+									 grid.eachOnRay( start, start + direction * ( worldSize / 4 ), [&]( size_t, real )
+													{
+														++nFound;
+													} );
+								 }
+								 bench::keep( nFound );
+							 } );
+
+			SpatialHash< vec2, size_t > hash( n * 2, cellSize );
+			for( size_t i = 0; i < n; ++i )
+			{
+				hash.add( movers[ i ].min, movers[ i ].max, i );
+			}
+
+			reporter.measure( "SpatialHash::eachOverlapping (512x320)", n, nQueries, [&]()
+							 {
+								 size_t nFound = 0;
+								 for( size_t i = 0; i < nQueries; ++i )
+								 {
+									 const vec2 min = points[ i ];
+									 const vec2 max = min + vec2( 512, 320 );
+									 hash.eachOverlapping( min, max, [&]( size_t j )
+														  {
+															  nFound += movers[ j ].min.x <= max.x && min.x <= movers[ j ].max.x &&
+																		movers[ j ].min.y <= max.y && min.y <= movers[ j ].max.y;
+														  } );
+								 }
+								 bench::keep( nFound );
+							 } );
+		}
+	}
+}
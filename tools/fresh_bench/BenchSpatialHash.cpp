@@ -0,0 +1,87 @@
+//
+//  BenchSpatialHash.cpp
+//  fresh_bench
+//
+
+#include "Benchmark.h"
+#include "FreshVector.h"
+#include "SpatialHash.h"
+#include <random>
+
+using namespace fr;
+
+namespace
+{
+	struct Bounds
+	{
+		vec2 min;
+		vec2 max;
+	};
+
+	// Actors of a few sizes scattered over a square world, about as crowded as a busy level.
+	//
+	std::vector< Bounds > scatter( size_t n, real worldSize )
+	{
+		std::mt19937 random{ 1 };
+		std::uniform_real_distribution< real > position( 0, worldSize );
+		std::uniform_real_distribution< real > size( 8, 48 );
+
+		std::vector< Bounds > bounds( n );
+		for( auto& b : bounds )
+		{
+			b.min.set( position( random ), position( random ));
+			b.max = b.min + vec2( size( random ), size( random ));
+		}
+		return bounds;
+	}
+}
+
+FRESH_BENCHMARK( SpatialHash )
+{
+	const real binSize = 64;
+
+	for( size_t n : { 100, 1000, 10000 } )
+	{
+		// Keep the density constant as the count grows.
+		//
+		const real worldSize = std::sqrt( real( n )) * 96;
+		const auto bounds = scatter( n, worldSize );
+
+		SpatialHash< vec2, size_t > hash( n * 2, binSize );
+
+		reporter.measure( "SpatialHash::clear+add", n, n, [&]()
+						 {
+							 hash.clear();
+							 for( size_t i = 0; i < n; ++i )
+							 {
+								 hash.add( bounds[ i ].min, bounds[ i ].max, i );
+							 }
+						 } );
+
+		size_t nPairs = 0;
+		reporter.measure( "SpatialHash::eachPair", n, n, [&]()
+						 {
+							 nPairs = 0;
+							 hash.eachPair( [&]( size_t a, size_t b )
+										   {
+											   nPairs += a < b;
+										   } );
+							 bench::keep( nPairs );
+						 } );
+
+		// A full frame's worth: rebuild the hash and then visit its pairs, as a world stepping its actors would.
+		//
+		reporter.measure( "SpatialHash rebuild + eachPair", n, n, [&]()
+						 {
+							 hash.clear();
+							 for( size_t i = 0; i < n; ++i )
+							 {
+								 hash.add( bounds[ i ].min, bounds[ i ].max, i );
+							 }
+							 hash.eachPair( [&]( size_t a, size_t b )
+										   {
+											   bench::keep( a ^ b );
+										   } );
+						 } );
+	}
+}
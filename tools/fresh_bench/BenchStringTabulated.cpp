@@ -0,0 +1,75 @@
+//
+//  BenchStringTabulated.cpp
+//  fresh_bench
+//
+
+#include "Benchmark.h"
+#include "StringTabulated.h"
+#include <vector>
+#include <sstream>
+
+using namespace fr;
+
+namespace
+{
+	// The same long shared prefixes as BenchSymbol, so the two interning schemes can be compared directly.
+	//
+	std::string tabulatedText( size_t i )
+	{
+		std::ostringstream text;
+		text << "DisplayObjectContainer'" << i;
+		return text.str();
+	}
+}
+
+FRESH_BENCHMARK( StringTabulated )
+{
+	for( size_t n : { 1000, 100000 } )
+	{
+		std::vector< std::string > strings;
+		std::vector< StringTabulated > tabulated;
+		for( size_t i = 0; i < n; ++i )
+		{
+			strings.push_back( tabulatedText( i ));
+			tabulated.push_back( strings.back() );
+		}
+
+		const size_t nOps = 100000;
+
+		reporter.measure( "StringTabulated::intern (existing)", n, nOps, [&]()
+						 {
+							 for( size_t i = 0; i < nOps; ++i )
+							 {
+								 bench::keep( StringTabulated{ strings[ ( i * 7919 ) % n ] } );
+							 }
+						 } );
+
+		reporter.measure( "StringTabulated==", n, nOps, [&]()
+						 {
+							 for( size_t i = 0; i < nOps; ++i )
+							 {
+								 bench::keep( tabulated[ ( i * 7919 ) % n ] == tabulated[ ( i * 104729 ) % n ] );
+							 }
+						 } );
+
+		reporter.measure( "StringTabulated<", n, nOps, [&]()
+						 {
+							 for( size_t i = 0; i < nOps; ++i )
+							 {
+								 bench::keep( tabulated[ ( i * 7919 ) % n ] < tabulated[ ( i * 104729 ) % n ] );
+							 }
+						 } );
+	}
+
+	// New strings, each added to the table. The table never shrinks, so every run interns a fresh set.
+	//
+	const size_t nNew = 10000;
+	size_t nextString = 1000000;
+	reporter.measure( "StringTabulated::intern (new)", nNew, nNew, [&]()
+					 {
+						 for( size_t i = 0; i < nNew; ++i )
+						 {
+							 bench::keep( StringTabulated{ tabulatedText( nextString++ ) } );
+						 }
+					 } );
+}
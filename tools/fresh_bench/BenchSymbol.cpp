@@ -0,0 +1,106 @@
+//
+//  BenchSymbol.cpp
+//  fresh_bench
+//
+
+#include "Benchmark.h"
+#include "Symbol.h"
+#include <vector>
+#include <sstream>
+#include <unordered_set>
+#include <thread>
+
+using namespace fr;
+
+namespace
+{
+	// Long shared prefixes are typical of generated object names and the worst case for string compares.
+	//
+	std::string symbolText( size_t i )
+	{
+		std::ostringstream text;
+		text << "DisplayObjectContainer'" << i;
+		return text.str();
+	}
+}
+
+FRESH_BENCHMARK( Symbol )
+{
+	for( size_t n : { 1000, 100000 } )
+	{
+		std::vector< std::string > strings;
+		std::vector< Symbol > symbols;
+		for( size_t i = 0; i < n; ++i )
+		{
+			strings.push_back( symbolText( i ));
+			symbols.push_back( strings.back() );
+		}
+
+		const size_t nOps = 100000;
+
+		reporter.measure( "Symbol::intern", n, nOps, [&]()
+						 {
+							 for( size_t i = 0; i < nOps; ++i )
+							 {
+								 bench::keep( Symbol{ strings[ ( i * 7919 ) % n ] } );
+							 }
+						 } );
+
+		// Already-interned strings converted on several threads at once, as loaders and workers do.
+		//
+		const size_t nThreads = 4;
+		reporter.measure( "Symbol::intern x4 threads", n, nOps, [&]()
+						 {
+							 std::vector< std::thread > threads;
+							 for( size_t t = 0; t < nThreads; ++t )
+							 {
+								 threads.emplace_back( [&, t]()
+													  {
+														  for( size_t i = t; i < nOps; i += nThreads )
+														  {
+															  bench::keep( Symbol{ strings[ ( i * 7919 ) % n ] } );
+														  }
+													  } );
+							 }
+							 for( auto& thread : threads )
+							 {
+								 thread.join();
+							 }
+						 } );
+
+		reporter.measure( "std::string==", n, nOps, [&]()
+						 {
+							 for( size_t i = 0; i < nOps; ++i )
+							 {
+								 bench::keep( strings[ ( i * 7919 ) % n ] == strings[ ( i * 104729 ) % n ] );
+							 }
+						 } );
+
+		reporter.measure( "Symbol==", n, nOps, [&]()
+						 {
+							 for( size_t i = 0; i < nOps; ++i )
+							 {
+								 bench::keep( symbols[ ( i * 7919 ) % n ] == symbols[ ( i * 104729 ) % n ] );
+							 }
+						 } );
+
+		std::unordered_set< std::string > stringSet( strings.begin(), strings.end() );
+		std::unordered_set< Symbol > symbolSet( symbols.begin(), symbols.end() );
+
+		reporter.measure( "unordered_set<std::string>::find", n, nOps, [&]()
+						 {
+							 for( size_t i = 0; i < nOps; ++i )
+							 {
+								 bench::keep( stringSet.find( strings[ ( i * 7919 ) % n ] ) != stringSet.end() );
+							 }
+						 } );
+
+		reporter.measure( "unordered_set<Symbol>::find", n, nOps, [&]()
+						 {
+							 for( size_t i = 0; i < nOps; ++i )
+							 {
+								 bench::keep( symbolSet.find( symbols[ ( i * 7919 ) % n ] ) != symbolSet.end() );
+							 }
+						 } );
+	}
+}
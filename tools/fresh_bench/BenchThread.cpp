@@ -0,0 +1,131 @@
+//
+//  BenchThread.cpp
+//  fresh_bench
+//
+
+#include "Benchmark.h"
+#include "FreshThread.h"
+#include <iostream>
+#include <numeric>
+#include <random>
+
+using namespace fr;
+
+namespace bench
+{
+	namespace
+	{
+		// parallelFor as it was: four threads created and joined on every call.
+		//
+		template< typename IterT, typename FunctionT >
+		void threadPerCallParallelFor( IterT begin, const IterT end, FunctionT&& fnEach, size_t maxThreads = 4 )
+		{
+			const auto work = [&]( IterT threadRangeBegin, const IterT threadRangeEnd )
+			{
+				for( ; threadRangeBegin != threadRangeEnd; ++threadRangeBegin )
+				{
+					fnEach( *threadRangeBegin );
+				}
+			};
+
+			std::vector< std::thread > threads( maxThreads - 1 );
+			const size_t perThreadSpanSize = std::distance( begin, end ) / maxThreads;
+
+			for( size_t i = 0; i < threads.size(); ++i )
+			{
+				const auto threadBegin = begin + i * perThreadSpanSize;
+				threads[ i ] = std::thread{ std::bind( work, threadBegin, threadBegin + perThreadSpanSize ) };
+			}
+
+			work( begin + threads.size() * perThreadSpanSize, end );
+
+			for( auto& thread : threads )
+			{
+				thread.join();
+			}
+		}
+
+		// Stands in for a per-entity update.
+		//
+		const auto update = []( float& x )
+		{
+			for( int i = 0; i < 16; ++i )
+			{
+				x = x * 0.999f + 0.5f;
+			}
+		};
+	}
+}
+
+FRESH_BENCHMARK( Thread )
+{
+	std::cout << "(" << numParallelThreads() << " threads)" << std::endl;
+
+	// A frame's worth of entities, updated many times as a game would once per frame.
+	//
+	const size_t nEntities = 2000;
+	const size_t nFrames = 200;
+	std::vector< float > entities( nEntities, 1.0f );
+
+	reporter.measure( "parallelFor (thread per call)", nEntities, nFrames, [&]()
+					 {
+						 for( size_t frame = 0; frame < nFrames; ++frame )
+						 {
+							 bench::threadPerCallParallelFor( entities.begin(), entities.end(), bench::update );
+						 }
+					 } );
+
+	reporter.measure( "parallelFor (pool)", nEntities, nFrames, [&]()
+					 {
+						 for( size_t frame = 0; frame < nFrames; ++frame )
+						 {
+							 parallelFor( entities.begin(), entities.end(), bench::update );
+						 }
+					 } );
+
+	reporter.measure( "serial for", nEntities, nFrames, [&]()
+					 {
+						 for( size_t frame = 0; frame < nFrames; ++frame )
+						 {
+							 std::for_each( entities.begin(), entities.end(), bench::update );
+						 }
+					 } );
+
+	const size_t nValues = 1 << 20;
+	std::vector< double > values( nValues );
+	std::iota( values.begin(), values.end(), 0.0 );
+
+	reporter.measure( "parallelReduce (sum of squares)", nValues, 1, [&]()
+					 {
+						 bench::keep( parallelReduce( values.begin(), values.end(), 0.0, []( double x ) { return x * x; }, std::plus< double >{} ));
+					 } );
+
+	reporter.measure( "std::accumulate (sum of squares)", nValues, 1, [&]()
+					 {
+						 bench::keep( std::accumulate( values.begin(), values.end(), 0.0, []( double sum, double x ) { return sum + x * x; } ));
+					 } );
+
+	std::vector< int > unsorted( nValues );
+	std::iota( unsorted.begin(), unsorted.end(), 0 );
+	std::shuffle( unsorted.begin(), unsorted.end(), std::mt19937{ 1 } );
+	std::vector< int > sorting;
+
+	reporter.measure( "parallelSort", nValues, 1, [&]()
+					 {
+						 sorting = unsorted;
+						 parallelSort( sorting.begin(), sorting.end() );
+					 } );
+
+	reporter.measure( "std::sort", nValues, 1, [&]()
+					 {
+						 sorting = unsorted;
+						 std::sort( sorting.begin(), sorting.end() );
+					 } );
+
+	Grid2< float > grid( Vector2i( 256, 256 ), vec2( 1 ), 1.0f );
+
+	reporter.measure( "parallelForGrid (256x256)", 256, 1, [&]()
+					 {
+						 parallelForGrid( grid, []( float& cell, const Vector2i& ) { bench::update( cell ); } );
+					 } );
+}
@@ -0,0 +1,80 @@
+//
+//  BenchTrace.cpp
+//  fresh_bench
+//
+
+#include "Benchmark.h"
+#include "Profiler.h"
+#include "TraceRecorder.h"
+#include <sstream>
+
+using namespace fr;
+
+namespace bench
+{
+	namespace
+	{
+		int tracedWork( int x )
+		{
+			TIMER_AUTO( tracedWork )
+			return x * 3 + 1;
+		}
+
+		int profiledWork( int x )
+		{
+			Profiler::AutoTimer timer( "profiledWork" );
+			return x * 3 + 1;
+		}
+	}
+}
+
+FRESH_BENCHMARK( TraceRecorder )
+{
+	const size_t nCalls = 100000;
+
+	reporter.measure( "TIMER_AUTO, not capturing", 1, nCalls, [&]()
+					 {
+						 int x = 0;
+						 for( size_t i = 0; i < nCalls; ++i )
+						 {
+							 x = bench::tracedWork( x );
+						 }
+						 bench::keep( x );
+					 } );
+
+	trace::startCapture();
+
+	reporter.measure( "TIMER_AUTO, capturing", 1, nCalls, [&]()
+					 {
+						 int x = 0;
+						 for( size_t i = 0; i < nCalls; ++i )
+						 {
+							 x = bench::tracedWork( x );
+						 }
+						 bench::keep( x );
+					 } );
+
+	trace::stopCapture();
+
+	reporter.measure( "Chrome trace export (full buffer)", trace::EVENTS_PER_THREAD, 1, [&]()
+					 {
+						 std::ostringstream out;
+						 trace::writeChromeTrace( out );
+						 bench::keep( out.str().size() );
+					 } );
+
+	if( !Profiler::doesExist() )
+	{
+		new Profiler();
+	}
+
+	reporter.measure( "Profiler::AutoTimer, for comparison", 1, nCalls, [&]()
+					 {
+						 int x = 0;
+						 for( size_t i = 0; i < nCalls; ++i )
+						 {
+							 x = bench::profiledWork( x );
+						 }
+						 bench::keep( x );
+					 } );
+}
@@ -0,0 +1,93 @@
+//
+//  Benchmark.h
+//  fresh_bench
+//
+
+#ifndef fresh_bench_Benchmark_h
+#define fresh_bench_Benchmark_h
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <cstddef>
+
+namespace bench
+{
+	struct Result
+	{
+		std::string benchmark;
+		std::string label;
+		size_t n = 0;
+		double nsPerOp = 0;
+		double allocationsPerOp = 0;
+	};
+
+	// Reporter times individual measurements, prints them, and keeps them for writeJson().
+	// A measurement runs its function a few times (each run performing nOps operations) and keeps the fastest run,
+	// which is the most repeatable figure on a machine that is doing other things.
+	// It also reports the heap allocations per operation made by that run.
+	//
+	class Reporter
+	{
+	public:
+		
+		explicit Reporter( size_t nRepetitions = 3 ) : m_nRepetitions( nRepetitions ) {}
+		
+		void beginBenchmark( const std::string& name );
+		// Later measurements are reported as belonging to the named benchmark.
+		
+		void measure( const std::string& label, size_t n, size_t nOps, const std::function< void() >& fn );
+		// REQUIRES( nOps > 0 );
+		
+		const std::vector< Result >& results() const		{ return m_results; }
+		
+		void writeJson( std::ostream& out ) const;
+		// Writes every result so far as a JSON array of objects with the members of Result, for regression tracking.
+		
+	private:
+		
+		size_t m_nRepetitions;
+		std::string m_benchmark;
+		std::vector< Result > m_results;
+	};
+	
+	typedef std::function< void( Reporter& ) > BenchmarkFunction;
+	
+	struct Benchmark
+	{
+		std::string name;
+		BenchmarkFunction fn;
+	};
+	
+	std::vector< Benchmark >& benchmarks();
+	
+	size_t allocationCount();
+	// The number of operator new calls made so far by the process.
+	
+	void check( bool condition, const char* description );
+	// Exits with an error unless condition holds. Unlike ASSERT this checks in optimized builds too,
+	// which are the ones benchmarks run in, so results measured on broken work never get reported.
+	
+	struct Registrar
+	{
+		Registrar( const char* name, BenchmarkFunction&& fn );
+	};
+	
+	// Prevents the optimizer from discarding a computed value.
+	//
+	template< typename T >
+	inline void keep( const T& value )
+	{
+		asm volatile( "" : : "g"( &value ) : "memory" );
+	}
+}
+
+#define FRESH_BENCH_CHECK( expr ) bench::check( (expr), #expr )
+
+#define FRESH_BENCHMARK( name_ )	\
+	static void bench_##name_( bench::Reporter& reporter );	\
+	static const bench::Registrar s_benchRegistrar_##name_( #name_, &bench_##name_ );	\
+	static void bench_##name_( bench::Reporter& reporter )
+
+#endif
@@ -0,0 +1,195 @@
+//
+//  main.cpp
+//  fresh_bench
+//
+//  Headless microbenchmarks for FreshCore.
+//  Usage: fresh_bench [--json <file>] [name-filter...]
+//  With no filters every registered benchmark runs. Otherwise only those whose names contain one of the filters.
+//  --json also writes the results to the file, as a JSON array of { benchmark, label, n, nsPerOp, allocationsPerOp }.
+//
+
+#include "Benchmark.h"
+#include "Classes.h"
+#include "ObjectLinker.h"
+#include "FreshTime.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <algorithm>
+#include <limits>
+#include <atomic>
+#include <new>
+#include <cstdlib>
+
+namespace
+{
+	std::atomic< size_t > g_nAllocations{ 0 };
+	
+	void writeJsonString( std::ostream& out, const std::string& s )
+	{
+		out << '"';
+		for( const char c : s )
+		{
+			switch( c )
+			{
+				case '"': out << "\\\""; break;
+				case '\\': out << "\\\\"; break;
+				default: out << c; break;
+			}
+		}
+		out << '"';
+	}
+}
+
+// Counting replacements for the global allocation functions. The array and nothrow forms forward to these.
+//
+void* operator new( size_t size )
+{
+	g_nAllocations.fetch_add( 1, std::memory_order_relaxed );
+	if( void* p = std::malloc( size ? size : 1 ))
+	{
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete( void* p ) noexcept
+{
+	std::free( p );
+}
+
+void operator delete( void* p, size_t ) noexcept
+{
+	std::free( p );
+}
+
+namespace bench
+{
+	std::vector< Benchmark >& benchmarks()
+	{
+		static std::vector< Benchmark > theBenchmarks;
+		return theBenchmarks;
+	}
+	
+	size_t allocationCount()
+	{
+		return g_nAllocations.load( std::memory_order_relaxed );
+	}
+	
+	void check( bool condition, const char* description )
+	{
+		if( !condition )
+		{
+			std::cerr << "Benchmark check failed: " << description << std::endl;
+			std::exit( 1 );
+		}
+	}
+	
+	Registrar::Registrar( const char* name, BenchmarkFunction&& fn )
+	{
+		benchmarks().push_back( Benchmark{ name, std::move( fn ) } );
+	}
+	
+	void Reporter::beginBenchmark( const std::string& name )
+	{
+		m_benchmark = name;
+		std::cout << "# " << name << std::endl;
+	}
+	
+	void Reporter::measure( const std::string& label, size_t n, size_t nOps, const std::function< void() >& fn )
+	{
+		REQUIRES( nOps > 0 );
+		
+		double bestSeconds = std::numeric_limits< double >::max();
+		size_t bestAllocations = 0;
+		for( size_t i = 0; i < m_nRepetitions; ++i )
+		{
+			const auto startAllocations = allocationCount();
+			const auto start = fr::getAbsoluteTimeClocks();
+			fn();
+			const auto seconds = fr::clocksToSeconds( fr::getAbsoluteTimeClocks() - start );
+			if( seconds < bestSeconds )
+			{
+				bestSeconds = seconds;
+				bestAllocations = allocationCount() - startAllocations;
+			}
+		}
+		
+		const double nsPerOp = bestSeconds * 1.0e9 / nOps;
+		const double allocationsPerOp = double( bestAllocations ) / nOps;
+		
+		std::cout << std::left << std::setw( 40 ) << label
+				  << std::right << " n=" << std::setw( 8 ) << n
+				  << std::setw( 14 ) << std::fixed << std::setprecision( 1 ) << nsPerOp << " ns/op"
+				  << std::setw( 10 ) << std::setprecision( 2 ) << allocationsPerOp << " allocs/op" << std::endl;
+		
+		m_results.push_back( Result{ m_benchmark, label, n, nsPerOp, allocationsPerOp } );
+	}
+	
+	void Reporter::writeJson( std::ostream& out ) const
+	{
+		out << "[\n";
+		for( size_t i = 0; i < m_results.size(); ++i )
+		{
+			const auto& result = m_results[ i ];
+			out << "{\"benchmark\":";
+			writeJsonString( out, result.benchmark );
+			out << ",\"label\":";
+			writeJsonString( out, result.label );
+			out << ",\"n\":" << result.n
+				<< std::fixed << std::setprecision( 2 )
+				<< ",\"nsPerOp\":" << result.nsPerOp
+				<< ",\"allocationsPerOp\":" << result.allocationsPerOp << "}"
+				<< ( i + 1 < m_results.size() ? ",\n" : "\n" );
+		}
+		out << "]\n";
+	}
+}
+
+int main( int argc, const char* argv[] )
+{
+	fr::initReflection();
+	fr::ObjectLinker::create();
+	
+	std::vector< std::string > filters;
+	std::string jsonPath;
+	for( int i = 1; i < argc; ++i )
+	{
+		if( std::string( argv[ i ] ) == "--json" && i + 1 < argc )
+		{
+			jsonPath = argv[ ++i ];
+		}
+		else
+		{
+			filters.push_back( argv[ i ] );
+		}
+	}
+	
+	bench::Reporter reporter;
+	
+	for( const auto& benchmark : bench::benchmarks() )
+	{
+		const bool selected = filters.empty() || std::any_of( filters.begin(), filters.end(), [&]( const std::string& filter )
+															 {
+																 return benchmark.name.find( filter ) != std::string::npos;
+															 } );
+		if( selected )
+		{
+			reporter.beginBenchmark( benchmark.name );
+			benchmark.fn( reporter );
+		}
+	}
+	
+	if( !jsonPath.empty() )
+	{
+		std::ofstream out( jsonPath );
+		reporter.writeJson( out );
+		if( !out )
+		{
+			std::cerr << "Could not write " << jsonPath << std::endl;
+			return 1;
+		}
+	}
+	
+	return 0;
+}
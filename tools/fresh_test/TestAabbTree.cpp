@@ -0,0 +1,251 @@
+//
+//  TestAabbTree.cpp
+//  fresh_test
+//
+
+#include "UnitTest.h"
+#include "AabbTree.h"
+#include "FreshVector.h"
+#include <random>
+#include <set>
+#include <cmath>
+
+using namespace fr;
+
+namespace
+{
+	typedef AabbTree< vec2, int > Tree;
+
+	struct Box
+	{
+		vec2 minCorner;
+		vec2 maxCorner;
+		bool isAlive = true;
+	};
+
+	bool overlaps( const Box& a, const Box& b )
+	{
+		return a.minCorner.x <= b.maxCorner.x && b.minCorner.x <= a.maxCorner.x &&
+			   a.minCorner.y <= b.maxCorner.y && b.minCorner.y <= a.maxCorner.y;
+	}
+
+	real distanceSquared( const vec2& point, const Box& box )
+	{
+		real sum = 0;
+		for( size_t i = 0; i < 2; ++i )
+		{
+			const real outside = std::max( std::max( box.minCorner[ i ] - point[ i ], point[ i ] - box.maxCorner[ i ] ), real( 0 ));
+			sum += outside * outside;
+		}
+		return sum;
+	}
+
+	bool segmentEnters( const vec2& start, const vec2& end, const Box& box, real& outT )
+	{
+		real tEnter = 0;
+		real tExit = 1;
+		for( size_t i = 0; i < 2; ++i )
+		{
+			const real delta = end[ i ] - start[ i ];
+			if( delta == 0 )
+			{
+				if( start[ i ] < box.minCorner[ i ] || box.maxCorner[ i ] < start[ i ] )
+				{
+					return false;
+				}
+			}
+			else
+			{
+				real t0 = ( box.minCorner[ i ] - start[ i ] ) / delta;
+				real t1 = ( box.maxCorner[ i ] - start[ i ] ) / delta;
+				if( t1 < t0 )
+				{
+					std::swap( t0, t1 );
+				}
+				tEnter = std::max( tEnter, t0 );
+				tExit = std::min( tExit, t1 );
+			}
+		}
+		outT = tEnter;
+		return tEnter <= tExit;
+	}
+
+	// Reaches the traversal stack, which no balanced tree small enough for a test would fill.
+	//
+	class ExposedTree : public Tree
+	{
+	public:
+		using Tree::NodeStack;
+	};
+}
+
+FRESH_TEST( AabbTreeMatchesBruteForce )
+{
+	// Mostly small boxes with a few large ones, moved, removed and re-added, checked against brute force after
+	// every frame.
+	//
+	const size_t nObjects = 1500;
+	const size_t k = 10;
+
+	std::mt19937 random( 11 );
+	std::uniform_real_distribution< real > position( -2000, 2000 ), step( -40, 40 ), unit( 0, 1 );
+	const auto size = [&]() { return unit( random ) < 0.05f ? 400 * unit( random ) + 100 : 30 * unit( random ) + 1; };
+
+	Tree tree( 4 );
+
+	std::vector< Box > boxes( nObjects );
+	std::vector< Tree::Handle > handles( nObjects );
+	for( size_t i = 0; i < nObjects; ++i )
+	{
+		boxes[ i ].minCorner.set( position( random ), position( random ));
+		boxes[ i ].maxCorner = boxes[ i ].minCorner + vec2( size(), size() );
+		handles[ i ] = tree.add( boxes[ i ].minCorner, boxes[ i ].maxCorner, int( i ));
+	}
+
+	for( int frame = 0; frame < 40; ++frame )
+	{
+		size_t nAlive = 0;
+		for( size_t i = 0; i < nObjects; ++i )
+		{
+			auto& box = boxes[ i ];
+			if( !box.isAlive )
+			{
+				if( random() % 4 == 0 )
+				{
+					box.isAlive = true;
+					handles[ i ] = tree.add( box.minCorner, box.maxCorner, int( i ));
+				}
+			}
+			else if( random() % 30 == 0 )
+			{
+				tree.remove( handles[ i ] );
+				box.isAlive = false;
+			}
+			else
+			{
+				const vec2 displacement( step( random ), step( random ));
+				box.minCorner += displacement;
+				box.maxCorner += displacement;
+				tree.move( handles[ i ], box.minCorner, box.maxCorner, displacement );
+			}
+
+			if( box.isAlive )
+			{
+				++nAlive;
+				VERIFY_BOOL( tree.contains( handles[ i ] ) && tree[ handles[ i ]] == int( i ));
+			}
+		}
+		VERIFY_BOOL( tree.size() == nAlive );
+
+		// A region.
+		//
+		Box region;
+		region.minCorner.set( position( random ), position( random ));
+		region.maxCorner = region.minCorner + vec2( 600, 300 );
+
+		std::multiset< int > expected, found;
+		for( size_t i = 0; i < nObjects; ++i )
+		{
+			if( boxes[ i ].isAlive && overlaps( boxes[ i ], region ))
+			{
+				expected.insert( int( i ));
+			}
+		}
+		tree.eachOverlapping( region.minCorner, region.maxCorner, [&]( int element ) { found.insert( element ); } );
+		VERIFY_BOOL( found == expected );
+
+		// A circle.
+		//
+		const vec2 center( position( random ), position( random ));
+		const real radius = 250;
+
+		expected.clear();
+		found.clear();
+		for( size_t i = 0; i < nObjects; ++i )
+		{
+			if( boxes[ i ].isAlive && distanceSquared( center, boxes[ i ] ) <= radius * radius )
+			{
+				expected.insert( int( i ));
+			}
+		}
+		tree.eachWithinRadius( center, radius, [&]( int element ) { found.insert( element ); } );
+		VERIFY_BOOL( found == expected );
+
+		// A ray, sometimes horizontal, and the first box on it.
+		//
+		const vec2 start( position( random ), position( random ));
+		vec2 end( position( random ), position( random ));
+		if( frame % 5 == 0 )
+		{
+			end.y = start.y;
+		}
+
+		expected.clear();
+		found.clear();
+		real firstT = 2;
+		bool anyOnRay = false;
+		for( size_t i = 0; i < nObjects; ++i )
+		{
+			real t;
+			if( boxes[ i ].isAlive && segmentEnters( start, end, boxes[ i ], t ))
+			{
+				expected.insert( int( i ));
+				anyOnRay = true;
+				firstT = std::min( firstT, t );
+			}
+		}
+		tree.eachOnRay( start, end, [&]( int element, real ) { found.insert( element ); } );
+		VERIFY_BOOL( found == expected );
+
+		real t = -1;
+		const auto first = tree.firstOnRay( start, end, &t );
+		VERIFY_BOOL( anyOnRay == ( first != Tree::INVALID_HANDLE ));
+		VERIFY_BOOL( !anyOnRay || std::abs( t - firstT ) <= 1e-6f );
+
+		// The nearest few, nearest first.
+		//
+		std::vector< real > expectedDistances;
+		for( size_t i = 0; i < nObjects; ++i )
+		{
+			if( boxes[ i ].isAlive )
+			{
+				expectedDistances.push_back( distanceSquared( center, boxes[ i ] ));
+			}
+		}
+		std::sort( expectedDistances.begin(), expectedDistances.end() );
+
+		std::vector< real > distances;
+		bool distancesAreTheElements = true;
+		tree.eachNearest( center, k, [&]( int element, real distance )
+						 {
+							 distances.push_back( distance );
+							 distancesAreTheElements = distancesAreTheElements && std::abs( distance - distanceSquared( center, boxes[ element ] )) <= 1e-3f;
+						 } );
+		VERIFY_BOOL( distancesAreTheElements );
+		VERIFY_BOOL( distances.size() == k );
+		for( size_t i = 0; i < k; ++i )
+		{
+			VERIFY_BOOL( std::abs( distances[ i ] - expectedDistances[ i ] ) <= 1e-3f );
+		}
+	}
+
+	return true;
+}
+
+FRESH_TEST( AabbTreeStackOutgrowsItsFixedPart )
+{
+	ExposedTree::NodeStack stack;
+
+	const Tree::Handle nPushed = 1000;
+	for( Tree::Handle handle = 0; handle < nPushed; ++handle )
+	{
+		stack.push( handle );
+	}
+	for( Tree::Handle handle = nPushed; handle > 0; --handle )
+	{
+		VERIFY_BOOL( !stack.empty() );
+		VERIFY_BOOL( stack.pop() == handle - 1 );
+	}
+	VERIFY_BOOL( stack.empty() );
+	return true;
+}
@@ -0,0 +1,80 @@
+//
+//  TestClassHierarchy.cpp
+//  fresh_test
+//
+
+#include "UnitTest.h"
+#include "Objects.h"
+#include "Classes.h"
+#include "StringTable.h"
+
+using namespace fr;
+
+namespace unittest
+{
+	class TestHierarchyRoot : public Object
+	{
+		FRESH_DECLARE_CLASS( TestHierarchyRoot, Object );
+	};
+
+	FRESH_DEFINE_CLASS( TestHierarchyRoot )
+	FRESH_IMPLEMENT_STANDARD_CONSTRUCTORS( TestHierarchyRoot )
+
+	namespace
+	{
+		ClassInfo::ptr createEmptyClass( const std::string& name, const std::string& baseName )
+		{
+			Manifest::Class directive( name, { baseName }, std::make_shared< Manifest::Map >() );
+			return createClass( name, baseName, directive );
+		}
+	}
+}
+
+using namespace unittest;
+
+FRESH_TEST( ClassHierarchyDeeperThanItsNumbering )
+{
+	// Each level of a chain takes half of its superclass's free interval, so a chain this long runs the
+	// number line out, renumbers, and leaves its deepest classes without intervals. Classes added beneath
+	// those must still register and answer isKindOf() correctly.
+	//
+	const size_t depth = 100;
+
+	std::vector< ClassInfo::ptr > chain{ &TestHierarchyRoot::StaticGetClassInfo() };
+	for( size_t i = 1; i < depth; ++i )
+	{
+		chain.push_back( createEmptyClass( "TestHierarchyLevel" + std::to_string( i ), chain.back()->className() ));
+	}
+
+	std::vector< ClassInfo::ptr > leaves;
+	for( size_t i = depth - 10; i < depth; ++i )
+	{
+		leaves.push_back( createEmptyClass( "TestHierarchyLeaf" + std::to_string( i ), chain[ i ]->className() ));
+	}
+
+	for( size_t i = 0; i < depth; ++i )
+	{
+		for( size_t j = 0; j < depth; ++j )
+		{
+			VERIFY_BOOL( chain[ i ]->isKindOf( *chain[ j ] ) == ( j <= i ));
+			VERIFY_BOOL( chain[ i ]->getSuperClassDepth( *chain[ j ] ) == ( j <= i ? int( i - j ) : -1 ));
+		}
+		VERIFY_BOOL( chain[ i ]->isKindOf( Object::StaticGetClassInfo() ));
+	}
+
+	for( size_t k = 0; k < leaves.size(); ++k )
+	{
+		const size_t parent = depth - 10 + k;
+		for( size_t j = 0; j < depth; ++j )
+		{
+			VERIFY_BOOL( leaves[ k ]->isKindOf( *chain[ j ] ) == ( j <= parent ));
+			VERIFY_BOOL( !chain[ j ]->isKindOf( *leaves[ k ] ));
+		}
+		for( size_t m = 0; m < leaves.size(); ++m )
+		{
+			VERIFY_BOOL( leaves[ k ]->isKindOf( *leaves[ m ] ) == ( k == m ));
+		}
+	}
+
+	return true;
+}
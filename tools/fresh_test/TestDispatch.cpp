@@ -0,0 +1,41 @@
+//
+//  TestDispatch.cpp
+//  fresh_test
+//
+
+#include "UnitTest.h"
+#include "Dispatch.h"
+#include "FreshException.h"
+#include <atomic>
+
+using namespace fr;
+
+FRESH_TEST( ConcurrentQueueHandsExceptionsToTheMainQueue )
+{
+	// A throwing block must neither take its worker down nor go unnoticed.
+	//
+	std::atomic< int > nRan{ 0 };
+
+	auto& queue = dispatch::globalQueue();
+	queue.async( std::make_shared< dispatch::Block >( []() { FRESH_THROW( FreshException, "Thrown from a worker." ); } ));
+	queue.wait();
+
+	for( int i = 0; i < 4; ++i )
+	{
+		queue.async( std::make_shared< dispatch::Block >( [&]() { ++nRan; } ));
+	}
+	queue.wait();
+	VERIFY_BOOL( nRan == 4 );
+
+	bool caught = false;
+	try
+	{
+		dispatch::mainQueue().poll();
+	}
+	catch( const FreshException& )
+	{
+		caught = true;
+	}
+	VERIFY_BOOL_MSG( caught, "The worker's exception should have been rethrown on the main queue." );
+	return true;
+}
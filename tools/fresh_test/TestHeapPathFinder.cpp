@@ -0,0 +1,100 @@
+//
+//  TestHeapPathFinder.cpp
+//  fresh_test
+//
+
+#include "UnitTest.h"
+#include "FindPath.h"
+#include <cmath>
+#include <random>
+
+using namespace fr;
+
+FRESH_TEST( HeapPathFinderMatchesPathFinder )
+{
+	// Random weighted grids with 8-way movement, some unsolvable. One scratch serves every query, as it would
+	// in a game. Both finders break ties the same way, so they must agree on the path itself, not only its cost.
+	//
+	std::mt19937 random( 3 );
+	PathFinderScratch< int, float > scratch;
+
+	size_t nQueries = 0;
+	size_t nFound = 0;
+
+	for( int iGrid = 0; iGrid < 300; ++iGrid )
+	{
+		const int size = 8 + random() % 40;
+
+		std::vector< bool > isSolid( size * size );
+		std::vector< float > weights( size * size );
+		for( int i = 0; i < size * size; ++i )
+		{
+			isSolid[ i ] = random() % 100 < 30;
+			weights[ i ] = float( 1 + random() % 3 );
+		}
+
+		const int start = random() % ( size * size );
+		const int goal = random() % ( size * size );
+		if( start == goal )
+		{
+			continue;
+		}
+		isSolid[ start ] = isSolid[ goal ] = false;
+
+		const auto getNeighbors = [&]( int node, int* outNeighbors )
+		{
+			static const int offsets[ 8 ][ 2 ] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 }, { -1, -1 }, { 1, 1 }, { 1, -1 }, { -1, 1 } };
+
+			size_t nNeighbors = 0;
+			const int x = node % size;
+			const int y = node / size;
+			for( const auto& offset : offsets )
+			{
+				const int nx = x + offset[ 0 ];
+				const int ny = y + offset[ 1 ];
+				if( 0 <= nx && nx < size && 0 <= ny && ny < size && !isSolid[ ny * size + nx ] )
+				{
+					outNeighbors[ nNeighbors++ ] = ny * size + nx;
+				}
+			}
+			return nNeighbors;
+		};
+		const auto heuristicEstimate = [&]( int from, int to )
+		{
+			const int dx = from % size - to % size;
+			const int dy = from / size - to / size;
+			return std::sqrt( float( dx * dx + dy * dy ));
+		};
+		const auto nodeDistance = [&]( int from, int to )
+		{
+			return heuristicEstimate( from, to ) * weights[ to ];
+		};
+		const auto time = []() { return 0.0; };
+
+		PathFinder< int, double, float > reference( start, goal, -1,
+												   heuristicEstimate,
+												   [&]( int node )
+												   {
+													   int neighbors[ 8 ];
+													   return std::vector< int >( neighbors, neighbors + getNeighbors( node, neighbors ));
+												   },
+												   nodeDistance,
+												   time );
+		auto finder = makeHeapPathFinder( scratch, start, goal, -1, heuristicEstimate, getNeighbors, nodeDistance, time, []( int node ) { return size_t( node ); } );
+
+		bool ranOutOfTime = false;
+		const bool referenceFound = reference.findPath( ranOutOfTime );
+		const bool found = finder.findPath( ranOutOfTime );
+
+		VERIFY_BOOL( found == referenceFound );
+		VERIFY_BOOL( !found || finder.path() == reference.path() );
+
+		++nQueries;
+		nFound += found;
+	}
+
+	// Both outcomes were exercised.
+	//
+	VERIFY_BOOL( 0 < nFound && nFound < nQueries );
+	return true;
+}
@@ -0,0 +1,205 @@
+//
+//  TestInputRecording.cpp
+//  fresh_test
+//
+
+#include "UnitTest.h"
+#include "InputRecording.h"
+#include "FreshFile.h"
+#include <cstdio>
+
+using namespace fr;
+
+namespace
+{
+	const size_t NUM_FRAMES = 6;
+	const size_t NUM_BUTTONS = size_t( Gamepad::Button::NUM );
+	const size_t NUM_AXES = size_t( Gamepad::Axis::NUM );
+
+	EventKeyboard keyEvent( size_t iFrame )
+	{
+		return EventKeyboard( iFrame % 2 ? EventKeyboard::KEY_UP : EventKeyboard::KEY_DOWN,
+							  nullptr,
+							  unsigned( 'a' + iFrame ),
+							  Keyboard::Key( Keyboard::A + iFrame ),
+							  iFrame == 1,
+							  iFrame == 2,
+							  iFrame == 3,
+							  false );
+	}
+
+	Application::Touches touchesFor( size_t iFrame )
+	{
+		Application::Touches touches;
+		for( size_t i = 0; i <= iFrame % 3; ++i )
+		{
+			touches.push_back( Application::Touch( vec2( real( 10 * iFrame ), real( i )),
+												   vec2( real( i ), real( 10 * iFrame )),
+												   vec2( 0, real( iFrame )),
+												   int( i ),
+												   int( iFrame % 3 + 1 ),
+												   int( iFrame ),
+												   reinterpret_cast< void* >( uintptr_t( 100 + i ))));
+		}
+		return touches;
+	}
+
+	bool isPressedIn( size_t iButton, size_t iFrame )
+	{
+		return ( iButton + iFrame ) % 3 == 0;
+	}
+
+	float axisIn( size_t iAxis, size_t iFrame )
+	{
+		return float( iAxis + 1 ) / float( iFrame + NUM_AXES );
+	}
+
+	SystemClock durationIn( size_t iFrame, size_t i )
+	{
+		return SystemClock( 1000 * iFrame + i + 1 );
+	}
+
+	unsigned int seedIn( size_t iFrame, size_t i )
+	{
+		return unsigned( 7919 * iFrame + i );
+	}
+
+	bool sameTouches( const Application::Touches& a, const Application::Touches& b )
+	{
+		if( a.size() != b.size() )
+		{
+			return false;
+		}
+		for( size_t i = 0; i < a.size(); ++i )
+		{
+			if( a[ i ].position != b[ i ].position || a[ i ].lastPosition != b[ i ].lastPosition || a[ i ].wheelDelta != b[ i ].wheelDelta ||
+			    a[ i ].iTouch != b[ i ].iTouch || a[ i ].nTouches != b[ i ].nTouches || a[ i ].nTaps != b[ i ].nTaps || a[ i ].touchId != b[ i ].touchId )
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+FRESH_TEST( InputRecordingReplaysWhatWasRecorded )
+{
+	const path filePath = getTempDirectoryPath() / "fresh_test_input_recording.frin";
+
+	// Record. Frames carry different numbers of durations and seeds, and the gamepad attaches in the second frame.
+	//
+	{
+		InputRecorder recorder( filePath, true );
+
+		auto gamepads = createObject< GamepadManager >();
+		Gamepad::ptr gamepad;
+
+		for( size_t iFrame = 0; iFrame < NUM_FRAMES; ++iFrame )
+		{
+			recorder.recordKey( keyEvent( iFrame ));
+
+			const auto touches = touchesFor( iFrame );
+			recorder.recordTouches( iFrame % 2 ? EventTouch::TouchPhase::Move : EventTouch::TouchPhase::Begin, touches.begin(), touches.end() );
+
+			if( iFrame == 1 )
+			{
+				gamepad = gamepads->attachReplayedGamepad();
+			}
+			if( gamepad )
+			{
+				bool buttons[ NUM_BUTTONS ];
+				float axes[ NUM_AXES ];
+				for( size_t i = 0; i < NUM_BUTTONS; ++i )
+				{
+					buttons[ i ] = isPressedIn( i, iFrame );
+				}
+				for( size_t i = 0; i < NUM_AXES; ++i )
+				{
+					axes[ i ] = axisIn( i, iFrame );
+				}
+				gamepad->setReplayedState( buttons, axes );
+			}
+			gamepads->updateReplayed();
+			recorder.recordGamepads( *gamepads );
+
+			for( size_t i = 0; i < iFrame % 3; ++i )
+			{
+				recorder.recordFrameDuration( durationIn( iFrame, i ));
+			}
+			for( size_t i = 0; i < iFrame % 4; ++i )
+			{
+				recorder.recordSeed( seedIn( iFrame, i ));
+			}
+
+			recorder.endFrame();
+		}
+		VERIFY_BOOL( recorder.nFrames() == NUM_FRAMES );
+	}
+
+	// Replay into a fresh set of gamepads. Each frame asks for one more duration and seed than it recorded,
+	// as a diverging replay would; the extra ones fall back to the arguments and don't eat into the next frame.
+	//
+	InputReplayer replayer( filePath );
+	VERIFY_BOOL( replayer.wasFixedTimestep() );
+	VERIFY_BOOL( replayer.numFrames() == NUM_FRAMES );
+
+	auto gamepads = createObject< GamepadManager >();
+
+	for( size_t iFrame = 0; iFrame < NUM_FRAMES; ++iFrame )
+	{
+		VERIFY_BOOL( !replayer.isFinished() );
+		VERIFY_BOOL( replayer.numFramesRemaining() == NUM_FRAMES - iFrame );
+
+		const auto& input = replayer.beginFrame( *gamepads );
+		VERIFY_BOOL( input.size() == 2 );
+
+		const auto& key = input[ 0 ];
+		const auto expectedKey = keyEvent( iFrame );
+		VERIFY_BOOL( key.type == InputReplayer::Record::Type::Key );
+		const auto replayedKey = key.keyboardEvent();
+		VERIFY_BOOL( replayedKey.type() == expectedKey.type() );
+		VERIFY_BOOL( replayedKey.charCode() == expectedKey.charCode() );
+		VERIFY_BOOL( replayedKey.key() == expectedKey.key() );
+		VERIFY_BOOL( replayedKey.isAltOptionDown() == expectedKey.isAltOptionDown() );
+		VERIFY_BOOL( replayedKey.isCtrlCommandDown() == expectedKey.isCtrlCommandDown() );
+		VERIFY_BOOL( replayedKey.isShiftDown() == expectedKey.isShiftDown() );
+
+		const auto& touches = input[ 1 ];
+		VERIFY_BOOL( touches.type == InputReplayer::Record::Type::Touches );
+		VERIFY_BOOL( touches.phase == ( iFrame % 2 ? EventTouch::TouchPhase::Move : EventTouch::TouchPhase::Begin ));
+		VERIFY_BOOL( sameTouches( touches.touches, touchesFor( iFrame )));
+
+		gamepads->updateReplayed();
+		VERIFY_BOOL( gamepads->numAttachedGamepads() == ( iFrame >= 1 ? 1 : 0 ));
+		if( iFrame >= 1 )
+		{
+			const auto gamepad = gamepads->gamepadAt( 0 );
+			for( size_t i = 0; i < NUM_BUTTONS; ++i )
+			{
+				VERIFY_BOOL( gamepad->button( Gamepad::Button( i )) == isPressedIn( i, iFrame ));
+			}
+			for( size_t i = 0; i < NUM_AXES; ++i )
+			{
+				VERIFY_BOOL( gamepad->axis( Gamepad::Axis( i )) == axisIn( i, iFrame ));
+			}
+		}
+
+		for( size_t i = 0; i < iFrame % 3; ++i )
+		{
+			VERIFY_BOOL( replayer.frameDuration( 0 ) == durationIn( iFrame, i ));
+		}
+		VERIFY_BOOL( replayer.frameDuration( 12345 ) == 12345 );
+
+		for( size_t i = 0; i < iFrame % 4; ++i )
+		{
+			VERIFY_BOOL( replayer.seed( 0 ) == seedIn( iFrame, i ));
+		}
+		VERIFY_BOOL( replayer.seed( 4321 ) == 4321 );
+
+		replayer.endFrame();
+	}
+	VERIFY_BOOL( replayer.isFinished() );
+
+	std::remove( filePath.c_str() );
+	return true;
+}
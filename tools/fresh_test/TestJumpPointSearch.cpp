@@ -0,0 +1,147 @@
+//
+//  TestJumpPointSearch.cpp
+//  fresh_test
+//
+
+#include "UnitTest.h"
+#include "JumpPointSearch.h"
+#include <deque>
+#include <random>
+
+using namespace fr;
+
+namespace
+{
+	// The length in cells, inclusive, of a shortest 4-connected path, or 0 if there is none.
+	//
+	size_t breadthFirstPathLength( const std::vector< bool >& isOpen, const Vector2i& extents, const Vector2i& start, const Vector2i& goal )
+	{
+		const auto index = [&]( const Vector2i& pos ) { return pos.y * extents.x + pos.x; };
+
+		if( !isOpen[ index( start ) ] || !isOpen[ index( goal ) ] )
+		{
+			return 0;
+		}
+
+		std::vector< size_t > lengths( isOpen.size(), 0 );
+		std::deque< Vector2i > frontier{ start };
+		lengths[ index( start ) ] = 1;
+
+		while( !frontier.empty() )
+		{
+			const auto pos = frontier.front();
+			frontier.pop_front();
+
+			if( pos == goal )
+			{
+				return lengths[ index( pos ) ];
+			}
+
+			static const Vector2i steps[] = { Vector2i( 1, 0 ), Vector2i( -1, 0 ), Vector2i( 0, 1 ), Vector2i( 0, -1 ) };
+			for( const auto& step : steps )
+			{
+				const auto next = pos + step;
+				if( 0 <= next.x && next.x < extents.x && 0 <= next.y && next.y < extents.y && isOpen[ index( next ) ] && lengths[ index( next ) ] == 0 )
+				{
+					lengths[ index( next ) ] = lengths[ index( pos ) ] + 1;
+					frontier.push_back( next );
+				}
+			}
+		}
+		return 0;
+	}
+
+	bool isValidPath( const JumpPointGrid::Path& path, const JumpPointGrid& grid, const Vector2i& start, const Vector2i& goal )
+	{
+		if( path.empty() || path.front() != start || path.back() != goal )
+		{
+			return false;
+		}
+		for( size_t i = 0; i < path.size(); ++i )
+		{
+			if( !grid.isOpen( path[ i ] ))
+			{
+				return false;
+			}
+			if( i > 0 )
+			{
+				const auto step = path[ i ] - path[ i - 1 ];
+				if( std::abs( step.x ) + std::abs( step.y ) != 1 )
+				{
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+}
+
+FRESH_TEST( JumpPointSearchMatchesBreadthFirstSearch )
+{
+	// Random grids from open to cluttered, searched with and without a jump table and checked against
+	// breadth-first search. Cells change between queries, so the rows that searches without a table keep must
+	// be forgotten when their cells change.
+	//
+	std::mt19937 random( 7 );
+
+	size_t nQueries = 0;
+	size_t nFound = 0;
+
+	for( int iGrid = 0; iGrid < 120; ++iGrid )
+	{
+		const Vector2i extents( 20 + random() % 100, 20 + random() % 100 );
+		const int density = random() % 40;
+
+		JumpPointGrid plain, tabled;
+		plain.reset( extents );
+		tabled.reset( extents );
+
+		std::vector< bool > isOpen( extents.x * extents.y );
+		for( int y = 0; y < extents.y; ++y )
+		{
+			for( int x = 0; x < extents.x; ++x )
+			{
+				const bool open = int( random() % 100 ) >= density;
+				isOpen[ y * extents.x + x ] = open;
+				plain.isOpen( Vector2i( x, y ), open );
+				tabled.isOpen( Vector2i( x, y ), open );
+			}
+		}
+
+		for( int iQuery = 0; iQuery < 8; ++iQuery )
+		{
+			if( iQuery > 0 )
+			{
+				for( int i = 0; i < 20; ++i )
+				{
+					const Vector2i pos( random() % extents.x, random() % extents.y );
+					const bool open = random() % 3 != 0;
+					isOpen[ pos.y * extents.x + pos.x ] = open;
+					plain.isOpen( pos, open );
+					tabled.isOpen( pos, open );
+				}
+			}
+			tabled.buildJumpTable();
+
+			const Vector2i start( random() % extents.x, random() % extents.y );
+			const Vector2i goal( random() % extents.x, random() % extents.y );
+
+			const size_t expectedLength = breadthFirstPathLength( isOpen, extents, start, goal );
+
+			for( auto grid : { &plain, &tabled } )
+			{
+				JumpPointGrid::Path path;
+				const bool found = grid->findPath( start, goal, path );
+
+				VERIFY_BOOL( found == ( expectedLength > 0 ));
+				VERIFY_BOOL( found ? isValidPath( path, *grid, start, goal ) && path.size() == expectedLength : path.empty() );
+			}
+
+			++nQueries;
+			nFound += expectedLength > 0;
+		}
+	}
+
+	VERIFY_BOOL( 0 < nFound && nFound < nQueries );
+	return true;
+}
@@ -0,0 +1,172 @@
+//
+//  TestManifestCompiled.cpp
+//  fresh_test
+//
+
+#include "UnitTest.h"
+#include "FreshManifest.h"
+#include "FreshException.h"
+#include "FreshFile.h"
+#include <fstream>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <utime.h>
+
+using namespace fr;
+
+namespace
+{
+	path makeTempDirectory()
+	{
+		std::string pattern = ( getTempDirectoryPath() / "fresh_testXXXXXX" ).string();
+		if( !::mkdtemp( &pattern[ 0 ] ))
+		{
+			FRESH_THROW( FreshException, "Could not create a temporary directory." );
+		}
+		return pattern;
+	}
+
+	void writeFile( const path& filePath, const std::string& contents )
+	{
+		std::ofstream out( filePath.c_str() );
+		out << contents;
+	}
+
+	void setModifiedTime( const path& filePath, std::time_t time )
+	{
+		::utimbuf times{ time, time };
+		::utime( filePath.c_str(), &times );
+	}
+
+	void appendWord( std::vector< unsigned char >& bytes, uint32_t w )
+	{
+		for( size_t i = 0; i < 4; ++i )
+		{
+			bytes.push_back( static_cast< unsigned char >( w >> ( i * 8 )));
+		}
+	}
+
+	void patchWord( std::vector< unsigned char >& bytes, size_t index, uint32_t w )
+	{
+		for( size_t i = 0; i < 4; ++i )
+		{
+			bytes[ index * 4 + i ] = static_cast< unsigned char >( w >> ( i * 8 ));
+		}
+	}
+}
+
+FRESH_TEST( CompiledManifestGoesStaleWithIncludes )
+{
+	const path directory = makeTempDirectory();
+	const path innerPath = directory / "inner.fresh";
+	const path outerPath = directory / "outer.fresh";
+	const path compiledPath = directory / "outer.freshc";
+
+	writeFile( innerPath, "object Object innerObject {\n}\n" );
+	writeFile( outerPath, "include \"" + innerPath.string() + "\"\nobject Object outerObject {\n}\n" );
+
+	Manifest source;
+	source.load( outerPath );
+	VERIFY_BOOL( source.includedPaths().size() == 1 );
+	VERIFY_BOOL( source.includedPaths().front() == innerPath );
+
+	source.saveCompiled( compiledPath );
+
+	Manifest compiled;
+	compiled.loadCompiled( compiledPath );
+	VERIFY_BOOL( compiled == source );
+
+	const std::time_t now = std::time( nullptr );
+	setModifiedTime( innerPath, now - 100 );
+	setModifiedTime( outerPath, now - 100 );
+	setModifiedTime( compiledPath, now );
+	VERIFY_BOOL( Manifest::isCompiledUpToDate( compiledPath, outerPath ));
+
+	// Changing only the included file makes the compiled manifest stale.
+	//
+	setModifiedTime( innerPath, now + 100 );
+	VERIFY_BOOL( !Manifest::isCompiledUpToDate( compiledPath, outerPath ));
+
+	// So does changing the source.
+	//
+	setModifiedTime( innerPath, now - 100 );
+	setModifiedTime( outerPath, now + 100 );
+	VERIFY_BOOL( !Manifest::isCompiledUpToDate( compiledPath, outerPath ));
+
+	// And losing the included file.
+	//
+	setModifiedTime( outerPath, now - 100 );
+	std::remove( innerPath.c_str() );
+	VERIFY_BOOL( !Manifest::isCompiledUpToDate( compiledPath, outerPath ));
+
+	// Without the source, the compiled manifest is all there is.
+	//
+	std::remove( outerPath.c_str() );
+	VERIFY_BOOL( Manifest::isCompiledUpToDate( compiledPath, outerPath ));
+
+	std::remove( compiledPath.c_str() );
+	std::remove( directory.c_str() );
+	return true;
+}
+
+FRESH_TEST( CompiledManifestRejectsSharedNodeBlowup )
+{
+	// A compiled manifest whose maps each refer twice to the map before: 48 levels expand to 2^48 nodes.
+	// The writer never shares nodes, so the reader must refuse rather than expand them.
+	//
+	std::vector< unsigned char > bytes( 32, 0 );
+
+	const uint32_t stringNode = uint32_t( bytes.size() );
+	appendWord( bytes, 0 );		// String node
+	appendWord( bytes, 0 );		// "k"
+
+	uint32_t previous = stringNode;
+	for( int level = 0; level < 48; ++level )
+	{
+		const uint32_t mapNode = uint32_t( bytes.size() );
+		appendWord( bytes, 1 );		// Map node
+		appendWord( bytes, 2 );
+		for( int entry = 0; entry < 2; ++entry )
+		{
+			appendWord( bytes, 0 );
+			appendWord( bytes, previous );
+			appendWord( bytes, 0 );
+		}
+		previous = mapNode;
+	}
+
+	const uint32_t directiveTable = uint32_t( bytes.size() );
+	appendWord( bytes, 1 );			// Object directive
+	appendWord( bytes, 0 );
+	appendWord( bytes, 0 );
+	appendWord( bytes, previous );
+
+	const uint32_t stringIndex = uint32_t( bytes.size() );
+	appendWord( bytes, stringIndex + 8 );
+	appendWord( bytes, 1 );
+	bytes.push_back( 'k' );
+	bytes.push_back( 0 );
+
+	bytes[ 0 ] = 'F'; bytes[ 1 ] = 'R'; bytes[ 2 ] = 'M'; bytes[ 3 ] = 'C';
+	patchWord( bytes, 1, 2 );
+	patchWord( bytes, 2, 1 );
+	patchWord( bytes, 3, stringIndex );
+	patchWord( bytes, 4, 1 );
+	patchWord( bytes, 5, directiveTable );
+	patchWord( bytes, 6, uint32_t( bytes.size() ));
+
+	Manifest manifest;
+	Manifest::Directives directives;
+	try
+	{
+		manifest.loadCompiled( bytes.data(), bytes.size(), directives );
+	}
+	catch( const FreshException& )
+	{
+		return true;
+	}
+
+	VERIFY_BOOL_MSG( false, "Loading a manifest with widely shared nodes should have failed." );
+	return false;
+}
@@ -0,0 +1,156 @@
+//
+//  TestManifestDocument.cpp
+//  fresh_test
+//
+
+#include "UnitTest.h"
+#include "ManifestDocument.h"
+#include "Objects.h"
+#include "Classes.h"
+#include "Packages.h"
+#include "Property.h"
+#include "FreshFile.h"
+#include "FreshVector.h"
+#include <fstream>
+
+using namespace fr;
+
+namespace unittest
+{
+	class TestDocumentThing : public Object
+	{
+		FRESH_DECLARE_CLASS( TestDocumentThing, Object );
+	public:
+
+		int number() const										{ return m_number; }
+		const std::string& text() const							{ return m_text; }
+		const vec2& position() const							{ return m_position; }
+		SmartPtr< TestDocumentThing > other() const				{ return m_other; }
+		const std::vector< SmartPtr< TestDocumentThing >>& children() const	{ return m_children; }
+
+	private:
+
+		DVAR( int, m_number, 0 );
+		DVAR( std::string, m_text, "" );
+		DVAR( vec2, m_position, vec2( 0, 0 ));
+		DVAR( SmartPtr< TestDocumentThing >, m_other, nullptr );
+		VAR( std::vector< SmartPtr< TestDocumentThing >>, m_children );
+	};
+
+	FRESH_DEFINE_CLASS( TestDocumentThing )
+	DEFINE_VAR( TestDocumentThing, int, m_number );
+	DEFINE_VAR( TestDocumentThing, std::string, m_text );
+	DEFINE_VAR( TestDocumentThing, vec2, m_position );
+	DEFINE_VAR( TestDocumentThing, SmartPtr< TestDocumentThing >, m_other );
+	DEFINE_VAR( TestDocumentThing, std::vector< SmartPtr< TestDocumentThing >>, m_children );
+	FRESH_IMPLEMENT_STANDARD_CONSTRUCTORS( TestDocumentThing )
+
+	namespace
+	{
+		// Constants, a pseudoclass, and objects with references, arrays and inline objects.
+		//
+		const char* const MANIFEST_TEXT =
+			"const int testDocumentConstant \"12\"\n"
+			"class TestDocumentDerived extends TestDocumentThing {\n\tnumber \"5\"\n\ttext \"from class\"\n}\n"
+			"object TestDocumentThing testDocumentFirst {\n"
+			"\tnumber \"7\"\n\ttext \"first thing\"\n\tposition \"1.5,-2\"\n\tother \"TestDocumentThing'testDocumentSecond'\"\n"
+			"\tchildren [\n\t\tobject TestDocumentThing {\n\t\t\tnumber \"21\"\n\t\t}\n\t\tobject TestDocumentDerived {\n\t\t}\n\t]\n"
+			"}\n"
+			"object TestDocumentDerived testDocumentSecond {\n\ttext \"second thing\"\n}\n";
+
+		path writeCompiledManifest( const std::string& name )
+		{
+			const path textPath = getTempDirectoryPath() / ( name + ".fresh" );
+			const path compiledPath = getTempDirectoryPath() / ( name + Manifest::COMPILED_EXTENSION );
+			{
+				std::ofstream out( textPath.c_str() );
+				out << MANIFEST_TEXT;
+			}
+
+			Manifest manifest;
+			manifest.load( textPath );
+			manifest.saveCompiled( compiledPath );
+			return compiledPath;
+		}
+
+		bool matches( const ManifestDocument& document, const Manifest& manifest )
+		{
+			const auto directives = document.toManifestDirectives();
+			size_t i = 0;
+			bool allMatch = true;
+			manifest.eachDirective( [&]( const Manifest::Directive& directive )
+								   {
+									   allMatch = allMatch && i < directives.size() && Manifest::equivalent( *directives[ i ], directive );
+									   ++i;
+								   } );
+			return allMatch && i == directives.size();
+		}
+	}
+}
+
+using namespace unittest;
+
+FRESH_TEST( ManifestDocumentMatchesManifestInOneBlock )
+{
+	const path compiledPath = writeCompiledManifest( "fresh_test_document" );
+
+	Manifest manifest;
+	manifest.loadCompiled( compiledPath );
+
+	const ManifestDocument compiledDocument( compiledPath );
+	VERIFY_BOOL( matches( compiledDocument, manifest ));
+	VERIFY_BOOL( compiledDocument.arena().numBlocks() == 1 );
+
+	const ManifestDocument copiedDocument( manifest );
+	VERIFY_BOOL( matches( copiedDocument, manifest ));
+	VERIFY_BOOL( copiedDocument.arena().numBlocks() == 1 );
+
+	return true;
+}
+
+FRESH_TEST( PackageLoadsCompiledManifestThroughDocument )
+{
+	const path compiledPath = writeCompiledManifest( "fresh_test_document_package" );
+
+	Manifest manifest;
+	manifest.loadCompiled( compiledPath );
+	auto fromManifest = createPackage( "testDocumentFromManifest" );
+	const auto manifestObjects = fromManifest->loadFromManifest( manifest );
+
+	auto fromDocument = createPackage( "testDocumentFromDocument" );
+	const auto documentObjects = fromDocument->loadFile( compiledPath );
+
+	VERIFY_BOOL( manifestObjects.size() == 2 );
+	VERIFY_BOOL( documentObjects.size() == manifestObjects.size() );
+
+	for( size_t i = 0; i < documentObjects.size(); ++i )
+	{
+		auto expected = manifestObjects[ i ]->as< TestDocumentThing >();
+		auto actual = documentObjects[ i ]->as< TestDocumentThing >();
+		VERIFY_BOOL( expected && actual );
+		VERIFY_BOOL( &expected->classInfo() == &actual->classInfo() );
+		VERIFY_BOOL( expected->name() == actual->name() );
+		VERIFY_BOOL( expected->number() == actual->number() );
+		VERIFY_BOOL( expected->text() == actual->text() );
+		VERIFY_BOOL( expected->position() == actual->position() );
+		VERIFY_BOOL( expected->children().size() == actual->children().size() );
+		for( size_t j = 0; j < actual->children().size(); ++j )
+		{
+			VERIFY_BOOL( expected->children()[ j ]->number() == actual->children()[ j ]->number() );
+			VERIFY_BOOL( &expected->children()[ j ]->classInfo() == &actual->children()[ j ]->classInfo() );
+		}
+	}
+
+	// References resolve within each package.
+	//
+	auto first = documentObjects.front()->as< TestDocumentThing >();
+	VERIFY_BOOL( first->number() == 7 );
+	VERIFY_BOOL( first->other() == documentObjects.back() );
+	VERIFY_BOOL( first->children().size() == 2 && first->children()[ 0 ]->number() == 21 && first->children()[ 1 ]->number() == 5 );
+
+	auto second = documentObjects.back()->as< TestDocumentThing >();
+	VERIFY_BOOL( second->number() == 5 );
+	VERIFY_BOOL( second->text() == "second thing" );
+
+	return true;
+}
@@ -0,0 +1,265 @@
+//
+//  TestObjectClone.cpp
+//  fresh_test
+//
+
+#include "UnitTest.h"
+#include "Objects.h"
+#include "Classes.h"
+#include "Property.h"
+#include "StringTable.h"
+
+using namespace fr;
+
+namespace unittest
+{
+	// A stand-in for an asset: referred to, never owned.
+	//
+	class TestCloneResource : public Object
+	{
+		FRESH_DECLARE_CLASS( TestCloneResource, Object );
+	public:
+
+		virtual bool isSharedResource() const override	{ return true; }
+	};
+
+	class TestCloneComponent : public Object
+	{
+		FRESH_DECLARE_CLASS( TestCloneComponent, Object );
+	public:
+
+		SYNTHESIZE( int, strength )
+
+	private:
+
+		DVAR( int, m_strength, 0 );
+	};
+
+	// Owns its children and components as DisplayObjectContainer does, and adopts its children in postLoad() the same way.
+	//
+	class TestCloneNode : public Object
+	{
+		FRESH_DECLARE_CLASS( TestCloneNode, Object );
+	public:
+
+		typedef std::vector< SmartPtr< TestCloneNode >> Children;
+		typedef std::vector< SmartPtr< TestCloneComponent >> Components;
+
+		SYNTHESIZE( int, value )
+		const Children& children() const							{ return m_children; }
+		const Components& components() const						{ return m_components; }
+		SYNTHESIZE( SmartPtr< TestCloneResource >, resource )
+
+		WeakPtr< TestCloneNode > parent() const						{ return m_parent; }
+
+		void addChild( SmartPtr< TestCloneNode > child )
+		{
+			child->m_parent = this;
+			m_children.push_back( child );
+		}
+
+		void addComponent( SmartPtr< TestCloneComponent > component )
+		{
+			m_components.push_back( component );
+		}
+
+		virtual void postLoad() override
+		{
+			Super::postLoad();
+
+			for( auto iter = m_children.begin(); iter != m_children.end(); /* iteration within */ )
+			{
+				if( !(*iter)->m_parent )
+				{
+					(*iter)->m_parent = this;
+				}
+
+				if( (*iter)->m_parent != this )
+				{
+					iter = m_children.erase( iter );
+				}
+				else
+				{
+					++iter;
+				}
+			}
+		}
+
+	protected:
+
+		virtual void cloneProperties( const Object& original ) override
+		{
+			Super::cloneProperties( original );
+			m_parent = nullptr;
+		}
+
+	private:
+
+		DVAR( int, m_value, 0 );
+		VAR( Children, m_children );
+		VAR( Components, m_components );
+		VAR( SmartPtr< TestCloneResource >, m_resource );
+		VAR( WeakPtr< TestCloneNode >, m_parent );
+	};
+
+	class TestConfigured : public Object
+	{
+		FRESH_DECLARE_CLASS( TestConfigured, Object );
+	public:
+
+		SYNTHESIZE_GET( std::string, text )
+		SYNTHESIZE_GET( int, number )
+
+	private:
+
+		DVAR( std::string, m_text, "" );
+		DVAR( int, m_number, 0 );
+	};
+
+	FRESH_DEFINE_CLASS( TestCloneResource )
+	FRESH_IMPLEMENT_STANDARD_CONSTRUCTORS( TestCloneResource )
+
+	FRESH_DEFINE_CLASS( TestCloneComponent )
+	DEFINE_VAR( TestCloneComponent, int, m_strength );
+	FRESH_IMPLEMENT_STANDARD_CONSTRUCTORS( TestCloneComponent )
+
+	FRESH_DEFINE_CLASS( TestCloneNode )
+	DEFINE_VAR( TestCloneNode, int, m_value );
+	DEFINE_VAR( TestCloneNode, Children, m_children );
+	DEFINE_VAR( TestCloneNode, Components, m_components );
+	DEFINE_VAR( TestCloneNode, SmartPtr< TestCloneResource >, m_resource );
+	DEFINE_VAR( TestCloneNode, WeakPtr< TestCloneNode >, m_parent );
+	FRESH_IMPLEMENT_STANDARD_CONSTRUCTORS( TestCloneNode )
+
+	FRESH_DEFINE_CLASS( TestConfigured )
+	DEFINE_VAR( TestConfigured, std::string, m_text );
+	DEFINE_VAR( TestConfigured, int, m_number );
+	FRESH_IMPLEMENT_STANDARD_CONSTRUCTORS( TestConfigured )
+
+	namespace
+	{
+		void setConfiguration( Manifest::Map& map, const std::string& key, const std::string& value )
+		{
+			map[ key ] = std::make_pair( std::make_shared< Manifest::Value >( value ), Manifest::PropertyAttributes{} );
+		}
+
+		ClassInfo::ptr createTestClass( const std::string& name, const std::string& baseName, std::vector< std::pair< std::string, std::string >> configuration )
+		{
+			auto map = std::make_shared< Manifest::Map >();
+			for( const auto& pair : configuration )
+			{
+				setConfiguration( *map, pair.first, pair.second );
+			}
+			Manifest::Class directive( name, { baseName }, std::move( map ));
+			return createClass( name, baseName, directive );
+		}
+	}
+}
+
+using namespace unittest;
+
+FRESH_TEST( CloneOwnsChildrenAndComponents )
+{
+	auto resource = createObject< TestCloneResource >();
+
+	auto grandparent = createObject< TestCloneNode >();
+	auto original = createObject< TestCloneNode >();
+	grandparent->addChild( original );
+
+	original->value( 7 );
+	original->resource( resource );
+
+	auto component = createObject< TestCloneComponent >();
+	component->strength( 3 );
+	original->addComponent( component );
+
+	for( int i = 0; i < 3; ++i )
+	{
+		auto child = createObject< TestCloneNode >();
+		child->value( i );
+		child->addComponent( createObject< TestCloneComponent >() );
+		original->addChild( child );
+
+		auto grandchild = createObject< TestCloneNode >();
+		grandchild->value( 10 + i );
+		child->addChild( grandchild );
+	}
+
+	auto clone = dynamic_freshptr_cast< TestCloneNode::ptr >( original->createClone() );
+	VERIFY_BOOL( clone && clone != original );
+	VERIFY_BOOL( clone->value() == 7 );
+
+	// The clone is not attached where the original is.
+	//
+	VERIFY_BOOL( !clone->parent() );
+	VERIFY_BOOL( grandparent->children().size() == 1 );
+
+	// Shared resources are shared.
+	//
+	VERIFY_BOOL( clone->resource() == resource );
+
+	// Components are the clone's own.
+	//
+	VERIFY_BOOL( clone->components().size() == 1 );
+	VERIFY_BOOL( clone->components().front() != component );
+	VERIFY_BOOL( clone->components().front()->strength() == 3 );
+
+	// Children are the clone's own, all the way down, and know their new parents.
+	//
+	VERIFY_BOOL( clone->children().size() == 3 );
+	VERIFY_BOOL( original->children().size() == 3 );
+	for( size_t i = 0; i < 3; ++i )
+	{
+		const auto& child = clone->children()[ i ];
+		const auto& originalChild = original->children()[ i ];
+		VERIFY_BOOL( child != originalChild );
+		VERIFY_BOOL( child->value() == int( i ));
+		VERIFY_BOOL( child->parent() == clone );
+		VERIFY_BOOL( originalChild->parent() == original );
+		VERIFY_BOOL( child->components().size() == 1 && child->components().front() != originalChild->components().front() );
+
+		VERIFY_BOOL( child->children().size() == 1 );
+		VERIFY_BOOL( child->children().front() != originalChild->children().front() );
+		VERIFY_BOOL( child->children().front()->value() == 10 + int( i ));
+		VERIFY_BOOL( child->children().front()->parent() == child );
+	}
+
+	return true;
+}
+
+FRESH_TEST( ConfigurationOverridesAcrossCopyableKinds )
+{
+	// "!greeting" is a string table reference, which is loaded every time; plain text is copied from the prototype.
+	//
+	auto table = std::make_shared< Manifest::Map >();
+	setConfiguration( *table, "greeting", "Bonjour" );
+	Manifest::Map tableProperties;
+	tableProperties[ "table" ] = std::make_pair( std::make_shared< Manifest::Value >( table ), Manifest::PropertyAttributes{} );
+	auto stringTable = createObject< StringTable >( DEFAULT_OBJECT_NAME, &tableProperties );
+	VERIFY_BOOL( StringTable::string( "greeting" ) == "Bonjour" );
+
+	// A derived plain value overrides a base reference.
+	//
+	createTestClass( "TestConfiguredReferenceBase", "TestConfigured", { { "text", "!greeting" }, { "number", "1" } } );
+	auto plainDerived = createTestClass( "TestConfiguredPlainDerived", "TestConfiguredReferenceBase", { { "text", "Hello" } } );
+
+	// A derived reference overrides a base plain value.
+	//
+	createTestClass( "TestConfiguredPlainBase", "TestConfigured", { { "text", "Hello" }, { "number", "2" } } );
+	auto referenceDerived = createTestClass( "TestConfiguredReferenceDerived", "TestConfiguredPlainBase", { { "text", "!greeting" } } );
+
+	// Twice each, since the first instance compiles the prototype.
+	//
+	for( int i = 0; i < 2; ++i )
+	{
+		auto plain = createObject< TestConfigured >( *plainDerived );
+		VERIFY_BOOL( plain->text() == "Hello" );
+		VERIFY_BOOL( plain->number() == 1 );
+
+		auto reference = createObject< TestConfigured >( *referenceDerived );
+		VERIFY_BOOL( reference->text() == "Bonjour" );
+		VERIFY_BOOL( reference->number() == 2 );
+	}
+
+	return true;
+}
@@ -0,0 +1,91 @@
+//
+//  TestParsedValueCaching.cpp
+//  fresh_test
+//
+
+#include "UnitTest.h"
+#include "TypeTraits.h"
+#include "FreshVector.h"
+#include <thread>
+
+using namespace fr;
+
+FRESH_TEST( ParsedValueCachingRecognizesStringTableReferences )
+{
+	typedef ParsedValueCaching< std::string > Caching;
+
+	VERIFY_BOOL( !Caching::canCache( "!greeting" ));
+	VERIFY_BOOL( !Caching::canCache( "  !greeting" ));
+	VERIFY_BOOL( Caching::canCache( "Hello!" ));
+	VERIFY_BOOL( Caching::canCache( "Wait! What?" ));
+	VERIFY_BOOL( Caching::canCache( "" ));
+	return true;
+}
+
+FRESH_TEST( ParsedValueCachingRemembersParsedValues )
+{
+	const Manifest::Value number( std::string( "42" ));
+
+	int first = 0;
+	assignObjectProperty( first, number );
+	VERIFY_BOOL( first == 42 );
+	VERIFY_BOOL( number.parsed< int >() && *number.parsed< int >() == 42 );
+
+	int second = 7;
+	assignObjectProperty( second, number );
+	VERIFY_BOOL( second == 42 );
+
+	// Only the first type parsed is remembered.
+	//
+	float asFloat = 0;
+	assignObjectProperty( asFloat, number );
+	VERIFY_BOOL( asFloat == 42.0f );
+	VERIFY_BOOL( !number.parsed< float >() );
+
+	const Manifest::Value exclaimed( std::string( "Hello!" ));
+	std::string text;
+	assignObjectProperty( text, exclaimed );
+	VERIFY_BOOL( text == "Hello!" );
+	VERIFY_BOOL( exclaimed.parsed< std::string >() && *exclaimed.parsed< std::string >() == "Hello!" );
+
+	const Manifest::Value vector( std::string( "3,4" ));
+	vec2 position( 1, 1 );
+	assignObjectProperty( position, vector );
+	VERIFY_BOOL( position == vec2( 3, 4 ));
+	VERIFY_BOOL( vector.parsed< vec2 >() && *vector.parsed< vec2 >() == vec2( 3, 4 ));
+	return true;
+}
+
+FRESH_TEST( ParsedValueCachingIsSafeAcrossThreads )
+{
+	// Configuration nodes are shared by every instance, and instances may load on several threads.
+	//
+	for( int round = 0; round < 100; ++round )
+	{
+		const Manifest::Value shared( std::string( "1.5,-2.25" ));
+
+		const size_t nThreads = 4;
+		std::vector< vec2 > results( nThreads );
+		std::vector< std::thread > threads;
+		for( size_t t = 0; t < nThreads; ++t )
+		{
+			threads.emplace_back( [&, t]()
+								 {
+									 for( int i = 0; i < 100; ++i )
+									 {
+										 assignObjectProperty( results[ t ], shared );
+									 }
+								 } );
+		}
+		for( auto& thread : threads )
+		{
+			thread.join();
+		}
+
+		for( const auto& result : results )
+		{
+			VERIFY_BOOL( result == vec2( 1.5f, -2.25f ));
+		}
+	}
+	return true;
+}
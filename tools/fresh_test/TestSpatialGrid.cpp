@@ -0,0 +1,172 @@
+//
+//  TestSpatialGrid.cpp
+//  fresh_test
+//
+
+#include "UnitTest.h"
+#include "SpatialGrid.h"
+#include "FreshVector.h"
+#include <random>
+#include <set>
+
+using namespace fr;
+
+namespace
+{
+	struct Box
+	{
+		vec2 minCorner;
+		vec2 maxCorner;
+		bool isAlive = true;
+	};
+
+	bool overlaps( const Box& a, const Box& b )
+	{
+		return a.minCorner.x <= b.maxCorner.x && b.minCorner.x <= a.maxCorner.x &&
+			   a.minCorner.y <= b.maxCorner.y && b.minCorner.y <= a.maxCorner.y;
+	}
+
+	bool segmentCrosses( const vec2& start, const vec2& end, const Box& box )
+	{
+		real tEnter = 0;
+		real tExit = 1;
+		for( size_t i = 0; i < 2; ++i )
+		{
+			const real delta = end[ i ] - start[ i ];
+			if( delta == 0 )
+			{
+				if( start[ i ] < box.minCorner[ i ] || box.maxCorner[ i ] < start[ i ] )
+				{
+					return false;
+				}
+			}
+			else
+			{
+				real t0 = ( box.minCorner[ i ] - start[ i ] ) / delta;
+				real t1 = ( box.maxCorner[ i ] - start[ i ] ) / delta;
+				if( t1 < t0 )
+				{
+					std::swap( t0, t1 );
+				}
+				tEnter = std::max( tEnter, t0 );
+				tExit = std::min( tExit, t1 );
+			}
+		}
+		return tEnter <= tExit;
+	}
+}
+
+FRESH_TEST( SpatialGridMatchesBruteForce )
+{
+	// Adds, moves, removes and re-adds, checked against brute force after every frame. Three bins force
+	// most cells to share bins, so objects often sit in one bin several times over.
+	//
+	const size_t nObjects = 400;
+
+	std::mt19937 random( 7 );
+	std::uniform_real_distribution< real > position( -500, 500 ), size( 1, 150 ), step( -30, 30 );
+
+	for( size_t nBins : { size_t( 3 ), size_t( 64 ), size_t( 4000 ) } )
+	{
+		SpatialGrid< vec2, int > grid( nBins, 32 );
+
+		std::vector< Box > boxes( nObjects );
+		std::vector< SpatialGrid< vec2, int >::Handle > handles( nObjects );
+		for( size_t i = 0; i < nObjects; ++i )
+		{
+			boxes[ i ].minCorner.set( position( random ), position( random ));
+			boxes[ i ].maxCorner = boxes[ i ].minCorner + vec2( size( random ), size( random ));
+			handles[ i ] = grid.add( boxes[ i ].minCorner, boxes[ i ].maxCorner, int( i ));
+		}
+
+		for( int frame = 0; frame < 30; ++frame )
+		{
+			for( size_t i = 0; i < nObjects; ++i )
+			{
+				auto& box = boxes[ i ];
+				if( !box.isAlive )
+				{
+					if( random() % 5 == 0 )
+					{
+						box.isAlive = true;
+						handles[ i ] = grid.add( box.minCorner, box.maxCorner, int( i ));
+					}
+				}
+				else if( random() % 20 == 0 )
+				{
+					grid.remove( handles[ i ] );
+					box.isAlive = false;
+				}
+				else
+				{
+					const vec2 displacement( step( random ), step( random ));
+					box.minCorner += displacement;
+					box.maxCorner += displacement;
+					grid.move( handles[ i ], box.minCorner, box.maxCorner );
+				}
+			}
+
+			// Pairs, each exactly once.
+			//
+			std::set< std::pair< int, int >> expectedPairs, pairs;
+			for( size_t i = 0; i < nObjects; ++i )
+			{
+				for( size_t j = i + 1; j < nObjects; ++j )
+				{
+					if( boxes[ i ].isAlive && boxes[ j ].isAlive && overlaps( boxes[ i ], boxes[ j ] ))
+					{
+						expectedPairs.insert( std::make_pair( int( i ), int( j )));
+					}
+				}
+			}
+
+			size_t nReported = 0;
+			grid.eachPair( [&]( int a, int b )
+						  {
+							  ++nReported;
+							  pairs.insert( std::make_pair( std::min( a, b ), std::max( a, b )));
+						  } );
+			VERIFY_BOOL( pairs == expectedPairs );
+			VERIFY_BOOL( nReported == pairs.size() );
+
+			// A region.
+			//
+			Box region;
+			region.minCorner.set( position( random ), position( random ));
+			region.maxCorner = region.minCorner + vec2( 200, 120 );
+
+			std::multiset< int > expectedInRegion, inRegion;
+			for( size_t i = 0; i < nObjects; ++i )
+			{
+				if( boxes[ i ].isAlive && overlaps( boxes[ i ], region ))
+				{
+					expectedInRegion.insert( int( i ));
+				}
+			}
+			grid.eachOverlapping( region.minCorner, region.maxCorner, [&]( int element ) { inRegion.insert( element ); } );
+			VERIFY_BOOL( inRegion == expectedInRegion );
+
+			// A ray, sometimes vertical.
+			//
+			const vec2 start( position( random ), position( random ));
+			vec2 end( position( random ), position( random ));
+			if( frame % 7 == 0 )
+			{
+				end.x = start.x;
+			}
+
+			std::multiset< int > expectedOnRay, onRay;
+			for( size_t i = 0; i < nObjects; ++i )
+			{
+				if( boxes[ i ].isAlive && segmentCrosses( start, end, boxes[ i ] ))
+				{
+					expectedOnRay.insert( int( i ));
+				}
+			}
+			grid.eachOnRay( start, end, [&]( int element, real ) { onRay.insert( element ); } );
+			VERIFY_BOOL( onRay == expectedOnRay );
+		}
+	}
+
+	return true;
+}
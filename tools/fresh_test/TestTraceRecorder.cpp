@@ -0,0 +1,60 @@
+//
+//  TestTraceRecorder.cpp
+//  fresh_test
+//
+
+#include "UnitTest.h"
+#include "TraceRecorder.h"
+#include <sstream>
+#include <thread>
+
+using namespace fr;
+
+namespace
+{
+	std::string chromeTrace()
+	{
+		std::ostringstream out;
+		trace::writeChromeTrace( out );
+		return out.str();
+	}
+}
+
+FRESH_TEST( TraceKeepsCapturedEventsOfExitedThreads )
+{
+	const auto scope = trace::registerScope( "TraceTestExitedScope" );
+
+	trace::startCapture();
+
+	std::thread recorder( [&]()
+						 {
+							 trace::nameThread( "trace test recorder" );
+							 for( int i = 0; i < 3; ++i )
+							 {
+								 trace::AutoScope autoScope( scope );
+							 }
+						 } );
+	recorder.join();
+
+	std::thread idler( []() { trace::nameThread( "trace test idler" ); } );
+	idler.join();
+
+	trace::stopCapture();
+
+	// The recorder's events outlive it; the idler recorded nothing, so nothing of it is kept.
+	//
+	const auto exported = chromeTrace();
+	VERIFY_BOOL( exported.find( "TraceTestExitedScope" ) != std::string::npos );
+	VERIFY_BOOL( exported.find( "trace test recorder" ) != std::string::npos );
+	VERIFY_BOOL( exported.find( "trace test idler" ) == std::string::npos );
+
+	// A new capture forgets exited threads.
+	//
+	trace::startCapture();
+	trace::stopCapture();
+
+	const auto nextTrace = chromeTrace();
+	VERIFY_BOOL( nextTrace.find( "TraceTestExitedScope" ) == std::string::npos );
+	VERIFY_BOOL( nextTrace.find( "trace test recorder" ) == std::string::npos );
+	return true;
+}
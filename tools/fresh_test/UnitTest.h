@@ -0,0 +1,41 @@
+//
+//  UnitTest.h
+//  fresh_test
+//
+
+#ifndef fresh_test_UnitTest_h
+#define fresh_test_UnitTest_h
+
+#include "FreshTest.h"
+#include "FreshDebug.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace unittest
+{
+	// A test returns true iff it passed. Tests report failures through the VERIFY_BOOL macros of FreshTest.h,
+	// which trace the failed expression and return false.
+	//
+	typedef std::function< bool() > TestFunction;
+	
+	struct Test
+	{
+		std::string name;
+		TestFunction fn;
+	};
+	
+	std::vector< Test >& tests();
+	
+	struct Registrar
+	{
+		Registrar( const char* name, TestFunction&& fn );
+	};
+}
+
+#define FRESH_TEST( name_ )	\
+	static bool test_##name_();	\
+	static const unittest::Registrar s_testRegistrar_##name_( #name_, &test_##name_ );	\
+	static bool test_##name_()
+
+#endif
@@ -0,0 +1,75 @@
+//
+//  main.cpp
+//  fresh_test
+//
+//  Headless unit tests for FreshCore.
+//  Usage: fresh_test [name-filter...]
+//  With no filters every registered test runs. Otherwise only those whose names contain one of the filters.
+//  Exits with 0 iff every test that ran passed.
+//
+
+#include "UnitTest.h"
+#include "Classes.h"
+#include "ObjectLinker.h"
+#include "FreshException.h"
+#include <iostream>
+#include <algorithm>
+
+namespace unittest
+{
+	std::vector< Test >& tests()
+	{
+		static std::vector< Test > theTests;
+		return theTests;
+	}
+	
+	Registrar::Registrar( const char* name, TestFunction&& fn )
+	{
+		tests().push_back( Test{ name, std::move( fn ) } );
+	}
+}
+
+int main( int argc, const char* argv[] )
+{
+	fr::initReflection();
+	fr::ObjectLinker::create();
+	
+	const std::vector< std::string > filters( argv + 1, argv + argc );
+	
+	size_t nRun = 0;
+	size_t nFailed = 0;
+	
+	for( const auto& test : unittest::tests() )
+	{
+		const bool selected = filters.empty() || std::any_of( filters.begin(), filters.end(), [&]( const std::string& filter )
+															 {
+																 return test.name.find( filter ) != std::string::npos;
+															 } );
+		if( !selected )
+		{
+			continue;
+		}
+		
+		++nRun;
+		
+		bool passed = false;
+		try
+		{
+			passed = test.fn();
+		}
+		catch( const std::exception& e )
+		{
+			std::cerr << "Caught exception: " << e.what() << std::endl;
+		}
+		
+		std::cout << ( passed ? "PASSED " : "FAILED " ) << test.name << std::endl;
+		if( !passed )
+		{
+			++nFailed;
+		}
+	}
+	
+	std::cout << nRun - nFailed << " of " << nRun << " tests passed." << std::endl;
+	
+	return nFailed == 0 ? 0 : 1;
+}